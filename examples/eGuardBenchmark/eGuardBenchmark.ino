@@ -0,0 +1,62 @@
+#include <astekcrypto.h>
+#include <benchmark/eg_bench.h>
+
+// Times every eg* entry point and prints one CSV record per call type, see
+// src/benchmark/eg_bench.h for the columns. Capture the serial output to a file
+// and compare it with a previous run to spot regressions.
+//
+// The chain cases need about 1.1 KB of RAM; on an Uno add
+// #define EG_BENCH_SKIP_CHAIN to src/benchmark/eg_bench.c.
+//
+// After the run the interface counters are printed as a second CSV table. Add
+// #define ATCA_IFACE_INSTRUMENT to src/atca_iface.h to break them down per command
+// (calls, bytes, wakes, receive retries, CRC failures and time spent in delays).
+
+#define BENCH_ITERATIONS  10
+
+static uint32_t bench_clock(void) {
+  return micros();
+}
+
+static void bench_report(const eg_bench_result_t* result, void* context) {
+  char line[EG_BENCH_LINE_SIZE];
+
+  eg_bench_format(result, line, sizeof(line));
+  Serial.println(line);
+}
+
+static void stats_dump(const char* line, void* context) {
+  Serial.println(line);
+}
+
+// the setup function runs once when you press reset or power the board
+void setup() {
+  char line[EG_BENCH_LINE_SIZE];
+  ATCA_STATUS ret;
+
+  Serial.begin(9600);
+
+  ret = egSelectDevice(cfg_eGuard);
+  if (0 != ret) {
+    Serial.print(F("No device found. Returned: "));
+    Serial.println(ret, HEX);
+    return;
+  }
+
+  eg_bench_format_header(line, sizeof(line));
+  Serial.println(line);
+
+  ret = eg_bench_run(BENCH_ITERATIONS, bench_clock, bench_report, NULL);
+  if (0 != ret) {
+    Serial.print(F("Benchmark failed. Returned: "));
+    Serial.println(ret, HEX);
+  }
+
+  Serial.println();
+  atdumpifacestats(atGetIFace(atcab_getDevice()), stats_dump, NULL);
+  Serial.println(F("# done"));
+}
+
+// the loop function runs over and over again forever
+void loop() {
+}
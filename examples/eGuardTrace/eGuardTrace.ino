@@ -0,0 +1,60 @@
+#include <astekcrypto.h>
+#include <hal/hal_trace.h>
+
+// Records the bus transactions of a few eg* calls and prints them as hex lines.
+// Capture the serial output to a file and replay it on a host with
+// extras/eg_replay to profile the same I/O pattern without the board:
+//
+//   ./eg_replay trace.txt sernum random sha pubkey auth-sym
+//
+// Requires #define ATCA_HAL_TRACE in src/hal/atca_hal.h. The ring keeps the
+// most recent HAL_TRACE_BUFFER_SIZE bytes (256 on AVR); older records are
+// dropped and the replay skips what it cannot match.
+
+#ifndef ATCA_HAL_TRACE
+#error "Add #define ATCA_HAL_TRACE to src/hal/atca_hal.h"
+#endif
+
+static uint32_t trace_clock(void) {
+  return micros();
+}
+
+static void trace_print(const char* line, void* context) {
+  Serial.println(line);
+}
+
+// the setup function runs once when you press reset or power the board
+void setup() {
+  uint8_t message[64];
+  uint8_t buffer[ATCA_PUB_KEY_SIZE];
+  ATCA_STATUS ret;
+  uint8_t i;
+
+  Serial.begin(9600);
+  hal_trace_set_clock(trace_clock);
+
+  for (i = 0; i < sizeof(message); i++) {
+    message[i] = i;
+  }
+
+  ret = egSelectDevice(cfg_eGuard);
+  if (0 != ret) {
+    Serial.print(F("No device found. Returned: "));
+    Serial.println(ret, HEX);
+    return;
+  }
+
+  // The same calls, in the same order, as eg_replay runs by default
+  egSerNum(buffer);
+  egGenRandom(buffer);
+  egSHA256(message, sizeof(message), buffer);
+  egDevicePubKey(buffer);
+  egAuthenticate(SYMMETRIC, NULL);
+
+  hal_trace_dump(trace_print, NULL);
+  Serial.println(F("# done"));
+}
+
+// the loop function runs over and over again forever
+void loop() {
+}
@@ -0,0 +1,209 @@
+/**
+ * \file
+ * \brief Compile-time checked mirrors of the shipped certificate definitions.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Instantiates atcacert_static::cert_def<> for the signer and device definitions, so every
+ * static_assert in atcacert_def_static.h runs against them when this file compiles, then checks
+ * at run time that each constexpr mirror matches() its C definition and builds the same
+ * certificate as the C API:
+ *
+ *   gcc -c -I../../src ../../src/custom/cert_def_1_signer.c ../../src/custom/cert_def_2_device.c \
+ *       ../../src/atcacert/atcacert_def.c ../../src/atcacert/atcacert_der.c \
+ *       ../../src/atcacert/atcacert_date.c ../../src/crypto/atca_crypto_sw_sha1.c \
+ *       ../../src/crypto/atca_crypto_sw_sha2.c ../../src/crypto/hashes/sha1_routines.c \
+ *       ../../src/crypto/hashes/sha2_routines.c
+ *   g++ -std=c++11 -I../../src -o cert_def_static cert_def_static.cpp *.o
+ *   ./cert_def_static
+ *
+ * Update the mirrors below whenever src/custom/cert_def_1_signer.c or cert_def_2_device.c change;
+ * the program fails when they drift apart.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "atcacert/atcacert_def_static.h"
+#include "custom/cert_def_1_signer.h"
+#include "custom/cert_def_2_device.h"
+
+extern "C" const uint8_t g_cert_template_1_signer[];
+extern "C" const uint8_t g_cert_template_2_device[];
+
+static constexpr atcacert_def_t k_cert_def_1_signer = {
+	CERTTYPE_X509,
+	1,                                  // template_id
+	0,                                  // chain_id
+	0,                                  // private_key_slot
+	SNSRC_PUB_KEY_HASH,
+	{ DEVZONE_NONE, 0, 0, 0, 0 },       // cert_sn_dev_loc
+	DATEFMT_RFC5280_UTC,
+	DATEFMT_RFC5280_GEN,
+	{ 4, 415 },                         // tbs_cert_loc
+	0,                                  // expire_years
+	{ DEVZONE_DATA, 11, 0, 0, 72 },     // public_key_dev_loc
+	{ DEVZONE_DATA, 12, 0, 0, 72 },     // comp_cert_dev_loc
+	{
+		{ 251, 64 },                    // STDCERT_PUBLIC_KEY
+		{ 431, 74 },                    // STDCERT_SIGNATURE
+		{ 124, 13 },                    // STDCERT_ISSUE_DATE
+		{ 139, 15 },                    // STDCERT_EXPIRE_DATE
+		{ 220, 4 },                     // STDCERT_SIGNER_ID
+		{ 15, 16 },                     // STDCERT_CERT_SN
+		{ 399, 20 },                    // STDCERT_AUTH_KEY_ID
+		{ 366, 20 }                     // STDCERT_SUBJ_KEY_ID
+	},
+	NULL,                               // cert_elements
+	0,                                  // cert_elements_count
+	g_cert_template_1_signer,
+	506,                                // cert_template_size
+	NULL                                // tbs_midstate
+};
+
+static constexpr atcacert_def_t k_cert_def_2_device = {
+	CERTTYPE_X509,
+	2,                                  // template_id
+	0,                                  // chain_id
+	0,                                  // private_key_slot
+	SNSRC_PUB_KEY_HASH,
+	{ DEVZONE_NONE, 0, 0, 0, 0 },       // cert_sn_dev_loc
+	DATEFMT_RFC5280_UTC,
+	DATEFMT_RFC5280_GEN,
+	{ 4, 337 },                         // tbs_cert_loc
+	0,                                  // expire_years
+	{ DEVZONE_DATA, 0, 1, 0, 64 },      // public_key_dev_loc
+	{ DEVZONE_DATA, 10, 0, 0, 72 },     // comp_cert_dev_loc
+	{
+		{ 240, 64 },                    // STDCERT_PUBLIC_KEY
+		{ 353, 74 },                    // STDCERT_SIGNATURE
+		{ 118, 13 },                    // STDCERT_ISSUE_DATE
+		{ 133, 15 },                    // STDCERT_EXPIRE_DATE
+		{ 110, 4 },                     // STDCERT_SIGNER_ID
+		{ 15, 16 },                     // STDCERT_CERT_SN
+		{ 321, 20 },                    // STDCERT_AUTH_KEY_ID
+		{ 0, 0 }                        // STDCERT_SUBJ_KEY_ID
+	},
+	NULL,                               // cert_elements
+	0,                                  // cert_elements_count
+	g_cert_template_2_device,
+	428,                                // cert_template_size
+	NULL                                // tbs_midstate
+};
+
+typedef atcacert_static::cert_def<k_cert_def_1_signer> signer_def;
+typedef atcacert_static::cert_def<k_cert_def_2_device> device_def;
+
+/* Builds a certificate both ways, with the same key and dates, and compares the results. */
+template <typename StaticDef>
+static int check_build(const char* name, const atcacert_def_t* cert_def)
+{
+	static const uint8_t public_key[64] = {
+		0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x10,
+		0x21, 0x32, 0x43, 0x54, 0x65, 0x76, 0x87, 0x98, 0xA9, 0xBA, 0xCB, 0xDC, 0xED, 0xFE, 0x0F, 0x01,
+		0x12, 0x23, 0x34, 0x45, 0x56, 0x67, 0x78, 0x89, 0x9A, 0xAB, 0xBC, 0xCD, 0xDE, 0xEF, 0xF0, 0x02,
+		0x13, 0x24, 0x35, 0x46, 0x57, 0x68, 0x79, 0x8A, 0x9B, 0xAC, 0xBD, 0xCE, 0xDF, 0xE0, 0xF1, 0x03
+	};
+	atcacert_tm_utc_t issue_date;
+	uint8_t cert_static[StaticDef::template_size];
+	uint8_t cert_c[StaticDef::template_size];
+	uint8_t digest_static[32];
+	uint8_t digest_c[32];
+	int ret;
+
+	memset(&issue_date, 0, sizeof(issue_date));
+	issue_date.tm_year = 2026 - 1900;
+	issue_date.tm_mon  = 9;
+	issue_date.tm_mday = 19;
+	issue_date.tm_hour = 12;
+
+	StaticDef::init(cert_static);
+	ret = StaticDef::set_subj_public_key(cert_static, public_key);
+	if (ret == ATCA_SUCCESS)
+		ret = StaticDef::set_issue_date(cert_static, issue_date);
+	if (ret == ATCA_SUCCESS)
+		ret = StaticDef::get_tbs_digest(cert_static, digest_static);
+
+	memcpy(cert_c, cert_def->cert_template, cert_def->cert_template_size);
+	if (ret == ATCA_SUCCESS)
+		ret = atcacert_set_subj_public_key(cert_def, cert_c, sizeof(cert_c), public_key);
+	if (ret == ATCA_SUCCESS)
+		ret = atcacert_set_issue_date(cert_def, cert_c, sizeof(cert_c), &issue_date);
+	if (ret == ATCA_SUCCESS)
+		ret = atcacert_get_tbs_digest(cert_def, cert_c, sizeof(cert_c), digest_c);
+
+	if (ret != ATCA_SUCCESS)
+	{
+		printf("%s: build failed (0x%02X)\n", name, ret);
+		return 1;
+	}
+	if (memcmp(cert_static, cert_c, sizeof(cert_c)) != 0 || memcmp(digest_static, digest_c, sizeof(digest_c)) != 0)
+	{
+		printf("%s: the static and C builds differ\n", name);
+		return 1;
+	}
+	return 0;
+}
+
+int main(void)
+{
+	int failed = 0;
+
+	if (!signer_def::matches(&g_cert_def_1_signer))
+	{
+		printf("signer: k_cert_def_1_signer doesn't match g_cert_def_1_signer\n");
+		failed = 1;
+	}
+	if (!device_def::matches(&g_cert_def_2_device))
+	{
+		printf("device: k_cert_def_2_device doesn't match g_cert_def_2_device\n");
+		failed = 1;
+	}
+	if (signer_def::matches(&g_cert_def_2_device) || device_def::matches(&g_cert_def_1_signer))
+	{
+		printf("matches() accepts the other definition\n");
+		failed = 1;
+	}
+	if (!failed)
+	{
+		failed |= check_build<signer_def>("signer", &g_cert_def_1_signer);
+		failed |= check_build<device_def>("device", &g_cert_def_2_device);
+	}
+
+	printf("%s\n", failed ? "FAIL" : "ok");
+	return failed;
+}
@@ -0,0 +1,169 @@
+/**
+ * \file
+ * \brief Host benchmark of the eGuard (eg*) entry points against the simulated device.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Runs eg_bench_run() against hal/hal_sim.c and prints one CSV record per entry point:
+ *
+ *   gcc -std=gnu99 -O2 -DATCA_HAL_SIM -I../../src -I../../src/hal -o eg_bench eg_bench.c \
+ *       $(find ../../src -name '*.c' ! -name custom_hal.c)
+ *   ./eg_bench [-n iterations] [-r] [-s] > baseline.csv
+ *
+ * Wall time is host CPU time plus the simulated device time (command execution, wake and bus
+ * transfer at 400 kHz), which approximates the latency on hardware. -r makes the delays sleep
+ * for real and measures the host clock only. -s appends the interface counters from
+ * atdumpifacestats(); add -DATCA_IFACE_INSTRUMENT to break them down per command.
+ *
+ * The simulated device has keys but no certificates, so the chain cases (SW_PKI_CHAIN,
+ * HW_PKI_CHAIN, egAuthResponse, egSecureBoot) and egVerifyTag report their failure status
+ * unless matching material is loaded with hal_sim_load_slot(). They are still timed up to
+ * the point of failure. examples/eGuardBenchmark runs the same cases on the board.
+ */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "astekcrypto.h"
+#include "benchmark/eg_bench.h"
+#include "hal/hal_sim.h"
+#include "crypto/atca_crypto_sw_sha2.h"
+#include "custom/custom_auth_def.h"
+
+static int realtime = 0;
+static int dump_stats = 0;
+
+static uint32_t bench_clock(void)
+{
+	struct timespec now;
+	uint64_t us;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	us = (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+	if (!realtime)
+	{
+		us += hal_sim_time_us();
+	}
+	return (uint32_t)us;
+}
+
+static void bench_report(const eg_bench_result_t* result, void* context)
+{
+	char line[EG_BENCH_LINE_SIZE];
+
+	eg_bench_format(result, line, sizeof(line));
+	fprintf((FILE*)context, "%s\n", line);
+}
+
+static void bench_dump(const char* line, void* context)
+{
+	fprintf((FILE*)context, "%s\n", line);
+}
+
+int main(int argc, char* argv[])
+{
+	ATCAIfaceCfg* cfg = &cfg_ateccx08a_sim_default;
+	uint8_t symmetric_key[ATCA_KEY_SIZE];
+	char line[EG_BENCH_LINE_SIZE];
+	long iterations = 10;
+	ATCA_STATUS status;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+		{
+			iterations = strtol(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-r") == 0)
+		{
+			realtime = 1;
+		}
+		else if (strcmp(argv[i], "-s") == 0)
+		{
+			dump_stats = 1;
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [-n iterations] [-r] [-s]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (iterations < 1 || iterations > UINT16_MAX)
+	{
+		fprintf(stderr, "iterations must be 1 to %u\n", UINT16_MAX);
+		return 2;
+	}
+	hal_sim_set_realtime(realtime != 0);
+
+	status = egSelectDevice(cfg);
+	if (status != ATCA_SUCCESS)
+	{
+		fprintf(stderr, "egSelectDevice failed: %02X\n", status);
+		return 1;
+	}
+
+	// The symmetric slot holds the derived key the firmware authenticates against
+	atcac_sw_sha2_256(g_symmetric_key, g_symmetric_key_size, symmetric_key);
+	hal_sim_load_slot(cfg->atcasim.instance, SYMMETRIC_KEY_ID, symmetric_key, sizeof(symmetric_key));
+
+	eg_bench_format_header(line, sizeof(line));
+	printf("%s\n", line);
+
+	status = eg_bench_run((uint16_t)iterations, bench_clock, bench_report, stdout);
+	if (status != ATCA_SUCCESS)
+	{
+		fprintf(stderr, "eg_bench_run failed: %02X\n", status);
+		return 1;
+	}
+
+	// Interface counters, per command when built with ATCA_IFACE_INSTRUMENT
+	if (dump_stats)
+	{
+		printf("\n");
+		atdumpifacestats(atGetIFace(atcab_getDevice()), bench_dump, stdout);
+	}
+
+	atcab_release();
+	return 0;
+}
@@ -0,0 +1,287 @@
+/**
+ * \file
+ * \brief Host-side check of the certificate chain walker against the simulator.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Issues chains of 1 to 5 certificates on hal/hal_sim.c, each signed by the key of the one before
+ * it, and walks them with atcacert_chain_verify() through every verifier:
+ *
+ *   gcc -std=gnu99 -O2 -DATCA_HAL_SIM -I../../src -I../../src/hal -o eg_chain_check \
+ *       eg_chain_check.c $(find ../../src -name '*.c' ! -name custom_hal.c) -lpthread
+ *   ./eg_chain_check
+ *
+ * The software verifiers walk on threads where ATCACERT_CHAIN_THREADS allows it, the device
+ * verifier and mixed chains walk in turn. Build it again with -DATCACERT_CHAIN_THREADS=0 for the
+ * single-threaded walker. Every chain is also checked with a bad signature at each depth.
+ *
+ * Prints one line per case and exits non-zero if any fails.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "astekcrypto.h"
+#include "basic/atca_basic.h"
+#include "atcacert/atcacert_chain.h"
+#include "atcacert/atcacert_issue.h"
+#include "crypto/atca_crypto_sw_ecdsa.h"
+#include "custom/cert_def_1_signer.h"
+#include "custom/cert_def_2_device.h"
+
+#define MAX_DEPTH   (5)     // Longer than ATCACERT_CHAIN_MAX_LINKS, so the walk takes two rounds
+#define CERT_STRIDE (600)
+#define KEY_SLOTS   (3)
+
+static const uint8_t key_slots[KEY_SLOTS] = { 0, 2, 3 };    // Slots of the simulator holding P256 private keys
+
+static int failures = 0;
+
+static uint8_t slot_public_keys[KEY_SLOTS][64];
+static ecc_fixed_base_t slot_tables[KEY_SLOTS];
+static uint8_t certs[MAX_DEPTH][CERT_STRIDE];
+static size_t cert_sizes[MAX_DEPTH];
+static atcacert_chain_link_t links[MAX_DEPTH];
+static atcacert_chain_scratch_t scratch;
+
+static void report(const char* name, int ok)
+{
+	printf("%-32s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+/** \brief Signs on the simulated device with the slot the context points at. */
+static int sign_slot(const uint8_t tbs_digest[32], uint8_t signature[64], const void* context)
+{
+	return atcab_sign(*(const uint8_t*)context, tbs_digest, signature);
+}
+
+static const atcacert_issue_signer_t signer_slot = { sign_slot, false };
+
+/** \brief Key of link i: link i is signed by key i and holds key i + 1, key 0 is the root. */
+static size_t link_key(size_t i)
+{
+	return i % KEY_SLOTS;
+}
+
+/**
+ * \brief Issue certificates 0 to MAX_DEPTH - 1, the last one from the device definition.
+ */
+static int issue_chain(void)
+{
+	static const atcacert_tm_utc_t issue_date = { 0, 0, 12, 1, 2, 2025 - 1900 };
+	atcacert_issue_batch_t batch;
+	uint8_t tbs_digest[32];
+	size_t i;
+
+	for (i = 0; i < MAX_DEPTH; i++)
+	{
+		memset(&batch, 0, sizeof(batch));
+		batch.cert_def = (i == MAX_DEPTH - 1) ? &g_cert_def_2_device : &g_cert_def_1_signer;
+		batch.issue_date = &issue_date;
+		batch.auth_public_key = slot_public_keys[link_key(i)];
+		batch.count = 1;
+		batch.public_keys = (const uint8_t (*)[64])slot_public_keys[link_key(i + 1)];
+		if (atcacert_issue_certs(&batch, &signer_slot, &key_slots[link_key(i)], certs[i], sizeof(certs[i]),
+		                         &cert_sizes[i], (uint8_t (*)[32])tbs_digest) != ATCA_SUCCESS)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * \brief Point the links at the last depth certificates. The fixed-base verifier is named by each
+ *        link with the table of its issuer, the others are left to the walk's default.
+ */
+static void set_links(size_t depth, const atcacert_chain_verifier_t* verifier)
+{
+	size_t i;
+
+	for (i = 0; i < depth; i++)
+	{
+		memset(&links[i], 0, sizeof(links[i]));
+		links[i].cert_def = (i == depth - 1) ? &g_cert_def_2_device : &g_cert_def_1_signer;
+		links[i].cert = certs[MAX_DEPTH - depth + i];
+		links[i].cert_size = cert_sizes[MAX_DEPTH - depth + i];
+		if (verifier == &atcacert_chain_verifier_fixed_sw)
+		{
+			links[i].verifier = verifier;
+			links[i].verifier_context = &slot_tables[link_key(MAX_DEPTH - depth + i)];
+		}
+	}
+	// A leaf only chain still needs the device definition
+	if (depth == 1)
+	{
+		links[0].cert = certs[MAX_DEPTH - 1];
+		links[0].cert_size = cert_sizes[MAX_DEPTH - 1];
+	}
+}
+
+/** \brief Flip a bit of the signature of a certificate, or flip it back. */
+static int flip_signature(const atcacert_def_t* cert_def, uint8_t* cert, size_t* cert_size)
+{
+	uint8_t signature[64];
+
+	if (atcacert_get_signature(cert_def, cert, *cert_size, signature) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+	signature[63] ^= 0x01;
+	return atcacert_set_signature(cert_def, cert, cert_size, CERT_STRIDE, signature) == ATCA_SUCCESS;
+}
+
+/**
+ * \brief Walk every chain length, good and with a bad signature at each depth.
+ */
+static int check_chains(const atcacert_chain_verifier_t* verifier, int own_scratch)
+{
+	const uint8_t* leaf_public_key = NULL;
+	size_t depth;
+	size_t bad;
+	size_t cert;
+	int ret;
+
+	for (depth = 1; depth <= MAX_DEPTH; depth++)
+	{
+		const uint8_t* root = slot_public_keys[link_key(MAX_DEPTH - depth)];
+
+		set_links(depth, verifier);
+		if (atcacert_chain_verify(links, depth, root, verifier, own_scratch ? &scratch : NULL, &leaf_public_key) != ATCA_SUCCESS
+		    || leaf_public_key == NULL
+		    || memcmp(leaf_public_key, slot_public_keys[link_key(MAX_DEPTH)], 64) != 0)
+		{
+			return 0;
+		}
+
+		// The wrong root fails the first link
+		if (atcacert_chain_verify(links, depth, slot_public_keys[link_key(MAX_DEPTH - depth + 1)], verifier,
+		                          own_scratch ? &scratch : NULL, NULL) == ATCA_SUCCESS)
+		{
+			return 0;
+		}
+
+		for (bad = 0; bad < depth; bad++)
+		{
+			cert = MAX_DEPTH - depth + bad;
+			if (!flip_signature(links[bad].cert_def, certs[cert], &cert_sizes[cert]))
+			{
+				return 0;
+			}
+			links[bad].cert_size = cert_sizes[cert];
+			ret = atcacert_chain_verify(links, depth, root, verifier, own_scratch ? &scratch : NULL, NULL);
+			if (!flip_signature(links[bad].cert_def, certs[cert], &cert_sizes[cert]))
+			{
+				return 0;
+			}
+			links[bad].cert_size = cert_sizes[cert];
+			if (ret == ATCA_SUCCESS)
+			{
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+/**
+ * \brief A chain whose links use different verifiers, and the walk's default verifier.
+ */
+static int check_mixed(void)
+{
+	const atcacert_chain_verifier_t* verifiers[] = {
+		&atcacert_chain_verifier_fixed_sw, &atcacert_chain_verifier_hw, &atcacert_chain_verifier_sw
+	};
+	const uint8_t* root = slot_public_keys[link_key(0)];
+	size_t i;
+
+	set_links(MAX_DEPTH, NULL);
+	if (atcacert_chain_verify(links, MAX_DEPTH, root, &atcacert_chain_verifier_hw, NULL, NULL) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+	for (i = 0; i < MAX_DEPTH; i++)
+	{
+		links[i].verifier = verifiers[i % 3];
+		links[i].verifier_context = &slot_tables[link_key(i)];
+	}
+	return atcacert_chain_verify(links, MAX_DEPTH, root, &atcacert_chain_verifier_sw, NULL, NULL) == ATCA_SUCCESS;
+}
+
+/**
+ * \brief The fixed-base verifier refuses a table built for another key than the link's issuer.
+ */
+static int check_wrong_table(void)
+{
+	set_links(2, &atcacert_chain_verifier_fixed_sw);
+	links[1].verifier_context = &slot_tables[link_key(MAX_DEPTH)];
+	return atcacert_chain_verify(links, 2, slot_public_keys[link_key(MAX_DEPTH - 2)], &atcacert_chain_verifier_sw, NULL, NULL) == ATCACERT_E_VERIFY_FAILED;
+}
+
+int main(void)
+{
+	size_t i;
+
+	if (egSelectDevice(&cfg_ateccx08a_sim_default) != ATCA_SUCCESS)
+	{
+		fprintf(stderr, "eg_chain_check: can't start the simulated device\n");
+		return 1;
+	}
+	for (i = 0; i < KEY_SLOTS; i++)
+	{
+		if (atcab_get_pubkey(key_slots[i], slot_public_keys[i]) != ATCA_SUCCESS
+		    || !ecc_fixed_base_precompute(slot_public_keys[i], &slot_tables[i]))
+		{
+			fprintf(stderr, "eg_chain_check: can't read the key in slot %u\n", key_slots[i]);
+			return 1;
+		}
+	}
+
+	report("issue chain", issue_chain());
+	report("sw verifier", check_chains(&atcacert_chain_verifier_sw, 0));
+	report("sw verifier, own scratch", check_chains(&atcacert_chain_verifier_sw, 1));
+	report("fixed_sw verifier", check_chains(&atcacert_chain_verifier_fixed_sw, 1));
+	report("hw verifier", check_chains(&atcacert_chain_verifier_hw, 1));
+	report("mixed verifiers", check_mixed());
+	report("fixed_sw wrong table", check_wrong_table());
+
+	return failures != 0;
+}
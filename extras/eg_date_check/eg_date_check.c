@@ -0,0 +1,584 @@
+/**
+ * \file
+ * \brief Host-side round-trip check and benchmark of the atcacert_date codecs.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Encodes and decodes every day in the range of each format through atcacert/atcacert_date.c
+ * and compares the results with snprintf() for the text formats and with timegm() and
+ * gmtime_r() for the POSIX formats:
+ *
+ *   gcc -std=gnu99 -O2 -I../../src -o eg_date_check eg_date_check.c \
+ *       ../../src/atcacert/atcacert_date.c
+ *   ./eg_date_check [-b iterations]
+ *
+ * Prints one line per case and exits non-zero if any fails. -b then times an encode and a
+ * decode per iteration for each format and prints one CSV record per format.
+ */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "atcacert/atcacert_date.h"
+
+#define POSIX_STEP  (7919)
+#define BENCH_DATES (1024)
+
+typedef struct
+{
+	atcacert_date_format_t format;
+	const char*            name;
+	int                    min_year;
+	int                    max_year;
+} date_format_info_t;
+
+static const date_format_info_t formats[] = {
+	{ DATEFMT_ISO8601_SEP,     "ISO8601_SEP",     0,    9999 },
+	{ DATEFMT_RFC5280_UTC,     "RFC5280_UTC",     1950, 2049 },
+	{ DATEFMT_POSIX_UINT32_BE, "POSIX_UINT32_BE", 1970, 2106 },
+	{ DATEFMT_POSIX_UINT32_LE, "POSIX_UINT32_LE", 1970, 2106 },
+	{ DATEFMT_RFC5280_GEN,     "RFC5280_GEN",     0,    9999 },
+};
+
+static int failures = 0;
+
+static void report(const char* name, int ok)
+{
+	printf("%-32s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static int is_posix(atcacert_date_format_t format)
+{
+	return format == DATEFMT_POSIX_UINT32_BE || format == DATEFMT_POSIX_UINT32_LE;
+}
+
+static int same_date(const atcacert_tm_utc_t* a, const atcacert_tm_utc_t* b)
+{
+	return a->tm_year == b->tm_year && a->tm_mon == b->tm_mon && a->tm_mday == b->tm_mday
+	       && a->tm_hour == b->tm_hour && a->tm_min == b->tm_min && a->tm_sec == b->tm_sec;
+}
+
+static int same_libc_date(const atcacert_tm_utc_t* a, const struct tm* b)
+{
+	return a->tm_year == b->tm_year && a->tm_mon == b->tm_mon && a->tm_mday == b->tm_mday
+	       && a->tm_hour == b->tm_hour && a->tm_min == b->tm_min && a->tm_sec == b->tm_sec;
+}
+
+static int days_in_month(int year, int mon)
+{
+	static const int days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+	if (mon == 1 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0))
+	{
+		return 29;
+	}
+	return days[mon];
+}
+
+static uint32_t posix_value(atcacert_date_format_t format, const uint8_t* formatted_date)
+{
+	if (format == DATEFMT_POSIX_UINT32_BE)
+	{
+		return ((uint32_t)formatted_date[0] << 24) | ((uint32_t)formatted_date[1] << 16)
+		       | ((uint32_t)formatted_date[2] << 8) | (uint32_t)formatted_date[3];
+	}
+	return ((uint32_t)formatted_date[3] << 24) | ((uint32_t)formatted_date[2] << 16)
+	       | ((uint32_t)formatted_date[1] << 8) | (uint32_t)formatted_date[0];
+}
+
+static void posix_bytes(atcacert_date_format_t format, uint32_t value, uint8_t* formatted_date)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		formatted_date[format == DATEFMT_POSIX_UINT32_BE ? 3 - i : i] = (uint8_t)(value >> (8 * i));
+	}
+}
+
+/** \brief Independent rendering of a text format, as the codec should produce it. */
+static size_t text_oracle(atcacert_date_format_t format, const atcacert_tm_utc_t* t, char* str)
+{
+	int year = t->tm_year + 1900;
+
+	switch (format)
+	{
+	case DATEFMT_ISO8601_SEP:
+		return (size_t)sprintf(str, "%04d-%02d-%02dT%02d:%02d:%02dZ", year, t->tm_mon + 1,
+		                       t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
+	case DATEFMT_RFC5280_UTC:
+		return (size_t)sprintf(str, "%02d%02d%02d%02d%02d%02dZ", year % 100, t->tm_mon + 1,
+		                       t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
+	default:
+		return (size_t)sprintf(str, "%04d%02d%02d%02d%02d%02dZ", year, t->tm_mon + 1,
+		                       t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
+	}
+}
+
+/**
+ * \brief Encode and decode every day of the format's range, days 29 to 31 of short months
+ *        included, with the time of day varying from one day to the next.
+ */
+static int check_every_day(const date_format_info_t* info)
+{
+	uint8_t formatted_date[DATEFMT_MAX_SIZE];
+	char expected[DATEFMT_MAX_SIZE + 1];
+	size_t size;
+	atcacert_tm_utc_t t;
+	atcacert_tm_utc_t decoded;
+	struct tm libc_tm;
+	time_t posix_time;
+	uint32_t n = 0;
+	int year;
+	int mon;
+	int mday;
+
+	for (year = info->min_year; year <= info->max_year; year++)
+	{
+		for (mon = 0; mon < 12; mon++)
+		{
+			for (mday = 1; mday <= 31; mday++, n++)
+			{
+				memset(&t, 0, sizeof(t));
+				t.tm_year = year - 1900;
+				t.tm_mon = mon;
+				t.tm_mday = mday;
+				t.tm_hour = (int)(n % 24);
+				t.tm_min = (int)((n * 7) % 60);
+				t.tm_sec = (int)((n * 13) % 60);
+				if (is_posix(info->format) && year == 2106 && (mon > 1 || (mon == 1 && mday >= 7)))
+				{
+					break; // Past the last whole POSIX day, covered by check_limits()
+				}
+
+				size = sizeof(formatted_date);
+				if (atcacert_date_enc(info->format, &t, formatted_date, &size) != ATCA_SUCCESS
+				    || size != ATCACERT_DATE_FORMAT_SIZES[info->format])
+				{
+					return 0;
+				}
+
+				if (is_posix(info->format))
+				{
+					// Days past the end of the month carry into the next, as timegm() does
+					memset(&libc_tm, 0, sizeof(libc_tm));
+					libc_tm.tm_year = t.tm_year;
+					libc_tm.tm_mon = t.tm_mon;
+					libc_tm.tm_mday = t.tm_mday;
+					libc_tm.tm_hour = t.tm_hour;
+					libc_tm.tm_min = t.tm_min;
+					libc_tm.tm_sec = t.tm_sec;
+					posix_time = timegm(&libc_tm);
+					if ((uint32_t)posix_time != posix_value(info->format, formatted_date)
+					    || atcacert_date_dec(info->format, formatted_date, size, &decoded) != ATCA_SUCCESS
+					    || !same_libc_date(&decoded, &libc_tm))
+					{
+						return 0;
+					}
+				}
+				else
+				{
+					if (text_oracle(info->format, &t, expected) != size
+					    || memcmp(formatted_date, expected, size) != 0
+					    || atcacert_date_dec(info->format, formatted_date, size, &decoded) != ATCA_SUCCESS)
+					{
+						return 0;
+					}
+				}
+
+				if (mday <= days_in_month(year, mon) && !same_date(&decoded, &t))
+				{
+					return 0;
+				}
+			}
+		}
+	}
+	return 1;
+}
+
+/**
+ * \brief Decode one POSIX time, compare with gmtime_r() and encode it back.
+ */
+static int check_posix_value(atcacert_date_format_t format, uint32_t value)
+{
+	uint8_t formatted_date[DATEFMT_POSIX_UINT32_BE_SIZE];
+	uint8_t encoded[DATEFMT_POSIX_UINT32_BE_SIZE];
+	size_t size = sizeof(encoded);
+	atcacert_tm_utc_t decoded;
+	struct tm libc_tm;
+	time_t posix_time = (time_t)value;
+
+	posix_bytes(format, value, formatted_date);
+	if (atcacert_date_dec(format, formatted_date, sizeof(formatted_date), &decoded) != ATCA_SUCCESS
+	    || gmtime_r(&posix_time, &libc_tm) == NULL
+	    || !same_libc_date(&decoded, &libc_tm))
+	{
+		return 0;
+	}
+
+	// The encoder stops one second short of UINT32_MAX, as it always has
+	if (value == UINT32_MAX)
+	{
+		return atcacert_date_enc(format, &decoded, encoded, &size) == ATCACERT_E_INVALID_DATE;
+	}
+	return atcacert_date_enc(format, &decoded, encoded, &size) == ATCA_SUCCESS
+	       && memcmp(encoded, formatted_date, sizeof(encoded)) == 0;
+}
+
+/**
+ * \brief Decode POSIX times across the whole 32-bit range and encode them back.
+ */
+static int check_posix_sweep(atcacert_date_format_t format)
+{
+	uint64_t value;
+
+	for (value = 0; value < UINT32_MAX; value += POSIX_STEP)
+	{
+		if (!check_posix_value(format, (uint32_t)value))
+		{
+			return 0;
+		}
+	}
+	return check_posix_value(format, UINT32_MAX - 1) && check_posix_value(format, UINT32_MAX);
+}
+
+static int enc_status(atcacert_date_format_t format, int year, int mon, int mday, int hour, int min, int sec)
+{
+	uint8_t formatted_date[DATEFMT_MAX_SIZE];
+	size_t size = sizeof(formatted_date);
+	atcacert_tm_utc_t t;
+
+	t.tm_year = year - 1900;
+	t.tm_mon = mon;
+	t.tm_mday = mday;
+	t.tm_hour = hour;
+	t.tm_min = min;
+	t.tm_sec = sec;
+	return atcacert_date_enc(format, &t, formatted_date, &size);
+}
+
+/**
+ * \brief Range checks on every field, the maximum date and the RFC 5280 two-digit year pivot.
+ */
+static int check_limits(const date_format_info_t* info)
+{
+	uint8_t formatted_date[DATEFMT_MAX_SIZE];
+	size_t size = sizeof(formatted_date);
+	atcacert_tm_utc_t max_date;
+	atcacert_tm_utc_t decoded;
+	int y = info->min_year;
+
+	if (enc_status(info->format, y - 1, 11, 31, 23, 59, 59) != ATCACERT_E_INVALID_DATE
+	    || enc_status(info->format, info->max_year + 1, 0, 1, 0, 0, 0) != ATCACERT_E_INVALID_DATE
+	    || enc_status(info->format, y, -1, 1, 0, 0, 0) != ATCACERT_E_INVALID_DATE
+	    || enc_status(info->format, y, 12, 1, 0, 0, 0) != ATCACERT_E_INVALID_DATE
+	    || enc_status(info->format, y, 0, 0, 0, 0, 0) != ATCACERT_E_INVALID_DATE
+	    || enc_status(info->format, y, 0, 32, 0, 0, 0) != ATCACERT_E_INVALID_DATE
+	    || enc_status(info->format, y, 0, 1, -1, 0, 0) != ATCACERT_E_INVALID_DATE
+	    || enc_status(info->format, y, 0, 1, 24, 0, 0) != ATCACERT_E_INVALID_DATE
+	    || enc_status(info->format, y, 0, 1, 0, 60, 0) != ATCACERT_E_INVALID_DATE
+	    || enc_status(info->format, y, 0, 1, 0, 0, 60) != ATCACERT_E_INVALID_DATE
+	    || enc_status(info->format, y, 0, 1, 0, 0, 0) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+
+	if (atcacert_date_get_max_date(info->format, &max_date) != ATCA_SUCCESS
+	    || max_date.tm_year != info->max_year - 1900)
+	{
+		return 0;
+	}
+	if (is_posix(info->format))
+	{
+		// UINT32_MAX decodes to the maximum date, the encoder accepts up to the second before
+		return enc_status(info->format, 2106, 1, 7, 6, 28, 14) == ATCA_SUCCESS
+		       && enc_status(info->format, 2106, 1, 7, 6, 28, 15) == ATCACERT_E_INVALID_DATE
+		       && enc_status(info->format, 2106, 1, 7, 6, 29, 0) == ATCACERT_E_INVALID_DATE
+		       && enc_status(info->format, 2106, 1, 8, 0, 0, 0) == ATCACERT_E_INVALID_DATE
+		       && enc_status(info->format, 2106, 2, 1, 0, 0, 0) == ATCACERT_E_INVALID_DATE;
+	}
+	if (atcacert_date_enc(info->format, &max_date, formatted_date, &size) != ATCA_SUCCESS
+	    || atcacert_date_dec(info->format, formatted_date, size, &decoded) != ATCA_SUCCESS
+	    || !same_date(&decoded, &max_date))
+	{
+		return 0;
+	}
+	if (info->format == DATEFMT_RFC5280_UTC)
+	{
+		for (y = 1950; y <= 2049; y++)
+		{
+			size = sizeof(formatted_date);
+			if (enc_status(info->format, y, 0, 1, 0, 0, 0) != ATCA_SUCCESS)
+			{
+				return 0;
+			}
+			sprintf((char*)formatted_date, "%02d0101000000Z", y % 100);
+			if (atcacert_date_dec(info->format, formatted_date, DATEFMT_RFC5280_UTC_SIZE, &decoded) != ATCA_SUCCESS
+			    || decoded.tm_year != y - 1900)
+			{
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+/**
+ * \brief Replace each character of a valid text date in turn and expect a decoding error.
+ */
+static int check_malformed(const date_format_info_t* info)
+{
+	static const char bad[] = { '/', ':', 'x', ' ', '\0', (char)0xB0 };
+	atcacert_tm_utc_t t = { 56, 34, 12, 28, 1, 2024 - 1900 };
+	atcacert_tm_utc_t decoded;
+	char formatted_date[DATEFMT_MAX_SIZE + 1];
+	size_t size;
+	size_t pos;
+	size_t i;
+
+	if (is_posix(info->format))
+	{
+		return 1; // Every 32-bit value is a valid POSIX time
+	}
+	size = text_oracle(info->format, &t, formatted_date);
+	for (pos = 0; pos < size; pos++)
+	{
+		for (i = 0; i < sizeof(bad); i++)
+		{
+			char saved = formatted_date[pos];
+
+			formatted_date[pos] = bad[i];
+			if (bad[i] != saved
+			    && atcacert_date_dec(info->format, (uint8_t*)formatted_date, size, &decoded) != ATCACERT_E_DECODING_ERROR)
+			{
+				return 0;
+			}
+			formatted_date[pos] = saved;
+		}
+	}
+	return atcacert_date_dec(info->format, (uint8_t*)formatted_date, size - 1, &decoded) == ATCACERT_E_DECODING_ERROR;
+}
+
+/**
+ * \brief Every issue date and expire count of the compressed certificate format.
+ */
+static int check_compcert(void)
+{
+	uint8_t enc_dates[3];
+	atcacert_tm_utc_t t;
+	atcacert_tm_utc_t issue_date;
+	atcacert_tm_utc_t expire_date;
+	atcacert_tm_utc_t max_date;
+	int year;
+	int mon;
+	int mday;
+	int hour;
+	int years;
+
+	atcacert_date_get_max_date(DATEFMT_RFC5280_GEN, &max_date);
+	memset(&t, 0, sizeof(t));
+	for (year = 2000; year <= 2031; year++)
+	{
+		for (mon = 0; mon < 12; mon++)
+		{
+			for (mday = 1; mday <= 31; mday++)
+			{
+				for (hour = 0; hour < 24; hour++)
+				{
+					for (years = 0; years <= 31; years++)
+					{
+						t.tm_year = year - 1900;
+						t.tm_mon = mon;
+						t.tm_mday = mday;
+						t.tm_hour = hour;
+						t.tm_min = years;   // Minutes and seconds are dropped
+						t.tm_sec = hour;
+						if (atcacert_date_enc_compcert(&t, (uint8_t)years, enc_dates) != ATCA_SUCCESS
+						    || atcacert_date_dec_compcert(enc_dates, DATEFMT_RFC5280_GEN, &issue_date, &expire_date) != ATCA_SUCCESS)
+						{
+							return 0;
+						}
+						t.tm_min = 0;
+						t.tm_sec = 0;
+						if (!same_date(&issue_date, &t))
+						{
+							return 0;
+						}
+						t.tm_year += years;
+						if (!same_date(&expire_date, years == 0 ? &max_date : &t))
+						{
+							return 0;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	t.tm_year = 2032 - 1900;
+	if (atcacert_date_enc_compcert(&t, 0, enc_dates) != ATCACERT_E_INVALID_DATE)
+	{
+		return 0;
+	}
+	t.tm_year = 1999 - 1900;
+	if (atcacert_date_enc_compcert(&t, 0, enc_dates) != ATCACERT_E_INVALID_DATE)
+	{
+		return 0;
+	}
+	t.tm_year = 2020 - 1900;
+	return atcacert_date_enc_compcert(&t, 32, enc_dates) == ATCACERT_E_INVALID_DATE;
+}
+
+static uint64_t bench_clock_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * \brief Time a run of encodes, then a run of decodes of the results, over a table of dates
+ *        spread across the range of the format.
+ */
+static void bench_format(const date_format_info_t* info, long iterations)
+{
+	static atcacert_tm_utc_t dates[BENCH_DATES];
+	static uint8_t formatted_dates[BENCH_DATES][DATEFMT_MAX_SIZE];
+	size_t size = ATCACERT_DATE_FORMAT_SIZES[info->format];
+	atcacert_tm_utc_t decoded;
+	uint64_t enc_ns;
+	uint64_t dec_ns;
+	uint64_t start;
+	uint32_t check = 0;
+	size_t sz;
+	long i;
+
+	for (i = 0; i < BENCH_DATES; i++)
+	{
+		dates[i].tm_year = info->min_year + (int)(i * 37 % (info->max_year - info->min_year)) - 1900;
+		dates[i].tm_mon = (int)(i % 12);
+		dates[i].tm_mday = 1 + (int)(i % 28);
+		dates[i].tm_hour = (int)(i % 24);
+		dates[i].tm_min = (int)(i % 60);
+		dates[i].tm_sec = (int)((i * 7) % 60);
+	}
+
+	start = bench_clock_ns();
+	for (i = 0; i < iterations; i++)
+	{
+		sz = sizeof(formatted_dates[0]);
+		check += (uint32_t)atcacert_date_enc(info->format, &dates[i % BENCH_DATES], formatted_dates[i % BENCH_DATES], &sz);
+	}
+	enc_ns = bench_clock_ns() - start;
+
+	start = bench_clock_ns();
+	for (i = 0; i < iterations; i++)
+	{
+		atcacert_date_dec(info->format, formatted_dates[i % BENCH_DATES], size, &decoded);
+		check += (uint32_t)decoded.tm_sec;
+	}
+	dec_ns = bench_clock_ns() - start;
+
+	printf("%s,%ld,%.1f,%.1f,%u\n", info->name, iterations, (double)enc_ns / iterations,
+	       (double)dec_ns / iterations, check);
+}
+
+int main(int argc, char* argv[])
+{
+	char name[40];
+	long iterations = 0;
+	size_t i;
+
+	for (i = 1; i < (size_t)argc; i++)
+	{
+		if (strcmp(argv[i], "-b") == 0 && i + 1 < (size_t)argc)
+		{
+			iterations = strtol(argv[++i], NULL, 0);
+			if (iterations < 1)
+			{
+				fprintf(stderr, "iterations must be positive\n");
+				return 2;
+			}
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [-b iterations]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	for (i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+	{
+		snprintf(name, sizeof(name), "%s every day", formats[i].name);
+		report(name, check_every_day(&formats[i]));
+		snprintf(name, sizeof(name), "%s limits", formats[i].name);
+		report(name, check_limits(&formats[i]));
+		if (is_posix(formats[i].format))
+		{
+			snprintf(name, sizeof(name), "%s sweep", formats[i].name);
+			report(name, check_posix_sweep(formats[i].format));
+		}
+		else
+		{
+			snprintf(name, sizeof(name), "%s malformed", formats[i].name);
+			report(name, check_malformed(&formats[i]));
+		}
+	}
+	report("compcert every date", check_compcert());
+
+	if (iterations > 0)
+	{
+		printf("format,iterations,enc_ns,dec_ns,check\n");
+		for (i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+		{
+			bench_format(&formats[i], iterations);
+		}
+	}
+
+	return failures != 0;
+}
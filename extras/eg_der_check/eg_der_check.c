@@ -0,0 +1,893 @@
+/**
+ * \file
+ * \brief Host-side cross-check of the atcacert_der integer and signature codecs.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Runs random and mutated inputs through the DER length, integer and ECDSA signature codecs
+ * in atcacert/atcacert_der.c and compares every return code, reported size and output byte
+ * with the codecs they replaced, which are kept verbatim in this file:
+ *
+ *   gcc -std=gnu99 -O2 -I../../src -o eg_der_check eg_der_check.c \
+ *       ../../src/atcacert/atcacert_der.c
+ *   ./eg_der_check [-n iterations]
+ *
+ * -n sets the inputs per codec (default 500000, 3M over the six codecs). The one allowed
+ * difference: a signature holding an integer longer than 33 bytes now fails with
+ * ATCACERT_E_DECODING_ERROR where the old decoder returned ATCACERT_E_BUFFER_TOO_SMALL from its
+ * 33-byte temporary. Both reject the signature.
+ *
+ * Prints one line per case and exits non-zero if any fails.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "atcacert/atcacert_der.h"
+
+#define DEFAULT_ITERATIONS (500000)
+#define MAX_INT_SIZE       (40)
+#define MAX_DER_SIZE       (128)
+#define FILL               (0xA5)
+
+static int failures = 0;
+static uint32_t rng_state = 0x2545F491;
+
+static void report(const char* name, int ok)
+{
+	printf("%-32s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static uint32_t rng_next(void)
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+static uint32_t rng_below(uint32_t n)
+{
+	return rng_next() % n;
+}
+
+static void rng_fill(uint8_t* buf, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++)
+	{
+		buf[i] = (uint8_t)rng_next();
+	}
+}
+
+/*
+ * The codecs as they were before the span reader, kept verbatim apart from the names.
+ */
+
+static int ref_der_enc_length(uint32_t length, uint8_t* der_length, size_t* der_length_size)
+{
+	size_t der_length_size_calc = 0;
+	int exp = sizeof(length) - 1;
+
+	if (der_length_size == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (length < 0x80) {
+		// The length can take the short form with only one byte
+		der_length_size_calc = 1;
+		exp = 0;
+	}else {
+		// Length is long-form, encoded as a multi-byte big-endian unsigned integer
+
+		// Find first non-zero octet
+		while (length / ((uint32_t)1 << (8 * exp)) == 0)
+			exp--;
+
+		der_length_size_calc = 2 + exp;
+	}
+
+	if (der_length != NULL && *der_length_size < der_length_size_calc) {
+		*der_length_size = der_length_size_calc;
+		return ATCACERT_E_BUFFER_TOO_SMALL;
+	}
+
+	*der_length_size = der_length_size_calc;
+
+	if (der_length == NULL)
+		return ATCA_SUCCESS; // Caller is only requesting the size
+
+	// Encode length in big-endian format
+	for (; exp >= 0; exp--)
+		der_length[der_length_size_calc - 1 - exp] = (uint8_t)((length >> (exp * 8)) & 0xFF);
+
+	if (der_length_size_calc > 1)
+		der_length[0] = 0x80 | (uint8_t)(der_length_size_calc - 1); // Set number of bytes octet with long-form flag
+
+	return ATCA_SUCCESS;
+}
+
+static int ref_der_dec_length(const uint8_t* der_length, size_t* der_length_size, uint32_t* length)
+{
+	if (der_length == NULL || der_length_size == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (*der_length_size < 1)
+		return ATCACERT_E_DECODING_ERROR;
+
+	if (der_length[0] & 0x80) {
+		// Long form
+		size_t num_bytes = der_length[0] & 0x7F;
+		size_t i;
+		if (*der_length_size < num_bytes + 1)
+			return ATCACERT_E_DECODING_ERROR;   //  Invalid DER length format, not enough data.
+		if (num_bytes == 0)
+			return ATCACERT_E_DECODING_ERROR;   //  Invalid DER length format, indefinite length not supported.
+		if (num_bytes > sizeof(*length))
+			return ATCACERT_E_DECODING_ERROR;   //  Can't parse DER length format, larger than length.
+
+		if (length != NULL) {
+			// Decode integer in big-endian format
+			*length = 0;
+			for (i = 1; i <= num_bytes; i++)
+				*length += der_length[i] * ((uint32_t)1 << (8 * (num_bytes - i)));
+		}
+		*der_length_size = num_bytes + 1; // Return the actual number of bytes the DER length encoding used.
+	}else {
+		if (length != NULL)
+			*length = der_length[0];
+		*der_length_size = 1; // Return the actual number of bytes the DER length encoding used.
+	}
+
+	return ATCA_SUCCESS;
+}
+
+static int ref_der_enc_integer( const uint8_t* int_data,
+                              size_t int_data_size,
+                              uint8_t is_unsigned,
+                              uint8_t*       der_int,
+                              size_t*        der_int_size)
+{
+	uint8_t der_length[5];
+	size_t der_length_size = sizeof(der_length);
+	size_t der_int_size_calc = 0;
+	size_t trim = 0;
+	size_t pad = 0;
+
+	if (int_data == NULL || der_int_size == NULL || int_data_size <= 0)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (!(is_unsigned && (int_data[0] & 0x80))) {
+		// This is not an unsigned value that needs a padding byte, trim any unnecessary bytes.
+		// Trim a byte when the upper 9 bits are all 0s or all 1s.
+		while (
+		    (int_data_size - trim >= 2) && (
+		        ((int_data[trim] == 0x00) && ((int_data[trim + 1] & 0x80) == 0)) ||
+		        ((int_data[trim] == 0xFF) && ((int_data[trim + 1] & 0x80) != 0))))
+			trim++;
+	}else
+		// Will be adding extra byte for unsigned padding so it's not interpreted as negative
+		pad = 1;
+
+	int ret = ref_der_enc_length(int_data_size + pad - trim, der_length, &der_length_size);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	der_int_size_calc = 1 + der_length_size + int_data_size + pad - trim;
+
+	if (der_int != NULL && der_int_size_calc > *der_int_size) {
+		*der_int_size = der_int_size_calc;
+		return ATCACERT_E_BUFFER_TOO_SMALL;
+	}
+
+	*der_int_size = der_int_size_calc;
+
+	if (der_int == NULL)
+		return ATCA_SUCCESS;                                                      // Caller just wanted the size of the encoded integer
+
+	der_int[0] = 0x02;                                                                  // Integer tag
+	memcpy(&der_int[1], der_length, der_length_size);                                   // Integer length
+	if (pad)
+		der_int[der_length_size + 1] = 0;                                               // Unsigned integer value requires padding byte so it's not interpreted as negative
+	memcpy(&der_int[der_length_size + 1 + pad], &int_data[trim], int_data_size - trim); // Integer value
+
+	return ATCA_SUCCESS;
+}
+
+static int ref_der_dec_integer( const uint8_t* der_int,
+                              size_t*        der_int_size,
+                              uint8_t*       int_data,
+                              size_t*        int_data_size)
+{
+	int ret = 0;
+	size_t der_length_size = 0;
+	uint32_t int_data_size_calc = 0;
+
+	if (der_int == NULL || der_int_size == NULL || (int_data != NULL && int_data_size == NULL))
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (*der_int_size < 1)
+		return ATCACERT_E_DECODING_ERROR; // No data to decode
+
+	if (der_int[0] != 0x02)
+		return ATCACERT_E_DECODING_ERROR; // Not an integer tag
+
+	der_length_size = *der_int_size - 1;
+	ret = ref_der_dec_length(&der_int[1], &der_length_size, &int_data_size_calc);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	if (*der_int_size < (1 + der_length_size + int_data_size_calc))
+		return ATCACERT_E_DECODING_ERROR; // Invalid DER integer, not enough data.
+
+	*der_int_size = (1 + der_length_size + int_data_size_calc);
+
+	if (int_data == NULL && int_data_size == NULL)
+		return ATCA_SUCCESS; // Caller doesn't want the actual data, just the der_int_size
+
+	if (int_data != NULL && *int_data_size < int_data_size_calc) {
+		*int_data_size = int_data_size_calc;
+		return ATCACERT_E_BUFFER_TOO_SMALL;
+	}
+
+	*int_data_size = int_data_size_calc;
+
+	if (int_data == NULL)
+		return ATCA_SUCCESS; // Caller doesn't want the actual data, just the int_data_size
+
+	memcpy(int_data, &der_int[1 + der_length_size], int_data_size_calc);
+
+	return ATCA_SUCCESS;
+}
+
+static int ref_der_enc_ecdsa_sig_value( const uint8_t raw_sig[64],
+                                      uint8_t*      der_sig,
+                                      size_t*       der_sig_size)
+{
+	int ret = 0;
+	size_t r_size = 0;
+	size_t s_size = 0;
+	size_t der_sig_size_calc = 0;
+
+	if (raw_sig == NULL || der_sig_size == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	// Find size of the DER encoded R integer
+	ret = ref_der_enc_integer(&raw_sig[0], 32, TRUE, NULL, &r_size);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	// Find size of the DER encoded S integer
+	ret = ref_der_enc_integer(&raw_sig[32], 32, TRUE, NULL, &s_size);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	// This calculation assumes all DER lengths are a single byte, which is fine for 32 byte
+	// R and S integers.
+	der_sig_size_calc = 5 + r_size + s_size;
+
+	if (der_sig != NULL && *der_sig_size < der_sig_size_calc) {
+		*der_sig_size = der_sig_size_calc;
+		return ATCACERT_E_BUFFER_TOO_SMALL;
+	}
+
+	*der_sig_size = der_sig_size_calc;
+
+	if (der_sig == NULL)
+		return ATCA_SUCCESS;                  // Caller just wanted the encoded size
+
+	der_sig[0] = 0x03;                              // signatureValue bit string tag
+	der_sig[1] = (uint8_t)(der_sig_size_calc - 2);  // signatureValue bit string length
+	der_sig[2] = 0x00;                              // signatureValue bit string spare bits
+
+	// signatureValue bit string value is the DER encoding of ECDSA-Sig-Value
+	der_sig[3] = 0x30;                              // sequence tag
+	der_sig[4] = (uint8_t)(der_sig_size_calc - 5);  // sequence length
+
+	// Add R integer
+	ret = ref_der_enc_integer(&raw_sig[0], 32, TRUE, &der_sig[5], &r_size);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	// Add S integer
+	ret = ref_der_enc_integer(&raw_sig[32], 32, TRUE, &der_sig[5 + r_size], &s_size);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	return ATCA_SUCCESS;
+}
+
+static int ref_der_dec_ecdsa_sig_value( const uint8_t* der_sig,
+                                      size_t*        der_sig_size,
+                                      uint8_t raw_sig[64])
+{
+	int ret = 0;
+	size_t curr_idx = 0;
+	size_t dec_size = 0;
+	uint32_t bs_length = 0;
+	uint32_t seq_length = 0;
+	size_t r_size = 0;
+	size_t s_size = 0;
+	uint8_t int_data[33];
+	size_t int_data_size = 0;
+
+	if (der_sig == NULL || der_sig_size == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (*der_sig_size < 1)
+		return ATCACERT_E_DECODING_ERROR; // No data to decode
+
+	// signatureValue bit string tag
+	curr_idx = 0;
+	if (der_sig[curr_idx] != 0x03)
+		return ATCACERT_E_DECODING_ERROR; // Unexpected tag value
+	curr_idx++;
+
+	// signatureValue bit string length
+	dec_size = *der_sig_size - curr_idx;
+	ret = ref_der_dec_length(&der_sig[curr_idx], &dec_size, &bs_length);
+	if (ret != ATCA_SUCCESS)
+		return ret; // Failed to decode length
+	curr_idx += dec_size;
+	if (curr_idx + bs_length > *der_sig_size)
+		return ATCACERT_E_DECODING_ERROR; // Not enough data in buffer to decode the rest
+
+	// signatureValue bit string spare bits
+	if (curr_idx >= *der_sig_size)
+		return ATCACERT_E_DECODING_ERROR;   // No data left
+	if (der_sig[curr_idx] != 0x00)
+		return ATCACERT_E_DECODING_ERROR;   // Unexpected spare bits value
+	curr_idx++;
+
+	// signatureValue bit string value is the DER encoding of ECDSA-Sig-Value
+
+	// sequence tag
+	if (curr_idx >= *der_sig_size)
+		return ATCACERT_E_DECODING_ERROR;   // No data left
+	if (der_sig[curr_idx] != 0x30)
+		return ATCACERT_E_DECODING_ERROR;   // Unexpected tag value
+	curr_idx++;
+
+	// sequence length
+	if (curr_idx >= *der_sig_size)
+		return ATCACERT_E_DECODING_ERROR; // No data left
+	dec_size = *der_sig_size - curr_idx;
+	ret = ref_der_dec_length(&der_sig[curr_idx], &dec_size, &seq_length);
+	if (ret != ATCA_SUCCESS)
+		return ret; // Failed to decode length
+	curr_idx += dec_size;
+	if (curr_idx + seq_length > *der_sig_size)
+		return ATCACERT_E_DECODING_ERROR; // Not enough data in buffer to decode the rest
+
+	// R integer
+	if (curr_idx >= *der_sig_size)
+		return ATCACERT_E_DECODING_ERROR; // No data left
+	r_size = *der_sig_size - curr_idx;
+	int_data_size = sizeof(int_data);
+	ret = ref_der_dec_integer(&der_sig[curr_idx], &r_size, int_data, &int_data_size);
+	if (ret != ATCA_SUCCESS)
+		return ret; // Failed to decode length
+	curr_idx += r_size;
+
+	if (raw_sig != NULL)
+		memset(raw_sig, 0, 64); // Zero out the raw sig as the decoded integers may not touch all bytes
+
+	if (int_data_size <= 32) {
+		if (raw_sig != NULL)
+			memcpy(&raw_sig[32 - int_data_size], &int_data[0], int_data_size);
+	}else if (int_data_size == 33) {
+		if (int_data[0] != 0x00)
+			return ATCACERT_E_DECODING_ERROR; // R integer is too large
+		// DER integer was 0-padded to keep it positive
+		if (raw_sig != NULL)
+			memcpy(&raw_sig[0], &int_data[1], 32);
+	}else
+		return ATCACERT_E_DECODING_ERROR; // R integer is too large
+
+	// S integer
+	if (curr_idx >= *der_sig_size)
+		return ATCACERT_E_DECODING_ERROR; // No data left
+	s_size = *der_sig_size - curr_idx;
+	int_data_size = sizeof(int_data);
+	ret = ref_der_dec_integer(&der_sig[curr_idx], &s_size, int_data, &int_data_size);
+	if (ret != ATCA_SUCCESS)
+		return ret; // Failed to decode length
+	curr_idx += s_size;
+
+	if (int_data_size <= 32) {
+		if (raw_sig != NULL)
+			memcpy(&raw_sig[64 - int_data_size], &int_data[0], int_data_size);
+	}else if (int_data_size == 33) {
+		if (int_data[0] != 0x00)
+			return ATCACERT_E_DECODING_ERROR; // S integer is too large
+		// DER integer was 0-padded to keep it positive
+		if (raw_sig != NULL)
+			memcpy(&raw_sig[32], &int_data[1], 32);
+	}else
+		return ATCACERT_E_DECODING_ERROR; // S integer is too large
+
+	if (seq_length != r_size + s_size)
+		return ATCACERT_E_DECODING_ERROR; // Unexpected extra data in sequence
+
+	if (bs_length != r_size + s_size + 3)
+		return ATCACERT_E_DECODING_ERROR; // Unexpected extra data in bit string
+
+	*der_sig_size = curr_idx;
+
+	return ATCA_SUCCESS;
+}
+/*
+ * Input generators.
+ */
+
+static uint32_t gen_length(void)
+{
+	static const uint32_t edges[] = {
+		0x00, 0x01, 0x7F, 0x80, 0x81, 0xFF, 0x100, 0xFFFF, 0x10000, 0xFFFFFF, 0x1000000, 0xFFFFFFFF
+	};
+
+	switch (rng_below(4))
+	{
+	case 0:  return rng_below(300);
+	case 1:  return edges[rng_below(sizeof(edges) / sizeof(edges[0]))];
+	case 2:  return rng_next() >> rng_below(32);
+	default: return rng_next();
+	}
+}
+
+/**
+ * \brief Random big-endian integer of 1 to MAX_INT_SIZE bytes, often starting with a run of
+ *        0x00 or 0xFF bytes so the trimming and padding rules are exercised.
+ */
+static size_t gen_int(uint8_t* data)
+{
+	size_t size = 1 + rng_below(MAX_INT_SIZE);
+	size_t run = rng_below(2) ? rng_below((uint32_t)size + 1) : 0;
+	uint8_t lead = rng_below(2) ? 0x00 : 0xFF;
+
+	rng_fill(data, size);
+	memset(data, lead, run);
+
+	return size;
+}
+
+/**
+ * \brief Random 64-byte R and S, each often with leading zeros or the top bit set.
+ */
+static void gen_raw_sig(uint8_t raw_sig[64])
+{
+	size_t half;
+
+	rng_fill(raw_sig, 64);
+	for (half = 0; half < 64; half += 32)
+	{
+		switch (rng_below(4))
+		{
+		case 0:  memset(&raw_sig[half], 0, rng_below(33)); break;
+		case 1:  raw_sig[half] |= 0x80; break;
+		case 2:  raw_sig[half] &= 0x7F; break;
+		default: break;
+		}
+	}
+}
+
+/**
+ * \brief Leaves half the inputs alone and damages the rest: a flipped byte, a truncation,
+ *        trailing junk or a rewritten header byte.
+ */
+static void mutate(uint8_t* der, size_t* size, size_t capacity)
+{
+	size_t extra;
+
+	switch (rng_below(8))
+	{
+	case 4:
+		if (*size > 0)
+		{
+			der[rng_below((uint32_t)*size)] ^= (uint8_t)(1 + rng_below(255));
+		}
+		break;
+	case 5:
+		*size = rng_below((uint32_t)*size + 1);
+		break;
+	case 6:
+		extra = rng_below((uint32_t)(capacity - *size) + 1);
+		rng_fill(&der[*size], extra);
+		*size += extra;
+		break;
+	case 7:
+		if (*size > 0)
+		{
+			der[rng_below(*size < 8 ? (uint32_t)*size : 8)] = (uint8_t)rng_next();
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static size_t put_tl(uint8_t* der, uint8_t tag, size_t length)
+{
+	size_t size = MAX_DER_SIZE;
+
+	der[0] = tag;
+	ref_der_enc_length((uint32_t)length, &der[1], &size);
+
+	return 1 + size;
+}
+
+/**
+ * \brief Builds a signature bit string around two integers of 1 to MAX_INT_SIZE bytes with
+ *        consistent lengths, so integers too long for P256 reach the R and S checks.
+ */
+static size_t gen_der_sig(uint8_t* der)
+{
+	uint8_t ints[2 * (MAX_INT_SIZE + 3)];
+	uint8_t data[MAX_INT_SIZE];
+	size_t ints_size = 0;
+	size_t int_size;
+	size_t size;
+	int i;
+
+	for (i = 0; i < 2; i++)
+	{
+		int_size = sizeof(ints) - ints_size;
+		ref_der_enc_integer(data, gen_int(data), (uint8_t)rng_below(2), &ints[ints_size], &int_size);
+		ints_size += int_size;
+	}
+
+	size = put_tl(der, 0x03, 1 + 1 + atcacert_der_length_size((uint32_t)ints_size) + ints_size);
+	der[size++] = 0x00;
+	size += put_tl(&der[size], 0x30, ints_size);
+	memcpy(&der[size], ints, ints_size);
+
+	return size + ints_size;
+}
+
+/**
+ * \brief Output buffer sizes around the exact fit, plus 0 and anything up to MAX_DER_SIZE.
+ */
+static size_t gen_out_size(size_t exact)
+{
+	switch (rng_below(4))
+	{
+	case 0:  return exact > 0 ? exact - 1 : 0;
+	case 1:  return exact;
+	default: return rng_below(MAX_DER_SIZE + 1);
+	}
+}
+
+static void show(const char* name, const uint8_t* data, size_t size, int ref_ret, int ret)
+{
+	size_t i;
+
+	fprintf(stderr, "%s: old 0x%02X, new 0x%02X for", name, ref_ret, ret);
+	for (i = 0; i < size; i++)
+	{
+		fprintf(stderr, " %02X", data[i]);
+	}
+	fprintf(stderr, "\n");
+}
+
+/*
+ * Cross-checks, one per codec. Sizes are compared whenever either side can report one, the
+ * outputs only on success.
+ */
+
+static int check_enc_length(long iterations)
+{
+	uint8_t ref_out[8];
+	uint8_t out[8];
+	size_t ref_size;
+	size_t size;
+	uint32_t length;
+	int use_buf;
+	int ref_ret;
+	int ret;
+	long n;
+
+	if (atcacert_der_enc_length(0, out, NULL) != ref_der_enc_length(0, ref_out, NULL))
+	{
+		return 0;
+	}
+
+	for (n = 0; n < iterations; n++)
+	{
+		length = gen_length();
+		use_buf = rng_below(4) != 0;
+		ref_size = size = rng_below(7);
+		memset(ref_out, FILL, sizeof(ref_out));
+		memset(out, FILL, sizeof(out));
+
+		ref_ret = ref_der_enc_length(length, use_buf ? ref_out : NULL, &ref_size);
+		ret = atcacert_der_enc_length(length, use_buf ? out : NULL, &size);
+		if (ret != ref_ret || size != ref_size || memcmp(out, ref_out, sizeof(out)) != 0)
+		{
+			show("enc_length", (const uint8_t*)&length, sizeof(length), ref_ret, ret);
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int check_dec_length(long iterations)
+{
+	uint8_t der[16];
+	size_t der_size;
+	size_t ref_size;
+	size_t size;
+	uint32_t ref_length;
+	uint32_t length;
+	int use_length;
+	int ref_ret;
+	int ret;
+	long n;
+
+	if (atcacert_der_dec_length(NULL, &size, &length) != ref_der_dec_length(NULL, &size, &length))
+	{
+		return 0;
+	}
+
+	for (n = 0; n < iterations; n++)
+	{
+		if (rng_below(4) == 0)
+		{
+			der_size = rng_below(9);
+			rng_fill(der, der_size);
+		}
+		else
+		{
+			der_size = sizeof(der) - 8;
+			ref_der_enc_length(gen_length(), der, &der_size);
+			mutate(der, &der_size, sizeof(der));
+		}
+		use_length = rng_below(8) != 0;
+		ref_size = size = rng_below(4) == 0 ? rng_below((uint32_t)der_size + 1) : der_size;
+		ref_length = length = 0x5A5A5A5A;
+
+		ref_ret = ref_der_dec_length(der, &ref_size, use_length ? &ref_length : NULL);
+		ret = atcacert_der_dec_length(der, &size, use_length ? &length : NULL);
+		if (ret != ref_ret || (ret == ATCA_SUCCESS && (size != ref_size || length != ref_length)))
+		{
+			show("dec_length", der, der_size, ref_ret, ret);
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int check_enc_integer(long iterations)
+{
+	uint8_t data[MAX_INT_SIZE];
+	uint8_t ref_out[MAX_DER_SIZE];
+	uint8_t out[MAX_DER_SIZE];
+	size_t data_size;
+	size_t ref_size;
+	size_t size;
+	uint8_t is_unsigned;
+	int use_buf;
+	int ref_ret;
+	int ret;
+	long n;
+
+	for (n = 0; n < iterations; n++)
+	{
+		data_size = rng_below(64) == 0 ? 0 : gen_int(data);
+		is_unsigned = (uint8_t)rng_below(2);
+		use_buf = rng_below(4) != 0;
+		ref_size = 0;
+		ref_der_enc_integer(data, data_size > 0 ? data_size : 1, is_unsigned, NULL, &ref_size);
+		ref_size = size = gen_out_size(ref_size);
+		memset(ref_out, FILL, sizeof(ref_out));
+		memset(out, FILL, sizeof(out));
+
+		ref_ret = ref_der_enc_integer(data, data_size, is_unsigned, use_buf ? ref_out : NULL, &ref_size);
+		ret = atcacert_der_enc_integer(data, data_size, is_unsigned, use_buf ? out : NULL, &size);
+		if (ret != ref_ret || (ret != ATCACERT_E_BAD_PARAMS && size != ref_size)
+		    || memcmp(out, ref_out, sizeof(out)) != 0)
+		{
+			show("enc_integer", data, data_size, ref_ret, ret);
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int check_dec_integer(long iterations)
+{
+	uint8_t der[MAX_DER_SIZE];
+	uint8_t data[MAX_INT_SIZE];
+	uint8_t ref_out[MAX_INT_SIZE + 8];
+	uint8_t out[MAX_INT_SIZE + 8];
+	size_t der_size;
+	size_t ref_size;
+	size_t size;
+	size_t ref_int_size;
+	size_t int_size;
+	uint32_t mode;
+	int ref_ret;
+	int ret;
+	long n;
+
+	for (n = 0; n < iterations; n++)
+	{
+		der_size = MAX_DER_SIZE / 2;
+		ref_der_enc_integer(data, gen_int(data), (uint8_t)rng_below(2), der, &der_size);
+		mutate(der, &der_size, sizeof(der));
+		mode = rng_below(4); // 0: size only, 1: data size only, else data too
+		ref_size = size = der_size;
+		ref_int_size = int_size = rng_below(sizeof(out) + 1);
+		memset(ref_out, FILL, sizeof(ref_out));
+		memset(out, FILL, sizeof(out));
+
+		ref_ret = ref_der_dec_integer(der, &ref_size, mode >= 2 ? ref_out : NULL, mode >= 1 ? &ref_int_size : NULL);
+		ret = atcacert_der_dec_integer(der, &size, mode >= 2 ? out : NULL, mode >= 1 ? &int_size : NULL);
+		if (ret != ref_ret
+		    || ((ret == ATCA_SUCCESS || ret == ATCACERT_E_BUFFER_TOO_SMALL)
+		        && (size != ref_size || int_size != ref_int_size))
+		    || (ret == ATCA_SUCCESS && memcmp(out, ref_out, sizeof(out)) != 0))
+		{
+			show("dec_integer", der, der_size, ref_ret, ret);
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int check_enc_ecdsa_sig_value(long iterations)
+{
+	uint8_t raw_sig[64];
+	uint8_t ref_out[MAX_DER_SIZE];
+	uint8_t out[MAX_DER_SIZE];
+	size_t ref_size;
+	size_t size;
+	int use_buf;
+	int ref_ret;
+	int ret;
+	long n;
+
+	for (n = 0; n < iterations; n++)
+	{
+		gen_raw_sig(raw_sig);
+		use_buf = rng_below(4) != 0;
+		ref_size = 0;
+		ref_der_enc_ecdsa_sig_value(raw_sig, NULL, &ref_size);
+		ref_size = size = gen_out_size(ref_size);
+		memset(ref_out, FILL, sizeof(ref_out));
+		memset(out, FILL, sizeof(out));
+
+		ref_ret = ref_der_enc_ecdsa_sig_value(raw_sig, use_buf ? ref_out : NULL, &ref_size);
+		ret = atcacert_der_enc_ecdsa_sig_value(raw_sig, use_buf ? out : NULL, &size);
+		if (ret != ref_ret || size != ref_size || memcmp(out, ref_out, sizeof(out)) != 0)
+		{
+			show("enc_ecdsa_sig_value", raw_sig, sizeof(raw_sig), ref_ret, ret);
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int check_dec_ecdsa_sig_value(long iterations)
+{
+	uint8_t der[MAX_DER_SIZE];
+	uint8_t raw_sig[64];
+	uint8_t ref_raw_sig[64];
+	size_t der_size;
+	size_t ref_size;
+	size_t size;
+	int use_raw;
+	int ref_ret;
+	int ret;
+	long n;
+
+	for (n = 0; n < iterations; n++)
+	{
+		if (rng_below(2))
+		{
+			gen_raw_sig(raw_sig);
+			der_size = sizeof(der);
+			ref_der_enc_ecdsa_sig_value(raw_sig, der, &der_size);
+		}
+		else
+		{
+			der_size = gen_der_sig(der);
+		}
+		mutate(der, &der_size, sizeof(der));
+		use_raw = rng_below(8) != 0;
+		ref_size = size = der_size;
+		memset(ref_raw_sig, FILL, sizeof(ref_raw_sig));
+		memset(raw_sig, FILL, sizeof(raw_sig));
+
+		ref_ret = ref_der_dec_ecdsa_sig_value(der, &ref_size, use_raw ? ref_raw_sig : NULL);
+		ret = atcacert_der_dec_ecdsa_sig_value(der, &size, use_raw ? raw_sig : NULL);
+		if (ref_ret == ATCACERT_E_BUFFER_TOO_SMALL && ret == ATCACERT_E_DECODING_ERROR)
+		{
+			continue; // Integer longer than 33 bytes, see the top of the file
+		}
+		if (ret != ref_ret
+		    || (ret == ATCA_SUCCESS && (size != ref_size || memcmp(raw_sig, ref_raw_sig, sizeof(raw_sig)) != 0)))
+		{
+			show("dec_ecdsa_sig_value", der, der_size, ref_ret, ret);
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+int main(int argc, char* argv[])
+{
+	long iterations = DEFAULT_ITERATIONS;
+	size_t i;
+
+	for (i = 1; i < (size_t)argc; i++)
+	{
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < (size_t)argc)
+		{
+			iterations = strtol(argv[++i], NULL, 0);
+			if (iterations < 1)
+			{
+				fprintf(stderr, "iterations must be positive\n");
+				return 2;
+			}
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [-n iterations]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	report("enc_length", check_enc_length(iterations));
+	report("dec_length", check_dec_length(iterations));
+	report("enc_integer", check_enc_integer(iterations));
+	report("dec_integer", check_dec_integer(iterations));
+	report("enc_ecdsa_sig_value", check_enc_ecdsa_sig_value(iterations));
+	report("dec_ecdsa_sig_value", check_dec_ecdsa_sig_value(iterations));
+
+	return failures != 0;
+}
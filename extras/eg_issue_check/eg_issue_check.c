@@ -0,0 +1,342 @@
+/**
+ * \file
+ * \brief Host-side check of atcacert_issue_certs() against the atcacert_set_* setters.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Issues batches from both shipped definitions and from a custom definition that keeps its public
+ * key in the padded 72-byte form, and builds each certificate again one at a time with the
+ * atcacert_set_* setters. Certificates, sizes and TBS digests must match byte for byte:
+ *
+ *   gcc -std=gnu99 -O2 -DATCA_HAL_SIM -I../../src -I../../src/hal -o eg_issue_check \
+ *       eg_issue_check.c $(find ../../src -name '*.c' ! -name custom_hal.c) -lpthread
+ *   ./eg_issue_check
+ *
+ * Build it again with -DATCACERT_ISSUE_THREADS=0 for the single-threaded path. The signed cases
+ * sign on the simulated device and verify with atcacert_verify_cert_sw().
+ *
+ * Prints one line per case and exits non-zero if any fails.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "astekcrypto.h"
+#include "basic/atca_basic.h"
+#include "atcacert/atcacert_issue.h"
+#include "atcacert/atcacert_host_sw.h"
+#include "custom/cert_def_1_signer.h"
+#include "custom/cert_def_2_device.h"
+
+#define CHECK_SIGN_SLOT (0)
+#define MAX_COUNT       (33)    // Several key ID batches of 8 and a remainder
+#define PADDED_SIZE     (160)
+
+static int failures = 0;
+static uint32_t rng_state = 0x6D2B79F5;
+
+static uint8_t public_keys[MAX_COUNT][64];
+static uint8_t device_sns[MAX_COUNT][9];
+static uint8_t cert_sns[MAX_COUNT * 32];
+static uint8_t arena[MAX_COUNT * 600];
+static uint8_t expected[600];
+
+/* Custom layout: 72-byte padded public key, POSIX dates and a stored serial number in the TBS
+   data, a raw 64-byte signature after it. */
+static uint8_t padded_template[PADDED_SIZE];
+
+static const atcacert_def_t padded_cert_def = {
+	.type                   = CERTTYPE_CUSTOM,
+	.template_id            = 3,
+	.chain_id               = 0,
+	.private_key_slot       = 0,
+	.sn_source              = SNSRC_STORED,
+	.cert_sn_dev_loc        = { .zone = DEVZONE_NONE },
+	.issue_date_format      = DATEFMT_POSIX_UINT32_BE,
+	.expire_date_format     = DATEFMT_POSIX_UINT32_BE,
+	.tbs_cert_loc           = { .offset = 0, .count = 96 },
+	.expire_years           = 10,
+	.public_key_dev_loc     = { .zone = DEVZONE_DATA, .slot = 10, .offset = 0, .count = 72 },
+	.comp_cert_dev_loc      = { .zone = DEVZONE_NONE },
+	.std_cert_elements      = {
+		{ .offset = 4,  .count = 72 },  // STDCERT_PUBLIC_KEY
+		{ .offset = 96, .count = 64 },  // STDCERT_SIGNATURE
+		{ .offset = 76, .count = 4  },  // STDCERT_ISSUE_DATE
+		{ .offset = 80, .count = 4  },  // STDCERT_EXPIRE_DATE
+		{ .offset = 0,  .count = 0  },  // STDCERT_SIGNER_ID
+		{ .offset = 84, .count = 8  },  // STDCERT_CERT_SN
+		{ .offset = 0,  .count = 0  },  // STDCERT_AUTH_KEY_ID
+		{ .offset = 0,  .count = 0  },  // STDCERT_SUBJ_KEY_ID
+	},
+	.cert_elements          = NULL,
+	.cert_elements_count    = 0,
+	.cert_template          = padded_template,
+	.cert_template_size     = sizeof(padded_template),
+	.tbs_midstate           = NULL,
+};
+
+static void report(const char* name, int ok)
+{
+	printf("%-32s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static uint32_t rng_next(void)
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+static void rng_fill(uint8_t* buf, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++)
+	{
+		buf[i] = (uint8_t)rng_next();
+	}
+}
+
+/** \brief Deterministic stand-in for a signature, so unsigned layouts can be compared byte for byte. */
+static int sign_fake(const uint8_t tbs_digest[32], uint8_t signature[64], const void* context)
+{
+	size_t i;
+
+	(void)context;
+	for (i = 0; i < 64; i++)
+	{
+		signature[i] = tbs_digest[i % 32] ^ (uint8_t)i;
+	}
+	signature[0] |= 0x80;   // Both DER integers get a leading zero
+	signature[32] &= 0x7F;
+	return ATCA_SUCCESS;
+}
+
+static const atcacert_issue_signer_t signer_fake = { sign_fake, true };
+
+/** \brief Signs on the simulated device, which runs one command at a time. */
+static int sign_device(const uint8_t tbs_digest[32], uint8_t signature[64], const void* context)
+{
+	(void)context;
+	return atcab_sign(CHECK_SIGN_SLOT, tbs_digest, signature);
+}
+
+static const atcacert_issue_signer_t signer_device = { sign_device, false };
+
+/**
+ * \brief Build certificate i of the batch the long way and compare it with the issued one.
+ */
+static int check_cert(const atcacert_issue_batch_t* batch, const atcacert_issue_signer_t* signer, size_t stride,
+                      size_t i, const size_t cert_sizes[], uint8_t (*tbs_digests)[32])
+{
+	const atcacert_def_t* cert_def = batch->cert_def;
+	size_t cert_size = cert_def->cert_template_size;
+	size_t sn_size = cert_def->std_cert_elements[STDCERT_CERT_SN].count;
+	atcacert_tm_utc_t expire_date;
+	uint8_t tbs_digest[32];
+	uint8_t signature[64];
+	uint8_t public_key[64];
+
+	memcpy(expected, cert_def->cert_template, cert_size);
+	if (batch->issue_date != NULL
+	    && atcacert_set_issue_date(cert_def, expected, cert_size, batch->issue_date) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+	if (batch->expire_date != NULL)
+	{
+		expire_date = *batch->expire_date;
+	}
+	else if (batch->issue_date != NULL)
+	{
+		expire_date = *batch->issue_date;
+		expire_date.tm_year += cert_def->expire_years;
+		if (cert_def->expire_years == 0)
+		{
+			atcacert_date_get_max_date(cert_def->expire_date_format, &expire_date);
+		}
+	}
+	if ((batch->expire_date != NULL || batch->issue_date != NULL)
+	    && atcacert_set_expire_date(cert_def, expected, cert_size, &expire_date) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+	if ((batch->signer_id != NULL && atcacert_set_signer_id(cert_def, expected, cert_size, batch->signer_id) != ATCA_SUCCESS)
+	    || (batch->auth_public_key != NULL && atcacert_set_auth_key_id(cert_def, expected, cert_size, batch->auth_public_key) != ATCA_SUCCESS)
+	    || atcacert_set_subj_public_key(cert_def, expected, cert_size, batch->public_keys[i]) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+	if (batch->cert_sns != NULL)
+	{
+		if (atcacert_set_cert_sn(cert_def, expected, cert_size, &batch->cert_sns[i * sn_size], sn_size) != ATCA_SUCCESS)
+		{
+			return 0;
+		}
+	}
+	else if (atcacert_gen_cert_sn(cert_def, expected, cert_size, batch->device_sns[i]) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+	if (atcacert_get_tbs_digest(cert_def, expected, cert_size, tbs_digest) != ATCA_SUCCESS
+	    || memcmp(tbs_digest, tbs_digests[i], 32) != 0)
+	{
+		return 0;
+	}
+
+	if (signer == &signer_device)
+	{
+		// The device signature changes every time, take it from the issued certificate
+		if (atcacert_get_signature(cert_def, &arena[i * stride], cert_sizes[i], signature) != ATCA_SUCCESS
+		    || atcacert_verify_cert_sw(cert_def, &arena[i * stride], cert_sizes[i], (const uint8_t*)batch->auth_public_key) != ATCA_SUCCESS)
+		{
+			return 0;
+		}
+	}
+	else if (signer == &signer_fake)
+	{
+		sign_fake(tbs_digest, signature, NULL);
+	}
+	if (signer != NULL && atcacert_set_signature(cert_def, expected, &cert_size, sizeof(expected), signature) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+
+	if (atcacert_get_subj_public_key(cert_def, &arena[i * stride], cert_sizes[i], public_key) != ATCA_SUCCESS
+	    || memcmp(public_key, batch->public_keys[i], 64) != 0)
+	{
+		return 0;
+	}
+	return cert_sizes[i] == cert_size && memcmp(&arena[i * stride], expected, cert_size) == 0;
+}
+
+static int check_batch(const atcacert_def_t* cert_def, const atcacert_issue_signer_t* signer,
+                       const uint8_t auth_public_key[64], size_t count, int explicit_dates)
+{
+	static const atcacert_tm_utc_t issue_date = { 0, 0, 9, 14, 5, 2024 - 1900 };
+	static const atcacert_tm_utc_t expire_date = { 59, 59, 23, 31, 11, 2039 - 1900 };
+	static const uint8_t signer_id[2] = { 0xC4, 0x8B };
+	static size_t cert_sizes[MAX_COUNT];
+	static uint8_t tbs_digests[MAX_COUNT][32];
+	atcacert_issue_batch_t batch;
+	size_t stride = atcacert_issue_cert_stride(cert_def);
+	size_t i;
+
+	memset(&batch, 0, sizeof(batch));
+	batch.cert_def = cert_def;
+	batch.issue_date = &issue_date;
+	batch.expire_date = explicit_dates ? &expire_date : NULL;
+	batch.signer_id = explicit_dates ? signer_id : NULL;
+	batch.auth_public_key = auth_public_key;
+	batch.count = count;
+	batch.public_keys = (const uint8_t (*)[64])public_keys;
+	batch.device_sns = (const uint8_t (*)[9])device_sns;
+	batch.cert_sns = (cert_def->sn_source == SNSRC_STORED) ? cert_sns : NULL;
+
+	memset(arena, 0, sizeof(arena));
+	if (atcacert_issue_certs(&batch, signer, NULL, arena, sizeof(arena), cert_sizes, tbs_digests) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+	for (i = 0; i < count; i++)
+	{
+		if (!check_cert(&batch, signer, stride, i, cert_sizes, tbs_digests))
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int main(void)
+{
+	static const size_t counts[] = { 1, 2, 7, 8, 9, MAX_COUNT };
+	static const struct {
+		const char*           name;
+		const atcacert_def_t* cert_def;
+	} defs[] = {
+		{ "signer",     &g_cert_def_1_signer },
+		{ "device",     &g_cert_def_2_device },
+		{ "padded key", &padded_cert_def     },
+	};
+	static const struct {
+		const char*                    name;
+		const atcacert_issue_signer_t* signer;
+	} signers[] = {
+		{ "unsigned", NULL           },
+		{ "signed",   &signer_fake   },
+		{ "device",   &signer_device },
+	};
+	uint8_t auth_public_key[64];
+	char name[64];
+	size_t d, s, c;
+	int ok;
+
+	if (egSelectDevice(&cfg_ateccx08a_sim_default) != ATCA_SUCCESS
+	    || atcab_get_pubkey(CHECK_SIGN_SLOT, auth_public_key) != ATCA_SUCCESS)
+	{
+		fprintf(stderr, "eg_issue_check: can't start the simulated device\n");
+		return 1;
+	}
+
+	rng_fill(&public_keys[0][0], sizeof(public_keys));
+	rng_fill(&device_sns[0][0], sizeof(device_sns));
+	rng_fill(cert_sns, sizeof(cert_sns));
+	rng_fill(padded_template, sizeof(padded_template));
+
+	for (d = 0; d < sizeof(defs) / sizeof(defs[0]); d++)
+	{
+		for (s = 0; s < sizeof(signers) / sizeof(signers[0]); s++)
+		{
+			ok = 1;
+			for (c = 0; c < sizeof(counts) / sizeof(counts[0]) && ok; c++)
+			{
+				ok = check_batch(defs[d].cert_def, signers[s].signer, auth_public_key, counts[c], (int)(c & 1));
+			}
+			snprintf(name, sizeof(name), "%s %s", defs[d].name, signers[s].name);
+			report(name, ok);
+		}
+	}
+
+	return failures != 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * \file
+ * \brief Host-side check of the packet-level atcab_ API against the simulator.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Drives atcab_get_packet(), atcab_execute_packet() and atcab_packet_response() against
+ * hal/hal_sim.c, including the calls that take their input from inside the device packet:
+ *
+ *   gcc -std=gnu99 -O2 -DATCA_HAL_SIM -I../../src -I../../src/hal -o eg_packet_check \
+ *       eg_packet_check.c $(find ../../src -name '*.c' ! -name custom_hal.c)
+ *   ./eg_packet_check
+ *
+ * Prints one line per case and exits non-zero if any fails.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "astekcrypto.h"
+#include "basic/atca_basic.h"
+#include "crypto/atca_crypto_sw_ecdsa.h"
+#include "crypto/atca_crypto_sw_sha2.h"
+
+#define CHECK_SIGN_SLOT (0)
+
+static int failures = 0;
+
+static void report(const char* name, int ok)
+{
+	printf("%-32s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static int verify(const uint8_t* pubkey, const uint8_t* msg, const uint8_t* signature)
+{
+	return atcac_sw_ecdsa_verify_p256(msg, signature, pubkey) == ATCA_SUCCESS;
+}
+
+int main(void)
+{
+	ATCAPacket* packet;
+	const uint8_t* response = NULL;
+	uint8_t length = 0;
+	uint8_t pubkey[ATCA_PUB_KEY_SIZE];
+	uint8_t msg[ATCA_KEY_SIZE];
+	uint8_t block[ATCA_SHA2_256_BLOCK_SIZE];
+	uint8_t digest[ATCA_SHA_DIGEST_SIZE];
+	uint8_t expected[ATCA_SHA_DIGEST_SIZE];
+	uint8_t signature[ATCA_SIG_SIZE];
+	size_t i;
+
+	if (egSelectDevice(&cfg_ateccx08a_sim_default) != ATCA_SUCCESS
+	    || atcab_get_pubkey(CHECK_SIGN_SLOT, pubkey) != ATCA_SUCCESS)
+	{
+		fprintf(stderr, "eg_packet_check: can't start the simulated device\n");
+		return 1;
+	}
+
+	// Random built and executed by hand, read through the response view
+	packet = atcab_get_packet();
+	packet->param1 = RANDOM_SEED_UPDATE;
+	packet->param2 = 0x0000;
+	report("random through packet",
+	       packet != NULL && atRandom(packet) == ATCA_SUCCESS
+	       && atcab_execute_packet(packet, CMD_RANDOM) == ATCA_SUCCESS
+	       && (response = atcab_packet_response(packet, &length)) == &packet->crypto_data[ATCA_RSP_DATA_IDX]
+	       && length == ATCA_KEY_SIZE);
+
+	// Nonce from the view of the Random response, source and destination overlap
+	memcpy(msg, response, sizeof(msg));
+	report("challenge from response view", atcab_challenge(response) == ATCA_SUCCESS);
+	packet->param1 = SIGN_MODE_EXTERNAL;
+	packet->param2 = CHECK_SIGN_SLOT;
+	report("sign through packet",
+	       atSign(packet) == ATCA_SUCCESS
+	       && atcab_execute_packet(packet, CMD_SIGN) == ATCA_SUCCESS
+	       && (response = atcab_packet_response(packet, &length)) != NULL
+	       && length == ATCA_SIG_SIZE && verify(pubkey, msg, response));
+
+	// Message written straight into the packet, the seed update mustn't overwrite it
+	packet = atcab_get_packet();
+	for (i = 0; i < sizeof(msg); i++)
+	{
+		msg[i] = (uint8_t)(0xA5 ^ i);
+	}
+	memcpy(packet->crypto_data, msg, sizeof(msg));
+	report("sign from packet->crypto_data",
+	       atcab_sign(CHECK_SIGN_SLOT, packet->crypto_data, signature) == ATCA_SUCCESS
+	       && verify(pubkey, msg, signature));
+
+	// SHA blocks one byte into the packet, as a response view would be
+	for (i = 0; i < sizeof(block); i++)
+	{
+		block[i] = (uint8_t)(3 * i + 1);
+	}
+	atcac_sw_sha2_256(block, sizeof(block), expected);
+	report("sha_start", atcab_sha_start() == ATCA_SUCCESS);
+	packet = atcab_get_packet();
+	memcpy(&packet->crypto_data[ATCA_RSP_DATA_IDX], block, sizeof(block));
+	report("sha_update from packet",
+	       atcab_sha_update(sizeof(block), &packet->crypto_data[ATCA_RSP_DATA_IDX]) == ATCA_SUCCESS);
+	report("sha_end",
+	       atcab_sha_end(digest, 0, NULL) == ATCA_SUCCESS
+	       && memcmp(digest, expected, sizeof(digest)) == 0);
+
+	atcac_sw_sha2_256(block, sizeof(block) - 1, expected);
+	report("sha_start", atcab_sha_start() == ATCA_SUCCESS);
+	packet = atcab_get_packet();
+	memcpy(&packet->crypto_data[ATCA_RSP_DATA_IDX], block, sizeof(block) - 1);
+	report("sha_end from packet",
+	       atcab_sha_end(digest, sizeof(block) - 1, &packet->crypto_data[ATCA_RSP_DATA_IDX]) == ATCA_SUCCESS
+	       && memcmp(digest, expected, sizeof(digest)) == 0);
+
+	return failures == 0 ? 0 : 1;
+}
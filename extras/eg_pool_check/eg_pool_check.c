@@ -0,0 +1,272 @@
+/**
+ * \file
+ * \brief Host-side check of the device pool on the simulator.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Runs batches through atcab_pool_run() on two hal/hal_sim.c devices and checks the results with
+ * the software SHA-256 and the global device:
+ *
+ *   gcc -std=gnu99 -O2 -DATCA_HAL_SIM -I../../src -I../../src/hal -o eg_pool_check \
+ *       eg_pool_check.c $(find ../../src -name '*.c' ! -name custom_hal.c) -lpthread
+ *   ./eg_pool_check
+ *
+ * The long SHA-256 jobs keep a device busy for several seconds of simulated time, well past the
+ * watchdog, and more than 255 blocks. The batches run again after atcab_pool_release() has put
+ * the devices to sleep.
+ *
+ * Prints one line per case and exits non-zero if any fails.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "astekcrypto.h"
+#include "basic/atca_basic.h"
+#include "basic/atca_pool.h"
+#include "crypto/atca_crypto_sw_sha2.h"
+
+#define POOL_DEVICES (2)
+#define SIGN_JOBS    (6)
+#define KEY_SLOT     (0)    // Slot of the simulator holding a P256 private key
+#define MAX_MESSAGE  (40000)
+
+static const size_t sha_lengths[] = { 0, 1, 55, 56, 63, 64, 65, 127, 128, 1000 };
+static const size_t long_sha_lengths[] = { 9600, 16320, 16384, MAX_MESSAGE };
+
+static int failures = 0;
+
+static ATCAIfaceCfg pool_cfgs[POOL_DEVICES];
+static uint8_t message[MAX_MESSAGE];
+static uint8_t public_keys[POOL_DEVICES][64];   // Each simulated device has its own keys
+
+static void report(const char* name, int ok)
+{
+	printf("%-32s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static int pool_start(ATCAPool* pool)
+{
+	ATCAIfaceCfg* cfgs[POOL_DEVICES];
+	size_t i;
+
+	for (i = 0; i < POOL_DEVICES; i++)
+	{
+		cfgs[i] = &pool_cfgs[i];
+	}
+
+	return atcab_pool_init(pool, cfgs, POOL_DEVICES) == ATCA_SUCCESS;
+}
+
+static int check_sha(ATCAPool* pool, const size_t* lengths, size_t count)
+{
+	ATCAPoolJob jobs[16];
+	uint8_t digests[16][32];
+	uint8_t expected[32];
+	size_t i;
+
+	memset(jobs, 0, sizeof(jobs));
+	for (i = 0; i < count; i++)
+	{
+		jobs[i].op = ATCA_POOL_SHA256;
+		jobs[i].message = message;
+		jobs[i].length = lengths[i];
+		jobs[i].out = digests[i];
+	}
+
+	if (atcab_pool_run(pool, jobs, (uint16_t)count) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		atcac_sw_sha2_256(message, lengths[i], expected);
+		if (memcmp(digests[i], expected, sizeof(expected)) != 0)
+		{
+			fprintf(stderr, "SHA-256 of %u bytes differs\n", (unsigned)lengths[i]);
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int check_random(ATCAPool* pool)
+{
+	ATCAPoolJob jobs[2 * POOL_DEVICES];
+	uint8_t numbers[2 * POOL_DEVICES][32];
+	size_t i;
+
+	memset(jobs, 0, sizeof(jobs));
+	for (i = 0; i < 2 * POOL_DEVICES; i++)
+	{
+		jobs[i].op = ATCA_POOL_RANDOM;
+		jobs[i].out = numbers[i];
+	}
+
+	if (atcab_pool_run(pool, jobs, 2 * POOL_DEVICES) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+
+	// A device gives a new number each time
+	for (i = POOL_DEVICES; i < 2 * POOL_DEVICES; i++)
+	{
+		if (memcmp(numbers[i], numbers[i - POOL_DEVICES], 32) == 0)
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * \brief Signs a digest per job across the pool, then verifies each signature, and each with a
+ *        flipped bit, with the key of the device that signed it on whichever device is free.
+ */
+static int check_sign_verify(ATCAPool* pool)
+{
+	ATCAPoolJob jobs[2 * SIGN_JOBS];
+	uint8_t digests[SIGN_JOBS][32];
+	uint8_t signatures[2 * SIGN_JOBS][64];
+	uint8_t sign_devices[SIGN_JOBS];
+	size_t i;
+
+	memset(jobs, 0, sizeof(jobs));
+	for (i = 0; i < SIGN_JOBS; i++)
+	{
+		atcac_sw_sha2_256(message, 100 + i, digests[i]);
+		jobs[i].op = ATCA_POOL_SIGN;
+		jobs[i].key_id = KEY_SLOT;
+		jobs[i].message = digests[i];
+		jobs[i].out = signatures[i];
+	}
+	if (atcab_pool_run(pool, jobs, SIGN_JOBS) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+	for (i = 0; i < SIGN_JOBS; i++)
+	{
+		sign_devices[i] = jobs[i].device;
+	}
+
+	memset(jobs, 0, sizeof(jobs));
+	for (i = 0; i < 2 * SIGN_JOBS; i++)
+	{
+		if (i >= SIGN_JOBS)
+		{
+			memcpy(signatures[i], signatures[i - SIGN_JOBS], 64);
+			signatures[i][i % 64] ^= 0x01;
+		}
+		jobs[i].op = ATCA_POOL_VERIFY;
+		jobs[i].message = digests[i % SIGN_JOBS];
+		jobs[i].signature = signatures[i];
+		jobs[i].public_key = public_keys[sign_devices[i % SIGN_JOBS]];
+	}
+	if (atcab_pool_run(pool, jobs, 2 * SIGN_JOBS) != ATCA_SUCCESS)
+	{
+		return 0;
+	}
+
+	for (i = 0; i < 2 * SIGN_JOBS; i++)
+	{
+		if (jobs[i].verified != (i < SIGN_JOBS))
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static void check_pool(const char* round)
+{
+	ATCAPool pool;
+	char name[40];
+
+	snprintf(name, sizeof(name), "%s init", round);
+	report(name, pool_start(&pool));
+	if (pool.count != POOL_DEVICES)
+	{
+		return;
+	}
+
+	snprintf(name, sizeof(name), "%s sha256", round);
+	report(name, check_sha(&pool, sha_lengths, sizeof(sha_lengths) / sizeof(sha_lengths[0])));
+	snprintf(name, sizeof(name), "%s sha256 long", round);
+	report(name, check_sha(&pool, long_sha_lengths, sizeof(long_sha_lengths) / sizeof(long_sha_lengths[0])));
+	snprintf(name, sizeof(name), "%s random", round);
+	report(name, check_random(&pool));
+	snprintf(name, sizeof(name), "%s sign and verify", round);
+	report(name, check_sign_verify(&pool));
+
+	atcab_pool_release(&pool);
+}
+
+int main(void)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(message); i++)
+	{
+		message[i] = (uint8_t)(i * 7 + 1);
+	}
+
+	// The global device reads the public key of each pool device
+	for (i = 0; i < POOL_DEVICES; i++)
+	{
+		pool_cfgs[i] = cfg_ateccx08a_sim_default;
+		pool_cfgs[i].atcasim.instance = (uint8_t)i;
+		if (egSelectDevice(&pool_cfgs[i]) != ATCA_SUCCESS
+		    || atcab_get_pubkey(KEY_SLOT, public_keys[i]) != ATCA_SUCCESS)
+		{
+			report("simulator", 0);
+			return 1;
+		}
+	}
+
+	check_pool("first");
+	check_pool("again");
+
+	return failures != 0;
+}
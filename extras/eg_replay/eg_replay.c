@@ -0,0 +1,244 @@
+/**
+ * \file
+ * \brief Replays a recorded bus trace through the eGuard library on a host.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Runs eg* entry points against the replay HAL of hal/hal_trace.c, answering every bus
+ * transaction from a trace recorded on a board (see examples/eGuardTrace):
+ *
+ *   gcc -std=gnu99 -O2 -DATCA_HAL_REPLAY -I../../src -I../../src/hal -o eg_replay eg_replay.c \
+ *       $(find ../../src -name '*.c' ! -name custom_hal.c)
+ *   ./eg_replay trace.txt sernum random sha pubkey auth-sym
+ *
+ * The calls must be given in the order the board made them; the default list is the one the
+ * sketch runs. One CSV record is printed per call: the status, the host time spent in the
+ * library and the device time recorded in the trace between the transactions the call replayed.
+ *
+ * The host draws its own random numbers, so commands built from them (the nonce and challenge
+ * of auth-sym) differ from the trace. They are counted as mismatches and the call fails its MAC
+ * check, but its transactions and timing are still the recorded ones.
+ */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L         // clock_gettime()
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "astekcrypto.h"
+#include "hal/hal_trace.h"
+
+#define REPLAY_MESSAGE_SIZE     (64)
+
+static uint8_t message[REPLAY_MESSAGE_SIZE];
+static uint8_t digest[ATCA_SHA_DIGEST_SIZE];
+static uint8_t sernum[ATCA_SERIAL_NUM_SIZE];
+static uint8_t random_number[ATCA_BLOCK_SIZE];
+static uint8_t pubkey[ATCA_PUB_KEY_SIZE];
+static uint8_t signature[ATCA_SIG_SIZE];
+
+static ATCA_STATUS replay_detect(void)   { return egDetectDevice(); }
+static ATCA_STATUS replay_sernum(void)   { return egSerNum(sernum); }
+static ATCA_STATUS replay_random(void)   { return egGenRandom(random_number); }
+static ATCA_STATUS replay_sha(void)      { return egSHA256(message, sizeof(message), digest); }
+static ATCA_STATUS replay_pubkey(void)   { return egDevicePubKey(pubkey); }
+static ATCA_STATUS replay_auth_sym(void) { return egAuthenticate(SYMMETRIC, NULL); }
+static ATCA_STATUS replay_auth_pki(void) { return egAuthenticate(SW_PKI, pubkey); }
+static ATCA_STATUS replay_sign(void)     { return egSignTag(message, sizeof(message), signature); }
+static ATCA_STATUS replay_verify(void)   { return egVerifyTag(message, sizeof(message), signature); }
+
+static const struct
+{
+	const char* name;
+	ATCA_STATUS (*call)(void);
+} replay_calls[] =
+{
+	{ "detect",   replay_detect },
+	{ "sernum",   replay_sernum },
+	{ "random",   replay_random },
+	{ "sha",      replay_sha },
+	{ "pubkey",   replay_pubkey },
+	{ "auth-sym", replay_auth_sym },
+	{ "auth-pki", replay_auth_pki },
+	{ "sign",     replay_sign },
+	{ "verify",   replay_verify },
+};
+
+static const char* default_calls[] = { "sernum", "random", "sha", "pubkey", "auth-sym" };
+
+static uint64_t host_us(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+}
+
+static int hex_value(char c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	return -1;
+}
+
+/** \brief Decodes the hex lines of a hal_trace_dump() capture, skipping comments and anything
+ * 			the serial monitor printed around it. */
+static uint8_t* load_trace(const char* path, size_t* length)
+{
+	char line[512];
+	uint8_t* trace = NULL;
+	size_t size = 0;
+	size_t i, n;
+	FILE* file;
+
+	*length = 0;
+	if ((file = fopen(path, "r")) == NULL)
+	{
+		return NULL;
+	}
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		n = strcspn(line, "\r\n");
+		if (n == 0 || n % 2 != 0 || line[0] == '#')
+		{
+			continue;
+		}
+		for (i = 0; i < n && hex_value(line[i]) >= 0; i++)
+			;
+		if (i != n)
+		{
+			continue;
+		}
+		if (*length + n / 2 > size)
+		{
+			size = (size + n / 2) * 2;
+			trace = (uint8_t*)realloc(trace, size);
+			if (trace == NULL)
+			{
+				break;
+			}
+		}
+		for (i = 0; i < n; i += 2)
+		{
+			trace[(*length)++] = (uint8_t)(hex_value(line[i]) << 4 | hex_value(line[i + 1]));
+		}
+	}
+	fclose(file);
+
+	return trace;
+}
+
+int main(int argc, char* argv[])
+{
+	const char** calls = default_calls;
+	int call_count = sizeof(default_calls) / sizeof(default_calls[0]);
+	hal_replay_stats_t before, after;
+	uint8_t* trace;
+	size_t length, i, j;
+	uint64_t start, elapsed;
+	ATCA_STATUS status;
+
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s trace.txt [call...]\ncalls:", argv[0]);
+		for (j = 0; j < sizeof(replay_calls) / sizeof(replay_calls[0]); j++)
+		{
+			fprintf(stderr, " %s", replay_calls[j].name);
+		}
+		fprintf(stderr, "\n");
+		return 2;
+	}
+	if (argc > 2)
+	{
+		calls = (const char**)&argv[2];
+		call_count = argc - 2;
+	}
+
+	trace = load_trace(argv[1], &length);
+	if (trace == NULL || hal_replay_load(trace, length) != ATCA_SUCCESS)
+	{
+		fprintf(stderr, "%s: no trace records\n", argv[1]);
+		return 1;
+	}
+	for (i = 0; i < sizeof(message); i++)
+	{
+		message[i] = (uint8_t)i;
+	}
+
+	status = egSelectDevice(&cfg_ateccx08a_replay_default);
+	if (status != ATCA_SUCCESS)
+	{
+		fprintf(stderr, "egSelectDevice failed: %02X\n", status);
+		return 1;
+	}
+
+	printf("call,status,host_us,device_us,replayed,skipped,mismatches\n");
+	for (i = 0; i < (size_t)call_count; i++)
+	{
+		for (j = 0; j < sizeof(replay_calls) / sizeof(replay_calls[0]); j++)
+		{
+			if (strcmp(calls[i], replay_calls[j].name) == 0)
+			{
+				break;
+			}
+		}
+		if (j == sizeof(replay_calls) / sizeof(replay_calls[0]))
+		{
+			fprintf(stderr, "unknown call: %s\n", calls[i]);
+			return 2;
+		}
+
+		hal_replay_get_stats(&before);
+		start = host_us();
+		status = replay_calls[j].call();
+		elapsed = host_us() - start;
+		hal_replay_get_stats(&after);
+
+		printf("%s,%02X,%lu,%lu,%lu,%lu,%lu\n", calls[i], status, (unsigned long)elapsed,
+			(unsigned long)(after.device_us - before.device_us), (unsigned long)(after.replayed - before.replayed),
+			(unsigned long)(after.skipped - before.skipped), (unsigned long)(after.mismatches - before.mismatches));
+	}
+
+	atcab_release();
+	free(trace);
+	return 0;
+}
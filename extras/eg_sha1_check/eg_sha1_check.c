@@ -0,0 +1,339 @@
+/**
+ * \file
+ * \brief Host-side cross-check of the software SHA-1 in crypto/hashes/sha1_routines.c.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Compares CL_hash(), CL_hashInit()/CL_hashUpdate()/CL_hashFinal() in random chunks, and
+ * CL_hashMulti() with a plain FIPS 180-4 implementation kept in this file, after checking both
+ * against the FIPS test vectors. Build it once for each core:
+ *
+ *   gcc -std=gnu99 -O2 -I../../src -o eg_sha1_check eg_sha1_check.c \
+ *       ../../src/crypto/hashes/sha1_routines.c
+ *   ./eg_sha1_check
+ *
+ * and again with -DSHA1_NO_SHANI (portable unrolled rounds, lanes in CL_hashMulti()),
+ * -DSHA1_NO_SHANI -DSHA1_UNROLL=0 (the AVR loop) and -DSHA1_NO_SHANI -DSHA1_LANES=1, 4 or 16.
+ * The SHA extensions are only used when the host has them.
+ *
+ * Prints one line per case and exits non-zero if any fails.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "crypto/hashes/sha1_routines.h"
+
+#define MAX_LENGTH   (1100)
+#define MULTI_LENGTH (200)
+#define MULTI_COUNT  (35)   // Two batches of 16 lanes and a remainder
+#define MULTI_STRIDE (97)
+
+static int failures = 0;
+static uint32_t rng_state = 0x2545F491;
+
+static void report(const char* name, int ok)
+{
+	printf("%-32s %s\n", name, ok ? "ok" : "FAIL");
+	if (!ok)
+	{
+		failures++;
+	}
+}
+
+static uint32_t rng_next(void)
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+#define REF_ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+/**
+ * \brief SHA-1 straight from FIPS 180-4 section 6.1: pad the whole message, then run the
+ *        80-word schedule and the 80 rounds on each block.
+ */
+static void ref_sha1(const uint8_t* msg, size_t length, uint8_t digest[20])
+{
+	uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+	uint64_t bits = (uint64_t)length * 8;
+	size_t padded = (length + 9 + 63) / 64 * 64;
+	size_t offset;
+	size_t i;
+	uint8_t block[64];
+	uint32_t w[80];
+	uint32_t a, b, c, d, e, f, k, temp;
+
+	for (offset = 0; offset < padded; offset += 64)
+	{
+		for (i = 0; i < 64; i++)
+		{
+			size_t pos = offset + i;
+
+			if (pos < length)
+			{
+				block[i] = msg[pos];
+			}
+			else if (pos == length)
+			{
+				block[i] = 0x80;
+			}
+			else if (pos >= padded - 8)
+			{
+				block[i] = (uint8_t)(bits >> (8 * (padded - 1 - pos)));
+			}
+			else
+			{
+				block[i] = 0;
+			}
+		}
+
+		for (i = 0; i < 16; i++)
+		{
+			w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16)
+			       | ((uint32_t)block[4 * i + 2] << 8) | (uint32_t)block[4 * i + 3];
+		}
+		for (i = 16; i < 80; i++)
+		{
+			w[i] = REF_ROTL(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+		}
+
+		a = h[0];
+		b = h[1];
+		c = h[2];
+		d = h[3];
+		e = h[4];
+		for (i = 0; i < 80; i++)
+		{
+			if (i < 20)
+			{
+				f = (b & c) | (~b & d);
+				k = 0x5A827999;
+			}
+			else if (i < 40)
+			{
+				f = b ^ c ^ d;
+				k = 0x6ED9EBA1;
+			}
+			else if (i < 60)
+			{
+				f = (b & c) | (b & d) | (c & d);
+				k = 0x8F1BBCDC;
+			}
+			else
+			{
+				f = b ^ c ^ d;
+				k = 0xCA62C1D6;
+			}
+			temp = REF_ROTL(a, 5) + f + e + k + w[i];
+			e = d;
+			d = c;
+			c = REF_ROTL(b, 30);
+			b = a;
+			a = temp;
+		}
+		h[0] += a;
+		h[1] += b;
+		h[2] += c;
+		h[3] += d;
+		h[4] += e;
+	}
+
+	for (i = 0; i < 20; i++)
+	{
+		digest[i] = (uint8_t)(h[i / 4] >> (24 - 8 * (i % 4)));
+	}
+}
+
+/**
+ * \brief Hash with CL_hashUpdate() in chunks of 1 to max_chunk bytes.
+ */
+static void chunked_sha1(const uint8_t* msg, int length, int max_chunk, uint8_t digest[20])
+{
+	CL_HashContext ctx;
+	int offset = 0;
+	int chunk;
+
+	CL_hashInit(&ctx);
+	while (offset < length)
+	{
+		chunk = 1 + (int)(rng_next() % (uint32_t)max_chunk);
+		if (chunk > length - offset)
+		{
+			chunk = length - offset;
+		}
+		CL_hashUpdate(&ctx, msg + offset, chunk);
+		offset += chunk;
+	}
+	CL_hashFinal(&ctx, digest);
+}
+
+static int check_vectors(void)
+{
+	static const char* const messages[] = {
+		"",
+		"abc",
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+		"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+	};
+	static const uint8_t digests[][20] = {
+		{ 0xda, 0x39, 0xa3, 0xee, 0x5e, 0x6b, 0x4b, 0x0d, 0x32, 0x55, 0xbf, 0xef, 0x95, 0x60, 0x18, 0x90, 0xaf, 0xd8, 0x07, 0x09 },
+		{ 0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81, 0x6a, 0xba, 0x3e, 0x25, 0x71, 0x78, 0x50, 0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d },
+		{ 0x84, 0x98, 0x3e, 0x44, 0x1c, 0x3b, 0xd2, 0x6e, 0xba, 0xae, 0x4a, 0xa1, 0xf9, 0x51, 0x29, 0xe5, 0xe5, 0x46, 0x70, 0xf1 },
+		{ 0xa4, 0x9b, 0x24, 0x46, 0xa0, 0x2c, 0x64, 0x5b, 0xf4, 0x19, 0xf9, 0x95, 0xb6, 0x70, 0x91, 0x25, 0x3a, 0x04, 0xa2, 0x59 },
+	};
+	static const uint8_t million_a[20] = {
+		0x34, 0xaa, 0x97, 0x3c, 0xd4, 0xc4, 0xda, 0xa4, 0xf6, 0x1e, 0xeb, 0x2b, 0xdb, 0xad, 0x27, 0x31, 0x65, 0x34, 0x01, 0x6f
+	};
+	static uint8_t a_block[1000];
+	CL_HashContext ctx;
+	uint8_t ref[20];
+	uint8_t digest[20];
+	size_t i;
+
+	for (i = 0; i < sizeof(messages) / sizeof(messages[0]); i++)
+	{
+		ref_sha1((const uint8_t*)messages[i], strlen(messages[i]), ref);
+		CL_hash((U8*)messages[i], (int)strlen(messages[i]), digest);
+		if (memcmp(ref, digests[i], 20) != 0 || memcmp(digest, digests[i], 20) != 0)
+		{
+			return 0;
+		}
+	}
+
+	memset(a_block, 'a', sizeof(a_block));
+	CL_hashInit(&ctx);
+	for (i = 0; i < 1000; i++)
+	{
+		CL_hashUpdate(&ctx, a_block, sizeof(a_block));
+	}
+	CL_hashFinal(&ctx, digest);
+	return memcmp(digest, million_a, 20) == 0;
+}
+
+/**
+ * \brief One-shot and chunked hashes of every length up to MAX_LENGTH, from unaligned starts.
+ */
+static int check_lengths(const uint8_t* data, int chunked)
+{
+	uint8_t ref[20];
+	uint8_t digest[20];
+	int length;
+	const uint8_t* msg;
+
+	for (length = 0; length <= MAX_LENGTH; length++)
+	{
+		msg = data + length % 8;
+		ref_sha1(msg, (size_t)length, ref);
+		if (chunked)
+		{
+			chunked_sha1(msg, length, length % 3 == 0 ? 1 : 150, digest);
+		}
+		else
+		{
+			CL_hash((U8*)msg, length, digest);
+		}
+		if (memcmp(ref, digest, 20) != 0)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * \brief CL_hashMulti() over every batch size up to MULTI_COUNT and message length up to
+ *        MULTI_LENGTH. The bytes after the last digest must be left alone.
+ */
+static int check_multi(const uint8_t* data)
+{
+	static uint8_t digests[(MULTI_COUNT + 1) * 20];
+	const U8* msgs[MULTI_COUNT] = { NULL };
+	uint8_t ref[20];
+	int length;
+	int count;
+	int i;
+
+	for (length = 0; length <= MULTI_LENGTH; length++)
+	{
+		for (count = 0; count <= MULTI_COUNT; count++)
+		{
+			for (i = 0; i < count; i++)
+			{
+				msgs[i] = data + i * MULTI_STRIDE + length % 5;
+			}
+			memset(digests, 0xA5, sizeof(digests));
+			CL_hashMulti(msgs, length, count, digests);
+			for (i = 0; i < count; i++)
+			{
+				ref_sha1(msgs[i], (size_t)length, ref);
+				if (memcmp(ref, &digests[i * 20], 20) != 0)
+				{
+					return 0;
+				}
+			}
+			for (i = count * 20; i < (int)sizeof(digests); i++)
+			{
+				if (digests[i] != 0xA5)
+				{
+					return 0;
+				}
+			}
+		}
+	}
+	return 1;
+}
+
+int main(void)
+{
+	static uint8_t data[MULTI_COUNT * MULTI_STRIDE + MULTI_LENGTH + MAX_LENGTH];
+	size_t i;
+
+	for (i = 0; i < sizeof(data); i++)
+	{
+		data[i] = (uint8_t)rng_next();
+	}
+
+	report("FIPS 180 vectors", check_vectors());
+	report("one-shot lengths 0-1100", check_lengths(data, 0));
+	report("chunked lengths 0-1100", check_lengths(data, 1));
+	report("multi lengths 0-200", check_multi(data));
+
+	return failures != 0;
+}
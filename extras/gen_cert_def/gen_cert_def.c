@@ -0,0 +1,386 @@
+/**
+ * \file
+ * \brief Host-side generator for certificate definitions from X.509 certificates.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Turns a DER encoded P-256 X.509 certificate into a certificate definition source file, with
+ * the certificate as its template:
+ *
+ *   gcc -I../../src -o gen_cert_def gen_cert_def.c \
+ *       ../../src/atcacert/atcacert_x509.c ../../src/atcacert/atcacert_def.c \
+ *       ../../src/atcacert/atcacert_der.c ../../src/atcacert/atcacert_date.c \
+ *       ../../src/crypto/atca_crypto_sw_sha1.c ../../src/crypto/atca_crypto_sw_sha2.c \
+ *       ../../src/crypto/hashes/sha1_routines.c ../../src/crypto/hashes/sha2_routines.c
+ *   ./gen_cert_def -n 3_device device.der > ../../src/custom/cert_def_3_device.c
+ *
+ * Offsets, date formats and expire_years come from the certificate, see
+ * atcacert_x509_parse_def(). The device side follows the usual slot layout unless overridden:
+ * a device certificate's public key is generated from its private key slot (-k, default 0) and
+ * its compressed certificate is in slot 10; a signer (CA) certificate's public key is in slot 11
+ * and its compressed certificate in slot 12. The TBS midstate table is emitted along with the
+ * definition when the template has a constant prefix.
+ *
+ * The serial number element covers the whole INTEGER by default, so a hash scheme (-s) writes
+ * every byte of it. -l limits the element to its first sn_count bytes and leaves the rest as in
+ * the template; the shipped device definition, for one, hashes 16 bytes of its 17-byte serial
+ * number and keeps the last one constant. Changing that count changes every serial number the
+ * definition generates, so certificates already issued from a definition only rebuild with the
+ * count it used. The tool warns when the INTEGER is longer than what the scheme writes.
+ *
+ * The matching header declares g_cert_def_<name> as in src/custom/cert_def_2_device.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "atcacert/atcacert_x509.h"
+
+#define GEN_CERT_DEF_MAX_SIZE (4096)
+
+static const char* const date_format_names[] = {
+	"DATEFMT_ISO8601_SEP",
+	"DATEFMT_RFC5280_UTC",
+	"DATEFMT_POSIX_UINT32_BE",
+	"DATEFMT_POSIX_UINT32_LE",
+	"DATEFMT_RFC5280_GEN"
+};
+
+static const char* const std_cert_element_names[STDCERT_NUM_ELEMENTS] = {
+	"STDCERT_PUBLIC_KEY",
+	"STDCERT_SIGNATURE",
+	"STDCERT_ISSUE_DATE",
+	"STDCERT_EXPIRE_DATE",
+	"STDCERT_SIGNER_ID",
+	"STDCERT_CERT_SN",
+	"STDCERT_AUTH_KEY_ID",
+	"STDCERT_SUBJ_KEY_ID"
+};
+
+static const struct
+{
+	const char* option;
+	const char* name;
+	atcacert_cert_sn_src_t sn_source;
+	size_t sn_size;     // Serial number size the scheme needs, 0 for any up to 32 bytes
+} sn_sources[] = {
+	{ "device_sn",      "SNSRC_DEVICE_SN",      SNSRC_DEVICE_SN,      10 },
+	{ "signer_id",      "SNSRC_SIGNER_ID",      SNSRC_SIGNER_ID,      3  },
+	{ "pub_key_hash",   "SNSRC_PUB_KEY_HASH",   SNSRC_PUB_KEY_HASH,   0  },
+	{ "device_sn_hash", "SNSRC_DEVICE_SN_HASH", SNSRC_DEVICE_SN_HASH, 0  }
+};
+
+static const char* zone_name(atcacert_device_zone_t zone)
+{
+	switch (zone)
+	{
+	case DEVZONE_CONFIG: return "DEVZONE_CONFIG";
+	case DEVZONE_OTP:    return "DEVZONE_OTP";
+	case DEVZONE_DATA:   return "DEVZONE_DATA";
+	default:             return "DEVZONE_NONE";
+	}
+}
+
+static void print_device_loc(const char* field, const atcacert_device_loc_t* loc)
+{
+	printf("    .%-22s = {\n", field);
+	printf("        .zone      = %s,\n", zone_name(loc->zone));
+	printf("        .slot      = %u,\n", loc->slot);
+	printf("        .is_genkey = %u,\n", loc->is_genkey);
+	printf("        .offset    = %u,\n", loc->offset);
+	printf("        .count     = %u\n", loc->count);
+	printf("    },\n");
+}
+
+static void print_def(const char* name, const atcacert_def_t* def, size_t sn_source, int has_midstate)
+{
+	int i;
+
+	printf("const atcacert_def_t g_cert_def_%s = {\n", name);
+	printf("    .type                   = CERTTYPE_X509,\n");
+	printf("    .template_id            = %u,\n", def->template_id);
+	printf("    .chain_id               = %u,\n", def->chain_id);
+	printf("    .private_key_slot       = %u,\n", def->private_key_slot);
+	printf("    .sn_source              = %s,\n", sn_sources[sn_source].name);
+	print_device_loc("cert_sn_dev_loc", &def->cert_sn_dev_loc);
+	printf("    .issue_date_format      = %s,\n", date_format_names[def->issue_date_format]);
+	printf("    .expire_date_format     = %s,\n", date_format_names[def->expire_date_format]);
+	printf("    .tbs_cert_loc           = {\n");
+	printf("        .offset = %u,\n", def->tbs_cert_loc.offset);
+	printf("        .count  = %u\n", def->tbs_cert_loc.count);
+	printf("    },\n");
+	printf("    .expire_years           = %u,\n", def->expire_years);
+	print_device_loc("public_key_dev_loc", &def->public_key_dev_loc);
+	print_device_loc("comp_cert_dev_loc", &def->comp_cert_dev_loc);
+	printf("    .std_cert_elements      = {\n");
+	for (i = 0; i < STDCERT_NUM_ELEMENTS; i++)
+	{
+		printf("        { // %s\n", std_cert_element_names[i]);
+		printf("            .offset = %u,\n", def->std_cert_elements[i].offset);
+		printf("            .count  = %u\n", def->std_cert_elements[i].count);
+		printf("        }%s\n", i == STDCERT_NUM_ELEMENTS - 1 ? "" : ",");
+	}
+	printf("    },\n");
+	printf("    .cert_elements          = NULL,\n");
+	printf("    .cert_elements_count    = 0,\n");
+	printf("    .cert_template          = g_cert_template_%s,\n", name);
+	printf("    .cert_template_size     = sizeof(g_cert_template_%s),\n", name);
+	if (has_midstate)
+	{
+		printf("    .tbs_midstate           = &g_cert_def_%s_tbs_midstate,\n", name);
+	}
+	printf("};\n");
+}
+
+static int print_midstate(const char* name, const atcacert_def_t* def)
+{
+	atcacert_tbs_midstate_t midstate;
+	int i;
+
+	if (atcacert_get_tbs_midstate(def, &midstate) != ATCA_SUCCESS)
+	{
+		fprintf(stderr, "gen_cert_def: can't hash the template\n");
+		return -1;
+	}
+	if (midstate.prefix_size == 0)
+	{
+		return 0; // No constant TBS prefix, nothing to precompute
+	}
+
+	printf("const atcacert_tbs_midstate_t g_cert_def_%s_tbs_midstate = {\n", name);
+	printf("    .prefix_size = %u,\n", (unsigned)midstate.prefix_size);
+	printf("    .hash        = {");
+	for (i = 0; i < 8; i++)
+	{
+		printf("%s0x%08lXUL%s", (i % 4) == 0 ? "\n        " : "", (unsigned long)midstate.hash[i], i == 7 ? "\n" : ",");
+	}
+	printf("    }\n");
+	printf("};\n\n");
+	return 1;
+}
+
+static int usage(const char* argv0)
+{
+	fprintf(stderr,
+	        "usage: %s -n name [-t template_id] [-c chain_id] [-k private_key_slot]\n"
+	        "       [-p public_key_slot] [-z comp_cert_slot] [-l sn_count]\n"
+	        "       [-s device_sn|signer_id|pub_key_hash|device_sn_hash] cert.der\n",
+	        argv0);
+	return 2;
+}
+
+int main(int argc, char* argv[])
+{
+	static uint8_t cert[GEN_CERT_DEF_MAX_SIZE];
+	atcacert_def_t def;
+	const char* name = NULL;
+	const char* path = NULL;
+	long template_id = -1;
+	long chain_id = 0;
+	long private_key_slot = 0;
+	long public_key_slot = -1;
+	long comp_cert_slot = -1;
+	size_t sn_source = 2; // pub_key_hash
+	long sn_count = -1;
+	size_t sn_size;
+	size_t cert_size;
+	uint8_t is_ca = 0;
+	FILE* file;
+	int has_midstate;
+	int ret;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+		{
+			name = argv[++i];
+		}
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			template_id = strtol(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+		{
+			chain_id = strtol(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc)
+		{
+			private_key_slot = strtol(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+		{
+			public_key_slot = strtol(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-z") == 0 && i + 1 < argc)
+		{
+			comp_cert_slot = strtol(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+		{
+			sn_count = strtol(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+		{
+			i++;
+			for (sn_source = 0; sn_source < sizeof(sn_sources) / sizeof(sn_sources[0]); sn_source++)
+			{
+				if (strcmp(argv[i], sn_sources[sn_source].option) == 0)
+				{
+					break;
+				}
+			}
+			if (sn_source == sizeof(sn_sources) / sizeof(sn_sources[0]))
+			{
+				return usage(argv[0]);
+			}
+		}
+		else if (argv[i][0] != '-' && path == NULL)
+		{
+			path = argv[i];
+		}
+		else
+		{
+			return usage(argv[0]);
+		}
+	}
+	if (name == NULL || path == NULL)
+	{
+		return usage(argv[0]);
+	}
+	if (template_id > 15 || chain_id < 0 || chain_id > 15 || private_key_slot < 0 || private_key_slot > 15
+	    || public_key_slot > 15 || comp_cert_slot > 15)
+	{
+		fprintf(stderr, "gen_cert_def: IDs are 4-bit values and slots are 0 to 15\n");
+		return 2;
+	}
+
+	file = fopen(path, "rb");
+	if (file == NULL)
+	{
+		perror(path);
+		return 1;
+	}
+	cert_size = fread(cert, 1, sizeof(cert), file);
+	fclose(file);
+
+	memset(&def, 0, sizeof(def));
+	ret = atcacert_x509_parse_def(cert, cert_size, &def, &is_ca);
+	if (ret != ATCA_SUCCESS)
+	{
+		fprintf(stderr, "gen_cert_def: %s isn't a usable P-256 X.509 certificate (error 0x%02X)\n", path, ret);
+		return 1;
+	}
+
+	sn_size = def.std_cert_elements[STDCERT_CERT_SN].count;
+	if (sn_count == 0 || sn_count > (long)sn_size)
+	{
+		fprintf(stderr, "gen_cert_def: -l must be 1 to %u, the size of the serial number\n", (unsigned)sn_size);
+		return 2;
+	}
+	if (sn_count > 0)
+	{
+		def.std_cert_elements[STDCERT_CERT_SN].count = (uint16_t)sn_count;
+	}
+	else if (sn_sources[sn_source].sn_size != 0 && sn_size > sn_sources[sn_source].sn_size)
+	{
+		def.std_cert_elements[STDCERT_CERT_SN].count = (uint16_t)sn_sources[sn_source].sn_size;
+	}
+	else if (sn_sources[sn_source].sn_size == 0 && sn_size > 32)
+	{
+		def.std_cert_elements[STDCERT_CERT_SN].count = 32;
+	}
+	if (def.std_cert_elements[STDCERT_CERT_SN].count != sn_size)
+	{
+		fprintf(stderr, "gen_cert_def: warning: %s writes %u of the %u serial number bytes, the rest stay as in the template\n",
+		        sn_sources[sn_source].name, def.std_cert_elements[STDCERT_CERT_SN].count, (unsigned)sn_size);
+	}
+	sn_size = def.std_cert_elements[STDCERT_CERT_SN].count;
+	if (sn_sources[sn_source].sn_size != 0 ? sn_size != sn_sources[sn_source].sn_size : sn_size > 32)
+	{
+		fprintf(stderr, "gen_cert_def: the %u-byte serial number doesn't fit %s\n", (unsigned)sn_size, sn_sources[sn_source].name);
+		return 1;
+	}
+	if (sn_sources[sn_source].sn_source == SNSRC_SIGNER_ID && def.std_cert_elements[STDCERT_SIGNER_ID].count == 0)
+	{
+		fprintf(stderr, "gen_cert_def: no signer ID in the common name for SNSRC_SIGNER_ID\n");
+		return 1;
+	}
+
+	def.template_id                  = (uint8_t)(template_id >= 0 ? template_id : (is_ca ? 1 : 2));
+	def.chain_id                     = (uint8_t)chain_id;
+	def.private_key_slot             = (uint8_t)private_key_slot;
+	def.sn_source                    = sn_sources[sn_source].sn_source;
+	def.cert_sn_dev_loc.zone         = DEVZONE_NONE;
+	def.public_key_dev_loc.zone      = DEVZONE_DATA;
+	if (public_key_slot < 0 && !is_ca)
+	{
+		// Device public key comes straight from its private key
+		def.public_key_dev_loc.slot      = (uint8_t)private_key_slot;
+		def.public_key_dev_loc.is_genkey = 1;
+		def.public_key_dev_loc.count     = 64;
+	}
+	else
+	{
+		// Stored public key, padded to 72 bytes
+		def.public_key_dev_loc.slot  = (uint8_t)(public_key_slot >= 0 ? public_key_slot : 11);
+		def.public_key_dev_loc.count = 72;
+	}
+	def.comp_cert_dev_loc.zone  = DEVZONE_DATA;
+	def.comp_cert_dev_loc.slot  = (uint8_t)(comp_cert_slot >= 0 ? comp_cert_slot : (is_ca ? 12 : 10));
+	def.comp_cert_dev_loc.count = 72;
+
+	printf("/* Generated by extras/gen_cert_def from %s. */\n", path);
+	printf("#include \"atcacert/atcacert_def.h\"\n\n");
+	printf("const uint8_t g_cert_template_%s[] = {", name);
+	for (i = 0; i < def.cert_template_size; i++)
+	{
+		printf("%s0x%02X%s", (i % 16) == 0 ? "\n    " : ((i % 8) == 0 ? "  " : " "), cert[i],
+		       i == def.cert_template_size - 1 ? "\n" : ",");
+	}
+	printf("};\n\n");
+
+	has_midstate = print_midstate(name, &def);
+	if (has_midstate < 0)
+	{
+		return 1;
+	}
+	print_def(name, &def, sn_source, has_midstate);
+
+	return 0;
+}
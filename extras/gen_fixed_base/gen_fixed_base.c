@@ -0,0 +1,166 @@
+/**
+ * \file
+ * \brief Host-side generator for the fixed-base ECDSA verification tables.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Regenerate src/custom/custom_fixed_base.c whenever tag_signer_pubkey or
+ * g_signer_1_ca_public_key change:
+ *
+ *   gcc -I../../src -o gen_fixed_base gen_fixed_base.c \
+ *       ../../src/custom/custom_auth_def.c ../../src/custom/cert_def_1_signer.c \
+ *       ../../src/crypto/atca_crypto_sw_sha2.c ../../src/crypto/hashes/sha2_routines.c
+ *   ./gen_fixed_base > ../../src/custom/custom_fixed_base.c
+ *
+ * "./gen_fixed_base --curve" prints the body of curve_G_table for
+ * src/crypto/atca_crypto_sw_ecdsa.c.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "crypto/atca_crypto_sw_ecdsa.c"
+#include "custom/custom_auth_def.h"
+#include "custom/cert_def_1_signer.h"
+
+/* File header of the generated source, with the library license. */
+static const char* const file_header[] = {
+	"/**",
+	" * \\file",
+	" * \\brief Fixed-base comb tables for the compile-time public keys.",
+	" *",
+	" * Copyright (c) 2016 Astek Corporation. All rights reserved.",
+	" *",
+	" * \\astek_eguard_library_license_start",
+	" *",
+	" * \\page eGuard_License",
+	" * ",
+	" * The source code contained within is subject to Astek's eGuard licensing",
+	" * agreement located at: https://www.astekcorp.com/",
+	" *",
+	" * The eGuard product may be used in source and binary forms, with or without",
+	" * modifications, with the following conditions:",
+	" *",
+	" * 1. The source code must retain the above copyright notice, this list of",
+	" *    conditions, and the disclaimer.",
+	" *",
+	" * 2. Distribution of source code is not authorized.",
+	" *",
+	" * 3. This software may only be used in connection with an Astek eGuard",
+	" *    Product.",
+	" *",
+	" * DISCLAIMER: THIS SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, ",
+	" * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF",
+	" * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF",
+	" * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE",
+	" * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR",
+	" * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR",
+	" * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN",
+	" * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF",
+	" * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY",
+	" * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL",
+	" * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT",
+	" * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,",
+	" * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN",
+	" * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE",
+	" * OF THIS SOFTWARE.",
+	" * ",
+	" * \\astek_eguard_library_license_stop",
+	" *",
+	" * Generated by extras/gen_fixed_base from tag_signer_pubkey and g_signer_1_ca_public_key.",
+	" * Do not edit, rerun the generator whenever those keys change.",
+	" */",
+};
+
+static void print_table(const ecc_fixed_base_t* table)
+{
+	int i, j;
+
+	for (i = 0; i < ECC_FIXED_BASE_POINTS; i++)
+	{
+		printf("    {\n");
+		for (j = 0; j < ECC_BYTES * 2; j++)
+		{
+			printf("%s0x%02X,%s", (j % 16) == 0 ? "        " : "", table->point[i][j], (j % 16) == 15 ? "\n" : " ");
+		}
+		printf("    },\n");
+	}
+}
+
+static int emit_table(const char* name, const uint8_t* public_key)
+{
+	ecc_fixed_base_t table;
+
+	if (!ecc_fixed_base_precompute(public_key, &table))
+	{
+		fprintf(stderr, "gen_fixed_base: %s is not a valid public key\n", name);
+		return 1;
+	}
+	printf("const ecc_fixed_base_t %s ATCA_PROGMEM = { {\n", name);
+	print_table(&table);
+	printf("} };\n");
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	ecc_fixed_base_t table;
+	uint8_t generator[ECC_BYTES * 2];
+	size_t i;
+	int ret = 0;
+
+	if (argc > 1 && strcmp(argv[1], "--curve") == 0)
+	{
+		ecc_native2bytes(generator, curve_G.x);
+		ecc_native2bytes(generator + ECC_BYTES, curve_G.y);
+		if (!ecc_fixed_base_precompute(generator, &table))
+			return 1;
+		print_table(&table);
+		return 0;
+	}
+
+	for (i = 0; i < sizeof(file_header) / sizeof(file_header[0]); i++)
+	{
+		printf("%s\n", file_header[i]);
+	}
+	printf("#include \"custom_fixed_base.h\"\n\n");
+	ret |= emit_table("g_tag_signer_pubkey_table", tag_signer_pubkey);
+	printf("\n");
+	ret |= emit_table("g_signer_1_ca_public_key_table", g_signer_1_ca_public_key);
+
+	return ret;
+}
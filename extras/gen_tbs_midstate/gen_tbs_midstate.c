@@ -0,0 +1,101 @@
+/**
+ * \file
+ * \brief Host-side generator for the certificate templates' TBS midstate tables.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Prints the midstate table of each shipped certificate definition:
+ *
+ *   gcc -I../../src -o gen_tbs_midstate gen_tbs_midstate.c \
+ *       ../../src/atcacert/atcacert_def.c ../../src/atcacert/atcacert_der.c \
+ *       ../../src/atcacert/atcacert_date.c ../../src/custom/cert_def_1_signer.c \
+ *       ../../src/custom/cert_def_2_device.c ../../src/crypto/atca_crypto_sw_sha1.c \
+ *       ../../src/crypto/atca_crypto_sw_sha2.c ../../src/crypto/hashes/sha1_routines.c \
+ *       ../../src/crypto/hashes/sha2_routines.c
+ *   ./gen_tbs_midstate
+ *
+ * Rerun it whenever a certificate template changes, paste each table into the source file of
+ * its definition (src/custom/cert_def_1_signer.c, src/custom/cert_def_2_device.c) and point
+ * the definition's tbs_midstate at it. A definition whose first certificate element sits in the
+ * first SHA256 block of the TBS data has nothing to precompute and gets no table.
+ */
+#include <stdio.h>
+#include "atcacert/atcacert_def.h"
+#include "custom/cert_def_1_signer.h"
+#include "custom/cert_def_2_device.h"
+
+static int emit_midstate(const char* name, const atcacert_def_t* cert_def)
+{
+	atcacert_tbs_midstate_t midstate;
+	int i;
+
+	if (atcacert_get_tbs_midstate(cert_def, &midstate) != ATCA_SUCCESS)
+	{
+		fprintf(stderr, "gen_tbs_midstate: can't hash the template of %s\n", name);
+		return 1;
+	}
+	if (midstate.prefix_size == 0)
+	{
+		printf("/* %s: no constant TBS prefix, nothing to precompute. */\n", name);
+		return 0;
+	}
+
+	printf("const atcacert_tbs_midstate_t %s_tbs_midstate = {\n", name);
+	printf("    .prefix_size = %u,\n", (unsigned)midstate.prefix_size);
+	printf("    .hash        = {");
+	for (i = 0; i < 8; i++)
+	{
+		printf("%s0x%08lXUL%s", (i % 4) == 0 ? "\n        " : "", (unsigned long)midstate.hash[i], i == 7 ? "\n" : ",");
+	}
+	printf("    }\n");
+	printf("};\n");
+	return 0;
+}
+
+int main(void)
+{
+	int ret = 0;
+
+	printf("/* TBS midstate tables generated by extras/gen_tbs_midstate. Do not edit. */\n");
+	ret |= emit_midstate("g_cert_def_1_signer", &g_cert_def_1_signer);
+	printf("\n");
+	ret |= emit_midstate("g_cert_def_2_device", &g_cert_def_2_device);
+
+	return ret;
+}
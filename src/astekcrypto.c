@@ -46,6 +46,7 @@
 #include "custom/cert_def_2_device.h"
 #include "custom/custom_auth_def.h"
 #include "crypto/atca_crypto_sw_sha2.h"
+#include "crypto/atca_crypto_sw_rand.h"
 #include "atcacert/atcacert_host_hw.h"
 #include "authentication/Authenticate.h"
 #include "ecdsa/ecdsa.h"
@@ -84,6 +85,11 @@ ATCA_STATUS egGenRandom(uint8_t *randnum)
 	return atcab_random(randnum);
 }
 
+ATCA_STATUS egGenRandomBytes(uint8_t *data, size_t length)
+{
+	return atcac_sw_random(data, length);
+}
+
 ATCA_STATUS egSHA256(uint8_t* message, size_t length, uint8_t* digest)
 {
 	return atcab_sha(length, message, digest);				//generate digest of message using crypto IC
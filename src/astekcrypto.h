@@ -236,6 +236,20 @@ ATCA_STATUS egSerNum(uint8_t *sernum);
  **************************************************************************************************/
 ATCA_STATUS egGenRandom(uint8_t *randnum);
 
+/**********************************************************************************************//**
+ * \fn	ATCA_STATUS egGenRandomBytes(uint8_t *data, size_t length);
+ *
+ * \brief	eGuard Generate Random Bytes \n Fills a buffer of any length from the software DRBG
+ * 			pool. The pool is seeded from the crypto IC on first use and reseeded every
+ * 			ATCAC_DRBG_RESEED_INTERVAL refills, so most calls need no device I/O.
+ *
+ * \param [out]	data  	Buffer to receive the random bytes.
+ * \param 	  	length	Number of bytes requested.
+ *
+ * \return	Status of operation. Returns ATCA_SUCCESS on success, error code otherwise
+ **************************************************************************************************/
+ATCA_STATUS egGenRandomBytes(uint8_t *data, size_t length);
+
 /**********************************************************************************************//**
  * \fn	ATCA_STATUS egSHA256(uint8_t* message, size_t length, uint8_t* digest);
  *
@@ -235,4 +235,28 @@ ATCAIfaceCfg cfg_sha204_kithid_default = {
 	.atcahid.guid		= { 0x4d,		 0x1e, 0x55, 0xb2, 0xf1, 0x6f, 0x11, 0xcf, 0x88, 0xcb, 0x00, 0x11, 0x11, 0x00, 0x00, 0x30 },
 };
 
+#ifdef ATCA_HAL_SIM
+/** \brief default configuration for a provisioned, simulated ECCx08A device (host builds) */
+ATCAIfaceCfg cfg_ateccx08a_sim_default = {
+	.iface_type				= ATCA_SIM_IFACE,
+	.devtype				= ATECC508A,
+	.atcasim.instance		= 0,
+	.atcasim.provisioned	= 1,
+	.atcasim.seed			= 0,
+	.atcasim.baud			= 400000,
+	.wake_delay				= 800,
+	.rx_retries				= 20
+};
+#endif
+
+#ifdef ATCA_HAL_REPLAY
+/** \brief default configuration for replaying an ECCx08A trace, see hal/hal_trace.h (host builds) */
+ATCAIfaceCfg cfg_ateccx08a_replay_default = {
+	.iface_type				= ATCA_REPLAY_IFACE,
+	.devtype				= ATECC508A,
+	.wake_delay				= 800,
+	.rx_retries				= 20
+};
+#endif
+
 /** @} */
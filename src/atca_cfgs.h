@@ -119,6 +119,16 @@ extern ATCAIfaceCfg cfg_sha204_kithid_default;
 /** \brief example of a default configuration for AES132 SPI */
 extern ATCAIfaceCfg cfg_ataes132_spi_default;
 
+#ifdef ATCA_HAL_SIM
+/** \brief default configuration for a provisioned, simulated ECCx08A device */
+extern ATCAIfaceCfg cfg_ateccx08a_sim_default;
+#endif
+
+#ifdef ATCA_HAL_REPLAY
+/** \brief default configuration for replaying an ECCx08A trace */
+extern ATCAIfaceCfg cfg_ateccx08a_replay_default;
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -106,7 +106,6 @@
  */
 struct atca_command {
 	ATCADeviceType dt;
-	uint16_t *execution_times;
 };
 
 
@@ -133,308 +132,270 @@ ATCACommand newATCACommand( ATCADeviceType device_type )  // constructor
 
 // full superset of commands goes here
 
-/** \brief ATCACommand CheckMAC method
- * \param[in] cacmd   instance
- * \param[in] packet  pointer to the packet containing the command being built
+/** \brief packet size variants of every command, grouped per command in ATCA_CmdMap order.
+ *
+ * A command uses the first of its rows whose mode matches (param1 & mode_mask), so a row with a
+ * mask of zero is the fallback.  Rows with a non-zero data_max take param2 bytes of data on top
+ * of txsize.
+ */
+static const ATCACmdSize atca_cmd_sizes[] ATCA_PROGMEM = {
+	// mode_mask               mode                                    txsize                                  rxsize                  data_min        data_max
+	{ 0,                       0,                                      CHECKMAC_COUNT,                         CHECKMAC_RSP_SIZE,      0,              0 },                    // CheckMAC
+	{ 0,                       0,                                      COUNTER_COUNT,                          COUNTER_RSP_SIZE,       0,              0 },                    // Counter
+	{ 0,                       0,                                      DERIVE_KEY_COUNT_SMALL,                 DERIVE_KEY_RSP_SIZE,    0,              0 },                    // DeriveKey
+	{ 0,                       0,                                      ECDH_COUNT,                             ECDH_RSP_SIZE,          0,              0 },                    // ECDH
+	{ 0xFF,                    NONCE_MODE_MASK,                        GENDIG_COUNT + GENDIG_OTHER_DATA_SIZE,  GENDIG_RSP_SIZE,        0,              0 },                    // GenDig, shared nonce
+	{ 0,                       0,                                      GENDIG_COUNT,                           GENDIG_RSP_SIZE,        0,              0 },
+	{ 0,                       0,                                      GENKEY_COUNT,                           GENKEY_RSP_SIZE_LONG,   0,              0 },                    // GenKey
+	{ 0,                       0,                                      HMAC_COUNT,                             HMAC_RSP_SIZE,          0,              0 },                    // HMAC
+	{ 0,                       0,                                      INFO_COUNT,                             INFO_RSP_SIZE,          0,              0 },                    // Info
+	{ 0,                       0,                                      LOCK_COUNT,                             LOCK_RSP_SIZE,          0,              0 },                    // Lock
+	{ 0xFF,                    0,                                      MAC_COUNT_LONG,                         MAC_RSP_SIZE,           0,              0 },                    // MAC, with challenge
+	{ 0,                       0,                                      MAC_COUNT_SHORT,                        MAC_RSP_SIZE,           0,              0 },
+	{ NONCE_MODE_MASK,         NONCE_MODE_SEED_UPDATE,                 NONCE_COUNT_SHORT,                      NONCE_RSP_SIZE_LONG,    0,              0 },                    // Nonce
+	{ NONCE_MODE_MASK,         NONCE_MODE_NO_SEED_UPDATE,              NONCE_COUNT_SHORT,                      NONCE_RSP_SIZE_LONG,    0,              0 },
+	{ NONCE_MODE_MASK,         NONCE_MODE_PASSTHROUGH,                 NONCE_COUNT_LONG,                       NONCE_RSP_SIZE_SHORT,   0,              0 },
+	{ 0,                       0,                                      PAUSE_COUNT,                            PAUSE_RSP_SIZE,         0,              0 },                    // Pause
+	{ 0,                       0,                                      PRIVWRITE_COUNT,                        PRIVWRITE_RSP_SIZE,     0,              0 },                    // PrivWrite
+	{ 0,                       0,                                      RANDOM_COUNT,                           RANDOM_RSP_SIZE,        0,              0 },                    // Random
+	{ READ_ZONE_MASK,          0,                                      READ_COUNT,                             READ_4_RSP_SIZE,        0,              0 },                    // Read
+	{ 0,                       0,                                      READ_COUNT,                             READ_32_RSP_SIZE,       0,              0 },
+	{ 0xFF,                    SHA_MODE_SHA256_START,                  SHA_COUNT_LONG,                         SHA_RSP_SIZE_SHORT,     0,              0 },                    // SHA
+	{ 0xFF,                    SHA_MODE_SHA256_UPDATE,                 SHA_COUNT_LONG,                         SHA_RSP_SIZE_SHORT,     SHA_BLOCK_SIZE, SHA_BLOCK_SIZE },
+	{ 0xFF,                    SHA_MODE_SHA256_END,                    SHA_COUNT_LONG,                         SHA_RSP_SIZE_LONG,      0,              SHA_BLOCK_SIZE - 1 },
+	{ 0,                       0,                                      SIGN_COUNT,                             ATCA_RSP_SIZE_64,       0,              0 },                    // Sign, 64 or 72 byte response depending on the key
+	{ 0,                       0,                                      UPDATE_COUNT,                           UPDATE_RSP_SIZE,        0,              0 },                    // UpdateExtra
+	{ 0xFF,                    VERIFY_MODE_STORED,                     VERIFY_256_STORED_COUNT,                VERIFY_RSP_SIZE,        0,              0 },                    // Verify
+	{ 0xFF,                    VERIFY_MODE_VALIDATEEXTERNAL,           VERIFY_256_EXTERNAL_COUNT,              VERIFY_RSP_SIZE,        0,              0 },
+	{ 0xFF,                    VERIFY_MODE_EXTERNAL,                   VERIFY_256_EXTERNAL_COUNT,              VERIFY_RSP_SIZE,        0,              0 },
+	{ 0xFF,                    VERIFY_MODE_VALIDATE,                   VERIFY_256_VALIDATE_COUNT,              VERIFY_RSP_SIZE,        0,              0 },
+	{ 0xFF,                    VERIFY_MODE_INVALIDATE,                 VERIFY_256_VALIDATE_COUNT,              VERIFY_RSP_SIZE,        0,              0 },
+	{ WRITE_ZONE_WITH_MAC | ATCA_ZONE_READWRITE_32, WRITE_ZONE_WITH_MAC | ATCA_ZONE_READWRITE_32, WRITE_COUNT_LONG_MAC, WRITE_RSP_SIZE, 0,              0 },                    // Write
+	{ WRITE_ZONE_WITH_MAC | ATCA_ZONE_READWRITE_32, WRITE_ZONE_WITH_MAC, WRITE_COUNT_SHORT_MAC,                WRITE_RSP_SIZE,         0,              0 },
+	{ WRITE_ZONE_WITH_MAC | ATCA_ZONE_READWRITE_32, ATCA_ZONE_READWRITE_32, WRITE_COUNT_LONG,                  WRITE_RSP_SIZE,         0,              0 },
+	{ 0,                       0,                                      WRITE_COUNT_SHORT,                      WRITE_RSP_SIZE,         0,              0 },
+};
+
+/** \brief every command by ATCA_CmdMap: op-code, its rows in atca_cmd_sizes and the typical
+ *  execution times from the datasheets in milliseconds.  An execution time of 0 means the device
+ *  does not have the command.
+ */
+static const ATCACmdDef atca_cmd_defs[CMD_LASTCOMMAND] ATCA_PROGMEM = {
+	// opcode               first   rows    x08a    204a
+	{ 0,                    0,      0,      1,      3  },   // WAKE_TWHI
+	{ ATCA_CHECKMAC,        0,      1,      13,     38 },   // CMD_CHECKMAC
+	{ ATCA_COUNTER,         1,      1,      20,     0  },   // CMD_COUNTER
+	{ ATCA_DERIVE_KEY,      2,      1,      50,     62 },   // CMD_DERIVEKEY
+	{ ATCA_ECDH,            3,      1,      58,     0  },   // CMD_ECDH
+	{ ATCA_GENDIG,          4,      2,      11,     43 },   // CMD_GENDIG
+	{ ATCA_GENKEY,          6,      1,      115,    0  },   // CMD_GENKEY
+	{ ATCA_HMAC,            7,      1,      23,     69 },   // CMD_HMAC
+	{ ATCA_INFO,            8,      1,      2,      2  },   // CMD_INFO
+	{ ATCA_LOCK,            9,      1,      32,     24 },   // CMD_LOCK
+	{ ATCA_MAC,             10,     2,      14,     35 },   // CMD_MAC
+	{ ATCA_NONCE,           12,     3,      29,     60 },   // CMD_NONCE
+	{ ATCA_PAUSE,           15,     1,      3,      2  },   // CMD_PAUSE
+	{ ATCA_PRIVWRITE,       16,     1,      48,     0  },   // CMD_PRIVWRITE
+	{ ATCA_RANDOM,          17,     1,      23,     50 },   // CMD_RANDOM with SEED Update mode takes ~21ms, high side of range
+	{ ATCA_READ,            18,     2,      1,      4  },   // CMD_READMEM
+	{ ATCA_SHA,             20,     3,      9,      22 },   // CMD_SHA
+	{ ATCA_SIGN,            23,     1,      60,     0  },   // CMD_SIGN
+	{ ATCA_UPDATE_EXTRA,    24,     1,      10,     12 },   // CMD_UPDATEEXTRA
+	{ ATCA_VERIFY,          25,     5,      72,     0  },   // CMD_VERIFY
+	{ ATCA_WRITE,           30,     4,      26,     42 },   // CMD_WRITEMEM
+};
+
+/** \brief builds any command from the command tables
+ *
+ * Sets the op-code, the count and the expected response size of a packet whose param1, param2
+ * and data are already filled in, then computes its CRC.
+ * \param[in] cacmd   command set of the target device, used to reject commands the device
+ *                    does not have.  May be NULL to skip that check.
+ * \param[in] cmd     command to build
+ * \param[in,out] packet  packet to complete
+ * \param[in] extra   optional data bytes the mode does not imply (MAC, other data), added to
+ *                    the count
  * \return ATCA_STATUS
  */
-ATCA_STATUS atCheckMAC(ATCAPacket *packet )
+ATCA_STATUS atBuildPacket( ATCACommand cacmd, ATCA_CmdMap cmd, ATCAPacket *packet, uint8_t extra )
 {
-	// Set the opcode & parameters
-	packet->opcode = ATCA_CHECKMAC;
-	packet->txsize = CHECKMAC_COUNT;
-	packet->rxsize = CHECKMAC_RSP_SIZE;
+	ATCACmdDef def;
+	ATCACmdSize size;
+	uint8_t i;
+
+	if ( cmd <= WAKE_TWHI || cmd >= CMD_LASTCOMMAND )
+		return ATCA_BAD_OPCODE;
+
+	atca_memcpy_P( &def, &atca_cmd_defs[cmd], sizeof(def) );
+	if ( cacmd && (cacmd->dt == ATSHA204A ? def.exec_204a : def.exec_x08a) == 0 )
+		return ATCA_BAD_OPCODE;
+
+	for ( i = 0; i < def.rows; i++ ) {
+		atca_memcpy_P( &size, &atca_cmd_sizes[def.first + i], sizeof(size) );
+		if ( (packet->param1 & size.mode_mask) == size.mode )
+			break;
+	}
+	if ( i == def.rows )
+		return ATCA_BAD_PARAM;
+
+	if ( size.data_max ) {
+		if ( packet->param2 < size.data_min || packet->param2 > size.data_max )
+			return ATCA_BAD_PARAM;
+		extra += (uint8_t)packet->param2;
+	}
+
+	packet->opcode = def.opcode;
+	packet->txsize = size.txsize + extra;
+	packet->rxsize = size.rxsize;
 
 	atCalcCrc( packet );
 	return ATCA_SUCCESS;
 }
 
+/** \brief ATCACommand CheckMAC method
+ * \param[in] packet  pointer to the packet containing the command being built
+ * \return ATCA_STATUS
+ */
+ATCA_STATUS atCheckMAC( ATCAPacket *packet )
+{
+	return atBuildPacket( NULL, CMD_CHECKMAC, packet, 0 );
+}
+
 /** \brief ATCACommand Counter method
  * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
-ATCA_STATUS atCounter(ATCACommand cacmd, ATCAPacket *packet )
+ATCA_STATUS atCounter( ATCACommand cacmd, ATCAPacket *packet )
 {
-	if ( !atIsECCFamily( cacmd->dt ) )
-		return ATCA_BAD_OPCODE;
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_COUNTER;
-	packet->txsize = COUNTER_COUNT;
-	packet->rxsize = COUNTER_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( cacmd, CMD_COUNTER, packet, 0 );
 }
 
 /** \brief ATCACommand DeriveKey method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \param[in] hasMAC  hasMAC determines if MAC data is present in the packet input
  * \return ATCA_STATUS
  */
-ATCA_STATUS atDeriveKey(ATCAPacket *packet, bool hasMAC)
+ATCA_STATUS atDeriveKey( ATCAPacket *packet, bool hasMAC )
 {
-	// Set the opcode & parameters
-	packet->opcode = ATCA_DERIVE_KEY;
-
 	// hasMAC must be given since the packet does not have any implicit information to
 	// know if it has a mac or not unless the size is preset
-	if (hasMAC)
-	{
-		packet->txsize = DERIVE_KEY_COUNT_LARGE;
-	}
-	else
-	{
-		packet->txsize = DERIVE_KEY_COUNT_SMALL;
-	}
-
-	packet->rxsize = DERIVE_KEY_RSP_SIZE;
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_DERIVEKEY, packet, hasMAC ? DERIVE_KEY_COUNT_LARGE - DERIVE_KEY_COUNT_SMALL : 0 );
 }
 
 /** \brief ATCACommand ECDH method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
-ATCA_STATUS atECDH(ATCAPacket *packet )
+ATCA_STATUS atECDH( ATCAPacket *packet )
 {
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_ECDH;
-	packet->txsize = ECDH_COUNT;
-	packet->rxsize = ECDH_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_ECDH, packet, 0 );
 }
 
 /** \brief ATCACommand Generate Digest method
- * \param[in] cacmd     instance
- * \param[in] packet    pointer to the packet containing the command being built
- * \param[in] hasMACKey
+ * \param[in] packet     pointer to the packet containing the command being built
+ * \param[in] hasMACKey  true when 4 bytes of other data follow, ignored in shared nonce mode
  * \return ATCA_STATUS
  */
-ATCA_STATUS atGenDig(ATCAPacket *packet, bool hasMACKey)
+ATCA_STATUS atGenDig( ATCAPacket *packet, bool hasMACKey )
 {
+	bool other_data = hasMACKey && packet->param1 != NONCE_MODE_MASK;
 
-	// Set the opcode & parameters
-	packet->opcode = ATCA_GENDIG;
-
-	if ( packet->param1 == NONCE_MODE_MASK ) // shared nonce mode
-		packet->txsize = GENDIG_COUNT + GENDIG_OTHER_DATA_SIZE;
-	else if ( hasMACKey == true )
-		packet->txsize = GENDIG_COUNT_DATA;
-	else
-		packet->txsize = GENDIG_COUNT;
-
-	packet->rxsize = GENDIG_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_GENDIG, packet, other_data ? GENDIG_COUNT_DATA - GENDIG_COUNT : 0 );
 }
 
 /** \brief ATCACommand Generate Key method
- * \param[in] cacmd     instance
  * \param[in] packet    pointer to the packet containing the command being built
  * \param[in] isPubKey  indicates whether "other data" is present in packet
  * \return ATCA_STATUS
  */
-ATCA_STATUS atGenKey(ATCAPacket *packet, bool isPubKey)
+ATCA_STATUS atGenKey( ATCAPacket *packet, bool isPubKey )
 {
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_GENKEY;
-
-	if (isPubKey)
-	{
-		packet->txsize = GENKEY_COUNT_DATA;
-	}
-	else
-	{
-		packet->txsize = GENKEY_COUNT;	
-	}
-
-	packet->rxsize = GENKEY_RSP_SIZE_LONG;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_GENKEY, packet, isPubKey ? GENKEY_COUNT_DATA - GENKEY_COUNT : 0 );
 }
 
 /** \brief ATCACommand HMAC method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
-ATCA_STATUS atHMAC(ATCAPacket *packet )
+ATCA_STATUS atHMAC( ATCAPacket *packet )
 {
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_HMAC;
-	packet->txsize = HMAC_COUNT;
-	packet->rxsize = HMAC_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_HMAC, packet, 0 );
 }
 
 /** \brief ATCACommand Info method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
 ATCA_STATUS atInfo( ATCAPacket *packet )
 {
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_INFO;
-	packet->txsize = INFO_COUNT;
-	packet->rxsize = INFO_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_INFO, packet, 0 );
 }
 
 /** \brief ATCACommand Lock method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
-ATCA_STATUS atLock(  ATCAPacket *packet )
+ATCA_STATUS atLock( ATCAPacket *packet )
 {
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_LOCK;
-	packet->txsize = LOCK_COUNT;
-	packet->rxsize = LOCK_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_LOCK, packet, 0 );
 }
 
 /** \brief ATCACommand MAC method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
 ATCA_STATUS atMAC( ATCAPacket *packet )
 {
-
-	// Set the opcode & parameters
-	// variable packet size
-	packet->opcode = ATCA_MAC;
-	if ( packet->param1 == 0 )
-		packet->txsize = MAC_COUNT_LONG;
-	else
-		packet->txsize = MAC_COUNT_SHORT;
-
-	packet->rxsize = MAC_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_MAC, packet, 0 );
 }
 
 /** \brief ATCACommand Nonce method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
 ATCA_STATUS atNonce( ATCAPacket *packet )
 {
-	// Set the opcode & parameters
-	// variable packet size
-	packet->opcode = ATCA_NONCE;
-	int mode = packet->param1 & NONCE_MODE_MASK;
-
-	if ( (mode == NONCE_MODE_SEED_UPDATE || mode == NONCE_MODE_NO_SEED_UPDATE) ) {       // mode[0:1] == 0 | 1 then NumIn is 20 bytes
-		packet->txsize = NONCE_COUNT_SHORT; // 20 byte challenge
-		packet->rxsize = NONCE_RSP_SIZE_LONG;
-	} else if ( mode == NONCE_MODE_PASSTHROUGH ) {            // NumIn is 32 bytes
-		packet->txsize = NONCE_COUNT_LONG;  // 32 byte challenge
-		packet->rxsize = NONCE_RSP_SIZE_SHORT;
-	} else
-		return ATCA_BAD_PARAM;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_NONCE, packet, 0 );
 }
 
 /** \brief ATCACommand Pause method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
 ATCA_STATUS atPause( ATCAPacket *packet )
 {
-	// Set the opcode & parameters
-	packet->opcode = ATCA_PAUSE;
-	packet->txsize = PAUSE_COUNT;
-	packet->rxsize = PAUSE_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_PAUSE, packet, 0 );
 }
 
 /** \brief ATCACommand PrivWrite method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
 ATCA_STATUS atPrivWrite( ATCAPacket *packet )
 {
-	// Set the opcode & parameters
-	packet->opcode = ATCA_PRIVWRITE;
-	packet->txsize = PRIVWRITE_COUNT;
-	packet->rxsize = PRIVWRITE_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_PRIVWRITE, packet, 0 );
 }
 
 /** \brief ATCACommand Random method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
 ATCA_STATUS atRandom( ATCAPacket *packet )
 {
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_RANDOM;
-	packet->txsize = RANDOM_COUNT;
-	packet->rxsize = RANDOM_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_RANDOM, packet, 0 );
 }
 
 /** \brief ATCACommand Read method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
 ATCA_STATUS atRead( ATCAPacket *packet )
 {
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_READ;
-	packet->txsize = READ_COUNT;
-
-	// variable response size based on read type
-	if ((packet->param1 & READ_ZONE_MASK) == 0 )
-		packet->rxsize = READ_4_RSP_SIZE;
-	else
-		packet->rxsize = READ_32_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_READMEM, packet, 0 );
 }
 
 /** \brief ATCACommand SHA method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
@@ -443,149 +404,52 @@ ATCA_STATUS atSHA( ATCAPacket *packet )
 	if ( packet->param2 > SHA_BLOCK_SIZE )
 		return ATCA_BAD_PARAM;
 
-	if ( packet->param1 == SHA_MODE_SHA256_UPDATE && packet->param2 != SHA_BLOCK_SIZE )
-		return ATCA_BAD_PARAM;                                              // updates should always have 64 bytes of data
-
-	if ( packet->param1 == SHA_MODE_SHA256_END && packet->param2 > SHA_BLOCK_SIZE - 1 )    // END should be 0-63 bytes
-		return ATCA_BAD_PARAM;
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_SHA;
-
-	switch ( packet->param1 ) {
-	case SHA_MODE_SHA256_START: // START
-		packet->rxsize = SHA_RSP_SIZE_SHORT;
-		packet->txsize = SHA_COUNT_LONG;
-		break;
-	case SHA_MODE_SHA256_UPDATE: // UPDATE
-		packet->rxsize = SHA_RSP_SIZE_SHORT;
-		packet->txsize = SHA_COUNT_LONG + SHA_BLOCK_SIZE;
-		break;
-	case SHA_MODE_SHA256_END: // END
-		packet->rxsize = SHA_RSP_SIZE_LONG;
-		// check the given packet for a size variable in param2.  If it is > 0, it should
-		// be 0-63, incorporate that size into the packet
-		packet->txsize = SHA_COUNT_LONG + packet->param2;
-		break;
-	default:
-		return ATCA_BAD_PARAM;
-		break;
-	}
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_SHA, packet, 0 );
 }
 
 /** \brief ATCACommand Sign method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
 ATCA_STATUS atSign( ATCAPacket *packet )
 {
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_SIGN;
-	packet->txsize = SIGN_COUNT;
-
-	// could be a 64 or 72 byte response depending upon the key configuration for the KeyID
-	packet->rxsize = ATCA_RSP_SIZE_64;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_SIGN, packet, 0 );
 }
 
 /** \brief ATCACommand UpdateExtra method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
 ATCA_STATUS atUpdateExtra( ATCAPacket *packet )
 {
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_UPDATE_EXTRA;
-	packet->txsize = UPDATE_COUNT;
-	packet->rxsize = UPDATE_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_UPDATEEXTRA, packet, 0 );
 }
 
 /** \brief ATCACommand ECDSA Verify method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
 ATCA_STATUS atVerify( ATCAPacket *packet )
 {
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_VERIFY;
-
-	// variable packet size based on mode
-	switch ( packet->param1 ) {
-	case VERIFY_MODE_STORED:  // Stored mode
-		packet->txsize = VERIFY_256_STORED_COUNT;
-		break;
-	case VERIFY_MODE_VALIDATEEXTERNAL:  // ValidateExternal mode
-		packet->txsize = VERIFY_256_EXTERNAL_COUNT;
-		break;
-	case VERIFY_MODE_EXTERNAL:  // External mode
-		packet->txsize = VERIFY_256_EXTERNAL_COUNT;
-		break;
-	case VERIFY_MODE_VALIDATE:     // Validate mode
-	case VERIFY_MODE_INVALIDATE:     // Invalidate mode
-		packet->txsize = VERIFY_256_VALIDATE_COUNT;
-		break;
-	default:
-		return ATCA_BAD_PARAM;
-		break;
-	}
-	packet->rxsize = VERIFY_RSP_SIZE;
-
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_VERIFY, packet, 0 );
 }
 
 /** \brief ATCACommand Write method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
 ATCA_STATUS atWrite( ATCAPacket *packet )
 {
-	int macsize;
-	int writesize;
-
-	// Set the opcode & parameters
-	packet->opcode = ATCA_WRITE;
-
-	macsize = ( packet->param1 & WRITE_ZONE_WITH_MAC ? ATCA_ZONE_ACCESS_32 : 0 );  // if encrypted, use MAC
-	writesize = ( packet->param1 & ATCA_ZONE_READWRITE_32 ? ATCA_ZONE_ACCESS_32 : ATCA_ZONE_ACCESS_4 );
-
-	if ( macsize == WRITE_ZONE_WITH_MAC && writesize == ATCA_ZONE_ACCESS_32 )
-		packet->txsize = WRITE_COUNT_LONG_MAC;
-	else if ( macsize == WRITE_ZONE_WITH_MAC && writesize == ATCA_ZONE_ACCESS_4 )
-		packet->txsize = WRITE_COUNT_SHORT_MAC;
-	else if ( macsize == 0 && writesize == ATCA_ZONE_ACCESS_32 )
-		packet->txsize = WRITE_COUNT_LONG;
-	else if ( macsize == 0 && writesize == ATCA_ZONE_ACCESS_4 )
-		packet->txsize = WRITE_COUNT_SHORT;
-
-	packet->rxsize = WRITE_RSP_SIZE;
-	atCalcCrc( packet );
-	return ATCA_SUCCESS;
+	return atBuildPacket( NULL, CMD_WRITEMEM, packet, 0 );
 }
 
 /** \brief ATCACommand Write encrypted method
- * \param[in] cacmd   instance
  * \param[in] packet  pointer to the packet containing the command being built
  * \return ATCA_STATUS
  */
-ATCA_STATUS atWriteEnc(ATCAPacket *packet)
+ATCA_STATUS atWriteEnc( ATCAPacket *packet )
 {
-	// Set the opcode & parameters
+	// always 32 bytes of cipher text and a MAC, whatever the zone bits say
 	packet->opcode = ATCA_WRITE;
 	packet->txsize = WRITE_COUNT_LONG_MAC;
 	packet->rxsize = WRITE_RSP_SIZE;
@@ -605,62 +469,9 @@ void deleteATCACommand( ATCACommand *cacmd )  // destructor
 	*cacmd = NULL;
 }
 
-
-/** \brief execution times for x08a family, these are based on the typical value from the datasheet
- */
-uint16_t exectimes_x08a[] = {   // in milleseconds
-	1,                          // WAKE_TWHI
-	13,                         // CMD_CHECKMAC
-	20,                         // CMD_COUNTER
-	50,                         // CMD_DERIVEKEY
-	58,                         // CMD_ECDH
-	11,                         // CMD_GENDIG
-	115,                        // CMD_GENKEY
-	23,                         // CMD_HMAC
-	2,                          // CMD_INFO
-	32,                         // CMD_LOCK
-	14,                         // CMD_MAC
-	29,                         // CMD_NONCE
-	3,                          // CMD_PAUSE
-	48,                         // CMD_PRIVWRITE
-	23,                         // CMD_RANDOM with SEED Update mode takes ~21ms, high side of range
-	1,                          // CMD_READMEM
-	9,                          // CMD_SHA
-	60,                         // CMD_SIGN
-	10,                         // CMD_UPDATEEXTRA
-	72,                         // CMD_VERIFY
-	26                          // CMD_WRITE
-};
-
-
-/** \brief execution times for 204a, these are based on the typical value from the datasheet
- */
-uint16_t exectimes_204a[] = {
-	3,  // WAKE_TWHI
-	38, // CMD_CHECKMAC
-	0,
-	62, // CMD_DERIVEKEY
-	0,
-	43, // CMD_GENDIG
-	0,
-	69, // CMD_HMAC
-	2,  // CMD_DevRev
-	24, // CMD_LOCK
-	35, // CMD_MAC
-	60, // CMD_NONCE
-	2,  // CMD_PAUSE
-	0,
-	50, // CMD_RANDOM
-	4,  // CMD_READMEM
-	22, // CMD_SHA
-	0,
-	12, // CMD_UPDATEEXTRA
-	0,
-	42  // CMD_WRITEMEM
-};
-
 /** \brief initialize the execution times for a given device type
  *
+ * The times themselves live in the command table, this only checks the device type is known.
  * \param[in] cacmd - the command containing the list of execution times for the device
  * \param[in] device_type - the device type - execution times vary by device type
  * \return ATCA_STATUS
@@ -671,10 +482,8 @@ ATCA_STATUS atInitExecTimes(ATCACommand cacmd, ATCADeviceType device_type)
 	switch ( device_type ) {
 	case ATECC108A:
 	case ATECC508A:
-		cacmd->execution_times = exectimes_x08a;
-		break;
 	case ATSHA204A:
-		cacmd->execution_times = exectimes_204a;
+		cacmd->dt = device_type;
 		break;
 	default:
 		return ATCA_BAD_PARAM;
@@ -693,7 +502,33 @@ ATCA_STATUS atInitExecTimes(ATCACommand cacmd, ATCADeviceType device_type)
 
 uint16_t atGetExecTime( ATCACommand cacmd, ATCA_CmdMap cmd )
 {
-	return cacmd->execution_times[cmd];
+	ATCACmdDef def;
+
+	if ( cmd >= CMD_LASTCOMMAND )
+		return 0;
+
+	atca_memcpy_P( &def, &atca_cmd_defs[cmd], sizeof(def) );
+	return (cacmd->dt == ATSHA204A) ? def.exec_204a : def.exec_x08a;
+}
+
+/** \brief maps a command op-code to its entry in the command table
+ *
+ * \param[in] opcode - op-code byte of a command packet
+ * \return the ATCA_CmdMap entry, CMD_LASTCOMMAND for an unknown op-code
+ */
+
+ATCA_CmdMap atGetCmdMap( uint8_t opcode )
+{
+	ATCACmdDef def;
+	uint8_t cmd;
+
+	for ( cmd = CMD_CHECKMAC; cmd < CMD_LASTCOMMAND; cmd++ ) {
+		atca_memcpy_P( &def, &atca_cmd_defs[cmd], sizeof(def) );
+		if ( def.opcode == opcode )
+			return (ATCA_CmdMap)cmd;
+	}
+
+	return CMD_LASTCOMMAND;
 }
 
 
@@ -229,8 +229,29 @@ typedef enum {
 	CMD_LASTCOMMAND  // placeholder
 } ATCA_CmdMap;
 
+/** \brief One packet size variant of a command, picked by the mode bits in param1 */
+typedef struct {
+	uint8_t mode_mask;  //!< bits of param1 that select this variant, 0 matches any mode
+	uint8_t mode;       //!< value of the masked bits for this variant
+	uint8_t txsize;     //!< count of the command without variable data
+	uint8_t rxsize;     //!< expected response size
+	uint8_t data_min;   //!< smallest param2 data length when data_max is not 0
+	uint8_t data_max;   //!< largest param2 data length, 0 when param2 is not a data length
+} ATCACmdSize;
+
+/** \brief Table entry describing one command, indexed by ATCA_CmdMap */
+typedef struct {
+	uint8_t opcode;     //!< op-code byte
+	uint8_t first;      //!< index of the first ATCACmdSize row of the command
+	uint8_t rows;       //!< number of ATCACmdSize rows
+	uint8_t exec_x08a;  //!< typical execution time on ATECC108A/508A in ms, 0 if not supported
+	uint8_t exec_204a;  //!< typical execution time on ATSHA204A in ms, 0 if not supported
+} ATCACmdDef;
+
+ATCA_STATUS atBuildPacket( ATCACommand cacmd, ATCA_CmdMap cmd, ATCAPacket *packet, uint8_t extra );
 ATCA_STATUS atInitExecTimes(ATCACommand cacmd, ATCADeviceType device_type);
 uint16_t atGetExecTime( ATCACommand cacmd, ATCA_CmdMap cmd );
+ATCA_CmdMap atGetCmdMap( uint8_t opcode );
 
 void deleteATCACommand( ATCACommand *cacmd );      // destructor
 /*---- end of ATCACommand ----*/
@@ -116,4 +116,16 @@
 
 #endif
 
+/* Constant tables that should stay in program memory on Harvard targets
+   (AVR) and be copied out on demand. Other targets read them directly. */
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define ATCA_PROGMEM                    PROGMEM
+#define atca_memcpy_P(dst, src, len)    memcpy_P((dst), (src), (len))
+#else
+#include <string.h>
+#define ATCA_PROGMEM
+#define atca_memcpy_P(dst, src, len)    memcpy((dst), (src), (len))
+#endif
+
 #endif /* ATCA_COMPILER_H_ */
\ No newline at end of file
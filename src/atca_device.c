@@ -99,6 +99,7 @@
 struct atca_device {
 	ATCACommand mCommands;  // has-a command set to support a given CryptoAuth device
 	ATCAIface mIface;       // has-a physical interface
+	ATCAPacket mPacket;     // reusable command/response buffer, see atGetPacket()
 };
 
 /** \brief constructor for an Atmel CryptoAuth device
@@ -144,6 +145,20 @@ ATCAIface atGetIFace( ATCADevice dev )
 	return dev->mIface;
 }
 
+/** \brief returns the device's own packet buffer
+ *
+ * Callers can build a command directly in this buffer and read the response out of it once the
+ * command has executed, instead of keeping an ATCAPacket on the stack and copying payloads in
+ * and out.  The contents are only valid until the next command is sent to the device.
+ * \param[in] dev  device instance
+ * \return pointer to the packet owned by the device
+ */
+
+ATCAPacket* atGetPacket( ATCADevice dev )
+{
+	return &dev->mPacket;
+}
+
 /** \brief destructor for a device NULLs reference after object is freed
  * \param[in] cadev  pointer to a reference to a device
  *
@@ -104,6 +104,7 @@ ATCADevice newATCADevice(ATCAIfaceCfg *cfg );  // constructor
 /* member functions here */
 ATCACommand atGetCommands( ATCADevice dev );
 ATCAIface atGetIFace( ATCADevice dev );
+ATCAPacket* atGetPacket( ATCADevice dev );
 
 void deleteATCADevice( ATCADevice *cadev );    // destructor
 /*---- end of OATCADevice ----*/
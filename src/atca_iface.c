@@ -86,7 +86,9 @@
  * \atmel_crypto_device_library_license_stop
  */
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "atca_iface.h"
 #include "hal/atca_hal.h"
 
@@ -112,6 +114,14 @@ struct atca_iface {
 	ATCA_STATUS (*atidle)(ATCAIface hal);
 	ATCA_STATUS (*atsleep)(ATCAIface hal);
 
+	ATCAIfaceStats mStats;      // traffic counters, see atgetifacestats()
+	ATCA_CmdMap mCmd;           // command sent last, CMD_LASTCOMMAND after an idle, sleep or wake
+#ifdef ATCA_IFACE_INSTRUMENT
+	ATCAIfaceCmdStats mCmdStats[CMD_LASTCOMMAND + 1];   // per command counters, last entry is outside any command
+	uint16_t mPendingWakes;     // wakes not yet charged to a command
+	uint32_t mDelayMark;        // atca_delay_elapsed_us() when charging last stopped
+#endif
+
 	// treat as private
 	void *hal_data;     // generic pointer used by HAL to point to architecture specific structure
 	                    // no ATCA object should touch this except HAL, HAL manages this pointer and memory it points to
@@ -130,6 +140,7 @@ ATCAIface newATCAIface(ATCAIfaceCfg *cfg)  // constructor
 
 	caiface->mType = cfg->iface_type;
 	caiface->mIfaceCFG = cfg;
+	atresetifacestats(caiface);
 
 	if (atinit(caiface) != ATCA_SUCCESS) {
 		free(caiface);
@@ -159,31 +170,178 @@ ATCA_STATUS atinit(ATCAIface caiface)
 	return status;
 }
 
+#ifdef ATCA_IFACE_INSTRUMENT
+/** \brief charges the delay time since the last charge to the current command */
+static void _atchargedelay(ATCAIface caiface)
+{
+	uint32_t now = atca_delay_elapsed_us();
+
+	caiface->mCmdStats[caiface->mCmd].delay_us += now - caiface->mDelayMark;
+	caiface->mDelayMark = now;
+}
+#endif
+
 ATCA_STATUS atsend(ATCAIface caiface, uint8_t *txdata, uint16_t txlength)
 {
+	caiface->mStats.tx_bytes += txlength;
+	// txdata is an ATCAPacket, the op-code follows the reserved and count bytes
+	caiface->mCmd = (txlength > ATCA_OPCODE_IDX) ? atGetCmdMap(txdata[ATCA_OPCODE_IDX + 1]) : CMD_LASTCOMMAND;
+#ifdef ATCA_IFACE_INSTRUMENT
+	caiface->mCmdStats[caiface->mCmd].calls++;
+	caiface->mCmdStats[caiface->mCmd].tx_bytes += txlength;
+	caiface->mCmdStats[caiface->mCmd].wakes += caiface->mPendingWakes;
+	caiface->mPendingWakes = 0;
+	_atchargedelay(caiface);
+#endif
 	return caiface->atsend(caiface, txdata, txlength);
 }
 
 ATCA_STATUS atreceive( ATCAIface caiface, uint8_t *rxdata, uint16_t *rxlength)
 {
-	return caiface->atreceive(caiface, rxdata, rxlength);
+	ATCA_STATUS status = caiface->atreceive(caiface, rxdata, rxlength);
+
+	if (status == ATCA_SUCCESS)
+		caiface->mStats.rx_bytes += *rxlength;
+#ifdef ATCA_IFACE_INSTRUMENT
+	_atchargedelay(caiface);
+	if (status == ATCA_SUCCESS) {
+		caiface->mCmdStats[caiface->mCmd].rx_bytes += *rxlength;
+		if (*rxlength >= ATCA_RSP_SIZE_MIN && rxdata[ATCA_COUNT_IDX] <= *rxlength && rxdata[ATCA_COUNT_IDX] >= ATCA_RSP_SIZE_MIN
+		    && atCheckCrc(rxdata) != ATCA_SUCCESS)
+			caiface->mCmdStats[caiface->mCmd].crc_errors++;
+	}
+#endif
+	return status;
 }
 
 ATCA_STATUS atwake(ATCAIface caiface)
 {
+	caiface->mStats.wakes++;
+#ifdef ATCA_IFACE_INSTRUMENT
+	_atchargedelay(caiface);
+	caiface->mPendingWakes++;
+#endif
+	caiface->mCmd = CMD_LASTCOMMAND;
 	return caiface->atwake(caiface);
 }
 
 ATCA_STATUS atidle(ATCAIface caiface)
 {
+	ATCA_STATUS status;
+
+	caiface->mStats.idles++;
 	atca_delay_ms(CMD_DELAY);
-	return caiface->atidle(caiface);
+	status = caiface->atidle(caiface);
+#ifdef ATCA_IFACE_INSTRUMENT
+	_atchargedelay(caiface);
+#endif
+	caiface->mCmd = CMD_LASTCOMMAND;
+	return status;
 }
 
 ATCA_STATUS atsleep(ATCAIface caiface)
 {
+	ATCA_STATUS status;
+
+	caiface->mStats.sleeps++;
 	atca_delay_ms(CMD_DELAY);
-	return caiface->atsleep(caiface);
+	status = caiface->atsleep(caiface);
+#ifdef ATCA_IFACE_INSTRUMENT
+	_atchargedelay(caiface);
+#endif
+	caiface->mCmd = CMD_LASTCOMMAND;
+	return status;
+}
+
+/** \brief starts the retries of a HAL receive under the policy for the current command
+ * \param[in] caiface  instance
+ * \param[out] retry   state to pass to atretrynext() and atretrydone()
+ */
+void atretrystart(ATCAIface caiface, ATCARetryState *retry)
+{
+	const ATCARetryPolicy *policy = caiface->mIfaceCFG->rx_policy;
+
+	if (policy != NULL) {
+		while (policy->cmd != caiface->mCmd && policy->cmd != CMD_LASTCOMMAND)
+			policy++;
+	}
+
+	retry->policy = policy;
+	retry->attempts = 1;
+	retry->waited_us = 0;
+	if (policy != NULL && policy->attempts != 0)
+		retry->limit = policy->attempts;
+	else if (policy != NULL && policy->type == ATCA_RETRY_DEADLINE && policy->deadline_us != 0 && policy->delay_us != 0)
+		retry->limit = 0;   // the waits add up to the deadline, which ends the retries
+	else
+		retry->limit = (caiface->mIfaceCFG->rx_retries > 0) ? (uint16_t)caiface->mIfaceCFG->rx_retries : 1;
+}
+
+/** \brief called after a failed receive attempt, waits as the policy says
+ * \param[in] caiface  instance
+ * \param[in,out] retry  state from atretrystart()
+ * \return true to make another attempt, false to give up
+ */
+bool atretrynext(ATCAIface caiface, ATCARetryState *retry)
+{
+	const ATCARetryPolicy *policy = retry->policy;
+	uint32_t wait = 0;
+
+	(void)caiface;
+
+	if (retry->limit != 0 && retry->attempts >= retry->limit)
+		return false;
+
+	if (policy != NULL) {
+		switch (policy->type) {
+		case ATCA_RETRY_LINEAR:
+			wait = (uint32_t)policy->delay_us * retry->attempts;
+			break;
+		case ATCA_RETRY_EXPONENTIAL:
+			wait = (retry->attempts > 16) ? UINT32_MAX : (uint32_t)policy->delay_us << (retry->attempts - 1);
+			break;
+		default:
+			wait = policy->delay_us;
+			break;
+		}
+		if (policy->max_delay_us != 0 && wait > policy->max_delay_us)
+			wait = policy->max_delay_us;
+		if (policy->deadline_us != 0 && wait > policy->deadline_us - retry->waited_us)
+			return false;
+	}
+
+	if (wait != 0) {
+		// whole milliseconds first, atca_delay_us() is only meant for short waits
+		if (wait >= 1000)
+			atca_delay_ms(wait / 1000);
+		if (wait % 1000 != 0)
+			atca_delay_us(wait % 1000);
+		retry->waited_us += wait;
+	}
+	retry->attempts++;
+
+	return true;
+}
+
+/** \brief counts the retries and waits of a finished HAL receive
+ * \param[in] caiface  instance
+ * \param[in] retry    state from atretrystart()
+ * \param[in] status   result of the last attempt
+ */
+void atretrydone(ATCAIface caiface, ATCARetryState *retry, ATCA_STATUS status)
+{
+	uint16_t retries = retry->attempts - 1;
+
+	caiface->mStats.rx_retries += retries;
+	caiface->mStats.rx_wait_us += retry->waited_us;
+	if (status != ATCA_SUCCESS)
+		caiface->mStats.rx_timeouts++;
+#ifdef ATCA_IFACE_INSTRUMENT
+	caiface->mCmdStats[caiface->mCmd].retries += retries;
+	caiface->mCmdStats[caiface->mCmd].retry_wait_us += retry->waited_us;
+	if (status != ATCA_SUCCESS)
+		caiface->mCmdStats[caiface->mCmd].timeouts++;
+#endif
 }
 
 ATCAIfaceCfg * atgetifacecfg(ATCAIface caiface)
@@ -196,6 +354,100 @@ void* atgetifacehaldat(ATCAIface caiface)
 	return caiface->hal_data;
 }
 
+/** \brief traffic counters of an interface
+ * \param[in] caiface  instance
+ * \return counters since the interface was created or atresetifacestats() was called
+ */
+const ATCAIfaceStats* atgetifacestats(ATCAIface caiface)
+{
+	return &caiface->mStats;
+}
+
+/** \brief zeroes the traffic counters of an interface
+ * \param[in] caiface  instance
+ */
+void atresetifacestats(ATCAIface caiface)
+{
+	memset(&caiface->mStats, 0, sizeof(caiface->mStats));
+	caiface->mCmd = CMD_LASTCOMMAND;
+#ifdef ATCA_IFACE_INSTRUMENT
+	memset(caiface->mCmdStats, 0, sizeof(caiface->mCmdStats));
+	caiface->mPendingWakes = 0;
+	caiface->mDelayMark = atca_delay_elapsed_us();
+#endif
+}
+
+/** \brief the command the interface last sent, for a HAL that needs to treat commands differently
+ * \param[in] caiface  instance
+ * \return the command, CMD_LASTCOMMAND when none is in progress
+ */
+ATCA_CmdMap atgetifacecmd(ATCAIface caiface)
+{
+	return caiface->mCmd;
+}
+
+/** \brief per command counters of an interface, requires ATCA_IFACE_INSTRUMENT
+ * \param[in] caiface  instance
+ * \param[in] cmd      command, CMD_LASTCOMMAND for traffic outside any command
+ * \return counters since the interface was created or reset, NULL without ATCA_IFACE_INSTRUMENT
+ */
+const ATCAIfaceCmdStats* atgetifacecmdstats(ATCAIface caiface, ATCA_CmdMap cmd)
+{
+#ifdef ATCA_IFACE_INSTRUMENT
+	if (cmd <= CMD_LASTCOMMAND)
+		return &caiface->mCmdStats[cmd];
+#else
+	(void)caiface;
+	(void)cmd;
+#endif
+	return NULL;
+}
+
+#ifdef ATCA_IFACE_INSTRUMENT
+static const char * const _atcmdnames[CMD_LASTCOMMAND + 1] = {
+	"wake", "checkmac", "counter", "derivekey", "ecdh", "gendig", "genkey", "hmac", "info", "lock", "mac",
+	"nonce", "pause", "privwrite", "random", "read", "sha", "sign", "updateextra", "verify", "write", "other"
+};
+#endif
+
+/** \brief writes the counters of an interface as CSV lines, e.g. to Serial.println
+ *
+ * The first line is the header, then one line per command that was used:
+ * cmd,calls,tx_bytes,rx_bytes,wakes,retries,timeouts,retry_wait_us,crc_errors,delay_us. Without ATCA_IFACE_INSTRUMENT only
+ * a "total" line with the ATCAIfaceStats counters is written.
+ * \param[in] caiface  instance
+ * \param[in] dump     receives each line, without a line ending
+ * \param[in] context  passed through to dump
+ */
+void atdumpifacestats(ATCAIface caiface, ATCAIfaceDumpLine dump, void *context)
+{
+	char line[96];
+#ifdef ATCA_IFACE_INSTRUMENT
+	const ATCAIfaceCmdStats *cmd;
+	int i;
+#endif
+
+	dump("cmd,calls,tx_bytes,rx_bytes,wakes,retries,timeouts,retry_wait_us,crc_errors,delay_us", context);
+
+#ifdef ATCA_IFACE_INSTRUMENT
+	_atchargedelay(caiface);
+	for (i = 0; i <= CMD_LASTCOMMAND; i++) {
+		cmd = &caiface->mCmdStats[i];
+		if (cmd->calls == 0 && cmd->wakes == 0 && cmd->delay_us == 0)
+			continue;
+		snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%u,%u,%u,%lu,%u,%lu", _atcmdnames[i], (unsigned long)cmd->calls,
+		         (unsigned long)cmd->tx_bytes, (unsigned long)cmd->rx_bytes, (unsigned)cmd->wakes, (unsigned)cmd->retries,
+		         (unsigned)cmd->timeouts, (unsigned long)cmd->retry_wait_us, (unsigned)cmd->crc_errors, (unsigned long)cmd->delay_us);
+		dump(line, context);
+	}
+#endif
+
+	snprintf(line, sizeof(line), "total,,%lu,%lu,%u,%u,%u,%lu,,", (unsigned long)caiface->mStats.tx_bytes,
+	         (unsigned long)caiface->mStats.rx_bytes, (unsigned)caiface->mStats.wakes, (unsigned)caiface->mStats.rx_retries,
+	         (unsigned)caiface->mStats.rx_timeouts, (unsigned long)caiface->mStats.rx_wait_us);
+	dump(line, context);
+}
+
 void deleteATCAIface(ATCAIface *caiface) // destructor
 {
 	if ( *caiface ) {
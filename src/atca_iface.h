@@ -107,10 +107,48 @@ typedef enum {
 	ATCA_SWI_IFACE,
 	ATCA_UART_IFACE,
 	ATCA_SPI_IFACE,
-	ATCA_HID_IFACE
+	ATCA_HID_IFACE,
+	ATCA_SIM_IFACE,
+	ATCA_REPLAY_IFACE   // answers from a recorded trace, see hal/hal_trace.h
 	// additional physical interface types here
 } ATCAIfaceType;
 
+/* ATCARetryPolicy says how a HAL receive polls a device that is still executing and NACKs its address.
+   Attempt n + 1 follows attempt n after a wait of delay_us for ATCA_RETRY_FIXED and ATCA_RETRY_DEADLINE,
+   n * delay_us for ATCA_RETRY_LINEAR and delay_us * 2^(n - 1) for ATCA_RETRY_EXPONENTIAL, each wait
+   capped at max_delay_us when that is not 0. The receive gives up after attempts attempts (rx_retries
+   when 0) or once the waits would pass deadline_us when that is not 0. An ATCA_RETRY_DEADLINE policy
+   with attempts 0 is bounded by its deadline alone, which needs deadline_us and delay_us both set;
+   otherwise it falls back to rx_retries too.
+
+   ATCAIfaceCfg.rx_policy points to an array of policies ending with a CMD_LASTCOMMAND entry, the
+   default; the first entry for the command being received from, or the default, applies. With no
+   policy, rx_retries attempts are made back to back. */
+
+typedef enum {
+	ATCA_RETRY_FIXED,
+	ATCA_RETRY_LINEAR,
+	ATCA_RETRY_EXPONENTIAL,
+	ATCA_RETRY_DEADLINE
+} ATCARetryType;
+
+typedef struct {
+	ATCA_CmdMap cmd;        // command the entry applies to, CMD_LASTCOMMAND for the default entry
+	ATCARetryType type;
+	uint16_t delay_us;      // first wait between attempts
+	uint16_t max_delay_us;  // longest single wait, 0 for no limit
+	uint16_t attempts;      // most attempts, 0 for rx_retries
+	uint32_t deadline_us;   // most time spent waiting, 0 for no limit
+} ATCARetryPolicy;
+
+/** \brief progress of one receive through its retry policy, see atretrystart() */
+typedef struct {
+	const ATCARetryPolicy *policy;
+	uint16_t attempts;      // attempts made
+	uint16_t limit;         // attempts allowed, 0 for no limit
+	uint32_t waited_us;     // time spent waiting between attempts
+} ATCARetryState;
+
 /* ATCAIfaceCfg is a mediator object between a completely abstract notion of a physical interface and an actual physical interface.
 
     The main purpose of it is to keep hardware specifics from bleeding into the higher levels - hardware specifics could include
@@ -127,7 +165,7 @@ typedef struct {
 		struct ATCAI2C {
 			uint8_t slave_address;  // 8-bit slave address
 			uint8_t bus;            // logical i2c bus number, 0-based - HAL will map this to a pin pair for SDA SCL
-			uint32_t baud;          // typically 400000
+			uint32_t baud;          // typically 400000, 1000000 (Fast-mode Plus) where the pull-ups allow
 		} atcai2c;
 
 		struct ATCASWI {
@@ -150,13 +188,57 @@ typedef struct {
 			uint8_t guid[ATCAHID_SIZE];       // The GUID for this HID device
 		} atcahid;
 
+		struct ATCASIM {
+			uint8_t instance;       // simulated device, 0-based - see hal/hal_sim.h
+			uint8_t provisioned;    // 1 to start from locked zones with keys, 0 for a blank device
+			uint32_t seed;          // seeds the serial number, keys and random numbers of the device
+			uint32_t baud;          // bus speed charged to the simulated clock, 0 for none
+		} atcasim;
+
 	};
 
 	uint16_t wake_delay;    // microseconds of tWHI + tWLO which varies based on chip type
 	int rx_retries;         // the number of retries to attempt for receiving bytes
+	const ATCARetryPolicy *rx_policy;   // how to pace those retries, NULL for back to back
 	void     *cfg_data;     // opaque data used by HAL in device discovery
 } ATCAIfaceCfg;
 
+/* ATCAIfaceStats counts the traffic an interface has carried since it was created or last reset. Every
+   ATCAIface keeps one, the counters wrap silently. */
+
+typedef struct {
+	uint32_t tx_bytes;      // bytes handed to the HAL send, not counting the word address the HAL adds
+	uint32_t rx_bytes;      // bytes returned by the HAL receive
+	uint16_t wakes;         // wake attempts
+	uint16_t idles;         // idle attempts
+	uint16_t sleeps;        // sleep attempts
+	uint16_t rx_retries;    // receive attempts beyond the first
+	uint16_t rx_timeouts;   // receives that ran out of retries
+	uint32_t rx_wait_us;    // time waited between receive attempts
+} ATCAIfaceStats;
+
+/* With ATCA_IFACE_INSTRUMENT defined in the compiler settings each ATCAIface also keeps an
+   ATCAIfaceCmdStats per ATCA_CmdMap entry (about 500 bytes of RAM). A command is charged from the
+   wake that precedes it to the idle or sleep that ends it, so the wake delay and the execution wait
+   land on the command they were for. Traffic outside any command, such as a wake that is never
+   followed by a command, is charged to the CMD_LASTCOMMAND entry. */
+
+//#define ATCA_IFACE_INSTRUMENT
+
+typedef struct {
+	uint32_t calls;         // packets sent with this op-code
+	uint32_t tx_bytes;      // bytes sent
+	uint32_t rx_bytes;      // bytes received
+	uint32_t delay_us;      // microseconds spent in the atca_delay functions
+	uint16_t wakes;         // wakes issued for the command
+	uint16_t retries;       // receive attempts beyond the first
+	uint16_t timeouts;      // receives that ran out of retries
+	uint32_t retry_wait_us; // time waited between receive attempts, part of delay_us
+	uint16_t crc_errors;    // responses that failed the CRC check
+} ATCAIfaceCmdStats;
+
+typedef void (*ATCAIfaceDumpLine)(const char *line, void *context);
+
 typedef struct atca_iface * ATCAIface;
 ATCAIface newATCAIface(ATCAIfaceCfg *cfg);  // constructor
 // IFace methods
@@ -171,6 +253,16 @@ ATCA_STATUS atsleep(ATCAIface caiface);
 // accessors
 ATCAIfaceCfg * atgetifacecfg(ATCAIface caiface);
 void* atgetifacehaldat(ATCAIface caiface);
+const ATCAIfaceStats* atgetifacestats(ATCAIface caiface);
+void atresetifacestats(ATCAIface caiface);
+const ATCAIfaceCmdStats* atgetifacecmdstats(ATCAIface caiface, ATCA_CmdMap cmd);
+void atdumpifacestats(ATCAIface caiface, ATCAIfaceDumpLine dump, void *context);
+ATCA_CmdMap atgetifacecmd(ATCAIface caiface);
+
+// receive retries, used by the HAL
+void atretrystart(ATCAIface caiface, ATCARetryState *retry);
+bool atretrynext(ATCAIface caiface, ATCARetryState *retry);
+void atretrydone(ATCAIface caiface, ATCARetryState *retry, ATCA_STATUS status);
 
 void deleteATCAIface(ATCAIface *caiface);      // destructor
 /*---- end of OATCAIface ----*/
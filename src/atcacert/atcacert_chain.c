@@ -0,0 +1,376 @@
+/**
+ * \file
+ * \brief Verification of certificate chains of any depth.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#include <string.h>
+#include "atcacert_chain.h"
+#include "atcacert_client.h"
+#include "basic/atca_basic.h"
+#include "crypto/atca_crypto_sw_ecdsa.h"
+
+#if ATCACERT_CHAIN_THREADS > 1
+#include <pthread.h>
+#endif
+
+static int atcacert_chain_start_sw(const uint8_t tbs_digest[32], const uint8_t signature[64], const uint8_t issuer_public_key[64], const void* context)
+{
+	(void)context;
+	return atcac_sw_ecdsa_verify_p256(tbs_digest, signature, issuer_public_key);
+}
+
+static int atcacert_chain_start_fixed_sw(const uint8_t tbs_digest[32], const uint8_t signature[64], const uint8_t issuer_public_key[64], const void* context)
+{
+	const ecc_fixed_base_t* table = (const ecc_fixed_base_t*)context;
+	uint8_t table_public_key[64];
+
+	if (table == NULL || issuer_public_key == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	// The table's first entry is the key it was built from, it has to be the link's issuer
+	atca_memcpy_P(table_public_key, table->point[0], sizeof(table_public_key));
+	if (memcmp(table_public_key, issuer_public_key, sizeof(table_public_key)) != 0)
+		return ATCACERT_E_VERIFY_FAILED;
+
+	return atcac_sw_ecdsa_verify_p256_fixed(tbs_digest, signature, table);
+}
+
+static int atcacert_chain_start_hw(const uint8_t tbs_digest[32], const uint8_t signature[64], const uint8_t issuer_public_key[64], const void* context)
+{
+	(void)context;
+	return atcab_verify_extern_start(tbs_digest, signature, issuer_public_key);
+}
+
+static int atcacert_chain_finish_hw(const void* context)
+{
+	ATCA_STATUS status;
+	bool is_verified = false;
+
+	(void)context;
+	status = atcab_verify_extern_finish(&is_verified);
+	if (status != ATCA_SUCCESS)
+		return status;
+
+	return is_verified ? ATCA_SUCCESS : ATCACERT_E_VERIFY_FAILED;
+}
+
+const atcacert_chain_verifier_t atcacert_chain_verifier_sw       = { atcacert_chain_start_sw, NULL, true };
+const atcacert_chain_verifier_t atcacert_chain_verifier_fixed_sw = { atcacert_chain_start_fixed_sw, NULL, true };
+const atcacert_chain_verifier_t atcacert_chain_verifier_hw       = { atcacert_chain_start_hw, atcacert_chain_finish_hw, false };
+
+#if ATCACERT_CHAIN_SHARED_SCRATCH
+//! Scratch for the callers that don't bring their own
+static atcacert_chain_scratch_t g_chain_scratch;
+#endif
+
+/** \brief Extracts the TBS digest, signature and subject public key of a link. */
+static int atcacert_chain_prepare( const atcacert_chain_link_t* link,
+                                   atcacert_chain_item_t*       item)
+{
+	int ret = ATCA_SUCCESS;
+
+	if (link->cert_def == NULL || link->cert == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (link->tbs_digest != NULL)
+		memcpy(item->tbs_digest, link->tbs_digest, sizeof(item->tbs_digest));
+	else {
+		ret = atcacert_get_tbs_digest(link->cert_def, link->cert, link->cert_size, item->tbs_digest);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+
+	ret = atcacert_get_signature(link->cert_def, link->cert, link->cert_size, item->signature);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	return atcacert_get_subj_public_key(link->cert_def, link->cert, link->cert_size, item->subj_public_key);
+}
+
+/** \brief Checks the links one after the other, overlapping a background verifier with the
+ *         extraction of the next link. */
+static int atcacert_chain_walk( const atcacert_chain_link_t*     links,
+                                size_t count,
+                                const uint8_t root_public_key[64],
+                                const atcacert_chain_verifier_t* verifier,
+                                atcacert_chain_scratch_t*        scratch,
+                                const uint8_t**                  leaf_public_key)
+{
+	int ret = ATCA_SUCCESS;
+	int status;
+	const uint8_t* issuer_public_key = root_public_key;
+	const atcacert_chain_verifier_t* link_verifier;
+	const atcacert_chain_verifier_t* pending = NULL;
+	const void* pending_context = NULL;
+	atcacert_chain_item_t* item;
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		item = &scratch->items[i & 1];
+		ret = atcacert_chain_prepare(&links[i], item);
+
+		if (pending != NULL) {
+			status = pending->finish(pending_context);
+			pending = NULL;
+			if (status != ATCA_SUCCESS)
+				return status;
+		}
+		if (ret != ATCA_SUCCESS)
+			return ret;
+
+		link_verifier = (links[i].verifier != NULL) ? links[i].verifier : verifier;
+		ret = link_verifier->start(item->tbs_digest, item->signature, issuer_public_key, links[i].verifier_context);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+		if (link_verifier->finish != NULL) {
+			pending = link_verifier;
+			pending_context = links[i].verifier_context;
+		}
+		issuer_public_key = item->subj_public_key;
+	}
+
+	if (pending != NULL) {
+		ret = pending->finish(pending_context);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+
+	if (leaf_public_key != NULL)
+		*leaf_public_key = issuer_public_key;
+
+	return ATCA_SUCCESS;
+}
+
+#if ATCACERT_CHAIN_THREADS > 1
+
+/** \brief Links shared by the verifying threads, each takes the next unchecked one */
+typedef struct {
+	const atcacert_chain_link_t*     links;
+	const atcacert_chain_item_t*     items;
+	const uint8_t*                   root_public_key;
+	const atcacert_chain_verifier_t* verifier;
+	int*                             results;
+	size_t count;
+	size_t next;
+	int failed;
+	pthread_mutex_t lock;
+} atcacert_chain_work_t;
+
+static void* atcacert_chain_worker(void* arg)
+{
+	atcacert_chain_work_t* work = (atcacert_chain_work_t*)arg;
+	const atcacert_chain_verifier_t* verifier;
+	const uint8_t* issuer_public_key;
+	size_t i;
+	int ret;
+
+	for (;; ) {
+		pthread_mutex_lock(&work->lock);
+		if (work->failed || work->next >= work->count) {
+			pthread_mutex_unlock(&work->lock);
+			return NULL;
+		}
+		i = work->next++;
+		pthread_mutex_unlock(&work->lock);
+
+		verifier = (work->links[i].verifier != NULL) ? work->links[i].verifier : work->verifier;
+		issuer_public_key = (i == 0) ? work->root_public_key : work->items[i - 1].subj_public_key;
+		ret = verifier->start(work->items[i].tbs_digest, work->items[i].signature, issuer_public_key, work->links[i].verifier_context);
+		work->results[i] = ret;
+		if (ret != ATCA_SUCCESS) {
+			pthread_mutex_lock(&work->lock);
+			work->failed = 1;
+			pthread_mutex_unlock(&work->lock);
+		}
+	}
+}
+
+/** \brief Checks all links on several threads once they have been extracted. */
+static int atcacert_chain_verify_threads( const atcacert_chain_link_t*     links,
+                                          size_t count,
+                                          const uint8_t root_public_key[64],
+                                          const atcacert_chain_verifier_t* verifier,
+                                          atcacert_chain_scratch_t*        scratch,
+                                          const uint8_t**                  leaf_public_key)
+{
+	int ret = ATCA_SUCCESS;
+	int results[ATCACERT_CHAIN_SCRATCH_ITEMS];
+	pthread_t threads[ATCACERT_CHAIN_THREADS - 1];
+	size_t started = 0;
+	atcacert_chain_work_t work;
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		ret = atcacert_chain_prepare(&links[i], &scratch->items[i]);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+		results[i] = ATCACERT_E_VERIFY_FAILED;
+	}
+
+	work.links           = links;
+	work.items           = scratch->items;
+	work.root_public_key = root_public_key;
+	work.verifier        = verifier;
+	work.results         = results;
+	work.count           = count;
+	work.next            = 0;
+	work.failed          = 0;
+	if (pthread_mutex_init(&work.lock, NULL) != 0)
+		return ATCA_GEN_FAIL;
+
+	// This thread takes links too, so a thread that fails to start only costs speed
+	while (started < count - 1 && started < ATCACERT_CHAIN_THREADS - 1
+	       && pthread_create(&threads[started], NULL, atcacert_chain_worker, &work) == 0)
+		started++;
+	atcacert_chain_worker(&work);
+	for (i = 0; i < started; i++)
+		pthread_join(threads[i], NULL);
+	pthread_mutex_destroy(&work.lock);
+
+	// Links are taken in order, so every link ahead of a failed one has been checked
+	for (i = 0; i < count; i++) {
+		if (results[i] != ATCA_SUCCESS)
+			return results[i];
+	}
+
+	if (leaf_public_key != NULL)
+		*leaf_public_key = scratch->items[count - 1].subj_public_key;
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief True when the links can be checked on threads. */
+static bool atcacert_chain_is_concurrent( const atcacert_chain_link_t*     links,
+                                          size_t count,
+                                          const atcacert_chain_verifier_t* verifier)
+{
+	size_t i;
+
+	if (count < 2 || count > ATCACERT_CHAIN_SCRATCH_ITEMS)
+		return false;
+	for (i = 0; i < count; i++) {
+		const atcacert_chain_verifier_t* link_verifier = (links[i].verifier != NULL) ? links[i].verifier : verifier;
+		if (!link_verifier->concurrent || link_verifier->finish != NULL)
+			return false;
+	}
+
+	return true;
+}
+
+#endif
+
+int atcacert_chain_verify( const atcacert_chain_link_t*     links,
+                           size_t count,
+                           const uint8_t root_public_key[64],
+                           const atcacert_chain_verifier_t* verifier,
+                           atcacert_chain_scratch_t*        scratch,
+                           const uint8_t**                  leaf_public_key)
+{
+	if (links == NULL || count == 0 || root_public_key == NULL || verifier == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (scratch == NULL) {
+#if ATCACERT_CHAIN_SHARED_SCRATCH
+		scratch = &g_chain_scratch;
+#else
+		return ATCACERT_E_BAD_PARAMS;
+#endif
+	}
+
+#if ATCACERT_CHAIN_THREADS > 1
+	if (atcacert_chain_is_concurrent(links, count, verifier))
+		return atcacert_chain_verify_threads(links, count, root_public_key, verifier, scratch, leaf_public_key);
+#endif
+
+	return atcacert_chain_walk(links, count, root_public_key, verifier, scratch, leaf_public_key);
+}
+
+int atcacert_chain_read( atcacert_chain_link_t*    links,
+                         size_t count,
+                         const uint8_t root_public_key[64],
+                         uint8_t* const            certs[],
+                         size_t cert_sizes[],
+                         uint8_t (*tbs_digests)[32],
+                         atcacert_chain_scratch_t* scratch,
+                         const uint8_t**           leaf_public_key)
+{
+	int ret = ATCA_SUCCESS;
+	const uint8_t* issuer_public_key = root_public_key;
+	uint8_t* subj_public_key;
+	size_t i;
+
+	if (links == NULL || count == 0 || root_public_key == NULL || certs == NULL || cert_sizes == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (scratch == NULL) {
+#if ATCACERT_CHAIN_SHARED_SCRATCH
+		scratch = &g_chain_scratch;
+#else
+		return ATCACERT_E_BAD_PARAMS;
+#endif
+	}
+
+	for (i = 0; i < count; i++) {
+		ret = atcacert_read_cert(links[i].cert_def, issuer_public_key, certs[i], &cert_sizes[i]);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+
+		if (tbs_digests != NULL) {
+			ret = atcacert_get_tbs_digest(links[i].cert_def, certs[i], cert_sizes[i], tbs_digests[i]);
+			if (ret != ATCA_SUCCESS)
+				return ret;
+		}
+
+		links[i].cert       = certs[i];
+		links[i].cert_size  = cert_sizes[i];
+		links[i].tbs_digest = (tbs_digests != NULL) ? tbs_digests[i] : NULL;
+
+		subj_public_key = scratch->items[i & 1].subj_public_key;
+		ret = atcacert_get_subj_public_key(links[i].cert_def, certs[i], cert_sizes[i], subj_public_key);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+		issuer_public_key = subj_public_key;
+	}
+
+	if (leaf_public_key != NULL)
+		*leaf_public_key = issuer_public_key;
+
+	return ATCA_SUCCESS;
+}
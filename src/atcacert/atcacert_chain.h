@@ -0,0 +1,203 @@
+/**
+ * \file
+ * \brief Verification of certificate chains of any depth.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#ifndef ATCACERT_CHAIN_H
+#define ATCACERT_CHAIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "atcacert_def.h"
+
+/* A chain is an array of links ordered from the root down: links[0] is signed by the root public key
+   and every following link by the subject public key of the link before it. The walker first pulls
+   the TBS digest, signature and subject public key out of a certificate, which needs no checked
+   signature, and then hands them to the link's verifier:
+
+   - a verifier that works in the background (atcacert_chain_verifier_hw, the host device's Verify
+     command) keeps running while the MCU extracts the next link;
+   - when every link uses a concurrent verifier (the software ones) and the platform has threads
+     (Linux hosts), the links are checked on up to ATCACERT_CHAIN_THREADS threads at once.
+
+   The walk stops at the first link that fails. Its buffers live in an atcacert_chain_scratch_t the
+   caller can keep and reuse across calls.
+
+   RAM: the scratch takes 160 bytes per item, ATCACERT_CHAIN_SCRATCH_ITEMS items, so 320 bytes
+   without threads (AVR) and 640 bytes on a Linux host. The library's own scratch, used when a caller
+   passes NULL, stays in .bss for the life of the program. On a small part where that matters, build
+   with ATCACERT_CHAIN_SHARED_SCRATCH 0 and pass a scratch every call; it can then live on the stack
+   or share memory with other buffers. */
+
+#ifndef ATCACERT_CHAIN_THREADS
+#if defined(__linux__)
+#define ATCACERT_CHAIN_THREADS  (4)     //!< Most threads a walk uses, 0 for none
+#else
+#define ATCACERT_CHAIN_THREADS  (0)
+#endif
+#endif
+
+#ifndef ATCACERT_CHAIN_MAX_LINKS
+#define ATCACERT_CHAIN_MAX_LINKS (4)    //!< Most links checked on threads at the same time, longer chains are walked in turn
+#endif
+
+#if ATCACERT_CHAIN_THREADS > 1
+#define ATCACERT_CHAIN_SCRATCH_ITEMS ATCACERT_CHAIN_MAX_LINKS
+#else
+#define ATCACERT_CHAIN_SCRATCH_ITEMS (2)   // a link only needs the subject public key of the one before it
+#endif
+
+#ifndef ATCACERT_CHAIN_SHARED_SCRATCH
+#define ATCACERT_CHAIN_SHARED_SCRATCH (1)   //!< 0 drops the library's own scratch, callers must pass one
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \defgroup atcacert_ Certificate manipulation methods (atcacert_)
+ *
+ * \brief
+ * These methods provide convenient ways to perform certification I/O with
+ * CryptoAuth chips and perform certificate manipulation in memory
+ *
+   @{ */
+
+/**
+ * Checks the signature of a link. start() returns the result right away unless finish is set, in
+ * which case start() only launches the check and finish() collects its result before anything else
+ * uses the verifier. start() must be done with its arguments when it returns, the walker reuses
+ * their buffers for the next link.
+ */
+typedef struct atcacert_chain_verifier_s {
+	int (*start)(const uint8_t tbs_digest[32], const uint8_t signature[64], const uint8_t issuer_public_key[64], const void* context);
+	int (*finish)(const void* context);     //!< NULL when start() returns the result.
+	bool concurrent;                        //!< start() may run on several threads at once.
+} atcacert_chain_verifier_t;
+
+extern const atcacert_chain_verifier_t atcacert_chain_verifier_sw;        //!< Software ECDSA.
+extern const atcacert_chain_verifier_t atcacert_chain_verifier_fixed_sw;  //!< Software ECDSA against the issuer key's precomputed table, the context is its const ecc_fixed_base_t*. Fails with ATCACERT_E_VERIFY_FAILED when the table isn't the issuer key's.
+extern const atcacert_chain_verifier_t atcacert_chain_verifier_hw;        //!< The host device's Verify command.
+
+/**
+ * One certificate of a chain.
+ */
+typedef struct atcacert_chain_link_s {
+	const atcacert_def_t*            cert_def;          //!< Definition of the certificate.
+	const uint8_t*                   cert;              //!< The certificate.
+	size_t cert_size;                                   //!< Size of the certificate (cert) in bytes.
+	const uint8_t*                   tbs_digest;        //!< SHA256 digest of the TBS data when already known, e.g. from atcacert_get_tbs_digest, NULL to hash it.
+	const atcacert_chain_verifier_t* verifier;          //!< Verifier for this link, NULL for the walk's default.
+	const void*                      verifier_context;  //!< Passed to the verifier.
+} atcacert_chain_link_t;
+
+/**
+ * What checking a link needs, pulled out of its certificate.
+ */
+typedef struct atcacert_chain_item_s {
+	uint8_t tbs_digest[32];         //!< SHA256 digest of the TBS data.
+	uint8_t signature[64];          //!< Signature as R and S integers.
+	uint8_t subj_public_key[64];    //!< Subject public key, the issuer key of the next link.
+} atcacert_chain_item_t;
+
+/**
+ * Buffers for walking a chain. Keeping one around saves setting them up on the stack every call.
+ */
+typedef struct atcacert_chain_scratch_s {
+	atcacert_chain_item_t items[ATCACERT_CHAIN_SCRATCH_ITEMS];
+} atcacert_chain_scratch_t;
+
+/**
+ * \brief Verify a certificate chain.
+ *
+ * \param[in]  links            Links of the chain, root end first.
+ * \param[in]  count            Number of links.
+ * \param[in]  root_public_key  Public key that signed links[0] (64 bytes).
+ * \param[in]  verifier         Verifier for the links that don't name one.
+ * \param[in]  scratch          Buffers for the walk, NULL for the library's own. That one is shared
+ *                              by every caller, so it must not be used from two threads at once.
+ *                              Required when ATCACERT_CHAIN_SHARED_SCRATCH is 0.
+ * \param[out] leaf_public_key  Points at the subject public key of the last link inside scratch, valid
+ *                              until the scratch is used again. NULL if not needed.
+ *
+ * \return 0 if every link verifies, otherwise the error of the first link that doesn't.
+ */
+int atcacert_chain_verify( const atcacert_chain_link_t*     links,
+                           size_t count,
+                           const uint8_t root_public_key[64],
+                           const atcacert_chain_verifier_t* verifier,
+                           atcacert_chain_scratch_t*        scratch,
+                           const uint8_t**                  leaf_public_key);
+
+/**
+ * \brief Read a certificate chain from the device, each certificate rebuilt with the subject public
+ *        key of the one before it as its issuer key.
+ *
+ * \param[inout] links            Links of the chain, root end first. cert_def is set by the caller,
+ *                                cert, cert_size and tbs_digest are filled in.
+ * \param[in]    count            Number of links.
+ * \param[in]    root_public_key  Public key that signed links[0] (64 bytes).
+ * \param[in]    certs            Buffer for each certificate.
+ * \param[inout] cert_sizes       As input, the size of each buffer. As output, the size of each certificate.
+ * \param[out]   tbs_digests      Receives the TBS digest of each certificate, the links point at them.
+ *                                NULL when they aren't needed.
+ * \param[in]    scratch          Buffers for the walk, NULL for the library's own. Required when
+ *                                ATCACERT_CHAIN_SHARED_SCRATCH is 0.
+ * \param[out]   leaf_public_key  Points at the subject public key of the last certificate inside
+ *                                scratch. NULL if not needed.
+ *
+ * \return 0 on success
+ */
+int atcacert_chain_read( atcacert_chain_link_t*    links,
+                         size_t count,
+                         const uint8_t root_public_key[64],
+                         uint8_t* const            certs[],
+                         size_t cert_sizes[],
+                         uint8_t (*tbs_digests)[32],
+                         atcacert_chain_scratch_t* scratch,
+                         const uint8_t**           leaf_public_key);
+
+/** @} */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
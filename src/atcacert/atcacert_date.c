@@ -87,6 +87,7 @@
 
 
 #include "atcacert_date.h"
+#include "atca_compiler.h"
 #include <string.h>
 
 
@@ -202,72 +203,63 @@ int atcacert_date_get_max_date( atcacert_date_format_t format, atcacert_tm_utc_t
 }
 
 /**
- * \brief Convert an unsigned integer to a zero padded string with no terminating null.
+ * \brief Two-digit decimal strings "00" through "99", value n at offset 2 * n.
  */
-static uint8_t* uint_to_str(uint32_t num, int width, uint8_t* str)
-{
-	uint8_t* ret = str + width;
-	int i;
-
-	// Pre-fill the string width with zeros
-	for (i = 0; i < width; i++)
-		*(str++) = '0';
-	// Convert the number from right to left
-	for (; num; num /= 10)
-		*(--str) = '0' + (num % 10);
+static const uint8_t date_digit_pairs[200] ATCA_PROGMEM =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
 
-	return ret;
+/**
+ * \brief Convert an unsigned integer below 100 to a zero padded two-digit string with no
+ *        terminating null.
+ */
+static uint8_t* uint2_to_str(int num, uint8_t* str)
+{
+	atca_memcpy_P(str, &date_digit_pairs[num * 2], 2);
+	return str + 2;
 }
 
 /**
- * \brief Convert a number string as a zero padded unsigned integer back into a number
+ * \brief Convert an unsigned integer below 10000 to a zero padded four-digit string with no
+ *        terminating null.
  */
-static const uint8_t* str_to_uint(const uint8_t* str, int width, uint32_t* num)
+static uint8_t* uint4_to_str(int num, uint8_t* str)
 {
-	const uint8_t* error_ret = str;
-	const uint8_t* good_ret = str + width;
-	uint32_t prev_num = 0;
-	uint32_t digit_value = 1;
-	int digit;
-
-	str += width - 1;
-	*num = 0;
-	for (digit = 0; digit < width; digit++) {
-		if (*str < '0' || *str > '9')
-			return error_ret; // Character is not a digit
-		if (digit >= 10) {
-			if (*str != '0')
-				return error_ret; // Number is larger than the output can handle
-			continue;
-		}
-		if (digit == 9 && *str > '4')
-			return error_ret; // Number is larger than the output can handle
-
-		*num += digit_value * (*str - '0');
-		if (*num < prev_num)
-			return error_ret; // Number rolled over, it is larger than the output can handle
+	str = uint2_to_str(num / 100, str);
+	return uint2_to_str(num % 100, str);
+}
 
-		digit_value *= 10;
-		prev_num = *num;
-		str--;
-	}
+/**
+ * \brief Convert a two-digit number string back into a number. Returns str if either character
+ *        is not a digit.
+ */
+static const uint8_t* str_to_int2(const uint8_t* str, int* num)
+{
+	uint8_t tens = (uint8_t)(str[0] - '0'); // Characters below '0' wrap to large values
+	uint8_t ones = (uint8_t)(str[1] - '0');
 
-	return good_ret;
+	if (tens > 9 || ones > 9)
+		return str;
+	*num = tens * 10 + ones;
+	return str + 2;
 }
 
 /**
- * \brief Convert a number string as a zero padded unsigned integer back into a number constrained
- *        to an integer's size.
+ * \brief Convert a four-digit number string back into a number. Returns str if any character is
+ *        not a digit.
  */
-static const uint8_t* str_to_int(const uint8_t* str, int width, int* num)
+static const uint8_t* str_to_int4(const uint8_t* str, int* num)
 {
-	uint32_t unum = 0;
-	const uint8_t* ret = str_to_uint(str, width, &unum);
+	int hundreds = 0;
+	int rest = 0;
 
-	if (ret != str && unum > 2147483647UL)
-		ret = str; // Number exceeds int32's range
-	*num = (int)unum;
-	return ret;
+	if (str_to_int2(str, &hundreds) == str || str_to_int2(str + 2, &rest) == str + 2)
+		return str;
+	*num = hundreds * 100 + rest;
+	return str + 4;
 }
 
 int atcacert_date_enc_iso8601_sep( const atcacert_tm_utc_t*  timestamp,
@@ -283,37 +275,37 @@ int atcacert_date_enc_iso8601_sep( const atcacert_tm_utc_t*  timestamp,
 
 	if (year < 0 || year > 9999)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(year, 4, cur_pos);
+	cur_pos = uint4_to_str(year, cur_pos);
 
 	*(cur_pos++) = '-';
 
 	if (timestamp->tm_mon < 0 || timestamp->tm_mon > 11)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_mon + 1, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_mon + 1, cur_pos);
 
 	*(cur_pos++) = '-';
 
 	if (timestamp->tm_mday < 1 || timestamp->tm_mday > 31)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_mday, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_mday, cur_pos);
 
 	*(cur_pos++) = 'T';
 
 	if (timestamp->tm_hour < 0 || timestamp->tm_hour > 23)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_hour, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_hour, cur_pos);
 
 	*(cur_pos++) = ':';
 
 	if (timestamp->tm_min < 0 || timestamp->tm_min > 59)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_min, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_min, cur_pos);
 
 	*(cur_pos++) = ':';
 
 	if (timestamp->tm_sec < 0 || timestamp->tm_sec > 59)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_sec, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_sec, cur_pos);
 
 	*(cur_pos++) = 'Z';
 
@@ -331,7 +323,7 @@ int atcacert_date_dec_iso8601_sep( const uint8_t formatted_date[DATEFMT_ISO8601_
 
 	memset(timestamp, 0, sizeof(*timestamp));
 
-	new_pos = str_to_int(cur_pos, 4, &timestamp->tm_year);
+	new_pos = str_to_int4(cur_pos, &timestamp->tm_year);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
@@ -340,7 +332,7 @@ int atcacert_date_dec_iso8601_sep( const uint8_t formatted_date[DATEFMT_ISO8601_
 	if (*(cur_pos++) != '-')
 		return ATCACERT_E_DECODING_ERROR; // Unexpected separator
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_mon);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_mon);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
@@ -349,7 +341,7 @@ int atcacert_date_dec_iso8601_sep( const uint8_t formatted_date[DATEFMT_ISO8601_
 	if (*(cur_pos++) != '-')
 		return ATCACERT_E_DECODING_ERROR; // Unexpected separator
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_mday);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_mday);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
@@ -357,7 +349,7 @@ int atcacert_date_dec_iso8601_sep( const uint8_t formatted_date[DATEFMT_ISO8601_
 	if (*(cur_pos++) != 'T')
 		return ATCACERT_E_DECODING_ERROR; // Unexpected separator
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_hour);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_hour);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
@@ -365,7 +357,7 @@ int atcacert_date_dec_iso8601_sep( const uint8_t formatted_date[DATEFMT_ISO8601_
 	if (*(cur_pos++) != ':')
 		return ATCACERT_E_DECODING_ERROR; // Unexpected separator
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_min);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_min);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
@@ -373,7 +365,7 @@ int atcacert_date_dec_iso8601_sep( const uint8_t formatted_date[DATEFMT_ISO8601_
 	if (*(cur_pos++) != ':')
 		return ATCACERT_E_DECODING_ERROR; // Unexpected separator
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_sec);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_sec);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
@@ -401,27 +393,27 @@ int atcacert_date_enc_rfc5280_utc( const atcacert_tm_utc_t*  timestamp,
 		year = year - 2000;
 	else
 		return ATCACERT_E_INVALID_DATE;  // Year out of range for RFC2459 UTC format
-	cur_pos = uint_to_str(year, 2, cur_pos);
+	cur_pos = uint2_to_str(year, cur_pos);
 
 	if (timestamp->tm_mon < 0 || timestamp->tm_mon > 11)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_mon + 1, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_mon + 1, cur_pos);
 
 	if (timestamp->tm_mday < 1 || timestamp->tm_mday > 31)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_mday, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_mday, cur_pos);
 
 	if (timestamp->tm_hour < 0 || timestamp->tm_hour > 23)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_hour, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_hour, cur_pos);
 
 	if (timestamp->tm_min < 0 || timestamp->tm_min > 59)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_min, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_min, cur_pos);
 
 	if (timestamp->tm_sec < 0 || timestamp->tm_sec > 59)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_sec, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_sec, cur_pos);
 
 	*(cur_pos++) = 'Z';
 
@@ -439,7 +431,7 @@ int atcacert_date_dec_rfc5280_utc( const uint8_t formatted_date[DATEFMT_RFC5280_
 
 	memset(timestamp, 0, sizeof(*timestamp));
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_year);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_year);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
@@ -449,28 +441,28 @@ int atcacert_date_dec_rfc5280_utc( const uint8_t formatted_date[DATEFMT_RFC5280_
 		timestamp->tm_year += 1900;
 	timestamp->tm_year -= 1900;
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_mon);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_mon);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
 	timestamp->tm_mon -= 1;
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_mday);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_mday);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_hour);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_hour);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_min);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_min);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_sec);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_sec);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
@@ -494,27 +486,27 @@ int atcacert_date_enc_rfc5280_gen( const atcacert_tm_utc_t*  timestamp,
 
 	if (year < 0 || year > 9999)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(year, 4, cur_pos);
+	cur_pos = uint4_to_str(year, cur_pos);
 
 	if (timestamp->tm_mon < 0 || timestamp->tm_mon > 11)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_mon + 1, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_mon + 1, cur_pos);
 
 	if (timestamp->tm_mday < 1 || timestamp->tm_mday > 31)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_mday, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_mday, cur_pos);
 
 	if (timestamp->tm_hour < 0 || timestamp->tm_hour > 23)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_hour, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_hour, cur_pos);
 
 	if (timestamp->tm_min < 0 || timestamp->tm_min > 59)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_min, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_min, cur_pos);
 
 	if (timestamp->tm_sec < 0 || timestamp->tm_sec > 59)
 		return ATCACERT_E_INVALID_DATE;
-	cur_pos = uint_to_str(timestamp->tm_sec, 2, cur_pos);
+	cur_pos = uint2_to_str(timestamp->tm_sec, cur_pos);
 
 	*(cur_pos++) = 'Z';
 
@@ -532,34 +524,34 @@ int atcacert_date_dec_rfc5280_gen( const uint8_t formatted_date[DATEFMT_RFC5280_
 
 	memset(timestamp, 0, sizeof(*timestamp));
 
-	new_pos = str_to_int(cur_pos, 4, &timestamp->tm_year);
+	new_pos = str_to_int4(cur_pos, &timestamp->tm_year);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
 	timestamp->tm_year -= 1900;
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_mon);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_mon);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
 	timestamp->tm_mon -= 1;
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_mday);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_mday);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_hour);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_hour);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_min);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_min);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
 
-	new_pos = str_to_int(cur_pos, 2, &timestamp->tm_sec);
+	new_pos = str_to_int2(cur_pos, &timestamp->tm_sec);
 	if (new_pos == cur_pos)
 		return ATCACERT_E_DECODING_ERROR; // There was a problem converting the string to a number
 	cur_pos = new_pos;
@@ -570,88 +562,59 @@ int atcacert_date_dec_rfc5280_gen( const uint8_t formatted_date[DATEFMT_RFC5280_
 	return ATCA_SUCCESS;
 }
 
-static int is_leap_year(int year)
+/**
+ * \brief Days from 1970-01-01 to the given civil date, for years 1970 and later.
+ *
+ * Counts in years that start on March 1st so the leap day falls at the end of the year and the
+ * day of the year follows from the month with one linear formula. Days past the end of the month
+ * carry into the following months.
+ */
+static uint32_t days_from_civil(int year, int mon, int mday)
 {
-	return (year % 400 == 0) || ((year % 4 == 0) && (year % 100 != 0));
-}
+	uint32_t y = (uint32_t)year - (mon < 2 ? 1 : 0);
+	uint32_t era = y / 400;
+	uint32_t yoe = y - era * 400;                                                   // [0, 399]
+	uint32_t doy = (153 * (uint32_t)(mon < 2 ? mon + 10 : mon - 2) + 2) / 5 + mday - 1; // [0, 365]
+	uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                           // [0, 146096]
 
-static uint32_t get_year_secs(int year)
-{
-	if (is_leap_year(year))
-		return (31 + 29 + 31 + 30 + 31 + 30 + 31 + 31 + 30 + 31 + 30 + 31) * 86400;
-	else
-		return (31 + 28 + 31 + 30 + 31 + 30 + 31 + 31 + 30 + 31 + 30 + 31) * 86400;
+	return era * 146097 + doe - 719468;
 }
 
-static uint32_t get_month_secs(int year, int mon)
+/**
+ * \brief Civil date of the given number of days since 1970-01-01. Inverse of days_from_civil().
+ */
+static void civil_from_days(uint32_t days, atcacert_tm_utc_t* result)
 {
-	static const uint32_t month_secs[] = { 2678400, 2419200, 2678400, 2592000, 2678400, 2592000, 2678400, 2678400, 2592000, 2678400, 2592000, 2678400 };
-
-	if (mon == 1 && is_leap_year(year))
-		return 2505600;
-	else if (mon < 12)
-		return month_secs[mon];
-	else
-		return 0;
+	uint32_t z = days + 719468;
+	uint32_t era = z / 146097;
+	uint32_t doe = z - era * 146097;                                        // [0, 146096]
+	uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;   // [0, 399]
+	uint32_t doy = doe - (yoe * 365 + yoe / 4 - yoe / 100);                 // [0, 365]
+	uint32_t mp = (doy * 5 + 2) / 153;                                      // [0, 11], March is 0
+
+	result->tm_mday = (int)(doy - (mp * 153 + 2) / 5 + 1);
+	result->tm_mon = (int)(mp < 10 ? mp + 2 : mp - 10);
+	result->tm_year = (int)(era * 400 + yoe + (mp < 10 ? 0 : 1)) - 1900;
 }
 
 static atcacert_tm_utc_t *atcacert_gmtime32(const uint32_t *posix_time, atcacert_tm_utc_t *result)
 {
-	uint32_t secs_remaining = *posix_time;
-	uint32_t secs = 0;
-
-	result->tm_year = 1970;
-	result->tm_mon = 0;
-	result->tm_mday = 1;
-	result->tm_hour = 0;
-	result->tm_min = 0;
-	result->tm_sec = 0;
-
-	secs = get_year_secs(result->tm_year);
-	while (secs_remaining >= secs) {
-		result->tm_year++;
-		secs_remaining -= secs;
-		secs = get_year_secs(result->tm_year);
-	}
+	uint32_t secs = *posix_time % 86400;
 
-	secs = get_month_secs(result->tm_year, result->tm_mon);
-	while (secs_remaining >= secs) {
-		result->tm_mon++;
-		secs_remaining -= secs;
-		secs = get_month_secs(result->tm_year, result->tm_mon);
-	}
-
-	result->tm_year -= 1900;
-
-	result->tm_mday += secs_remaining / 86400;
-	secs_remaining %= 86400;
-
-	result->tm_hour += secs_remaining / 3600;
-	secs_remaining %= 3600;
+	civil_from_days(*posix_time / 86400, result);
 
-	result->tm_min += secs_remaining / 60;
-	secs_remaining %= 60;
-
-	result->tm_sec += secs_remaining;
+	result->tm_hour = (int)(secs / 3600);
+	secs %= 3600;
+	result->tm_min = (int)(secs / 60);
+	result->tm_sec = (int)(secs % 60);
 
 	return result;
 }
 
 static uint32_t atcacert_mkgmtime32(const atcacert_tm_utc_t *timeptr)
 {
-	uint32_t posix_time = 0;
-	int cur_value = 0;
-	int year = timeptr->tm_year + 1900;
-
-	cur_value = year - 1;
-	while (cur_value >= 1970)
-		posix_time += get_year_secs(cur_value--);
-
-	cur_value = timeptr->tm_mon - 1;
-	while (cur_value >= 0)
-		posix_time += get_month_secs(year, cur_value--);
+	uint32_t posix_time = days_from_civil(timeptr->tm_year + 1900, timeptr->tm_mon, timeptr->tm_mday) * 86400;
 
-	posix_time += (uint32_t)(timeptr->tm_mday - 1) * 86400;
 	posix_time += (uint32_t)timeptr->tm_hour * 3600;
 	posix_time += (uint32_t)timeptr->tm_min * 60;
 	posix_time += (uint32_t)timeptr->tm_sec;
@@ -95,6 +95,9 @@
 #define ATCACERT_MIN(x, y) ((x) < (y) ? (x) : (y))
 #define ATCACERT_MAX(x, y) ((x) >= (y) ? (x) : (y))
 
+/** \brief Keys atcacert_get_key_ids() hashes per call to atcac_sw_sha1_multi(). */
+#define ATCACERT_KEY_ID_BATCH (8)
+
 int atcacert_merge_device_loc( atcacert_device_loc_t*       device_locs,
                                size_t*                      device_locs_count,
                                size_t device_locs_max_count,
@@ -529,11 +532,19 @@ int atcacert_set_subj_public_key( const atcacert_def_t* cert_def,
 {
 	int ret = 0;
 	uint8_t key_id[20];
+	uint8_t padded_key[72];
+	const atcacert_cert_loc_t* key_loc;
 
 	if (cert_def == NULL || cert == NULL || subj_public_key == NULL)
 		return ATCACERT_E_BAD_PARAMS;
-
-	ret = atcacert_set_cert_element(&cert_def->std_cert_elements[STDCERT_PUBLIC_KEY], cert, cert_size, subj_public_key, 64);
+	key_loc = &cert_def->std_cert_elements[STDCERT_PUBLIC_KEY];
+
+	if (cert_def->type != CERTTYPE_X509 && key_loc->count == 72) {
+		// Public key is formatted with padding bytes in front of the X and Y components
+		atcacert_public_key_add_padding(subj_public_key, padded_key);
+		ret = atcacert_set_cert_element(key_loc, cert, cert_size, padded_key, 72);
+	}else
+		ret = atcacert_set_cert_element(key_loc, cert, cert_size, subj_public_key, 64);
 	if (ret != ATCA_SUCCESS)
 		return ret;
 
@@ -553,10 +564,23 @@ int atcacert_get_subj_public_key( const atcacert_def_t* cert_def,
                                   size_t cert_size,
                                   uint8_t subj_public_key[64])
 {
+	int ret = 0;
+	uint8_t padded_key[72];
+	const atcacert_cert_loc_t* key_loc;
+
 	if (cert_def == NULL || cert == NULL || subj_public_key == NULL)
 		return ATCACERT_E_BAD_PARAMS;
+	key_loc = &cert_def->std_cert_elements[STDCERT_PUBLIC_KEY];
 
-	return atcacert_get_cert_element(&cert_def->std_cert_elements[STDCERT_PUBLIC_KEY], cert, cert_size, subj_public_key, 64);
+	if (cert_def->type != CERTTYPE_X509 && key_loc->count == 72) {
+		ret = atcacert_get_cert_element(key_loc, cert, cert_size, padded_key, 72);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+		atcacert_public_key_remove_padding(padded_key, subj_public_key);
+		return ATCA_SUCCESS;
+	}
+
+	return atcacert_get_cert_element(key_loc, cert, cert_size, subj_public_key, 64);
 }
 
 int atcacert_get_subj_key_id( const atcacert_def_t* cert_def,
@@ -581,9 +605,8 @@ int atcacert_set_signature( const atcacert_def_t* cert_def,
 	size_t cur_der_sig_size;
 	size_t new_der_sig_size;
 	size_t old_cert_der_length_size;
-	size_t new_cert_der_length_size;
 	size_t new_cert_length;
-	uint8_t new_cert_der_length[5];
+	atcacert_der_out_t out;
 
 	if (cert_def == NULL || cert == NULL || cert_size == NULL || signature == NULL)
 		return ATCACERT_E_BAD_PARAMS;
@@ -622,17 +645,14 @@ int atcacert_set_signature( const atcacert_def_t* cert_def,
 		return ATCACERT_E_BAD_CERT;
 	new_cert_length = *cert_size - (1 + old_cert_der_length_size);
 
-	new_cert_der_length_size = sizeof(new_cert_der_length);
-	ret = atcacert_der_enc_length(new_cert_length, new_cert_der_length, &new_cert_der_length_size);
-	if (ret != ATCA_SUCCESS)
-		return ret;
-
-	if (old_cert_der_length_size != new_cert_der_length_size)
+	if (atcacert_der_length_size((uint32_t)new_cert_length) != old_cert_der_length_size)
 		return ATCACERT_E_BAD_CERT;
 
-	memcpy(&cert[1], new_cert_der_length, new_cert_der_length_size);
+	// Patch the certificate length in place
+	out.ptr  = &cert[1];
+	out.size = old_cert_der_length_size;
 
-	return ATCA_SUCCESS;
+	return atcacert_der_write_length(&out, (uint32_t)new_cert_length);
 }
 
 int atcacert_get_signature( const atcacert_def_t* cert_def,
@@ -1128,6 +1148,34 @@ int atcacert_get_tbs( const atcacert_def_t* cert_def,
 	return ATCA_SUCCESS;
 }
 
+/**
+ * \brief Hashes TBS data starting from the certificate definition's precomputed midstate, or
+ *        from scratch when the TBS data doesn't start with the template's prefix.
+ */
+static int atcacert_get_tbs_digest_midstate( const atcacert_def_t* cert_def,
+                                             const uint8_t*        tbs,
+                                             size_t tbs_size,
+                                             uint8_t tbs_digest[32])
+{
+	int ret = ATCA_SUCCESS;
+	const atcacert_tbs_midstate_t* midstate = cert_def->tbs_midstate;
+	atcac_sha2_256_ctx ctx;
+
+	if (midstate->prefix_size > tbs_size
+	    || (size_t)cert_def->tbs_cert_loc.offset + midstate->prefix_size > cert_def->cert_template_size
+	    || memcmp(tbs, &cert_def->cert_template[cert_def->tbs_cert_loc.offset], midstate->prefix_size) != 0)
+		return atcac_sw_sha2_256(tbs, tbs_size, tbs_digest);
+
+	ret = atcac_sw_sha2_256_resume(&ctx, midstate->hash, midstate->prefix_size);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	ret = atcac_sw_sha2_256_update(&ctx, &tbs[midstate->prefix_size], tbs_size - midstate->prefix_size);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	return atcac_sw_sha2_256_finish(&ctx, tbs_digest);
+}
+
 int atcacert_get_tbs_digest( const atcacert_def_t* cert_def,
                              const uint8_t*        cert,
                              size_t cert_size,
@@ -1144,6 +1192,9 @@ int atcacert_get_tbs_digest( const atcacert_def_t* cert_def,
 	if (ret != ATCA_SUCCESS)
 		return ret;
 
+	if (cert_def->tbs_midstate != NULL)
+		return atcacert_get_tbs_digest_midstate(cert_def, tbs, tbs_size, tbs_digest);
+
 	ret = atcac_sw_sha2_256(tbs, tbs_size, tbs_digest);
 	if (ret != ATCA_SUCCESS)
 		return ret;
@@ -1151,6 +1202,62 @@ int atcacert_get_tbs_digest( const atcacert_def_t* cert_def,
 	return ret;
 }
 
+/**
+ * \brief Number of TBS bytes, in whole SHA256 blocks, ahead of the first element the
+ *        certificate definition can change.
+ */
+static size_t atcacert_tbs_prefix_size( const atcacert_def_t* cert_def )
+{
+	size_t tbs_start = cert_def->tbs_cert_loc.offset;
+	size_t first = tbs_start + cert_def->tbs_cert_loc.count;
+	size_t i;
+
+	for (i = 0; i < STDCERT_NUM_ELEMENTS; i++) {
+		const atcacert_cert_loc_t* loc = &cert_def->std_cert_elements[i];
+		if (loc->count > 0 && loc->offset + loc->count > tbs_start && loc->offset < first)
+			first = loc->offset;
+	}
+	for (i = 0; i < cert_def->cert_elements_count; i++) {
+		const atcacert_cert_loc_t* loc = &cert_def->cert_elements[i].cert_loc;
+		if (loc->count > 0 && loc->offset + loc->count > tbs_start && loc->offset < first)
+			first = loc->offset;
+	}
+	if (first < tbs_start)
+		return 0;
+
+	return (first - tbs_start) & ~(size_t)(ATCA_SHA2_256_BLOCK_SIZE - 1);
+}
+
+int atcacert_get_tbs_midstate( const atcacert_def_t*    cert_def,
+                               atcacert_tbs_midstate_t* tbs_midstate )
+{
+	int ret = ATCA_SUCCESS;
+	atcac_sha2_256_ctx ctx;
+	size_t prefix_size = 0;
+	size_t processed = 0;
+
+	if (cert_def == NULL || cert_def->cert_template == NULL || tbs_midstate == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+	if (cert_def->cert_elements_count > 0 && cert_def->cert_elements == NULL)
+		return ATCACERT_E_BAD_CERT;
+	if ((size_t)cert_def->tbs_cert_loc.offset + (size_t)cert_def->tbs_cert_loc.count > cert_def->cert_template_size)
+		return ATCACERT_E_BAD_CERT;
+
+	prefix_size = atcacert_tbs_prefix_size(cert_def);
+	ret = atcac_sw_sha2_256_init(&ctx);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	ret = atcac_sw_sha2_256_update(&ctx, &cert_def->cert_template[cert_def->tbs_cert_loc.offset], prefix_size);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	ret = atcac_sw_sha2_256_get_midstate(&ctx, tbs_midstate->hash, &processed);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	tbs_midstate->prefix_size = (uint16_t)processed;
+
+	return ATCA_SUCCESS;
+}
+
 int atcacert_set_cert_element( const atcacert_cert_loc_t* cert_loc,
                                uint8_t*                   cert,
                                size_t cert_size,
@@ -1213,6 +1320,31 @@ int atcacert_get_key_id(const uint8_t public_key[64], uint8_t key_id[20])
 	return atcac_sw_sha1(msg, sizeof(msg), key_id);
 }
 
+int atcacert_get_key_ids(const uint8_t (*public_keys)[64], size_t count, uint8_t (*key_ids)[20])
+{
+	int ret = ATCA_SUCCESS;
+	uint8_t msgs[ATCACERT_KEY_ID_BATCH][65];
+	const uint8_t* msg_ptrs[ATCACERT_KEY_ID_BATCH];
+	size_t done, n, i;
+
+	if ((public_keys == NULL || key_ids == NULL) && count > 0)
+		return ATCACERT_E_BAD_PARAMS;
+
+	for (done = 0; done < count; done += n) {
+		n = ATCACERT_MIN(count - done, ATCACERT_KEY_ID_BATCH);
+		for (i = 0; i < n; i++) {
+			msgs[i][0] = 0x04;
+			memcpy(&msgs[i][1], public_keys[done + i], 64);
+			msg_ptrs[i] = msgs[i];
+		}
+		ret = atcac_sw_sha1_multi(msg_ptrs, sizeof(msgs[0]), n, &key_ids[done]);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+
+	return ATCA_SUCCESS;
+}
+
 void atcacert_public_key_add_padding(const uint8_t raw_key[64], uint8_t padded_key[72])
 {
 	memmove(&padded_key[40], &raw_key[32], 32); // Move Y to padded position
@@ -191,6 +191,15 @@ typedef struct atcacert_cert_element_s {
 	atcacert_cert_loc_t cert_loc;       //!< Location in the certificate template for the element.
 } atcacert_cert_element_t;
 
+/**
+ * Precomputed SHA256 midstate of a certificate template's constant TBS prefix, as emitted by
+ * extras/gen_tbs_midstate. Lets the TBS digest resume past the blocks every certificate shares.
+ */
+typedef struct atcacert_tbs_midstate_s {
+	uint16_t prefix_size;   //!< Number of TBS bytes hashed into hash, a multiple of the SHA256 block size.
+	uint32_t hash[8];       //!< SHA256 state words after hashing the prefix.
+} atcacert_tbs_midstate_t;
+
 /**
  * Defines a certificate and all the pieces to work with it.
  *
@@ -215,6 +224,7 @@ typedef struct atcacert_def_s {
 	uint8_t cert_elements_count;                                    //!< Number of additional certificate elements in cert_elements.
 	const uint8_t*         cert_template;                           //!< Pointer to the actual certificate template data.
 	uint16_t cert_template_size;                                    //!< Size of the certificate template in cert_template in bytes.
+	const atcacert_tbs_midstate_t* tbs_midstate;                    //!< Optional precomputed midstate of the template's TBS prefix, NULL to hash the whole TBS data.
 } atcacert_def_t;
 
 /**
@@ -338,6 +348,9 @@ int atcacert_get_device_data( const atcacert_def_t*        cert_def,
 /**
  * \brief Sets the subject public key and subject key ID in a certificate.
  *
+ * A custom (non-X.509) certificate whose public key location is 72 bytes gets the key in the
+ * padded form of the device slot, see atcacert_public_key_add_padding().
+ *
  * \param[in]    cert_def         Certificate definition for the certificate.
  * \param[inout] cert             Certificate to update.
  * \param[in]    cert_size        Size of the certificate (cert) in bytes.
@@ -351,7 +364,8 @@ int atcacert_set_subj_public_key( const atcacert_def_t* cert_def,
                                   const uint8_t subj_public_key[64]);
 
 /**
- * \brief Gets the subject public key from a certificate.
+ * \brief Gets the subject public key from a certificate. A 72-byte public key location in a custom
+ *        certificate holds the padded form, the padding is removed.
  *
  * \param[in]  cert_def         Certificate definition for the certificate.
  * \param[in]  cert             Certificate to get element from.
@@ -654,6 +668,9 @@ int atcacert_get_tbs( const atcacert_def_t* cert_def,
 /**
  * \brief Get the SHA256 digest of certificate's TBS data.
  *
+ * When the certificate definition carries a tbs_midstate and the certificate's TBS data starts
+ * with the same prefix as the template, only the rest of the TBS data is hashed.
+ *
  * \param[in]  cert_def    Certificate definition for the certificate.
  * \param[in]  cert        Certificate to get the TBS data pointer for.
  * \param[in]  cert_size   Size of the certificate (cert) in bytes.
@@ -666,6 +683,21 @@ int atcacert_get_tbs_digest( const atcacert_def_t * cert_def,
                              size_t cert_size,
                              uint8_t tbs_digest[32]);
 
+/**
+ * \brief Computes the SHA256 midstate of the whole blocks of a template's TBS data that come
+ *        before the first certificate element, for a definition's tbs_midstate.
+ *
+ * Meant for build-time generators such as extras/gen_tbs_midstate. A prefix_size of 0 means
+ * the template has no constant prefix and the definition should leave tbs_midstate NULL.
+ *
+ * \param[in]  cert_def      Certificate definition to hash the template of.
+ * \param[out] tbs_midstate  Midstate of the template's constant TBS prefix.
+ *
+ * \return 0 on success
+ */
+int atcacert_get_tbs_midstate( const atcacert_def_t*    cert_def,
+                               atcacert_tbs_midstate_t* tbs_midstate );
+
 /**
  * \brief Sets an element in a certificate. The data_size must match the size in cert_loc.
  *
@@ -721,6 +753,18 @@ int atcacert_get_cert_element( const atcacert_cert_loc_t* cert_loc,
  */
 int atcacert_get_key_id( const uint8_t public_key[64], uint8_t key_id[20] );
 
+/**
+ * \brief Calculates the key IDs of several public keys, hashing them side by side. Gives the same
+ *        result as atcacert_get_key_id() on each key.
+ *
+ * \param[in]  public_keys  ECC P256 public keys, X and Y integers concatenated together.
+ * \param[in]  count        Number of keys.
+ * \param[out] key_ids      Receives the key ID of each key.
+ *
+ * \return 0 on success
+ */
+int atcacert_get_key_ids( const uint8_t (*public_keys)[64], size_t count, uint8_t (*key_ids)[20] );
+
 /**
  * \brief Merge a new device location into a list of device locations. If the new location overlaps
  *        with an existing location, the existing one will be modified to encompass both. Otherwise
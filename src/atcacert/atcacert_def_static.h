@@ -0,0 +1,276 @@
+/**
+ * \file
+ * \brief Compile-time validated certificate definitions for C++ callers.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Wraps a constexpr atcacert_def_t in a class template. The definition is
+ * checked with static_assert when the template is instantiated, and the
+ * element accessors take fixed-size arrays, so the offset, count and size
+ * checks atcacert_get_cert_element()/atcacert_set_cert_element() repeat on
+ * every call are resolved by the compiler instead. Only C++11 and the C
+ * library headers are used, so it builds with the Arduino AVR toolchain.
+ *
+ * \code
+ * extern "C" const uint8_t g_cert_template_2_device[];
+ * constexpr atcacert_def_t k_device_def = { CERTTYPE_X509, 2, 0, 0, ... , g_cert_template_2_device, 428 };
+ * typedef atcacert_static::cert_def<k_device_def> device_def;
+ *
+ * uint8_t cert[device_def::template_size];
+ * device_def::init(cert);
+ * device_def::set_subj_public_key(cert, public_key);
+ * \endcode
+ */
+#ifndef ATCACERT_DEF_STATIC_H
+#define ATCACERT_DEF_STATIC_H
+
+#include "atcacert_def.h"
+#include "atcacert_date.h"
+
+#ifdef __cplusplus
+
+#include <string.h>
+
+namespace atcacert_static {
+
+/** \brief Size of a formatted date, 0 for an unknown format. */
+constexpr size_t date_format_size(atcacert_date_format_t format)
+{
+	return format == DATEFMT_ISO8601_SEP ? DATEFMT_ISO8601_SEP_SIZE :
+	       format == DATEFMT_RFC5280_UTC ? DATEFMT_RFC5280_UTC_SIZE :
+	       format == DATEFMT_POSIX_UINT32_BE ? DATEFMT_POSIX_UINT32_BE_SIZE :
+	       format == DATEFMT_POSIX_UINT32_LE ? DATEFMT_POSIX_UINT32_LE_SIZE :
+	       format == DATEFMT_RFC5280_GEN ? DATEFMT_RFC5280_GEN_SIZE : 0;
+}
+
+/** \brief True when a location lies within size bytes. Absent elements (count 0) always do. */
+constexpr bool loc_fits(const atcacert_cert_loc_t& loc, size_t size)
+{
+	return loc.count == 0 || (size_t)loc.offset + loc.count <= size;
+}
+
+/** \brief True when a location lies within another one. Absent elements (count 0) always do. */
+constexpr bool loc_inside(const atcacert_cert_loc_t& loc, const atcacert_cert_loc_t& outer)
+{
+	return loc.count == 0 || (loc.offset >= outer.offset && (size_t)loc.offset + loc.count <= (size_t)outer.offset + outer.count);
+}
+
+/** \brief True when every standard element from index i on lies within the template. */
+constexpr bool std_elements_fit(const atcacert_def_t& def, size_t i = 0)
+{
+	return i >= STDCERT_NUM_ELEMENTS
+	       || (loc_fits(def.std_cert_elements[i], def.cert_template_size) && std_elements_fit(def, i + 1));
+}
+
+/** \brief True when every standard element but the signature, from index i on, lies within the TBS data. */
+constexpr bool std_elements_in_tbs(const atcacert_def_t& def, size_t i = 0)
+{
+	return i >= STDCERT_NUM_ELEMENTS
+	       || ((i == STDCERT_SIGNATURE || loc_inside(def.std_cert_elements[i], def.tbs_cert_loc)) && std_elements_in_tbs(def, i + 1));
+}
+
+/** \brief True when an element is absent or exactly size bytes long. */
+constexpr bool loc_size_is(const atcacert_cert_loc_t& loc, size_t size)
+{
+	return loc.count == 0 || loc.count == size;
+}
+
+/**
+ * \brief A certificate definition whose layout is checked at compile time.
+ *
+ * \tparam Def  constexpr certificate definition with static storage duration.
+ */
+template <const atcacert_def_t& Def>
+class cert_def {
+	static_assert(Def.cert_template != NULL && Def.cert_template_size > 0, "certificate definition has no template");
+	static_assert(Def.template_id <= 0x0F && Def.chain_id <= 0x0F, "template_id and chain_id are 4-bit values");
+	static_assert(Def.expire_years <= 31, "expire_years is a 5-bit value");
+	static_assert(Def.tbs_cert_loc.count > 0 && loc_fits(Def.tbs_cert_loc, Def.cert_template_size), "TBS data runs past the template");
+	static_assert(std_elements_fit(Def), "a standard element runs past the template");
+	static_assert(Def.type != CERTTYPE_X509 || std_elements_in_tbs(Def), "an X.509 standard element other than the signature lies outside the TBS data");
+	static_assert(loc_size_is(Def.std_cert_elements[STDCERT_PUBLIC_KEY], 64) || (Def.type != CERTTYPE_X509 && loc_size_is(Def.std_cert_elements[STDCERT_PUBLIC_KEY], 72)), "public key element has the wrong size");
+	static_assert(loc_size_is(Def.std_cert_elements[STDCERT_ISSUE_DATE], date_format_size(Def.issue_date_format)), "issue date element doesn't match issue_date_format");
+	static_assert(loc_size_is(Def.std_cert_elements[STDCERT_EXPIRE_DATE], date_format_size(Def.expire_date_format)), "expire date element doesn't match expire_date_format");
+	static_assert(loc_size_is(Def.std_cert_elements[STDCERT_SIGNER_ID], 4), "signer ID element must be 4 bytes");
+	static_assert(loc_size_is(Def.std_cert_elements[STDCERT_AUTH_KEY_ID], 20) && loc_size_is(Def.std_cert_elements[STDCERT_SUBJ_KEY_ID], 20), "key ID elements must be 20 bytes");
+	static_assert(Def.cert_elements_count == 0 || Def.cert_elements != NULL, "cert_elements_count without cert_elements");
+
+public:
+	static constexpr size_t template_size = Def.cert_template_size;     //!< Size of a certificate built from the template.
+	static constexpr size_t tbs_offset = Def.tbs_cert_loc.offset;       //!< Offset of the TBS data in the certificate.
+	static constexpr size_t tbs_size = Def.tbs_cert_loc.count;          //!< Size of the TBS data.
+
+	/** \brief Location of a standard element, which the definition must have. */
+	template <atcacert_std_cert_element_t Id>
+	struct element {
+		static_assert(Id < STDCERT_NUM_ELEMENTS, "not a standard element");
+		static_assert(Def.std_cert_elements[Id].count > 0, "certificate definition doesn't have this element");
+		static_assert(Id != STDCERT_SIGNATURE || Def.type != CERTTYPE_X509, "X.509 signatures are variable-length DER, use atcacert_set_signature()");
+		static constexpr size_t offset = Def.std_cert_elements[Id].offset;  //!< Offset of the element in the certificate.
+		static constexpr size_t count = Def.std_cert_elements[Id].count;    //!< Size of the element.
+	};
+
+	/** \brief The runtime definition, for the C API. */
+	static constexpr const atcacert_def_t* def()
+	{
+		return &Def;
+	}
+
+	/** \brief Copies the template into a certificate buffer. */
+	template <size_t N>
+	static void init(uint8_t (&cert)[N])
+	{
+		static_assert(N >= template_size, "certificate buffer is smaller than the template");
+		memcpy(cert, Def.cert_template, template_size);
+	}
+
+	/** \brief Writes a standard element into a certificate. */
+	template <atcacert_std_cert_element_t Id, size_t N>
+	static void set_element(uint8_t (&cert)[N], const uint8_t (&data)[element<Id>::count])
+	{
+		static_assert(element<Id>::offset + element<Id>::count <= N, "element runs past the certificate buffer");
+		memcpy(&cert[element<Id>::offset], data, element<Id>::count);
+	}
+
+	/** \brief Reads a standard element from a certificate. */
+	template <atcacert_std_cert_element_t Id, size_t N>
+	static void get_element(const uint8_t (&cert)[N], uint8_t (&data)[element<Id>::count])
+	{
+		static_assert(element<Id>::offset + element<Id>::count <= N, "element runs past the certificate buffer");
+		memcpy(data, &cert[element<Id>::offset], element<Id>::count);
+	}
+
+	/** \brief Sets the subject public key and, when the definition has one, the subject key ID. */
+	template <size_t N>
+	static int set_subj_public_key(uint8_t (&cert)[N], const uint8_t (&public_key)[64])
+	{
+		const atcacert_cert_loc_t& key_id_loc = Def.std_cert_elements[STDCERT_SUBJ_KEY_ID];
+		uint8_t key_id[20];
+		int ret;
+
+		static_assert(element<STDCERT_PUBLIC_KEY>::count == 64, "use set_element() for padded public keys");
+		set_element<STDCERT_PUBLIC_KEY>(cert, public_key);
+		if (key_id_loc.count == 0)
+			return ATCA_SUCCESS;
+
+		static_assert(loc_fits(Def.std_cert_elements[STDCERT_SUBJ_KEY_ID], N), "subject key ID runs past the certificate buffer");
+		ret = atcacert_get_key_id(public_key, key_id);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+		memcpy(&cert[key_id_loc.offset], key_id, sizeof(key_id));
+
+		return ATCA_SUCCESS;
+	}
+
+	/** \brief Formats and sets the issue date. */
+	template <size_t N>
+	static int set_issue_date(uint8_t (&cert)[N], const atcacert_tm_utc_t& timestamp)
+	{
+		return set_date<STDCERT_ISSUE_DATE>(cert, Def.issue_date_format, timestamp);
+	}
+
+	/** \brief Formats and sets the expire date. */
+	template <size_t N>
+	static int set_expire_date(uint8_t (&cert)[N], const atcacert_tm_utc_t& timestamp)
+	{
+		return set_date<STDCERT_EXPIRE_DATE>(cert, Def.expire_date_format, timestamp);
+	}
+
+	/** \brief Pointer to the TBS data of a certificate, tbs_size bytes long. */
+	template <size_t N>
+	static const uint8_t* tbs(const uint8_t (&cert)[N])
+	{
+		static_assert(tbs_offset + tbs_size <= N, "TBS data runs past the certificate buffer");
+		return &cert[tbs_offset];
+	}
+
+	/** \brief SHA256 digest of a certificate's TBS data, resuming from the definition's tbs_midstate if it has one. */
+	template <size_t N>
+	static int get_tbs_digest(const uint8_t (&cert)[N], uint8_t (&tbs_digest)[32])
+	{
+		static_assert(tbs_offset + tbs_size <= N, "TBS data runs past the certificate buffer");
+		return atcacert_get_tbs_digest(&Def, cert, N, tbs_digest);
+	}
+
+	/**
+	 * \brief Checks that a runtime definition, typically the C one this constexpr definition
+	 *        mirrors, has the same layout and template. Meant for a one-time check at startup.
+	 */
+	static bool matches(const atcacert_def_t* cert_def)
+	{
+		size_t i;
+
+		if (cert_def == NULL || cert_def->type != Def.type || cert_def->template_id != Def.template_id
+		    || cert_def->chain_id != Def.chain_id || cert_def->cert_template_size != Def.cert_template_size
+		    || cert_def->issue_date_format != Def.issue_date_format || cert_def->expire_date_format != Def.expire_date_format
+		    || cert_def->tbs_cert_loc.offset != Def.tbs_cert_loc.offset || cert_def->tbs_cert_loc.count != Def.tbs_cert_loc.count)
+			return false;
+		for (i = 0; i < STDCERT_NUM_ELEMENTS; i++) {
+			if (cert_def->std_cert_elements[i].offset != Def.std_cert_elements[i].offset
+			    || cert_def->std_cert_elements[i].count != Def.std_cert_elements[i].count)
+				return false;
+		}
+
+		return cert_def->cert_template == Def.cert_template
+		       || memcmp(cert_def->cert_template, Def.cert_template, Def.cert_template_size) == 0;
+	}
+
+private:
+	template <atcacert_std_cert_element_t Id, size_t N>
+	static int set_date(uint8_t (&cert)[N], atcacert_date_format_t format, const atcacert_tm_utc_t& timestamp)
+	{
+		uint8_t formatted_date[DATEFMT_MAX_SIZE];
+		size_t formatted_date_size = sizeof(formatted_date);
+		int ret;
+
+		static_assert(element<Id>::offset + element<Id>::count <= N, "date runs past the certificate buffer");
+		ret = atcacert_date_enc(format, &timestamp, formatted_date, &formatted_date_size);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+		memcpy(&cert[element<Id>::offset], formatted_date, element<Id>::count);
+
+		return ATCA_SUCCESS;
+	}
+};
+
+}
+
+#endif // __cplusplus
+
+#endif // ATCACERT_DEF_STATIC_H
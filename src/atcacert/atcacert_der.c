@@ -89,28 +89,271 @@
 #include "atcacert_der.h"
 #include <string.h>
 
-int atcacert_der_enc_length(uint32_t length, uint8_t* der_length, size_t* der_length_size)
+size_t atcacert_der_length_size(uint32_t length)
 {
-	size_t der_length_size_calc = 0;
-	int exp = sizeof(length) - 1;
+	size_t size = 1;
 
-	if (der_length_size == NULL)
+	if (length < 0x80)
+		return 1; // Short form
+
+	// Long form, one byte for the number of bytes followed by the big-endian length
+	for (; length != 0; length >>= 8)
+		size++;
+
+	return size;
+}
+
+int atcacert_der_write_length(atcacert_der_out_t* out, uint32_t length)
+{
+	size_t size = atcacert_der_length_size(length);
+	size_t i;
+
+	if (out == NULL || out->ptr == NULL)
 		return ATCACERT_E_BAD_PARAMS;
 
-	if (length < 0x80) {
-		// The length can take the short form with only one byte
-		der_length_size_calc = 1;
-		exp = 0;
-	}else {
-		// Length is long-form, encoded as a multi-byte big-endian unsigned integer
+	if (out->size < size)
+		return ATCACERT_E_BUFFER_TOO_SMALL;
+
+	if (size == 1)
+		out->ptr[0] = (uint8_t)length;
+	else {
+		out->ptr[0] = 0x80 | (uint8_t)(size - 1); // Set number of bytes octet with long-form flag
+		for (i = size - 1; i > 0; i--, length >>= 8)
+			out->ptr[i] = (uint8_t)(length & 0xFF);
+	}
+
+	out->ptr  += size;
+	out->size -= size;
+
+	return ATCA_SUCCESS;
+}
+
+int atcacert_der_write_tl(atcacert_der_out_t* out, uint8_t tag, uint32_t length)
+{
+	if (out == NULL || out->ptr == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (out->size < 1 + atcacert_der_length_size(length))
+		return ATCACERT_E_BUFFER_TOO_SMALL;
+
+	out->ptr[0] = tag;
+	out->ptr++;
+	out->size--;
+
+	return atcacert_der_write_length(out, length);
+}
+
+/**
+ * \brief Number of leading bytes that can be dropped from an unsigned big-endian integer for its
+ *        minimal DER encoding.
+ */
+static size_t atcacert_der_uint_trim(const uint8_t* raw, size_t raw_size)
+{
+	size_t trim = 0;
+
+	// A leading zero is only needed when the following byte would read as negative
+	while (raw_size - trim >= 2 && raw[trim] == 0x00 && (raw[trim + 1] & 0x80) == 0)
+		trim++;
+
+	return trim;
+}
+
+size_t atcacert_der_uint_size(const uint8_t* raw, size_t raw_size)
+{
+	size_t trim;
+	size_t length;
+
+	if (raw == NULL || raw_size == 0)
+		return 0;
+
+	trim   = atcacert_der_uint_trim(raw, raw_size);
+	length = raw_size - trim + (raw[trim] >> 7); // Padding byte keeps the value positive
+
+	return 1 + atcacert_der_length_size((uint32_t)length) + length;
+}
+
+int atcacert_der_write_uint(atcacert_der_out_t* out, const uint8_t* raw, size_t raw_size)
+{
+	int ret = 0;
+	size_t trim;
+	size_t pad;
+
+	if (out == NULL || out->ptr == NULL || raw == NULL || raw_size == 0)
+		return ATCACERT_E_BAD_PARAMS;
+
+	trim = atcacert_der_uint_trim(raw, raw_size);
+	pad  = raw[trim] >> 7;
+
+	if (out->size < atcacert_der_uint_size(raw, raw_size))
+		return ATCACERT_E_BUFFER_TOO_SMALL;
+
+	ret = atcacert_der_write_tl(out, ATCACERT_DER_INTEGER, (uint32_t)(raw_size - trim + pad));
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	if (pad) {
+		out->ptr[0] = 0x00;
+		out->ptr++;
+		out->size--;
+	}
+	memcpy(out->ptr, &raw[trim], raw_size - trim);
+	out->ptr  += raw_size - trim;
+	out->size -= raw_size - trim;
+
+	return ATCA_SUCCESS;
+}
+
+int atcacert_der_read_tl(atcacert_der_span_t* span, uint8_t* tag, atcacert_der_span_t* value)
+{
+	int ret = 0;
+	size_t length_size = 0;
+	uint32_t length = 0;
+	const uint8_t* elem;
+
+	if (span == NULL || (span->ptr == NULL && span->size != 0))
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (span->size < 2)
+		return ATCACERT_E_DECODING_ERROR; // Not enough data for a tag and length
+
+	if ((span->ptr[0] & 0x1F) == 0x1F)
+		return ATCACERT_E_DECODING_ERROR; // Multi-byte tags not supported
+
+	length_size = span->size - 1;
+	ret = atcacert_der_dec_length(&span->ptr[1], &length_size, &length);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	if (length > span->size - 1 - length_size)
+		return ATCACERT_E_DECODING_ERROR; // Not enough data for the value
+
+	elem = span->ptr;
+	span->ptr  += 1 + length_size + length;
+	span->size -= 1 + length_size + length;
+
+	// Cursor is moved first so value can be the same span, stepping into the element
+	if (tag != NULL)
+		*tag = elem[0];
+	if (value != NULL) {
+		value->ptr  = &elem[1 + length_size];
+		value->size = length;
+	}
+
+	return ATCA_SUCCESS;
+}
+
+int atcacert_der_read(atcacert_der_span_t* span, uint8_t tag, atcacert_der_span_t* value)
+{
+	if (span == NULL || span->ptr == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	if (span->size < 1 || span->ptr[0] != tag)
+		return ATCACERT_E_DECODING_ERROR; // Unexpected tag value
+
+	return atcacert_der_read_tl(span, NULL, value);
+}
+
+int atcacert_der_read_uint(atcacert_der_span_t* span, uint8_t* raw, size_t raw_size)
+{
+	int ret = 0;
+	atcacert_der_span_t next;
+	atcacert_der_span_t value;
+
+	if (span == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	next = *span;
+	ret = atcacert_der_read(&next, ATCACERT_DER_INTEGER, &value);
+	if (ret != ATCA_SUCCESS)
+		return ret;
 
-		// Find first non-zero octet
-		while (length / ((uint32_t)1 << (8 * exp)) == 0)
-			exp--;
+	if (value.size == raw_size + 1 && value.ptr[0] == 0x00) {
+		// DER integer was 0-padded to keep it positive
+		value.ptr++;
+		value.size--;
+	}
+	if (value.size > raw_size)
+		return ATCACERT_E_DECODING_ERROR; // Integer is too large
+
+	if (raw != NULL) {
+		memset(raw, 0, raw_size - value.size);
+		memcpy(&raw[raw_size - value.size], value.ptr, value.size);
+	}
+
+	*span = next;
+
+	return ATCA_SUCCESS;
+}
+
+/**
+ * \brief Reads the next element and returns a span over all of it, tag and length included.
+ */
+static int atcacert_der_read_element(atcacert_der_span_t* span, uint8_t tag, atcacert_der_span_t* element)
+{
+	int ret = 0;
+	const uint8_t* start = span->ptr;
+	size_t start_size = span->size;
+
+	ret = atcacert_der_read(span, tag, NULL);
+	if (ret != ATCA_SUCCESS)
+		return ret;
 
-		der_length_size_calc = 2 + exp;
+	if (element != NULL) {
+		element->ptr  = start;
+		element->size = start_size - span->size;
 	}
 
+	return ATCA_SUCCESS;
+}
+
+int atcacert_der_split_cert( const uint8_t*       cert,
+                             size_t cert_size,
+                             atcacert_der_span_t* tbs,
+                             atcacert_der_span_t* sig_alg,
+                             atcacert_der_span_t* sig)
+{
+	int ret = 0;
+	atcacert_der_span_t span;
+
+	if (cert == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	span.ptr  = cert;
+	span.size = cert_size;
+
+	// Certificate ::= SEQUENCE { tbsCertificate, signatureAlgorithm, signatureValue }
+	ret = atcacert_der_read(&span, ATCACERT_DER_SEQUENCE, &span);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcacert_der_read_element(&span, ATCACERT_DER_SEQUENCE, tbs);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcacert_der_read_element(&span, ATCACERT_DER_SEQUENCE, sig_alg);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcacert_der_read_element(&span, ATCACERT_DER_BIT_STRING, sig);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	if (span.size != 0)
+		return ATCACERT_E_DECODING_ERROR; // Unexpected extra data in certificate
+
+	return ATCA_SUCCESS;
+}
+
+int atcacert_der_enc_length(uint32_t length, uint8_t* der_length, size_t* der_length_size)
+{
+	size_t der_length_size_calc = 0;
+	atcacert_der_out_t out;
+
+	if (der_length_size == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	der_length_size_calc = atcacert_der_length_size(length);
+
 	if (der_length != NULL && *der_length_size < der_length_size_calc) {
 		*der_length_size = der_length_size_calc;
 		return ATCACERT_E_BUFFER_TOO_SMALL;
@@ -121,14 +364,10 @@ int atcacert_der_enc_length(uint32_t length, uint8_t* der_length, size_t* der_le
 	if (der_length == NULL)
 		return ATCA_SUCCESS; // Caller is only requesting the size
 
-	// Encode length in big-endian format
-	for (; exp >= 0; exp--)
-		der_length[der_length_size_calc - 1 - exp] = (uint8_t)((length >> (exp * 8)) & 0xFF);
-
-	if (der_length_size_calc > 1)
-		der_length[0] = 0x80 | (uint8_t)(der_length_size_calc - 1); // Set number of bytes octet with long-form flag
+	out.ptr  = der_length;
+	out.size = der_length_size_calc;
 
-	return ATCA_SUCCESS;
+	return atcacert_der_write_length(&out, length);
 }
 
 int atcacert_der_dec_length(const uint8_t* der_length, size_t* der_length_size, uint32_t* length)
@@ -172,9 +411,10 @@ int atcacert_der_enc_integer( const uint8_t* int_data,
                               uint8_t*       der_int,
                               size_t*        der_int_size)
 {
-	uint8_t der_length[5];
-	size_t der_length_size = sizeof(der_length);
+	int ret = 0;
+	atcacert_der_out_t out;
 	size_t der_int_size_calc = 0;
+	size_t length = 0;
 	size_t trim = 0;
 	size_t pad = 0;
 
@@ -193,11 +433,8 @@ int atcacert_der_enc_integer( const uint8_t* int_data,
 		// Will be adding extra byte for unsigned padding so it's not interpreted as negative
 		pad = 1;
 
-	int ret = atcacert_der_enc_length(int_data_size + pad - trim, der_length, &der_length_size);
-	if (ret != ATCA_SUCCESS)
-		return ret;
-
-	der_int_size_calc = 1 + der_length_size + int_data_size + pad - trim;
+	length = int_data_size + pad - trim;
+	der_int_size_calc = 1 + atcacert_der_length_size((uint32_t)length) + length;
 
 	if (der_int != NULL && der_int_size_calc > *der_int_size) {
 		*der_int_size = der_int_size_calc;
@@ -207,13 +444,16 @@ int atcacert_der_enc_integer( const uint8_t* int_data,
 	*der_int_size = der_int_size_calc;
 
 	if (der_int == NULL)
-		return ATCA_SUCCESS;                                                      // Caller just wanted the size of the encoded integer
+		return ATCA_SUCCESS; // Caller just wanted the size of the encoded integer
 
-	der_int[0] = 0x02;                                                                  // Integer tag
-	memcpy(&der_int[1], der_length, der_length_size);                                   // Integer length
+	out.ptr  = der_int;
+	out.size = der_int_size_calc;
+	ret = atcacert_der_write_tl(&out, ATCACERT_DER_INTEGER, (uint32_t)length);
+	if (ret != ATCA_SUCCESS)
+		return ret;
 	if (pad)
-		der_int[der_length_size + 1] = 0;                                               // Unsigned integer value requires padding byte so it's not interpreted as negative
-	memcpy(&der_int[der_length_size + 1 + pad], &int_data[trim], int_data_size - trim); // Integer value
+		*out.ptr++ = 0;                                             // Unsigned integer value requires padding byte so it's not interpreted as negative
+	memcpy(out.ptr, &int_data[trim], int_data_size - trim);     // Integer value
 
 	return ATCA_SUCCESS;
 }
@@ -224,42 +464,34 @@ int atcacert_der_dec_integer( const uint8_t* der_int,
                               size_t*        int_data_size)
 {
 	int ret = 0;
-	size_t der_length_size = 0;
-	uint32_t int_data_size_calc = 0;
+	atcacert_der_span_t span;
+	atcacert_der_span_t value;
 
 	if (der_int == NULL || der_int_size == NULL || (int_data != NULL && int_data_size == NULL))
 		return ATCACERT_E_BAD_PARAMS;
 
-	if (*der_int_size < 1)
-		return ATCACERT_E_DECODING_ERROR; // No data to decode
-
-	if (der_int[0] != 0x02)
-		return ATCACERT_E_DECODING_ERROR; // Not an integer tag
-
-	der_length_size = *der_int_size - 1;
-	ret = atcacert_der_dec_length(&der_int[1], &der_length_size, &int_data_size_calc);
+	span.ptr  = der_int;
+	span.size = *der_int_size;
+	ret = atcacert_der_read(&span, ATCACERT_DER_INTEGER, &value);
 	if (ret != ATCA_SUCCESS)
 		return ret;
 
-	if (*der_int_size < (1 + der_length_size + int_data_size_calc))
-		return ATCACERT_E_DECODING_ERROR; // Invalid DER integer, not enough data.
-
-	*der_int_size = (1 + der_length_size + int_data_size_calc);
+	*der_int_size -= span.size;
 
 	if (int_data == NULL && int_data_size == NULL)
 		return ATCA_SUCCESS; // Caller doesn't want the actual data, just the der_int_size
 
-	if (int_data != NULL && *int_data_size < int_data_size_calc) {
-		*int_data_size = int_data_size_calc;
+	if (int_data != NULL && *int_data_size < value.size) {
+		*int_data_size = value.size;
 		return ATCACERT_E_BUFFER_TOO_SMALL;
 	}
 
-	*int_data_size = int_data_size_calc;
+	*int_data_size = value.size;
 
 	if (int_data == NULL)
 		return ATCA_SUCCESS; // Caller doesn't want the actual data, just the int_data_size
 
-	memcpy(int_data, &der_int[1 + der_length_size], int_data_size_calc);
+	memcpy(int_data, value.ptr, value.size);
 
 	return ATCA_SUCCESS;
 }
@@ -269,26 +501,18 @@ int atcacert_der_enc_ecdsa_sig_value( const uint8_t raw_sig[64],
                                       size_t*       der_sig_size)
 {
 	int ret = 0;
-	size_t r_size = 0;
-	size_t s_size = 0;
+	atcacert_der_out_t out;
+	size_t seq_length = 0;
+	size_t bs_length = 0;
 	size_t der_sig_size_calc = 0;
 
 	if (raw_sig == NULL || der_sig_size == NULL)
 		return ATCACERT_E_BAD_PARAMS;
 
-	// Find size of the DER encoded R integer
-	ret = atcacert_der_enc_integer(&raw_sig[0], 32, TRUE, NULL, &r_size);
-	if (ret != ATCA_SUCCESS)
-		return ret;
-
-	// Find size of the DER encoded S integer
-	ret = atcacert_der_enc_integer(&raw_sig[32], 32, TRUE, NULL, &s_size);
-	if (ret != ATCA_SUCCESS)
-		return ret;
-
-	// This calculation assumes all DER lengths are a single byte, which is fine for 32 byte
-	// R and S integers.
-	der_sig_size_calc = 5 + r_size + s_size;
+	// signatureValue bit string holds a spare bits byte and the ECDSA-Sig-Value sequence of R and S
+	seq_length = atcacert_der_uint_size(&raw_sig[0], 32) + atcacert_der_uint_size(&raw_sig[32], 32);
+	bs_length  = 1 + 1 + atcacert_der_length_size((uint32_t)seq_length) + seq_length;
+	der_sig_size_calc = 1 + atcacert_der_length_size((uint32_t)bs_length) + bs_length;
 
 	if (der_sig != NULL && *der_sig_size < der_sig_size_calc) {
 		*der_sig_size = der_sig_size_calc;
@@ -298,27 +522,26 @@ int atcacert_der_enc_ecdsa_sig_value( const uint8_t raw_sig[64],
 	*der_sig_size = der_sig_size_calc;
 
 	if (der_sig == NULL)
-		return ATCA_SUCCESS;                  // Caller just wanted the encoded size
+		return ATCA_SUCCESS; // Caller just wanted the encoded size
 
-	der_sig[0] = 0x03;                              // signatureValue bit string tag
-	der_sig[1] = (uint8_t)(der_sig_size_calc - 2);  // signatureValue bit string length
-	der_sig[2] = 0x00;                              // signatureValue bit string spare bits
+	out.ptr  = der_sig;
+	out.size = der_sig_size_calc;
 
-	// signatureValue bit string value is the DER encoding of ECDSA-Sig-Value
-	der_sig[3] = 0x30;                              // sequence tag
-	der_sig[4] = (uint8_t)(der_sig_size_calc - 5);  // sequence length
+	ret = atcacert_der_write_tl(&out, ATCACERT_DER_BIT_STRING, (uint32_t)bs_length);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	*out.ptr++ = 0x00; // signatureValue bit string spare bits
+	out.size--;
 
-	// Add R integer
-	ret = atcacert_der_enc_integer(&raw_sig[0], 32, TRUE, &der_sig[5], &r_size);
+	ret = atcacert_der_write_tl(&out, ATCACERT_DER_SEQUENCE, (uint32_t)seq_length);
 	if (ret != ATCA_SUCCESS)
 		return ret;
 
-	// Add S integer
-	ret = atcacert_der_enc_integer(&raw_sig[32], 32, TRUE, &der_sig[5 + r_size], &s_size);
+	ret = atcacert_der_write_uint(&out, &raw_sig[0], 32);
 	if (ret != ATCA_SUCCESS)
 		return ret;
 
-	return ATCA_SUCCESS;
+	return atcacert_der_write_uint(&out, &raw_sig[32], 32);
 }
 
 int atcacert_der_dec_ecdsa_sig_value( const uint8_t* der_sig,
@@ -326,117 +549,45 @@ int atcacert_der_dec_ecdsa_sig_value( const uint8_t* der_sig,
                                       uint8_t raw_sig[64])
 {
 	int ret = 0;
-	size_t curr_idx = 0;
-	size_t dec_size = 0;
-	uint32_t bs_length = 0;
-	uint32_t seq_length = 0;
-	size_t r_size = 0;
-	size_t s_size = 0;
-	uint8_t int_data[33];
-	size_t int_data_size = 0;
+	atcacert_der_span_t span;
+	atcacert_der_span_t bs;
+	atcacert_der_span_t seq;
 
 	if (der_sig == NULL || der_sig_size == NULL)
 		return ATCACERT_E_BAD_PARAMS;
 
-	if (*der_sig_size < 1)
-		return ATCACERT_E_DECODING_ERROR; // No data to decode
-
-	// signatureValue bit string tag
-	curr_idx = 0;
-	if (der_sig[curr_idx] != 0x03)
-		return ATCACERT_E_DECODING_ERROR; // Unexpected tag value
-	curr_idx++;
+	span.ptr  = der_sig;
+	span.size = *der_sig_size;
 
-	// signatureValue bit string length
-	dec_size = *der_sig_size - curr_idx;
-	ret = atcacert_der_dec_length(&der_sig[curr_idx], &dec_size, &bs_length);
+	// signatureValue bit string
+	ret = atcacert_der_read(&span, ATCACERT_DER_BIT_STRING, &bs);
 	if (ret != ATCA_SUCCESS)
-		return ret; // Failed to decode length
-	curr_idx += dec_size;
-	if (curr_idx + bs_length > *der_sig_size)
-		return ATCACERT_E_DECODING_ERROR; // Not enough data in buffer to decode the rest
+		return ret;
 
 	// signatureValue bit string spare bits
-	if (curr_idx >= *der_sig_size)
-		return ATCACERT_E_DECODING_ERROR;   // No data left
-	if (der_sig[curr_idx] != 0x00)
-		return ATCACERT_E_DECODING_ERROR;   // Unexpected spare bits value
-	curr_idx++;
+	if (bs.size < 1 || bs.ptr[0] != 0x00)
+		return ATCACERT_E_DECODING_ERROR; // Unexpected spare bits value
+	bs.ptr++;
+	bs.size--;
 
 	// signatureValue bit string value is the DER encoding of ECDSA-Sig-Value
-
-	// sequence tag
-	if (curr_idx >= *der_sig_size)
-		return ATCACERT_E_DECODING_ERROR;   // No data left
-	if (der_sig[curr_idx] != 0x30)
-		return ATCACERT_E_DECODING_ERROR;   // Unexpected tag value
-	curr_idx++;
-
-	// sequence length
-	if (curr_idx >= *der_sig_size)
-		return ATCACERT_E_DECODING_ERROR; // No data left
-	dec_size = *der_sig_size - curr_idx;
-	ret = atcacert_der_dec_length(&der_sig[curr_idx], &dec_size, &seq_length);
+	ret = atcacert_der_read(&bs, ATCACERT_DER_SEQUENCE, &seq);
 	if (ret != ATCA_SUCCESS)
-		return ret; // Failed to decode length
-	curr_idx += dec_size;
-	if (curr_idx + seq_length > *der_sig_size)
-		return ATCACERT_E_DECODING_ERROR; // Not enough data in buffer to decode the rest
-
-	// R integer
-	if (curr_idx >= *der_sig_size)
-		return ATCACERT_E_DECODING_ERROR; // No data left
-	r_size = *der_sig_size - curr_idx;
-	int_data_size = sizeof(int_data);
-	ret = atcacert_der_dec_integer(&der_sig[curr_idx], &r_size, int_data, &int_data_size);
+		return ret;
+	if (bs.size != 0)
+		return ATCACERT_E_DECODING_ERROR; // Unexpected extra data in bit string
+
+	// R and S integers go straight into their halves of the raw signature
+	ret = atcacert_der_read_uint(&seq, raw_sig == NULL ? NULL : &raw_sig[0], 32);
 	if (ret != ATCA_SUCCESS)
-		return ret; // Failed to decode length
-	curr_idx += r_size;
-
-	if (raw_sig != NULL)
-		memset(raw_sig, 0, 64); // Zero out the raw sig as the decoded integers may not touch all bytes
-
-	if (int_data_size <= 32) {
-		if (raw_sig != NULL)
-			memcpy(&raw_sig[32 - int_data_size], &int_data[0], int_data_size);
-	}else if (int_data_size == 33) {
-		if (int_data[0] != 0x00)
-			return ATCACERT_E_DECODING_ERROR; // R integer is too large
-		// DER integer was 0-padded to keep it positive
-		if (raw_sig != NULL)
-			memcpy(&raw_sig[0], &int_data[1], 32);
-	}else
-		return ATCACERT_E_DECODING_ERROR; // R integer is too large
-
-	// S integer
-	if (curr_idx >= *der_sig_size)
-		return ATCACERT_E_DECODING_ERROR; // No data left
-	s_size = *der_sig_size - curr_idx;
-	int_data_size = sizeof(int_data);
-	ret = atcacert_der_dec_integer(&der_sig[curr_idx], &s_size, int_data, &int_data_size);
+		return ret;
+	ret = atcacert_der_read_uint(&seq, raw_sig == NULL ? NULL : &raw_sig[32], 32);
 	if (ret != ATCA_SUCCESS)
-		return ret; // Failed to decode length
-	curr_idx += s_size;
-
-	if (int_data_size <= 32) {
-		if (raw_sig != NULL)
-			memcpy(&raw_sig[64 - int_data_size], &int_data[0], int_data_size);
-	}else if (int_data_size == 33) {
-		if (int_data[0] != 0x00)
-			return ATCACERT_E_DECODING_ERROR; // S integer is too large
-		// DER integer was 0-padded to keep it positive
-		if (raw_sig != NULL)
-			memcpy(&raw_sig[32], &int_data[1], 32);
-	}else
-		return ATCACERT_E_DECODING_ERROR; // S integer is too large
-
-	if (seq_length != r_size + s_size)
+		return ret;
+	if (seq.size != 0)
 		return ATCACERT_E_DECODING_ERROR; // Unexpected extra data in sequence
 
-	if (bs_length != r_size + s_size + 3)
-		return ATCACERT_E_DECODING_ERROR; // Unexpected extra data in bit string
-
-	*der_sig_size = curr_idx;
+	*der_sig_size -= span.size;
 
 	return ATCA_SUCCESS;
-}
\ No newline at end of file
+}
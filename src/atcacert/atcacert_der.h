@@ -106,6 +106,39 @@ extern "C" {
  *
    @{ */
 
+#define ATCACERT_DER_BOOLEAN          0x01    //!< ASN.1 BOOLEAN tag
+#define ATCACERT_DER_INTEGER          0x02    //!< ASN.1 INTEGER tag
+#define ATCACERT_DER_BIT_STRING       0x03    //!< ASN.1 BIT STRING tag
+#define ATCACERT_DER_OCTET_STRING     0x04    //!< ASN.1 OCTET STRING tag
+#define ATCACERT_DER_OID              0x06    //!< ASN.1 OBJECT IDENTIFIER tag
+#define ATCACERT_DER_UTC_TIME         0x17    //!< ASN.1 UTCTime tag
+#define ATCACERT_DER_GENERALIZED_TIME 0x18    //!< ASN.1 GeneralizedTime tag
+#define ATCACERT_DER_SEQUENCE         0x30    //!< ASN.1 SEQUENCE (constructed) tag
+#define ATCACERT_DER_SET              0x31    //!< ASN.1 SET (constructed) tag
+
+/**
+ * \brief Read cursor over DER encoded data.
+ *
+ * Points straight into the buffer being parsed, nothing is copied. Reading an element moves the
+ * cursor past it and hands back a span over the element's value, which can be read in turn to
+ * walk into constructed types.
+ */
+typedef struct atcacert_der_span_s {
+	const uint8_t* ptr;     //!< Next byte to be read.
+	size_t size;            //!< Bytes left to read.
+} atcacert_der_span_t;
+
+/**
+ * \brief Write cursor over a buffer receiving DER encoded data.
+ *
+ * Writing an element moves the cursor past it. The atcacert_der_*_size() functions give the size
+ * of an element up front, so a containing element's header can be written before its contents.
+ */
+typedef struct atcacert_der_out_s {
+	uint8_t* ptr;           //!< Where the next byte will be written.
+	size_t size;            //!< Bytes of room left.
+} atcacert_der_out_t;
+
 /**
  * \brief Encode a length in DER format.
  *
@@ -215,6 +248,101 @@ int atcacert_der_dec_ecdsa_sig_value( const uint8_t * der_sig,
                                       size_t *        der_sig_size,
                                       uint8_t raw_sig[64]);
 
+/**
+ * \brief Reads the tag and length of the next element and moves the cursor past the whole
+ *        element.
+ *
+ * Only single byte tags are supported.
+ *
+ * \param[inout] span   Cursor to read from. Left unchanged on error.
+ * \param[out]   tag    Element tag is returned here. Can be NULL.
+ * \param[out]   value  Span over the element value is returned here. Can be NULL.
+ *
+ * \return 0 on success
+ */
+int atcacert_der_read_tl(atcacert_der_span_t* span, uint8_t* tag, atcacert_der_span_t* value);
+
+/**
+ * \brief Reads the next element, which must have the expected tag, and moves the cursor past it.
+ *
+ * \param[inout] span   Cursor to read from. Left unchanged on error.
+ * \param[in]    tag    Expected element tag.
+ * \param[out]   value  Span over the element value is returned here. Can be NULL.
+ *
+ * \return 0 on success, ATCACERT_E_DECODING_ERROR if the tag doesn't match.
+ */
+int atcacert_der_read(atcacert_der_span_t* span, uint8_t tag, atcacert_der_span_t* value);
+
+/**
+ * \brief Reads a non-negative INTEGER element straight into a fixed size big-endian buffer.
+ *
+ * The value is right-aligned and zero filled on the left. A value one byte longer than raw_size
+ * is accepted when that byte is the 0x00 padding DER adds to keep the integer positive.
+ *
+ * \param[inout] span      Cursor to read from. Left unchanged on error.
+ * \param[out]   raw       Integer is returned here. Can be NULL to only validate and skip it.
+ * \param[in]    raw_size  Size of raw in bytes.
+ *
+ * \return 0 on success
+ */
+int atcacert_der_read_uint(atcacert_der_span_t* span, uint8_t* raw, size_t raw_size);
+
+/**
+ * \brief Size of the DER encoding of a length in bytes.
+ */
+size_t atcacert_der_length_size(uint32_t length);
+
+/**
+ * \brief Size in bytes of the INTEGER element (tag, length, and value) atcacert_der_write_uint()
+ *        produces for an unsigned big-endian integer.
+ */
+size_t atcacert_der_uint_size(const uint8_t* raw, size_t raw_size);
+
+/**
+ * \brief Writes a DER length at the cursor and moves the cursor past it.
+ *
+ * \return 0 on success, ATCACERT_E_BUFFER_TOO_SMALL if there isn't room.
+ */
+int atcacert_der_write_length(atcacert_der_out_t* out, uint32_t length);
+
+/**
+ * \brief Writes an element tag and length at the cursor and moves the cursor past them. The
+ *        caller writes the value next.
+ *
+ * \return 0 on success, ATCACERT_E_BUFFER_TOO_SMALL if there isn't room.
+ */
+int atcacert_der_write_tl(atcacert_der_out_t* out, uint8_t tag, uint32_t length);
+
+/**
+ * \brief Writes an unsigned big-endian integer as a minimal INTEGER element at the cursor and
+ *        moves the cursor past it.
+ *
+ * \return 0 on success, ATCACERT_E_BUFFER_TOO_SMALL if there isn't room.
+ */
+int atcacert_der_write_uint(atcacert_der_out_t* out, const uint8_t* raw, size_t raw_size);
+
+/**
+ * \brief Skip-scans an X.509 certificate (RFC 5280) for its top level elements without
+ *        copying anything.
+ *
+ * Returned spans cover whole elements, including tag and length, as they sit in the
+ * certificate: tbs is what gets signed and sig is what atcacert_der_dec_ecdsa_sig_value()
+ * parses.
+ *
+ * \param[in]  cert       DER encoded certificate.
+ * \param[in]  cert_size  Size of the certificate buffer in bytes.
+ * \param[out] tbs        tbsCertificate element. Can be NULL.
+ * \param[out] sig_alg    signatureAlgorithm element. Can be NULL.
+ * \param[out] sig        signatureValue element. Can be NULL.
+ *
+ * \return 0 on success
+ */
+int atcacert_der_split_cert( const uint8_t*       cert,
+                             size_t cert_size,
+                             atcacert_der_span_t* tbs,
+                             atcacert_der_span_t* sig_alg,
+                             atcacert_der_span_t* sig);
+
 /** @} */
 #ifdef __cplusplus
 }
@@ -96,8 +96,6 @@ int atcacert_verify_cert_hw( const atcacert_def_t* cert_def,
 {
 	int ret = 0;
 	uint8_t tbs_digest[32];
-	uint8_t signature[64];
-	bool is_verified = false;
 
 	if (cert_def == NULL || ca_public_key == NULL || cert == NULL)
 		return ATCACERT_E_BAD_PARAMS;
@@ -106,6 +104,22 @@ int atcacert_verify_cert_hw( const atcacert_def_t* cert_def,
 	if (ret != ATCA_SUCCESS)
 		return ret;
 
+	return atcacert_verify_digest_hw(cert_def, cert, cert_size, tbs_digest, ca_public_key);
+}
+
+int atcacert_verify_digest_hw( const atcacert_def_t* cert_def,
+                               const uint8_t*        cert,
+                               size_t cert_size,
+                               const uint8_t tbs_digest[32],
+                               const uint8_t ca_public_key[64])
+{
+	int ret = 0;
+	uint8_t signature[64];
+	bool is_verified = false;
+
+	if (cert_def == NULL || ca_public_key == NULL || cert == NULL || tbs_digest == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
 	ret = atcacert_get_signature(cert_def, cert, cert_size, signature);
 	if (ret != ATCA_SUCCESS)
 		return ret;
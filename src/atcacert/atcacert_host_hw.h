@@ -125,6 +125,26 @@ int atcacert_verify_cert_hw( const atcacert_def_t* cert_def,
                              size_t cert_size,
                              const uint8_t ca_public_key[64]);
 
+/**
+ * \brief Verify a certificate whose TBS digest is already known, e.g. from
+ *        atcacert_get_tbs_digest, using the host's ATECC device for crypto functions.
+ *
+ * \param[in] cert_def       Certificate definition describing where the signature is.
+ * \param[in] cert           Certificate to verify.
+ * \param[in] cert_size      Size of the certificate (cert) in bytes.
+ * \param[in] tbs_digest     SHA256 digest of the certificate's TBS data. 32 bytes.
+ * \param[in] ca_public_key  The ECC P256 public key of the certificate authority that signed this
+ *                           certificate (64 bytes).
+ *
+ * \return 0 if the verify succeeds, ATCACERT_VERIFY_FAILED or ATCA_EXECUTION_ERROR if it fails to
+ *         verify.
+ */
+int atcacert_verify_digest_hw( const atcacert_def_t* cert_def,
+                               const uint8_t*        cert,
+                               size_t cert_size,
+                               const uint8_t tbs_digest[32],
+                               const uint8_t ca_public_key[64]);
+
 /**
  * \brief Generate a random challenge to be sent to the client using the RNG on the host's ATECC
  *        device.
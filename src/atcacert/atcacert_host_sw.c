@@ -97,7 +97,6 @@ ATCA_STATUS atcacert_verify_cert_sw( const atcacert_def_t* cert_def,
 {
 	ATCA_STATUS ret = 0;
 	uint8_t tbs_digest[32];
-	uint8_t signature[64];
 
 	if (cert_def == NULL || ca_public_key == NULL || cert == NULL)
 		return ATCACERT_E_BAD_PARAMS;
@@ -106,6 +105,21 @@ ATCA_STATUS atcacert_verify_cert_sw( const atcacert_def_t* cert_def,
 	if (ret != ATCA_SUCCESS)
 		return ret;
 
+	return atcacert_verify_digest_sw(cert_def, cert, cert_size, tbs_digest, ca_public_key);
+}
+
+ATCA_STATUS atcacert_verify_digest_sw( const atcacert_def_t* cert_def,
+                                       const uint8_t* cert,
+                                       size_t cert_size,
+                                       const uint8_t tbs_digest[32],
+                                       const uint8_t ca_public_key[64])
+{
+	ATCA_STATUS ret = 0;
+	uint8_t signature[64];
+
+	if (cert_def == NULL || ca_public_key == NULL || cert == NULL || tbs_digest == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
 	ret = atcacert_get_signature(cert_def, cert, cert_size, signature);
 	if (ret != ATCA_SUCCESS)
 		return ret;
@@ -117,6 +131,29 @@ ATCA_STATUS atcacert_verify_cert_sw( const atcacert_def_t* cert_def,
 	return ATCA_SUCCESS;
 }
 
+ATCA_STATUS atcacert_verify_cert_fixed_sw( const atcacert_def_t* cert_def,
+                                   const uint8_t* cert,
+                                   size_t cert_size,
+                                   const ecc_fixed_base_t* ca_public_table)
+{
+	ATCA_STATUS ret = 0;
+	uint8_t tbs_digest[32];
+	uint8_t signature[64];
+
+	if (cert_def == NULL || ca_public_table == NULL || cert == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	ret = atcacert_get_tbs_digest(cert_def, cert, cert_size, tbs_digest);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcacert_get_signature(cert_def, cert, cert_size, signature);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	return atcac_sw_ecdsa_verify_p256_fixed(tbs_digest, signature, ca_public_table);
+}
+
 uint16_t atcacert_gen_challenge_sw( uint8_t challenge[32] )
 {
 	if (challenge == NULL)
@@ -92,6 +92,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include "atcacert_def.h"
+#include "crypto/atca_crypto_sw_ecdsa.h"
 
 // Inform function naming when compiling in C++
 #ifdef __cplusplus
@@ -125,6 +126,43 @@ ATCA_STATUS atcacert_verify_cert_sw( const atcacert_def_t* cert_def,
                              size_t cert_size,
                              const uint8_t ca_public_key[64]);
 
+/**
+ * \brief Verify a certificate whose TBS digest is already known, e.g. from
+ *        atcacert_get_tbs_digest, using software crypto functions.
+ *
+ * \param[in] cert_def       Certificate definition describing where the signature is.
+ * \param[in] cert           Certificate to verify.
+ * \param[in] cert_size      Size of the certificate (cert) in bytes.
+ * \param[in] tbs_digest     SHA256 digest of the certificate's TBS data. 32 bytes.
+ * \param[in] ca_public_key  The ECC P256 public key of the certificate authority that signed this
+ *                           certificate (64 bytes).
+ *
+ * \return 0 if the verify succeeds, ATCACERT_VERIFY_FAILED if it fails to verify.
+ */
+ATCA_STATUS atcacert_verify_digest_sw( const atcacert_def_t* cert_def,
+                                       const uint8_t* cert,
+                                       size_t cert_size,
+                                       const uint8_t tbs_digest[32],
+                                       const uint8_t ca_public_key[64]);
+
+/**
+ * \brief Verify a certificate against a fixed certificate authority key that has been expanded
+ *        into a comb table (see ecc_fixed_base_precompute()). Faster than atcacert_verify_cert_sw()
+ *        when the CA key is known at build time.
+ *
+ * \param[in] cert_def          Certificate definition describing how to extract the TBS and
+ *                              signature components from the certificate specified.
+ * \param[in] cert              Certificate to verify.
+ * \param[in] cert_size         Size of the certificate (cert) in bytes.
+ * \param[in] ca_public_table   Comb table of the certificate authority public key.
+ *
+ * \return 0 if the verify succeeds, ATCACERT_VERIFY_FAILED if it fails to verify.
+ */
+ATCA_STATUS atcacert_verify_cert_fixed_sw( const atcacert_def_t* cert_def,
+                                   const uint8_t* cert,
+                                   size_t cert_size,
+                                   const ecc_fixed_base_t* ca_public_table);
+
 /**
  * \brief Generate a random challenge to be sent to the client using a software PRNG.
  *
@@ -0,0 +1,367 @@
+/**
+ * \file
+ * \brief Bulk issuance of certificates from a certificate definition.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#include <string.h>
+#include "atcacert_issue.h"
+#include "crypto/atca_crypto_sw_ecdsa.h"
+#include "crypto/atca_crypto_sw_sha2.h"
+
+#if ATCACERT_ISSUE_THREADS > 1
+#include <pthread.h>
+#endif
+
+/** \brief Certificates whose key IDs are hashed together, see atcacert_get_key_ids(). */
+#define ATCACERT_ISSUE_KEY_ID_BATCH (8)
+
+/** \brief Largest DER encoded X.509 signature: a BIT STRING around a SEQUENCE of two 33-byte INTEGERs. */
+#define ATCACERT_ISSUE_DER_SIG_MAX_SIZE (75)
+
+static int atcacert_issue_sign_sw(const uint8_t tbs_digest[32], uint8_t signature[64], const void* context)
+{
+	if (context == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	return atcac_sw_ecdsa_sign_p256(tbs_digest, (const uint8_t*)context, signature);
+}
+
+const atcacert_issue_signer_t atcacert_issue_signer_sw = { atcacert_issue_sign_sw, true };
+
+/** \brief State shared by everything that issues certificates of one batch. */
+typedef struct {
+	const atcacert_issue_batch_t*  batch;
+	const atcacert_issue_signer_t* signer;
+	const void*                    context;
+	uint8_t*                       arena;           //!< The prototype is certificate 0 until everything else is copied from it.
+	size_t stride;
+	size_t*                        cert_sizes;
+	uint8_t (*tbs_digests)[32];
+	size_t prefix_size;                             //!< TBS bytes of the prototype hashed into ctx.
+	atcac_sha2_256_ctx ctx;
+} atcacert_issue_work_t;
+
+size_t atcacert_issue_cert_stride( const atcacert_def_t* cert_def )
+{
+	size_t sig_end;
+
+	if (cert_def == NULL)
+		return 0;
+	if (cert_def->type != CERTTYPE_X509)
+		return cert_def->cert_template_size;
+
+	sig_end = (size_t)cert_def->std_cert_elements[STDCERT_SIGNATURE].offset + ATCACERT_ISSUE_DER_SIG_MAX_SIZE;
+
+	return (sig_end > cert_def->cert_template_size) ? sig_end : cert_def->cert_template_size;
+}
+
+/**
+ * \brief Number of TBS bytes, in whole SHA256 blocks, ahead of the first element that differs
+ *        between the certificates of a batch.
+ */
+static size_t atcacert_issue_prefix_size( const atcacert_def_t* cert_def )
+{
+	static const atcacert_std_cert_element_t per_cert[] = { STDCERT_PUBLIC_KEY, STDCERT_SUBJ_KEY_ID, STDCERT_CERT_SN };
+	size_t tbs_start = cert_def->tbs_cert_loc.offset;
+	size_t first = tbs_start + cert_def->tbs_cert_loc.count;
+	size_t i;
+
+	for (i = 0; i < sizeof(per_cert) / sizeof(per_cert[0]); i++) {
+		const atcacert_cert_loc_t* loc = &cert_def->std_cert_elements[per_cert[i]];
+		if (loc->count > 0 && loc->offset + loc->count > tbs_start && loc->offset < first)
+			first = loc->offset;
+	}
+	if (first < tbs_start)
+		return 0;
+
+	return (first - tbs_start) & ~(size_t)(ATCA_SHA2_256_BLOCK_SIZE - 1);
+}
+
+/** \brief Writes the template and the elements every certificate of the batch shares into cert. */
+static int atcacert_issue_prototype( const atcacert_issue_batch_t* batch, uint8_t* cert )
+{
+	int ret = ATCA_SUCCESS;
+	const atcacert_def_t* cert_def = batch->cert_def;
+	size_t cert_size = cert_def->cert_template_size;
+	atcacert_tm_utc_t expire_date;
+
+	memcpy(cert, cert_def->cert_template, cert_size);
+
+	if (batch->issue_date != NULL) {
+		ret = atcacert_set_issue_date(cert_def, cert, cert_size, batch->issue_date);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+
+	if (batch->expire_date != NULL) {
+		ret = atcacert_set_expire_date(cert_def, cert, cert_size, batch->expire_date);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}else if (batch->issue_date != NULL) {
+		// Same rule as the compressed certificate, an expire_years of 0 never expires
+		if (cert_def->expire_years != 0) {
+			expire_date = *batch->issue_date;
+			expire_date.tm_year += cert_def->expire_years;
+		}else {
+			ret = atcacert_date_get_max_date(cert_def->expire_date_format, &expire_date);
+			if (ret != ATCA_SUCCESS)
+				return ret;
+		}
+		ret = atcacert_set_expire_date(cert_def, cert, cert_size, &expire_date);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+
+	if (batch->signer_id != NULL) {
+		ret = atcacert_set_signer_id(cert_def, cert, cert_size, batch->signer_id);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+
+	if (batch->auth_public_key != NULL) {
+		ret = atcacert_set_auth_key_id(cert_def, cert, cert_size, batch->auth_public_key);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief Issues certificate i from the prototype. Certificate 0 is the prototype itself. */
+static int atcacert_issue_cert( const atcacert_issue_work_t* work, size_t i, const uint8_t key_id[20] )
+{
+	int ret = ATCA_SUCCESS;
+	const atcacert_issue_batch_t* batch = work->batch;
+	const atcacert_def_t* cert_def = batch->cert_def;
+	size_t cert_size = cert_def->cert_template_size;
+	size_t sn_size = cert_def->std_cert_elements[STDCERT_CERT_SN].count;
+	uint8_t* cert = &work->arena[i * work->stride];
+	atcac_sha2_256_ctx ctx;
+	uint8_t tbs_digest[32];
+	uint8_t signature[64];
+	uint8_t padded_key[72];
+
+	if (i != 0)
+		memcpy(cert, work->arena, cert_size);
+	work->cert_sizes[i] = cert_size;
+
+	if (cert_def->type != CERTTYPE_X509 && cert_def->std_cert_elements[STDCERT_PUBLIC_KEY].count == 72) {
+		// Same padded form as atcacert_set_subj_public_key()
+		atcacert_public_key_add_padding(batch->public_keys[i], padded_key);
+		ret = atcacert_set_cert_element(&cert_def->std_cert_elements[STDCERT_PUBLIC_KEY], cert, cert_size, padded_key, 72);
+	}else
+		ret = atcacert_set_cert_element(&cert_def->std_cert_elements[STDCERT_PUBLIC_KEY], cert, cert_size, batch->public_keys[i], 64);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	ret = atcacert_set_cert_element(&cert_def->std_cert_elements[STDCERT_SUBJ_KEY_ID], cert, cert_size, key_id, 20);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	if (batch->cert_sns != NULL)
+		ret = atcacert_set_cert_sn(cert_def, cert, cert_size, &batch->cert_sns[i * sn_size], sn_size);
+	else
+		ret = atcacert_gen_cert_sn(cert_def, cert, cert_size, (batch->device_sns != NULL) ? batch->device_sns[i] : NULL);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ctx = work->ctx;
+	ret = atcac_sw_sha2_256_update(&ctx, &cert[cert_def->tbs_cert_loc.offset + work->prefix_size], cert_def->tbs_cert_loc.count - work->prefix_size);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	ret = atcac_sw_sha2_256_finish(&ctx, tbs_digest);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	if (work->tbs_digests != NULL)
+		memcpy(work->tbs_digests[i], tbs_digest, sizeof(tbs_digest));
+
+	if (work->signer == NULL)
+		return ATCA_SUCCESS;
+
+	ret = work->signer->sign(tbs_digest, signature, work->context);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	return atcacert_set_signature(cert_def, cert, &work->cert_sizes[i], work->stride, signature);
+}
+
+/** \brief Certificates [begin, end) of a batch and the first error among them. */
+typedef struct {
+	const atcacert_issue_work_t* work;
+	size_t begin;
+	size_t end;
+	int ret;
+} atcacert_issue_range_t;
+
+static void* atcacert_issue_worker(void* arg)
+{
+	atcacert_issue_range_t* range = (atcacert_issue_range_t*)arg;
+	uint8_t key_ids[ATCACERT_ISSUE_KEY_ID_BATCH][20];
+	size_t i, j, n;
+
+	for (i = range->begin; i < range->end; i += n) {
+		n = range->end - i;
+		if (n > ATCACERT_ISSUE_KEY_ID_BATCH)
+			n = ATCACERT_ISSUE_KEY_ID_BATCH;
+
+		range->ret = atcacert_get_key_ids(&range->work->batch->public_keys[i], n, key_ids);
+		if (range->ret != ATCA_SUCCESS)
+			return NULL;
+		for (j = 0; j < n; j++) {
+			range->ret = atcacert_issue_cert(range->work, i + j, key_ids[j]);
+			if (range->ret != ATCA_SUCCESS)
+				return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+#if ATCACERT_ISSUE_THREADS > 1
+
+/** \brief Issues certificates 1 to count - 1 on several threads, one slice each. */
+static int atcacert_issue_threads( const atcacert_issue_work_t* work, size_t count, size_t threads )
+{
+	atcacert_issue_range_t ranges[ATCACERT_ISSUE_THREADS];
+	pthread_t ids[ATCACERT_ISSUE_THREADS];
+	bool started[ATCACERT_ISSUE_THREADS];
+	size_t t;
+
+	for (t = 0; t < threads; t++) {
+		ranges[t].work  = work;
+		ranges[t].begin = 1 + (count - 1) * t / threads;
+		ranges[t].end   = 1 + (count - 1) * (t + 1) / threads;
+		ranges[t].ret   = ATCA_SUCCESS;
+	}
+
+	// This thread takes the first slice, a slice whose thread fails to start is issued here too
+	for (t = 1; t < threads; t++) {
+		started[t] = pthread_create(&ids[t], NULL, atcacert_issue_worker, &ranges[t]) == 0;
+		if (!started[t])
+			atcacert_issue_worker(&ranges[t]);
+	}
+	atcacert_issue_worker(&ranges[0]);
+	for (t = 1; t < threads; t++) {
+		if (started[t])
+			pthread_join(ids[t], NULL);
+	}
+
+	for (t = 0; t < threads; t++) {
+		if (ranges[t].ret != ATCA_SUCCESS)
+			return ranges[t].ret;
+	}
+
+	return ATCA_SUCCESS;
+}
+
+#endif
+
+int atcacert_issue_certs( const atcacert_issue_batch_t*  batch,
+                          const atcacert_issue_signer_t* signer,
+                          const void*                    context,
+                          uint8_t*                       arena,
+                          size_t arena_size,
+                          size_t cert_sizes[],
+                          uint8_t (*tbs_digests)[32])
+{
+	int ret = ATCA_SUCCESS;
+	const atcacert_def_t* cert_def;
+	atcacert_issue_work_t work;
+	atcacert_issue_range_t rest;
+	uint8_t key_id[20];
+#if ATCACERT_ISSUE_THREADS > 1
+	size_t threads = 1;
+#endif
+
+	if (batch == NULL || batch->cert_def == NULL || batch->cert_def->cert_template == NULL || batch->count == 0
+	    || batch->public_keys == NULL || arena == NULL || cert_sizes == NULL || (signer != NULL && signer->sign == NULL))
+		return ATCACERT_E_BAD_PARAMS;
+	cert_def = batch->cert_def;
+
+	if ((size_t)cert_def->tbs_cert_loc.offset + (size_t)cert_def->tbs_cert_loc.count > cert_def->cert_template_size)
+		return ATCACERT_E_BAD_CERT;
+
+	work.stride = atcacert_issue_cert_stride(cert_def);
+	if (batch->count > arena_size / work.stride)
+		return ATCACERT_E_BUFFER_TOO_SMALL;
+
+	work.batch       = batch;
+	work.signer      = signer;
+	work.context     = context;
+	work.arena       = arena;
+	work.cert_sizes  = cert_sizes;
+	work.tbs_digests = tbs_digests;
+	work.prefix_size = atcacert_issue_prefix_size(cert_def);
+
+	ret = atcacert_issue_prototype(batch, arena);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcac_sw_sha2_256_init(&work.ctx);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	ret = atcac_sw_sha2_256_update(&work.ctx, &arena[cert_def->tbs_cert_loc.offset], work.prefix_size);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	// Everything but certificate 0 first, they are copied from the prototype it still holds
+#if ATCACERT_ISSUE_THREADS > 1
+	if (signer == NULL || signer->concurrent)
+		threads = (batch->count - 1 < ATCACERT_ISSUE_THREADS) ? batch->count - 1 : ATCACERT_ISSUE_THREADS;
+	if (threads > 1) {
+		rest.ret = atcacert_issue_threads(&work, batch->count, threads);
+	}else
+#endif
+	{
+		rest.work  = &work;
+		rest.begin = 1;
+		rest.end   = batch->count;
+		rest.ret   = ATCA_SUCCESS;
+		atcacert_issue_worker(&rest);
+	}
+
+	ret = atcacert_get_key_id(batch->public_keys[0], key_id);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	ret = atcacert_issue_cert(&work, 0, key_id);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	return rest.ret;
+}
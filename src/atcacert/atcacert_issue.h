@@ -0,0 +1,146 @@
+/**
+ * \file
+ * \brief Bulk issuance of certificates from a certificate definition.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#ifndef ATCACERT_ISSUE_H
+#define ATCACERT_ISSUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "atcacert_def.h"
+
+/* Issuing a batch writes everything the certificates have in common (dates, signer ID, authority
+   key ID) into a prototype once and hashes the TBS data up to the first per-device element once.
+   Each certificate is then a copy of the prototype with its own public key, subject key ID and
+   serial number, its TBS digest resumed from the shared midstate, and its signature. The subject
+   key IDs of neighbouring certificates are hashed together with atcacert_get_key_ids().
+
+   Certificates are laid out in the arena one atcacert_issue_cert_stride() apart. When the signer
+   runs concurrently and the platform has threads (Linux hosts), the batch is split across up to
+   ATCACERT_ISSUE_THREADS threads. */
+
+#ifndef ATCACERT_ISSUE_THREADS
+#if defined(__linux__)
+#define ATCACERT_ISSUE_THREADS  (4)     //!< Most threads a batch uses, 0 for none
+#else
+#define ATCACERT_ISSUE_THREADS  (0)
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \defgroup atcacert_ Certificate manipulation methods (atcacert_)
+ *
+ * \brief
+ * These methods provide convenient ways to perform certification I/O with
+ * CryptoAuth chips and perform certificate manipulation in memory
+ *
+   @{ */
+
+/**
+ * Signs the TBS digest of an issued certificate.
+ */
+typedef struct atcacert_issue_signer_s {
+	int (*sign)(const uint8_t tbs_digest[32], uint8_t signature[64], const void* context);
+	bool concurrent;    //!< sign() may run on several threads at once.
+} atcacert_issue_signer_t;
+
+extern const atcacert_issue_signer_t atcacert_issue_signer_sw;    //!< Software ECDSA, the context is the 32-byte private key.
+
+/**
+ * Certificates to issue from one certificate definition.
+ */
+typedef struct atcacert_issue_batch_s {
+	const atcacert_def_t*    cert_def;          //!< Definition the certificates are built from.
+	const atcacert_tm_utc_t* issue_date;        //!< Issue date of every certificate, NULL to keep the template's.
+	const atcacert_tm_utc_t* expire_date;       //!< Expire date, NULL to derive it from issue_date and expire_years.
+	const uint8_t*           signer_id;         //!< Signer ID (2 bytes), NULL to keep the template's.
+	const uint8_t*           auth_public_key;   //!< Public key the authority key ID is made from (64 bytes), NULL to keep the template's.
+	size_t count;                               //!< Number of certificates.
+	const uint8_t (*public_keys)[64];           //!< Subject public key of each certificate, written padded where the definition holds 72 bytes.
+	const uint8_t (*device_sns)[9];             //!< Device serial number of each certificate, for the sn_source schemes that use it. May be NULL otherwise.
+	const uint8_t*           cert_sns;          //!< Serial number of each certificate back to back, each as long as the template's, to set them rather than generate them. May be NULL.
+} atcacert_issue_batch_t;
+
+/**
+ * \brief Room each certificate of a definition takes in the issuance arena, enough for the largest
+ *        DER encoded signature.
+ *
+ * \param[in] cert_def  Certificate definition.
+ *
+ * \return Bytes per certificate, 0 if cert_def is NULL.
+ */
+size_t atcacert_issue_cert_stride( const atcacert_def_t* cert_def );
+
+/**
+ * \brief Issue a batch of certificates.
+ *
+ * Certificate i is written at arena + i * atcacert_issue_cert_stride(batch->cert_def). Without a
+ * signer the certificates keep the template's signature, so they can be signed elsewhere from
+ * tbs_digests and finished with atcacert_set_signature(), which has room to grow in the stride.
+ *
+ * \param[in]  batch        Certificates to issue.
+ * \param[in]  signer       Signer of the certificates, NULL to leave them unsigned.
+ * \param[in]  context      Passed to the signer.
+ * \param[out] arena        Receives the certificates.
+ * \param[in]  arena_size   Size of the arena in bytes, at least count strides.
+ * \param[out] cert_sizes   Receives the size of each certificate.
+ * \param[out] tbs_digests  Receives the TBS digest of each certificate. NULL if not needed.
+ *
+ * \return 0 on success, otherwise the error of the first certificate that failed.
+ */
+int atcacert_issue_certs( const atcacert_issue_batch_t*  batch,
+                          const atcacert_issue_signer_t* signer,
+                          const void*                    context,
+                          uint8_t*                       arena,
+                          size_t arena_size,
+                          size_t cert_sizes[],
+                          uint8_t (*tbs_digests)[32]);
+
+/** @} */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
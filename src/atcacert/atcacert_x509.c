@@ -0,0 +1,447 @@
+/**
+ * \file
+ * \brief Derives certificate definitions from X.509 certificates.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#include <string.h>
+#include "atcacert_x509.h"
+#include "atcacert_der.h"
+
+static const uint8_t ATCACERT_X509_OID_ECDSA_SHA256[]     = { 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x04, 0x03, 0x02 };       // 1.2.840.10045.4.3.2
+static const uint8_t ATCACERT_X509_OID_EC_PUBLIC_KEY[]    = { 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01 };             // 1.2.840.10045.2.1
+static const uint8_t ATCACERT_X509_OID_PRIME256V1[]       = { 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x07 };       // 1.2.840.10045.3.1.7
+static const uint8_t ATCACERT_X509_OID_COMMON_NAME[]      = { 0x55, 0x04, 0x03 };                                     // 2.5.4.3
+static const uint8_t ATCACERT_X509_OID_SUBJ_KEY_ID[]      = { 0x55, 0x1D, 0x0E };                                     // 2.5.29.14
+static const uint8_t ATCACERT_X509_OID_BASIC_CONSTRAINTS[] = { 0x55, 0x1D, 0x13 };                                    // 2.5.29.19
+static const uint8_t ATCACERT_X509_OID_AUTH_KEY_ID[]      = { 0x55, 0x1D, 0x23 };                                     // 2.5.29.35
+
+#define ATCACERT_X509_TBS_VERSION       0xA0    //!< [0] EXPLICIT version tag
+#define ATCACERT_X509_TBS_ISSUER_UID    0x81    //!< [1] IMPLICIT issuerUniqueID tag
+#define ATCACERT_X509_TBS_SUBJECT_UID   0x82    //!< [2] IMPLICIT subjectUniqueID tag
+#define ATCACERT_X509_TBS_EXTENSIONS    0xA3    //!< [3] EXPLICIT extensions tag
+#define ATCACERT_X509_AKI_KEY_ID        0x80    //!< [0] IMPLICIT keyIdentifier tag in AuthorityKeyIdentifier
+
+static int atcacert_x509_peek(const atcacert_der_span_t* span, uint8_t tag)
+{
+	return span->size > 0 && span->ptr[0] == tag;
+}
+
+static int atcacert_x509_is_oid(const atcacert_der_span_t* value, const uint8_t* oid, size_t oid_size)
+{
+	return value->size == oid_size && memcmp(value->ptr, oid, oid_size) == 0;
+}
+
+static void atcacert_x509_set_loc(atcacert_cert_loc_t* loc, const uint8_t* cert, const uint8_t* ptr, size_t size)
+{
+	loc->offset = (uint16_t)(ptr - cert);
+	loc->count  = (uint16_t)size;
+}
+
+/**
+ * \brief Reads an AlgorithmIdentifier, which must be the given algorithm and, when param is set,
+ *        have the given named curve as its parameter.
+ */
+static int atcacert_x509_read_alg( atcacert_der_span_t* span,
+                                   const uint8_t*       oid,
+                                   size_t oid_size,
+                                   const uint8_t*       param,
+                                   size_t param_size)
+{
+	int ret = 0;
+	atcacert_der_span_t alg;
+	atcacert_der_span_t value;
+
+	ret = atcacert_der_read(span, ATCACERT_DER_SEQUENCE, &alg);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcacert_der_read(&alg, ATCACERT_DER_OID, &value);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	if (!atcacert_x509_is_oid(&value, oid, oid_size))
+		return ATCACERT_E_UNIMPLEMENTED; // Unsupported algorithm
+
+	if (param == NULL)
+		return ATCA_SUCCESS;
+
+	if (!atcacert_x509_peek(&alg, ATCACERT_DER_OID))
+		return ATCACERT_E_UNIMPLEMENTED; // Not a named curve
+	ret = atcacert_der_read(&alg, ATCACERT_DER_OID, &value);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	if (!atcacert_x509_is_oid(&value, param, param_size))
+		return ATCACERT_E_UNIMPLEMENTED; // Unsupported curve
+
+	return ATCA_SUCCESS;
+}
+
+/**
+ * \brief Reads a validity date, which is either UTCTime or GeneralizedTime.
+ */
+static int atcacert_x509_read_date( atcacert_der_span_t*    span,
+                                    const uint8_t*          cert,
+                                    atcacert_cert_loc_t*    loc,
+                                    atcacert_date_format_t* format,
+                                    atcacert_tm_utc_t*      timestamp)
+{
+	int ret = 0;
+	uint8_t tag = 0;
+	atcacert_der_span_t value;
+
+	ret = atcacert_der_read_tl(span, &tag, &value);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	if (tag == ATCACERT_DER_UTC_TIME)
+		*format = DATEFMT_RFC5280_UTC;
+	else if (tag == ATCACERT_DER_GENERALIZED_TIME)
+		*format = DATEFMT_RFC5280_GEN;
+	else
+		return ATCACERT_E_DECODING_ERROR; // Not a time
+
+	if (value.size != ATCACERT_DATE_FORMAT_SIZES[*format])
+		return ATCACERT_E_DECODING_ERROR; // Fractional seconds or time zones aren't allowed in certificates
+
+	ret = atcacert_date_dec(*format, value.ptr, value.size, timestamp);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	atcacert_x509_set_loc(loc, cert, value.ptr, value.size);
+
+	return ATCA_SUCCESS;
+}
+
+/**
+ * \brief Finds the signer ID, the last 4 hex digits of a name's common name.
+ */
+static int atcacert_x509_find_signer_id( atcacert_der_span_t  name,
+                                         const uint8_t*       cert,
+                                         atcacert_cert_loc_t* loc)
+{
+	int ret = 0;
+	atcacert_der_span_t rdn;
+	atcacert_der_span_t atv;
+	atcacert_der_span_t type;
+	atcacert_der_span_t value;
+	size_t i;
+
+	while (name.size > 0) {
+		ret = atcacert_der_read(&name, ATCACERT_DER_SET, &rdn);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+
+		while (rdn.size > 0) {
+			ret = atcacert_der_read(&rdn, ATCACERT_DER_SEQUENCE, &atv);
+			if (ret != ATCA_SUCCESS)
+				return ret;
+			ret = atcacert_der_read(&atv, ATCACERT_DER_OID, &type);
+			if (ret != ATCA_SUCCESS)
+				return ret;
+			ret = atcacert_der_read_tl(&atv, NULL, &value);
+			if (ret != ATCA_SUCCESS)
+				return ret;
+
+			if (!atcacert_x509_is_oid(&type, ATCACERT_X509_OID_COMMON_NAME, sizeof(ATCACERT_X509_OID_COMMON_NAME)) || value.size < 4)
+				continue;
+
+			// Upper case, as atcacert_set_signer_id() writes it
+			for (i = value.size - 4; i < value.size; i++) {
+				if (!((value.ptr[i] >= '0' && value.ptr[i] <= '9') || (value.ptr[i] >= 'A' && value.ptr[i] <= 'F')))
+					break;
+			}
+			if (i == value.size)
+				atcacert_x509_set_loc(loc, cert, &value.ptr[value.size - 4], 4);
+		}
+	}
+
+	return ATCA_SUCCESS;
+}
+
+/**
+ * \brief Picks up the key IDs and the CA flag from the certificate extensions.
+ */
+static int atcacert_x509_read_extensions( atcacert_der_span_t exts,
+                                          const uint8_t*      cert,
+                                          atcacert_def_t*     cert_def,
+                                          uint8_t*            is_ca)
+{
+	int ret = 0;
+	atcacert_der_span_t ext;
+	atcacert_der_span_t id;
+	atcacert_der_span_t value;
+	atcacert_der_span_t field;
+
+	ret = atcacert_der_read(&exts, ATCACERT_DER_SEQUENCE, &exts);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	while (exts.size > 0) {
+		// Extension ::= SEQUENCE { extnID, critical BOOLEAN DEFAULT FALSE, extnValue OCTET STRING }
+		ret = atcacert_der_read(&exts, ATCACERT_DER_SEQUENCE, &ext);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+		ret = atcacert_der_read(&ext, ATCACERT_DER_OID, &id);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+		if (atcacert_x509_peek(&ext, ATCACERT_DER_BOOLEAN)) {
+			ret = atcacert_der_read(&ext, ATCACERT_DER_BOOLEAN, NULL);
+			if (ret != ATCA_SUCCESS)
+				return ret;
+		}
+		ret = atcacert_der_read(&ext, ATCACERT_DER_OCTET_STRING, &value);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+
+		if (atcacert_x509_is_oid(&id, ATCACERT_X509_OID_SUBJ_KEY_ID, sizeof(ATCACERT_X509_OID_SUBJ_KEY_ID))) {
+			ret = atcacert_der_read(&value, ATCACERT_DER_OCTET_STRING, &field);
+			if (ret != ATCA_SUCCESS)
+				return ret;
+			if (field.size == 20)
+				atcacert_x509_set_loc(&cert_def->std_cert_elements[STDCERT_SUBJ_KEY_ID], cert, field.ptr, field.size);
+		}else if (atcacert_x509_is_oid(&id, ATCACERT_X509_OID_AUTH_KEY_ID, sizeof(ATCACERT_X509_OID_AUTH_KEY_ID))) {
+			ret = atcacert_der_read(&value, ATCACERT_DER_SEQUENCE, &value);
+			if (ret != ATCA_SUCCESS)
+				return ret;
+			if (!atcacert_x509_peek(&value, ATCACERT_X509_AKI_KEY_ID))
+				continue; // Identified by issuer and serial number only
+			ret = atcacert_der_read(&value, ATCACERT_X509_AKI_KEY_ID, &field);
+			if (ret != ATCA_SUCCESS)
+				return ret;
+			if (field.size == 20)
+				atcacert_x509_set_loc(&cert_def->std_cert_elements[STDCERT_AUTH_KEY_ID], cert, field.ptr, field.size);
+		}else if (atcacert_x509_is_oid(&id, ATCACERT_X509_OID_BASIC_CONSTRAINTS, sizeof(ATCACERT_X509_OID_BASIC_CONSTRAINTS))) {
+			ret = atcacert_der_read(&value, ATCACERT_DER_SEQUENCE, &value);
+			if (ret != ATCA_SUCCESS)
+				return ret;
+			if (!atcacert_x509_peek(&value, ATCACERT_DER_BOOLEAN))
+				continue; // cA defaults to FALSE
+			ret = atcacert_der_read(&value, ATCACERT_DER_BOOLEAN, &field);
+			if (ret != ATCA_SUCCESS)
+				return ret;
+			*is_ca = (field.size == 1 && field.ptr[0] != 0x00) ? TRUE : FALSE;
+		}
+	}
+
+	return ATCA_SUCCESS;
+}
+
+/**
+ * \brief Finds expire_years from the validity period. Compressed certificates can only hold a
+ *        whole number of years or no expiration at all.
+ */
+static int atcacert_x509_get_expire_years( const atcacert_tm_utc_t* issue_date,
+                                           const atcacert_tm_utc_t* expire_date,
+                                           atcacert_date_format_t   expire_date_format,
+                                           uint8_t*                 expire_years)
+{
+	int ret = 0;
+	int years = expire_date->tm_year - issue_date->tm_year;
+	atcacert_tm_utc_t max_date;
+
+	ret = atcacert_date_get_max_date(expire_date_format, &max_date);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	if (expire_date->tm_year == max_date.tm_year
+	    && expire_date->tm_mon == max_date.tm_mon
+	    && expire_date->tm_mday == max_date.tm_mday
+	    && expire_date->tm_hour == max_date.tm_hour
+	    && expire_date->tm_min == max_date.tm_min
+	    && expire_date->tm_sec == max_date.tm_sec) {
+		*expire_years = 0;
+		return ATCA_SUCCESS;
+	}
+
+	if (years < 1 || years > 31
+	    || expire_date->tm_mon != issue_date->tm_mon
+	    || expire_date->tm_mday != issue_date->tm_mday
+	    || expire_date->tm_hour != issue_date->tm_hour
+	    || expire_date->tm_min != issue_date->tm_min
+	    || expire_date->tm_sec != issue_date->tm_sec)
+		return ATCACERT_E_INVALID_DATE;
+
+	*expire_years = (uint8_t)years;
+
+	return ATCA_SUCCESS;
+}
+
+int atcacert_x509_parse_def( const uint8_t*  cert,
+                             size_t cert_size,
+                             atcacert_def_t* cert_def,
+                             uint8_t*        is_ca)
+{
+	int ret = 0;
+	atcacert_der_span_t tbs;
+	atcacert_der_span_t sig_alg;
+	atcacert_der_span_t sig;
+	atcacert_der_span_t span;
+	atcacert_der_span_t issuer;
+	atcacert_der_span_t subject;
+	atcacert_der_span_t value;
+	atcacert_tm_utc_t issue_date;
+	atcacert_tm_utc_t expire_date;
+	atcacert_date_format_t format;
+	atcacert_def_t def;
+	uint8_t ca = FALSE;
+	size_t size = 0;
+
+	if (cert == NULL || cert_def == NULL)
+		return ATCACERT_E_BAD_PARAMS;
+
+	def = *cert_def; // Only updated on success
+
+	ret = atcacert_der_split_cert(cert, cert_size, &tbs, &sig_alg, &sig);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	size = (size_t)(sig.ptr - cert) + sig.size;
+	if (size > 0xFFFF)
+		return ATCACERT_E_BAD_CERT; // Too large for a template
+
+	ret = atcacert_x509_read_alg(&sig_alg, ATCACERT_X509_OID_ECDSA_SHA256, sizeof(ATCACERT_X509_OID_ECDSA_SHA256), NULL, 0);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	memset(def.std_cert_elements, 0, sizeof(def.std_cert_elements));
+	def.type               = CERTTYPE_X509;
+	def.cert_template      = cert;
+	def.cert_template_size = (uint16_t)size;
+	atcacert_x509_set_loc(&def.tbs_cert_loc, cert, tbs.ptr, tbs.size);
+
+	// TBSCertificate ::= SEQUENCE { version, serialNumber, signature, issuer, validity, subject,
+	//                               subjectPublicKeyInfo, issuerUniqueID, subjectUniqueID, extensions }
+	span = tbs;
+	ret = atcacert_der_read(&span, ATCACERT_DER_SEQUENCE, &span);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	if (atcacert_x509_peek(&span, ATCACERT_X509_TBS_VERSION)) {
+		ret = atcacert_der_read(&span, ATCACERT_X509_TBS_VERSION, NULL);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+
+	ret = atcacert_der_read(&span, ATCACERT_DER_INTEGER, &value);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	atcacert_x509_set_loc(&def.std_cert_elements[STDCERT_CERT_SN], cert, value.ptr, value.size);
+
+	ret = atcacert_x509_read_alg(&span, ATCACERT_X509_OID_ECDSA_SHA256, sizeof(ATCACERT_X509_OID_ECDSA_SHA256), NULL, 0);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcacert_der_read(&span, ATCACERT_DER_SEQUENCE, &issuer);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcacert_der_read(&span, ATCACERT_DER_SEQUENCE, &value);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	ret = atcacert_x509_read_date(&value, cert, &def.std_cert_elements[STDCERT_ISSUE_DATE], &format, &issue_date);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	def.issue_date_format = format;
+	ret = atcacert_x509_read_date(&value, cert, &def.std_cert_elements[STDCERT_EXPIRE_DATE], &format, &expire_date);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	def.expire_date_format = format;
+
+	ret = atcacert_der_read(&span, ATCACERT_DER_SEQUENCE, &subject);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	// SubjectPublicKeyInfo, uncompressed P-256 point
+	ret = atcacert_der_read(&span, ATCACERT_DER_SEQUENCE, &value);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	ret = atcacert_x509_read_alg(&value, ATCACERT_X509_OID_EC_PUBLIC_KEY, sizeof(ATCACERT_X509_OID_EC_PUBLIC_KEY),
+	                             ATCACERT_X509_OID_PRIME256V1, sizeof(ATCACERT_X509_OID_PRIME256V1));
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	ret = atcacert_der_read(&value, ATCACERT_DER_BIT_STRING, &value);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	if (value.size != 2 + 64 || value.ptr[0] != 0x00 || value.ptr[1] != 0x04)
+		return ATCACERT_E_UNIMPLEMENTED; // Only uncompressed points are supported
+	atcacert_x509_set_loc(&def.std_cert_elements[STDCERT_PUBLIC_KEY], cert, &value.ptr[2], 64);
+
+	if (atcacert_x509_peek(&span, ATCACERT_X509_TBS_ISSUER_UID)) {
+		ret = atcacert_der_read(&span, ATCACERT_X509_TBS_ISSUER_UID, NULL);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+	if (atcacert_x509_peek(&span, ATCACERT_X509_TBS_SUBJECT_UID)) {
+		ret = atcacert_der_read(&span, ATCACERT_X509_TBS_SUBJECT_UID, NULL);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+	if (atcacert_x509_peek(&span, ATCACERT_X509_TBS_EXTENSIONS)) {
+		ret = atcacert_der_read(&span, ATCACERT_X509_TBS_EXTENSIONS, &value);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+		ret = atcacert_x509_read_extensions(value, cert, &def, &ca);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+	if (span.size != 0)
+		return ATCACERT_E_DECODING_ERROR; // Unexpected extra data in TBS
+
+	// Issuer has to be P-256 too
+	size = sig.size;
+	ret = atcacert_der_dec_ecdsa_sig_value(sig.ptr, &size, NULL);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	atcacert_x509_set_loc(&def.std_cert_elements[STDCERT_SIGNATURE], cert, sig.ptr, sig.size);
+
+	// Signer certificates carry their own signer ID, device certificates their issuer's
+	ret = atcacert_x509_find_signer_id(ca ? subject : issuer, cert, &def.std_cert_elements[STDCERT_SIGNER_ID]);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcacert_x509_get_expire_years(&issue_date, &expire_date, def.expire_date_format, &def.expire_years);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	*cert_def = def;
+	if (is_ca != NULL)
+		*is_ca = ca;
+
+	return ATCA_SUCCESS;
+}
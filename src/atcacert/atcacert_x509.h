@@ -0,0 +1,102 @@
+/**
+ * \file
+ * \brief Derives certificate definitions from X.509 certificates.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#ifndef ATCACERT_X509_H
+#define ATCACERT_X509_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "atcacert_def.h"
+
+/* A certificate definition describes where each element the device supplies (public key,
+   serial number, dates, signer ID, key IDs, signature) sits in a certificate template. Any
+   P-256 ECDSA-with-SHA256 X.509 certificate can serve as its own template, so walking its DER
+   structure finds those offsets without working them out by hand. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \defgroup atcacert_ Certificate manipulation methods (atcacert_)
+ *
+ * \brief
+ * These methods provide convenient ways to perform certification I/O with
+ * CryptoAuth chips and perform certificate manipulation in memory
+ *
+   @{ */
+
+/**
+ * \brief Fills in a certificate definition from an X.509 certificate, with the certificate
+ *        itself as the template.
+ *
+ * Sets type, issue_date_format, expire_date_format, expire_years, tbs_cert_loc,
+ * std_cert_elements, cert_template and cert_template_size. Elements the certificate doesn't
+ * have get a count of 0. The signer ID is the last 4 hex digits of the subject common name of a
+ * CA certificate, or of the issuer common name otherwise. The serial number element spans the
+ * whole INTEGER value; a definition may narrow it so its sn_source only writes the first bytes.
+ *
+ * Everything else describes the device rather than the certificate (template_id, chain_id,
+ * private_key_slot, sn_source, the device locations, cert_elements and tbs_midstate) and is left
+ * as the caller set it.
+ *
+ * \param[in]    cert       DER encoded X.509 certificate. cert_def points into it, so it has to
+ *                          outlive cert_def.
+ * \param[in]    cert_size  Size of the certificate buffer in bytes.
+ * \param[inout] cert_def   Certificate definition to fill in.
+ * \param[out]   is_ca      Set to TRUE when basic constraints mark this as a CA (signer)
+ *                          certificate, FALSE otherwise. Can be NULL.
+ *
+ * \return 0 on success, ATCACERT_E_UNIMPLEMENTED for key or signature algorithms other than
+ *         P-256 ECDSA-with-SHA256, ATCACERT_E_INVALID_DATE when the validity period isn't a whole
+ *         number of years (up to 31) or open ended, as compressed certificates require.
+ */
+int atcacert_x509_parse_def( const uint8_t*  cert,
+                             size_t cert_size,
+                             atcacert_def_t* cert_def,
+                             uint8_t*        is_ca);
+
+/** @} */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
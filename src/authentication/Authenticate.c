@@ -49,6 +49,7 @@
 #include "astekcrypto.h"
 #include "cryptoauthlib.h"
 #include "atcacert/atcacert_client.h"
+#include "atcacert/atcacert_chain.h"
 #include "atcacert/atcacert_host_hw.h"
 #include "atcacert/atcacert_host_sw.h"
 #include "custom/cert_def_1_signer.h"
@@ -60,7 +61,6 @@
 
 /** \brief global variables for public keys */
 uint8_t root_pub_key[ATCA_PUB_KEY_SIZE];
-uint8_t signer_pub_key[ATCA_PUB_KEY_SIZE];
 uint8_t device_pub_key[ATCA_PUB_KEY_SIZE];
 size_t  key_size = sizeof(root_pub_key);
 
@@ -72,6 +72,13 @@ size_t  g_signer_cert_size = sizeof(g_signer_cert);
 uint8_t g_device_cert[ATCA_MAX_CERT_SIZE];
 size_t  g_device_cert_size = sizeof(g_device_cert);
 
+/** \brief the rebuilt signer and device certificates, with their TBS digests computed while rebuilding them */
+static atcacert_chain_link_t g_chain[PKI_CHAIN_LINKS] = {
+	{ .cert_def = &g_cert_def_1_signer },
+	{ .cert_def = &g_cert_def_2_device }
+};
+static uint8_t g_chain_tbs_digests[PKI_CHAIN_LINKS][ATCA_SHA2_256_DIGEST_SIZE];
+
 /** \brief global storage for the challenge data to sign by the device */
 uint8_t g_challenge[RANDOM_NUM_SIZE];
 uint8_t g_response[ATCA_PUB_KEY_SIZE];
@@ -79,59 +86,30 @@ uint8_t g_response[ATCA_PUB_KEY_SIZE];
 static ATCA_STATUS rebuild_certs(void)
 {
 	ATCA_STATUS ret = ATCACERT_E_UNIMPLEMENTED;
+	uint8_t* const certs[PKI_CHAIN_LINKS] = { &g_signer_cert[0], &g_device_cert[0] };
+	size_t cert_sizes[PKI_CHAIN_LINKS] = { sizeof(g_signer_cert), sizeof(g_device_cert) };
+	const uint8_t* leaf_pub_key = NULL;
 	
-	//Re-initialize cert size variable
-	g_signer_cert_size = sizeof(g_signer_cert);
-	g_device_cert_size = sizeof(g_device_cert);
-	
-	ret = atcacert_read_cert(&g_cert_def_1_signer, root_pub_key, &g_signer_cert[0], &g_signer_cert_size);
-	if (ret != ATCA_SUCCESS) return ret;
-	
-	ret = atcacert_get_subj_public_key(&g_cert_def_1_signer, &g_signer_cert[0], g_signer_cert_size, signer_pub_key);
-	if (ret != ATCA_SUCCESS) return ret;
-	
-	ret = atcacert_read_cert(&g_cert_def_2_device, signer_pub_key, &g_device_cert[0], &g_device_cert_size);
+	ret = atcacert_chain_read(g_chain, PKI_CHAIN_LINKS, root_pub_key, certs, cert_sizes, g_chain_tbs_digests, NULL, &leaf_pub_key);
 	if (ret != ATCA_SUCCESS) return ret;
 	
-	ret = atcacert_get_subj_public_key(&g_cert_def_2_device, &g_device_cert[0], g_device_cert_size, device_pub_key);
-	if (ret != ATCA_SUCCESS) return ret;
+	g_signer_cert_size = cert_sizes[0];
+	g_device_cert_size = cert_sizes[1];
+	memcpy(device_pub_key, leaf_pub_key, ATCA_PUB_KEY_SIZE);
 	
 	return ret;
 }
 
 static ATCA_STATUS cert_chain_verify(void)
 {
-	ATCA_STATUS ret = ATCACERT_E_UNIMPLEMENTED;
-	
-	//Validate signer certificate against root public key
-	ret = atcacert_verify_cert_hw(&g_cert_def_1_signer, &g_signer_cert[0], g_signer_cert_size, root_pub_key);
-	if (ret != ATCA_SUCCESS) return ret;
-	
-	//Assumes signer key was already read from certificate in rebuilt certificate method
-	
-	//Validate the device cert against signer key
-	ret = atcacert_verify_cert_hw(&g_cert_def_2_device, &g_device_cert[0], g_device_cert_size, signer_pub_key);
-	if (ret != ATCA_SUCCESS) return ret;
-	
-	//return 0 if all succeeded
-	return ret; 
+	//Validate signer certificate against root public key and device cert against signer key
+	return atcacert_chain_verify(g_chain, PKI_CHAIN_LINKS, root_pub_key, &atcacert_chain_verifier_hw, NULL, NULL);
 }
 
 static ATCA_STATUS cert_chain_verify_sw(void)
 {
-	ATCA_STATUS ret = ATCACERT_E_UNIMPLEMENTED;
-	
-	ret = atcacert_verify_cert_sw(&g_cert_def_1_signer, &g_signer_cert[0], g_signer_cert_size, root_pub_key);
-	if (ret != ATCA_SUCCESS) return ret;
-	
-	//Assumes signer key was already read from certificate in rebuilt certificate method
-	
-	//Validate the device cert against signer key
-	ret = atcacert_verify_cert_sw(&g_cert_def_2_device, &g_device_cert[0], g_device_cert_size, signer_pub_key);
-	if (ret != ATCA_SUCCESS) return ret;
-	
-	//return 0 if all succeeded
-	return ret;
+	//Both signatures are checked at the same time where threads are available
+	return atcacert_chain_verify(g_chain, PKI_CHAIN_LINKS, root_pub_key, &atcacert_chain_verifier_sw, NULL, NULL);
 }
 
 static ATCA_STATUS client_generate_response(void)
@@ -146,11 +124,24 @@ static ATCA_STATUS client_generate_response(void)
 
 
 
+void auth_pki_chain_links(const pki_chain_auth_struct* auth_struct, atcacert_chain_link_t links[PKI_CHAIN_LINKS])
+{
+	memset(links, 0, PKI_CHAIN_LINKS * sizeof(links[0]));
+	
+	links[0].cert_def  = &g_cert_def_1_signer;
+	links[0].cert      = &auth_struct->signer_cert[0];
+	links[0].cert_size = SIGNER_CERT_SIZE;
+	
+	links[1].cert_def  = &g_cert_def_2_device;
+	links[1].cert      = &auth_struct->device_cert[0];
+	links[1].cert_size = DEVICE_CERT_SIZE;
+}
+
 ATCA_STATUS auth_hw_pki_2(pki_chain_auth_struct* auth_struct, uint8_t* tbs_digest)
 {
 	ATCA_STATUS status = ATCA_UNIMPLEMENTED;
-	uint8_t signer_public_key[ATCA_PUB_KEY_SIZE];
-	uint8_t device_public_key[ATCA_PUB_KEY_SIZE];
+	const uint8_t* device_public_key = NULL;
+	atcacert_chain_link_t links[PKI_CHAIN_LINKS];
 
 
 	//Check if parameters are valid
@@ -165,24 +156,11 @@ ATCA_STATUS auth_hw_pki_2(pki_chain_auth_struct* auth_struct, uint8_t* tbs_diges
 		return ATCA_BAD_PARAM;		//Return bad parameter if public keys don't match
 	}
 
-	//Validate signer certificate against root public key
-	status = atcacert_verify_cert_hw(&g_cert_def_1_signer, &auth_struct->signer_cert[0], SIGNER_CERT_SIZE, g_signer_1_ca_public_key);
-	if (status != ATCA_SUCCESS) return status;
-
-
-	/*1st Chain of Trust Level Verification*/
-	//Extract signer public key from signer cert
-	status = atcacert_get_subj_public_key(&g_cert_def_1_signer, &auth_struct->signer_cert[0], SIGNER_CERT_SIZE, signer_public_key);
-	if (status != ATCA_SUCCESS) return status;
-	
-	//Validate the device cert against signer key
-	status = atcacert_verify_cert_hw(&g_cert_def_2_device, &auth_struct->device_cert[0], DEVICE_CERT_SIZE, signer_public_key);
-	if (status != ATCA_SUCCESS) return status;
-
-
-	/*2nd Chain of Trust Level Verification*/
-	//Extract device public key from device cert
-	status = atcacert_get_subj_public_key(&g_cert_def_2_device, &auth_struct->device_cert[0], DEVICE_CERT_SIZE, device_public_key);
+	/*1st and 2nd Chain of Trust Level Verification*/
+	//Validate signer certificate against root public key and device cert against signer key,
+	//extracting the device public key from the device cert
+	auth_pki_chain_links(auth_struct, links);
+	status = atcacert_chain_verify(links, PKI_CHAIN_LINKS, g_signer_1_ca_public_key, &atcacert_chain_verifier_hw, NULL, &device_public_key);
 	if (status != ATCA_SUCCESS) return status;
 
 
@@ -277,44 +255,26 @@ ATCA_STATUS auth_sw_pki(uint8_t *pub_key)
 	return atcacert_verify_response_sw(pub_key, g_challenge, g_response);
 }
 
-ATCA_STATUS auth_symmetric_sw(void)
+ATCA_STATUS auth_symmetric_prepare(auth_symmetric_ctx* ctx)
 {
-	ATCA_STATUS status = ATCA_UNIMPLEMENTED;					//Status of operations
-	
-	uint8_t random_number[RANDOM_NUM_SIZE];		
-	uint8_t digest[ATCA_SHA_DIGEST_SIZE], response[ATCA_SHA_DIGEST_SIZE], mac_response_1[ATCA_SHA_DIGEST_SIZE], mac_response_2[ATCA_SHA_DIGEST_SIZE];				
-	uint8_t symmetric_key[ATCA_KEY_SIZE];
-	uint8_t temporary[ATCA_MSG_SIZE_MAC];						//buffer for temporary operations
-	uint8_t *p_temp;											//pointer to temporary buffer
+	ATCA_STATUS status = ATCA_UNIMPLEMENTED;
+	uint8_t *p_temp;											//pointer to constant MAC fields
 
-//Generate random number
-	status = hal_random_number(&random_number[0]);							//HAL user implemented PRG
-	if (status != ATCA_SUCCESS)
+	if (ctx == NULL)
 	{
-		return status;
+		return ATCA_BAD_PARAM;
 	}
-	
-//Request MAC computation from crypto IC
-	status = atcab_mac(0x00, SYMMETRIC_KEY_ID, random_number, digest);
+	ctx->prepared = false;
+
+//Compute key
+	status = atcac_sw_sha2_256(&g_symmetric_key[0], g_symmetric_key_size, ctx->key);
 	if (status != ATCA_SUCCESS)
 	{
 		return status;
-	}
-		
-//Compute key
-	atcac_sw_sha2_256(&g_symmetric_key[0], g_symmetric_key_size, symmetric_key);
-	
-//SW MAC computation
-	// Start calculation
-	p_temp = temporary;											//Get pointer to structure
-
-	// (1) first 32 bytes
-	memcpy(p_temp, symmetric_key, ATCA_KEY_SIZE);                // use Key[KeyID]
-	p_temp += ATCA_KEY_SIZE;
+	}
 
-	// (2) second 32 bytes
-	memcpy(p_temp, random_number, ATCA_KEY_SIZE);				// use Key[KeyID]
-	p_temp += ATCA_KEY_SIZE;
+//Constant MAC fields following Key[KeyID] and the challenge
+	p_temp = ctx->mac_tail;
 
 	// (3) 1 byte opcode
 	*p_temp++ = ATCA_MAC;										//Insert Opcode
@@ -343,20 +303,69 @@ ATCA_STATUS auth_symmetric_sw(void)
 	*p_temp++ = ATCA_SN_1;
 	
 	memset(p_temp, 0, ATCA_SN_SIZE_2);							//use zeros for 9
+
+	ctx->prepared = true;
+
+	return ATCA_SUCCESS;
+}
+
+ATCA_STATUS auth_symmetric_sw_prepared(auth_symmetric_ctx* ctx)
+{
+	ATCA_STATUS status = ATCA_UNIMPLEMENTED;					//Status of operations
 	
-	// Calculate SHA256 to get the MAC digest
-	status = atcac_sw_sha2_256(temporary, ATCA_MSG_SIZE_MAC, response);
+	uint8_t random_number[RANDOM_NUM_SIZE];		
+	uint8_t digest[ATCA_SHA_DIGEST_SIZE], response[ATCA_SHA_DIGEST_SIZE];
+	atcac_sha2_256_ctx sha_ctx;
+	uint8_t diff = 0;
+	size_t i;
+
+	if (ctx == NULL)
+	{
+		return ATCA_BAD_PARAM;
+	}
+
+	if (!ctx->prepared)
+	{
+		status = auth_symmetric_prepare(ctx);
+		if (status != ATCA_SUCCESS)
+		{
+			return status;
+		}
+	}
+
+//Generate random number
+	status = hal_random_number(&random_number[0]);							//HAL user implemented PRG
+	if (status != ATCA_SUCCESS)
+	{
+		return status;
+	}
+	
+//Request MAC computation from crypto IC
+	status = atcab_mac(0x00, SYMMETRIC_KEY_ID, random_number, digest);
+	if (status != ATCA_SUCCESS)
+	{
+		return status;
+	}
+	
+//SW MAC computation: Key[KeyID] || challenge || constant fields, hashed in place
+	atcac_sw_sha2_256_init(&sha_ctx);
+	atcac_sw_sha2_256_update(&sha_ctx, ctx->key, ATCA_KEY_SIZE);
+	atcac_sw_sha2_256_update(&sha_ctx, random_number, RANDOM_NUM_SIZE);
+	atcac_sw_sha2_256_update(&sha_ctx, ctx->mac_tail, sizeof(ctx->mac_tail));
+	status = atcac_sw_sha2_256_finish(&sha_ctx, response);
 	if (status != ATCA_SUCCESS)
 	{
 		return status;
 	}
 
-	//Prevent timing attack by hashing both digests before comparing
-	atcac_sw_sha2_256(response, ATCA_SHA_DIGEST_SIZE, mac_response_1);
-	atcac_sw_sha2_256(digest, ATCA_SHA_DIGEST_SIZE, mac_response_2);
+	//Constant time compare, every byte is examined regardless of mismatches
+	for (i = 0; i < ATCA_SHA_DIGEST_SIZE; i++)
+	{
+		diff |= response[i] ^ digest[i];
+	}
 	
 	//Verify keys match
-	if ( memcmp(&mac_response_1, &mac_response_2, ATCA_SHA_DIGEST_SIZE) == 0)
+	if (diff == 0)
 	{
 		return ATCA_SUCCESS;
 	}
@@ -364,15 +373,19 @@ ATCA_STATUS auth_symmetric_sw(void)
 	return ATCA_CHECKMAC_VERIFY_FAILED;
 }
 
+ATCA_STATUS auth_symmetric_sw(void)
+{
+	static auth_symmetric_ctx s_ctx;							//prepared on first use
+
+	return auth_symmetric_sw_prepared(&s_ctx);
+}
+
 
 ATCA_STATUS gen_auth_2_response(pki_chain_auth_struct* auth_struct, uint8_t* tbs_digest, uint32_t msg_size)
 {
 	ATCA_STATUS ret = ATCA_UNIMPLEMENTED;
-	uint8_t signer_pubkey[ATCA_PUB_KEY_SIZE];
-	
-	//Re-initialize cert size variable
-	g_signer_cert_size = sizeof(g_signer_cert);
-	g_device_cert_size = sizeof(g_device_cert);
+	uint8_t* const certs[PKI_CHAIN_LINKS] = { &g_signer_cert[0], &g_device_cert[0] };
+	size_t cert_sizes[PKI_CHAIN_LINKS] = { sizeof(g_signer_cert), sizeof(g_device_cert) };
 
 	//Check if parameters are valid
 	if (auth_struct == NULL || tbs_digest == NULL || msg_size == 0)
@@ -393,13 +406,11 @@ ATCA_STATUS gen_auth_2_response(pki_chain_auth_struct* auth_struct, uint8_t* tbs
 	//Copy CA root key to response struct
 	memcpy(auth_struct->root_pubkey, g_signer_1_ca_public_key, ATCA_PUB_KEY_SIZE);
 	
-	//Generate signer certificate
-	ret = atcacert_read_cert(&g_cert_def_1_signer, auth_struct->root_pubkey, &g_signer_cert[0], &g_signer_cert_size);
-	if (ret != ATCA_SUCCESS) return ret;
-	
-	//Extract signer public key
-	ret = atcacert_get_subj_public_key(&g_cert_def_1_signer, &g_signer_cert[0], g_signer_cert_size, signer_pubkey);
+	//Generate signer and device certificates
+	ret = atcacert_chain_read(g_chain, PKI_CHAIN_LINKS, auth_struct->root_pubkey, certs, cert_sizes, NULL, NULL, NULL);
 	if (ret != ATCA_SUCCESS) return ret;
+	g_signer_cert_size = cert_sizes[0];
+	g_device_cert_size = cert_sizes[1];
 	
 	//Sanity check for signer certificate size
 	if (g_signer_cert_size > SIGNER_CERT_SIZE)
@@ -411,10 +422,6 @@ ATCA_STATUS gen_auth_2_response(pki_chain_auth_struct* auth_struct, uint8_t* tbs
 		memcpy(auth_struct->signer_cert, g_signer_cert, SIGNER_CERT_SIZE);
 	}
 
-	//Generate device certificate
-	ret = atcacert_read_cert(&g_cert_def_2_device, signer_pubkey, &g_device_cert[0], &g_device_cert_size);
-	if (ret != ATCA_SUCCESS) return ret;
-	
 	//Sanity check for device certificate size
 	if (g_device_cert_size > DEVICE_CERT_SIZE)
 	{
@@ -49,11 +49,16 @@
 #define AUTHENTICATE_H_
 
 #include "cryptoauthlib.h"
+#include "host/atca_host.h"
+#include "atcacert/atcacert_chain.h"
 
 
 #define SIGNER_CERT_SIZE 506
 #define DEVICE_CERT_SIZE 428
 
+/** Number of certificates in the signer and device chain of trust. */
+#define PKI_CHAIN_LINKS 2
+
 /**********************************************************************************************//**
  * \struct	challenge_params
  * 
@@ -88,6 +93,33 @@ typedef struct pki_chain_auth_struct {
 	uint8_t device_cert[DEVICE_CERT_SIZE];
 } pki_chain_auth_struct;
 
+/**********************************************************************************************//**
+ * \struct	auth_symmetric_ctx
+ * 
+ * \brief	Prepared symmetric authenticator. Holds the derived symmetric key and the constant
+ * 			MAC message fields so each authentication only hashes the challenge dependent
+ * 			message once.
+ **************************************************************************************************/
+typedef struct auth_symmetric_ctx {
+	/** Derived symmetric key, SHA256 of g_symmetric_key. */
+	uint8_t key[ATCA_KEY_SIZE];
+	/** Opcode, mode, key ID, OTP and SN fields that follow the challenge in the MAC message. */
+	uint8_t mac_tail[ATCA_MSG_SIZE_MAC - ATCA_KEY_SIZE - RANDOM_NUM_SIZE];
+	/** Set once the fields above are valid. */
+	bool prepared;
+} auth_symmetric_ctx;
+
+/**********************************************************************************************//**
+ * \fn	void auth_pki_chain_links(const pki_chain_auth_struct* auth_struct, atcacert_chain_link_t links[PKI_CHAIN_LINKS]);
+ *
+ * \brief	Describes the signer and device certificates of an authentication structure as a chain
+ * 			for atcacert_chain_verify(), root end first. The links use the walk's default verifier.
+ *
+ * \param [in]	auth_struct	Device authentication structure.
+ * \param [out]	links	   	Receives the chain links.
+ **************************************************************************************************/
+void auth_pki_chain_links(const pki_chain_auth_struct* auth_struct, atcacert_chain_link_t links[PKI_CHAIN_LINKS]);
+
 /**********************************************************************************************//**
  * \fn	ATCA_STATUS auth_hw_pki_2(pki_chain_auth_struct* auth_struct, uint8_t* tbs_digest);
  *
@@ -154,6 +186,30 @@ ATCA_STATUS auth_sw_pki(uint8_t *pub_key);
  **************************************************************************************************/
 ATCA_STATUS auth_symmetric_sw(void);
 
+/**********************************************************************************************//**
+ * \fn	ATCA_STATUS auth_symmetric_prepare(auth_symmetric_ctx* ctx);
+ *
+ * \brief	Derives the symmetric key and builds the constant MAC message fields once. Call again
+ * 			if g_symmetric_key changes.
+ *
+ * \param [out]	ctx	Prepared authenticator to fill.
+ *
+ * \return	ATCA_STATUS		Return ATCA_SUCCESS on success.
+ **************************************************************************************************/
+ATCA_STATUS auth_symmetric_prepare(auth_symmetric_ctx* ctx);
+
+/**********************************************************************************************//**
+ * \fn	ATCA_STATUS auth_symmetric_sw_prepared(auth_symmetric_ctx* ctx);
+ *
+ * \brief	Symmetric software authentication using a prepared authenticator. Same result as
+ * 			auth_symmetric_sw(), prepares ctx on first use.
+ *
+ * \param [in,out]	ctx	Prepared authenticator.
+ *
+ * \return	ATCA_STATUS		Return ATCA_SUCCESS on successful authentication.
+ **************************************************************************************************/
+ATCA_STATUS auth_symmetric_sw_prepared(auth_symmetric_ctx* ctx);
+
 /**********************************************************************************************//**
  * \fn	ATCA_STATUS gen_device_auth_response(pki_3_auth_struct* params, uint8_t* app_tbs_digest, uint32_t app_size);
  *
@@ -222,17 +222,102 @@ ATCA_STATUS atcab_sleep(void)
 	return atsleep(_gIface);
 }
 
+/** \brief common cleanup code which idles the device after any operation
+ *  \return ATCA_STATUS
+ */
+static ATCA_STATUS _atcab_exit(void)
+{
+	return atcab_idle();
+}
+
+/** \brief returns the packet buffer owned by the global device
+ *
+ * Fill in param1, param2 and the payload in crypto_data directly, call the matching command
+ * builder (atRead(), atSHA(), ...) and then atcab_execute_packet().  The buffer is shared by every
+ * atcab_ call, so its contents only last until the next command.
+ * \return the device packet, NULL if there is no device
+ */
+ATCAPacket* atcab_get_packet(void)
+{
+	if ( _gDevice == NULL )
+		return NULL;
+
+	return atGetPacket(_gDevice);
+}
+
+/** \brief sends a built packet to the global device and leaves the response in the same packet
+ *
+ * Wakes the device, sends the command, waits for its execution time, receives and checks the
+ * response and idles the device again.
+ * \param[in,out] packet  command built with one of the at* command methods, receives the response
+ * \param[in] cmd         command, used to look up the execution time
+ * \return ATCA_STATUS
+ */
+ATCA_STATUS atcab_execute_packet(ATCAPacket *packet, ATCA_CmdMap cmd)
+{
+	ATCA_STATUS status = ATCA_GEN_FAIL;
+
+	if ( _gDevice == NULL )
+		return ATCA_GEN_FAIL;
+	if ( packet == NULL )
+		return ATCA_BAD_PARAM;
+
+	do {
+		if ( (status = atcab_wakeup()) != ATCA_SUCCESS )
+			break;
+
+		// send the command
+		if ( (status = atsend( _gIface, (uint8_t*)packet, packet->txsize )) != ATCA_SUCCESS )
+			break;
+
+		// delay the appropriate amount of time for command to execute
+		atca_delay_ms( atGetExecTime( _gCommandObj, cmd ) );
+
+		// receive the response
+		if ( (status = atreceive( _gIface, packet->crypto_data, &(packet->rxsize))) != ATCA_SUCCESS )
+			break;
+
+		// Check response size
+		if (packet->rxsize < 4) {
+			if (packet->rxsize > 0)
+				status = ATCA_RX_FAIL;
+			else
+				status = ATCA_RX_NO_RESPONSE;
+			break;
+		}
+
+		status = isATCAError(packet->crypto_data);
+	} while (0);
+
+	_atcab_exit();
+	return status;
+}
+
+/** \brief returns a view of the data in a response held by a packet, without copying it
+ * \param[in] packet   packet that went through atcab_execute_packet()
+ * \param[out] length  number of data bytes, excluding the count byte and CRC
+ * \return pointer to the first data byte inside the packet
+ */
+const uint8_t* atcab_packet_response(const ATCAPacket *packet, uint8_t *length)
+{
+	uint8_t count = packet->crypto_data[ATCA_COUNT_IDX];
+
+	if ( length )
+		*length = (count >= ATCA_RSP_SIZE_MIN) ? (uint8_t)(count - ATCA_PACKET_OVERHEAD) : 0;
+	return &packet->crypto_data[ATCA_RSP_DATA_IDX];
+}
+
 
 /** \brief auto discovery of crypto auth devices
  *
  * Calls interface discovery functions and fills in cfgArray up to the maximum
  * number of configurations either found or the size of the array. The cfgArray
  * can have a mixture of interface types (ie: some I2C, some SWI or UART) depending upon
- * which interfaces you've enabled
+ * which interfaces you've enabled. Entries left over get devtype ATCA_DEV_UNKNOWN.
  *
  * \param[out] cfgArray, ptr to an array of interface configs
  * \param[in] max, maximum size of cfgArray
- * \return ATCA_STATUS
+ * \return ATCA_SUCCESS, or ATCA_NO_DEVICES if nothing was found
  */
 
 #define MAX_BUSES   4
@@ -250,7 +335,8 @@ ATCA_STATUS atcab_cfg_discover( ATCAIfaceCfg cfgArray[], uint16_t max)
 	hal_i2c_discover_buses(i2c_buses, MAX_BUSES);
 
 	for ( i = 0; i < MAX_BUSES && ifaceNum < max; i++ ) {
-		if ( i2c_buses[i] != -1 ) {
+		if ( i2c_buses[i] != (uint16_t)-1 ) {
+			found = max - ifaceNum;     // room left, the HAL fills at most that many
 			hal_i2c_discover_devices( i2c_buses[i], &cfgArray[ifaceNum], &found );
 			ifaceNum += found;
 		}
@@ -262,7 +348,7 @@ ATCA_STATUS atcab_cfg_discover( ATCAIfaceCfg cfgArray[], uint16_t max)
 	memset( swi_buses, -1, sizeof(swi_buses));
 	hal_swi_discover_buses(swi_buses, MAX_BUSES);
 	for ( i = 0; i < MAX_BUSES && ifaceNum < max; i++ ) {
-		if ( swi_buses[i] != -1 ) {
+		if ( swi_buses[i] != (uint16_t)-1 ) {
 			hal_swi_discover_devices( swi_buses[i], &cfgArray[ifaceNum], &found);
 			ifaceNum += found;
 		}
@@ -275,7 +361,7 @@ ATCA_STATUS atcab_cfg_discover( ATCAIfaceCfg cfgArray[], uint16_t max)
 	memset( uart_buses, -1, sizeof(uart_buses));
 	hal_uart_discover_buses(uart_buses, MAX_BUSES);
 	for ( i = 0; i < MAX_BUSES && ifaceNum < max; i++ ) {
-		if ( uart_buses[i] != -1 ) {
+		if ( uart_buses[i] != (uint16_t)-1 ) {
 			hal_uart_discover_devices( uart_buses[i], &cfgArray[ifaceNum], &found);
 			ifaceNum += found;
 		}
@@ -287,7 +373,7 @@ ATCA_STATUS atcab_cfg_discover( ATCAIfaceCfg cfgArray[], uint16_t max)
 	memset( cdc_buses, -1, sizeof(cdc_buses));
 	hal_kit_cdc_discover_buses(cdc_buses, MAX_BUSES);
 	for ( i = 0; i < MAX_BUSES && ifaceNum < max; i++ ) {
-		if ( cdc_buses[i] != -1 ) {
+		if ( cdc_buses[i] != (uint16_t)-1 ) {
 			hal_kit_cdc_discover_devices( cdc_buses[i], &cfgArray[ifaceNum++], &found );
 			ifaceNum += found;
 		}
@@ -299,25 +385,21 @@ ATCA_STATUS atcab_cfg_discover( ATCAIfaceCfg cfgArray[], uint16_t max)
 	memset( hid_buses, -1, sizeof(hid_buses));
 	hal_kit_hid_discover_buses(hid_buses, MAX_BUSES);
 	for ( i = 0; i < MAX_BUSES && ifaceNum < max; i++ ) {
-		if ( hid_buses[i] != -1 ) {
+		if ( hid_buses[i] != (uint16_t)-1 ) {
 			hal_kit_hid_discover_devices( hid_buses[i], &cfgArray[ifaceNum++], &found);
 			ifaceNum += found;
 		}
 	}
 #endif
 
-	return ATCA_SUCCESS;
-}
+	for ( i = ifaceNum; i < max; i++ )
+		cfgArray[i].devtype = ATCA_DEV_UNKNOWN;
 
-/** \brief common cleanup code which idles the device after any operation
- *  \return ATCA_STATUS
- */
-static ATCA_STATUS _atcab_exit(void)
-{
-	return atcab_idle();
+	return (ifaceNum > 0) ? ATCA_SUCCESS : ATCA_NO_DEVICES;
 }
 
 
+
 /** \brief get the device revision information
  *  \param[out] revision - 4-byte storage for receiving the revision number from the device
  *  \return ATCA_STATUS
@@ -384,8 +466,7 @@ ATCA_STATUS atcab_info( uint8_t *revision )
 ATCA_STATUS atcab_random(uint8_t *rand_out)
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
-	ATCAPacket packet;
-	uint16_t execution_time = 0;
+	ATCAPacket *packet;
 
 	if ( !_gDevice )
 		return ATCA_GEN_FAIL;
@@ -397,47 +478,17 @@ ATCA_STATUS atcab_random(uint8_t *rand_out)
 	}
 
 	// build an random command
-	packet.param1 = RANDOM_SEED_UPDATE;
-	packet.param2 = 0x0000;
-	status = atRandom( &packet);
-	if (status != ATCA_SUCCESS) 
-	{ 
-		return status; 
-	}
-	execution_time = atGetExecTime( _gCommandObj, CMD_RANDOM);
-
-	do {
-		if ( (status = atcab_wakeup()) != ATCA_SUCCESS )
-			break;
-
-		// send the command
-		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS)
-			break;
+	packet = atGetPacket(_gDevice);
+	packet->param1 = RANDOM_SEED_UPDATE;
+	packet->param2 = 0x0000;
+	if ( (status = atRandom( packet )) != ATCA_SUCCESS )
+		return status;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
+	if ( (status = atcab_execute_packet( packet, CMD_RANDOM )) != ATCA_SUCCESS )
+		return status;
 
-		// receive the response
-		if ( (status = atreceive( _gIface, packet.crypto_data, &packet.rxsize)) != ATCA_SUCCESS)
-			break;
-
-		// Check response size
-		if (packet.rxsize < 4) {
-			if (packet.rxsize > 0)
-				status = ATCA_RX_FAIL;
-			else
-				status = ATCA_RX_NO_RESPONSE;
-			break;
-		}
-
-		if ( (status = isATCAError(packet.crypto_data)) != ATCA_SUCCESS )
-			break;
-
-		memcpy( rand_out, &packet.crypto_data[1], 32 );  // data[0] is the length byte of the response
-	} while (0);
-
-	_atcab_exit();
-	return status;
+	memcpy( rand_out, &packet->crypto_data[1], 32 );  // data[0] is the length byte of the response
+	return ATCA_SUCCESS;
 }
 
 /** \brief generate a key on given slot
@@ -520,56 +571,25 @@ ATCA_STATUS atcab_nonce_rand(const uint8_t *seed, uint8_t* rand_out)
 ATCA_STATUS atcab_challenge(const uint8_t *challenge)
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
-	ATCAPacket packet;
-	uint16_t execution_time = 0;
+	ATCAPacket *packet;
 
-	do {
-		// Verify the inputs
-		if (challenge == NULL) {
-			status = ATCA_BAD_PARAM;
-			break;
-		}
-
-		// build a nonce command (pass through mode)
-		packet.param1 = NONCE_MODE_PASSTHROUGH;
-		packet.param2 = 0x0000;
-		memcpy( packet.crypto_data, challenge, 32 );
-
-		if ((status = atNonce( &packet)) != ATCA_SUCCESS )
-			break;
-
-		execution_time = atGetExecTime( _gCommandObj, CMD_NONCE);
-
-		if ((status = atcab_wakeup()) != ATCA_SUCCESS )
-			break;
-
-		// send the command
-		if ((status = atsend( _gIface, (uint8_t*)&packet, packet.txsize)) != ATCA_SUCCESS )
-			break;
-
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
-		// receive the response
-		if ((status = atreceive( _gIface, packet.crypto_data, &(packet.rxsize))) != ATCA_SUCCESS )
-			break;
-
-		// Check response size
-		if (packet.rxsize < 4) {
-			if (packet.rxsize > 0)
-				status = ATCA_RX_FAIL;
-			else
-				status = ATCA_RX_NO_RESPONSE;
-			break;
-		}
+	// Verify the inputs
+	if ( !_gDevice )
+		return ATCA_GEN_FAIL;
+	if (challenge == NULL)
+		return ATCA_BAD_PARAM;
 
-		if ( (status = isATCAError(packet.crypto_data)) != ATCA_SUCCESS )
-			break;
+	// build a nonce command (pass through mode), the challenge may already sit in the packet
+	packet = atGetPacket(_gDevice);
+	packet->param1 = NONCE_MODE_PASSTHROUGH;
+	packet->param2 = 0x0000;
+	if ( challenge != packet->crypto_data )
+		memmove( packet->crypto_data, challenge, 32 );  // may be a view of the previous response
 
-	} while (0);
+	if ((status = atNonce( packet )) != ATCA_SUCCESS )
+		return status;
 
-	_atcab_exit();
-	return status;
+	return atcab_execute_packet( packet, CMD_NONCE );
 }
 
 /** \brief send a challenge to the device (a seed update nonce)
@@ -691,51 +711,100 @@ ATCA_STATUS atcab_read_serial_number(uint8_t* serial_number)
 ATCA_STATUS atcab_verify_extern(const uint8_t *message, const uint8_t *signature, const uint8_t *pubkey, bool *verified)
 {
 	ATCA_STATUS status;
-	ATCAPacket packet;
-	uint16_t execution_time = 0;
 
-	do {
-		*verified = false;
+	*verified = false;
+
+	if ( (status = atcab_verify_extern_start(message, signature, pubkey)) != ATCA_SUCCESS )
+		return status;
+
+	return atcab_verify_extern_finish(verified);
+}
+
+/** \brief loads the message and sends an external Verify command without waiting for the result
+ *
+ * The device computes the verification while the caller does other work; atcab_verify_extern_finish()
+ * collects the result.  The command lives in the device packet, so no other atcab_ call may come in
+ * between.
+ *  \param[in]  message    pointer
+ *  \param[in]  signature  pointer
+ *  \param[in]  pubkey     pointer
+ *  \return ATCA_STATUS, the device is idle again on failure
+ */
+
+ATCA_STATUS atcab_verify_extern_start(const uint8_t *message, const uint8_t *signature, const uint8_t *pubkey)
+{
+	ATCA_STATUS status;
+	ATCAPacket *packet = atcab_get_packet();
 
+	if ( packet == NULL )
+		return ATCA_GEN_FAIL;
+
+	do {
 		// nonce passthrough
 		if ( (status = atcab_challenge(message)) != ATCA_SUCCESS )
 			break;
 
 		// build a verify command
-		packet.param1 = VERIFY_MODE_EXTERNAL; //verify the signature
-		packet.param2 = VERIFY_KEY_P256;
-		memcpy( &packet.crypto_data[0], signature, ATCA_SIG_SIZE);
-		memcpy( &packet.crypto_data[64], pubkey, ATCA_PUB_KEY_SIZE);
+		packet->param1 = VERIFY_MODE_EXTERNAL; //verify the signature
+		packet->param2 = VERIFY_KEY_P256;
+		memcpy( &packet->crypto_data[0], signature, ATCA_SIG_SIZE);
+		memcpy( &packet->crypto_data[64], pubkey, ATCA_PUB_KEY_SIZE);
 
-		if ( (status = atVerify( &packet)) != ATCA_SUCCESS )
+		if ( (status = atVerify( packet)) != ATCA_SUCCESS )
 			break;
 
-		execution_time = atGetExecTime( _gCommandObj, CMD_VERIFY );
-
 		if ( (status = atcab_wakeup()) != ATCA_SUCCESS )
 			break;
 
 		// send the command
-		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
+		if ( (status = atsend( _gIface, (uint8_t*)packet, packet->txsize )) != ATCA_SUCCESS )
 			break;
 
+		return ATCA_SUCCESS;
+	} while (0);
+
+	_atcab_exit();
+	return status;
+}
+
+/** \brief collects the result of the Verify command sent by atcab_verify_extern_start()
+ *
+ * With a receive policy in the interface configuration the device is polled right away, so the time
+ * spent since the start counts towards the execution time.  Without one the full execution time is
+ * waited out first.
+ *  \param[out] verified   boolean whether or not the challenge/signature/pubkey verified
+ *  \return ATCA_STATUS
+ */
+
+ATCA_STATUS atcab_verify_extern_finish(bool *verified)
+{
+	ATCA_STATUS status;
+	ATCAPacket *packet = atcab_get_packet();
+
+	*verified = false;
+
+	if ( packet == NULL )
+		return ATCA_GEN_FAIL;
+
+	do {
 		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
+		if ( atgetifacecfg(_gIface)->rx_policy == NULL )
+			atca_delay_ms( atGetExecTime( _gCommandObj, CMD_VERIFY ) );
 
 		// receive the response
-		if ( (status = atreceive( _gIface, packet.crypto_data, &(packet.rxsize) )) != ATCA_SUCCESS )
+		if ( (status = atreceive( _gIface, packet->crypto_data, &(packet->rxsize) )) != ATCA_SUCCESS )
 			break;
 
 		// Check response size
-		if (packet.rxsize < 4) {
-			if (packet.rxsize > 0)
+		if (packet->rxsize < 4) {
+			if (packet->rxsize > 0)
 				status = ATCA_RX_FAIL;
 			else
 				status = ATCA_RX_NO_RESPONSE;
 			break;
 		}
 
-		status = isATCAError(packet.crypto_data);
+		status = isATCAError(packet->crypto_data);
 		*verified = (status == 0);
 		if (status == ATCA_CHECKMAC_VERIFY_FAILED)
 			status = ATCA_SUCCESS; // Verify failed, but command succeeded
@@ -1052,65 +1121,39 @@ ATCA_STATUS atcab_write_zone(uint8_t zone, uint8_t slot, uint8_t block, uint8_t
 ATCA_STATUS atcab_read_zone(uint8_t zone, uint8_t slot, uint8_t block, uint8_t offset, uint8_t *data, uint8_t len)
 {
 	ATCA_STATUS status = ATCA_SUCCESS;
-	ATCAPacket packet;
+	ATCAPacket *packet;
 	uint16_t addr;
-	uint16_t execution_time = 0;
-
-	do {
-		// Check the input parameters
-		if (data == NULL)
-			return ATCA_BAD_PARAM;
-
-		if ( len != 4 && len != 32 )
-			return ATCA_BAD_PARAM;
-
-		// The get address function checks the remaining variables
-		if ( (status = atcab_get_addr(zone, slot, block, offset, &addr)) != ATCA_SUCCESS )
-			break;
-
-		// If there are 32 bytes to write, then xor the bit into the mode
-		if (len == ATCA_BLOCK_SIZE)
-			zone = zone | ATCA_ZONE_READWRITE_32;
-
-		// build a read command
-		packet.param1 = zone;
-		packet.param2 = addr;
 
-		if ( (status = atRead( &packet)) != ATCA_SUCCESS )
-			break;
-
-		execution_time = atGetExecTime( _gCommandObj, CMD_READMEM);
-
-		if ( (status = atcab_wakeup()) != ATCA_SUCCESS ) break;
+	// Check the input parameters
+	if ( !_gDevice )
+		return ATCA_GEN_FAIL;
+	if (data == NULL)
+		return ATCA_BAD_PARAM;
 
-		// send the command
-		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
-			break;
+	if ( len != 4 && len != 32 )
+		return ATCA_BAD_PARAM;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
+	// The get address function checks the remaining variables
+	if ( (status = atcab_get_addr(zone, slot, block, offset, &addr)) != ATCA_SUCCESS )
+		return status;
 
-		// receive the response
-		if ( (status = atreceive( _gIface, packet.crypto_data, &(packet.rxsize) )) != ATCA_SUCCESS )
-			break;
+	// If there are 32 bytes to write, then xor the bit into the mode
+	if (len == ATCA_BLOCK_SIZE)
+		zone = zone | ATCA_ZONE_READWRITE_32;
 
-		// Check response size
-		if (packet.rxsize < 4) {
-			if (packet.rxsize > 0)
-				status = ATCA_RX_FAIL;
-			else
-				status = ATCA_RX_NO_RESPONSE;
-			break;
-		}
+	// build a read command
+	packet = atGetPacket(_gDevice);
+	packet->param1 = zone;
+	packet->param2 = addr;
 
-		if ( (status = isATCAError(packet.crypto_data)) != ATCA_SUCCESS )
-			break;
+	if ( (status = atRead( packet )) != ATCA_SUCCESS )
+		return status;
 
-		memcpy( data, &packet.crypto_data[1], len );
-	} while (0);
+	if ( (status = atcab_execute_packet( packet, CMD_READMEM )) != ATCA_SUCCESS )
+		return status;
 
-	_atcab_exit();
-	return status;
+	memcpy( data, &packet->crypto_data[1], len );
+	return ATCA_SUCCESS;
 }
 
 /** \brief Read 32 bytes of data from the given slot.
@@ -1874,56 +1917,42 @@ ATCA_STATUS atcab_lock_data_slot(uint8_t slot, uint8_t* lock_response)
 ATCA_STATUS atcab_sign(uint16_t slot, const uint8_t *msg, uint8_t *signature)
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
-	ATCAPacket packet;
-	uint16_t execution_time = 0;
-	uint8_t randomnum[64];
+	ATCAPacket *packet;
+	uint8_t message[ATCA_KEY_SIZE];
 
 	if ( !_gDevice )
 		return ATCA_GEN_FAIL;
+	if ( msg == NULL || signature == NULL )
+		return ATCA_BAD_PARAM;
 
-	do {
-		if ( (status = atcab_random(randomnum)) != ATCA_SUCCESS ) break;
-		if ( (status = atcab_challenge( msg )) != ATCA_SUCCESS ) break;
-
-		// build sign command
-		packet.param1 = SIGN_MODE_EXTERNAL;
-		packet.param2 = slot;
-		if ( (status = atSign( &packet)) != ATCA_SUCCESS )
-			break;
-
-		execution_time = atGetExecTime( _gCommandObj, CMD_SIGN);
-
-		if ( (status != atcab_wakeup()) != ATCA_SUCCESS ) break;
-
-		// send the command
-		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
-			break;
-
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms(execution_time);
-
-		// receive the response
-		if ( (status = atreceive( _gIface, packet.crypto_data, &(packet.rxsize))) != ATCA_SUCCESS )
-			break;
-
-		// Check response size
-		if (packet.rxsize < 4) {
-			if (packet.rxsize > 0)
-				status = ATCA_RX_FAIL;
-			else
-				status = ATCA_RX_NO_RESPONSE;
-			break;
-		}
-
-		// check for response
-		if ( (status = isATCAError(packet.crypto_data)) != ATCA_SUCCESS )
-			break;
-
-		memcpy( signature, &packet.crypto_data[1], ATCA_SIG_SIZE );
-	} while (0);
-
-	_atcab_exit();
-	return status;
+	// the random number is only needed to update the seed, its response stays in the device packet
+	packet = atGetPacket(_gDevice);
+	if ( (uintptr_t)msg >= (uintptr_t)packet && (uintptr_t)msg < (uintptr_t)(packet + 1) ) {
+		// the message was written into the packet, keep it away from the Random response
+		memcpy( message, msg, sizeof(message) );
+		msg = message;
+	}
+	packet->param1 = RANDOM_SEED_UPDATE;
+	packet->param2 = 0x0000;
+	if ( (status = atRandom( packet )) != ATCA_SUCCESS )
+		return status;
+	if ( (status = atcab_execute_packet( packet, CMD_RANDOM )) != ATCA_SUCCESS )
+		return status;
+
+	if ( (status = atcab_challenge( msg )) != ATCA_SUCCESS )
+		return status;
+
+	// build sign command
+	packet->param1 = SIGN_MODE_EXTERNAL;
+	packet->param2 = slot;
+	if ( (status = atSign( packet )) != ATCA_SUCCESS )
+		return status;
+
+	if ( (status = atcab_execute_packet( packet, CMD_SIGN )) != ATCA_SUCCESS )
+		return status;
+
+	memcpy( signature, &packet->crypto_data[1], ATCA_SIG_SIZE );
+	return ATCA_SUCCESS;
 }
 
 /** \brief Issues a GenDig command to SHA256 hash the source data indicated by zone with the
@@ -2778,51 +2807,20 @@ ATCA_STATUS atcab_checkmac( uint8_t mode, uint16_t key_id, const uint8_t *challe
 ATCA_STATUS atcab_sha_start(void)
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
-	ATCAPacket packet;
-	uint16_t execution_time = 0;
+	ATCAPacket *packet;
 
-	do {
-
-		// build checkmac command
-		packet.param1 = SHA_SHA256_START_MASK;
-		packet.param2 = 0;
-
-		if ( (status = atSHA( &packet)) != ATCA_SUCCESS )
-			break;
-
-		execution_time = atGetExecTime( _gCommandObj, CMD_SHA);
-
-		if ( (status != atcab_wakeup()) != ATCA_SUCCESS )
-			break;
-
-		// send the command
-		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
-			break;
-
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms( execution_time );
-
-		// receive the response
-		if ( (status = atreceive( _gIface, packet.crypto_data, &(packet.rxsize))) != ATCA_SUCCESS )
-			break;
-
-		// Check response size
-		if (packet.rxsize < 4) {
-			if (packet.rxsize > 0)
-				status = ATCA_RX_FAIL;
-			else
-				status = ATCA_RX_NO_RESPONSE;
-			break;
-		}
+	if ( !_gDevice )
+		return ATCA_GEN_FAIL;
 
-		// check for response
-		if ( (status = isATCAError(packet.crypto_data)) != ATCA_SUCCESS )
-			break;
+	// build SHA command
+	packet = atGetPacket(_gDevice);
+	packet->param1 = SHA_SHA256_START_MASK;
+	packet->param2 = 0;
 
-	} while (0);
+	if ( (status = atSHA( packet )) != ATCA_SUCCESS )
+		return status;
 
-	_atcab_exit();
-	return status;
+	return atcab_execute_packet( packet, CMD_SHA );
 }
 
 /** \brief Adds the message to be digested
@@ -2833,57 +2831,26 @@ ATCA_STATUS atcab_sha_start(void)
 ATCA_STATUS atcab_sha_update(uint16_t length, const uint8_t *message)
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
-	ATCAPacket packet;
-	uint16_t execution_time = 0;
-
-	do {
-
-		// Verify the inputs
-		if ( message == NULL || length > SHA_BLOCK_SIZE ) {
-			status = ATCA_BAD_PARAM;
-			break;
-		}
-
-		// build checkmac command
-		packet.param1 = SHA_SHA256_UPDATE_MASK;
-		packet.param2 = length;
-		memcpy(&packet.crypto_data[0], message, length);
-
-		if ( (status = atSHA( &packet)) != ATCA_SUCCESS )
-			break;
-
-		execution_time = atGetExecTime( _gCommandObj, CMD_SHA);
+	ATCAPacket *packet;
 
-		if ( (status != atcab_wakeup()) != ATCA_SUCCESS ) break;
-
-		// send the command
-		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
-			break;
-
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms( execution_time );
+	if ( !_gDevice )
+		return ATCA_GEN_FAIL;
 
-		// receive the response
-		if ( (status = atreceive( _gIface, packet.crypto_data, &(packet.rxsize))) != ATCA_SUCCESS )
-			break;
+	// Verify the inputs
+	if ( message == NULL || length > SHA_BLOCK_SIZE )
+		return ATCA_BAD_PARAM;
 
-		// Check response size
-		if (packet.rxsize < 4) {
-			if (packet.rxsize > 0)
-				status = ATCA_RX_FAIL;
-			else
-				status = ATCA_RX_NO_RESPONSE;
-			break;
-		}
+	// build SHA command, the message may already have been written into the packet
+	packet = atGetPacket(_gDevice);
+	packet->param1 = SHA_SHA256_UPDATE_MASK;
+	packet->param2 = length;
+	if ( message != packet->crypto_data )
+		memmove(&packet->crypto_data[0], message, length);  // may be a view of the previous response
 
-		// check for response
-		if ( (status = isATCAError(packet.crypto_data)) != ATCA_SUCCESS )
-			break;
+	if ( (status = atSHA( packet )) != ATCA_SUCCESS )
+		return status;
 
-	} while (0);
-
-	_atcab_exit();
-	return status;
+	return atcab_execute_packet( packet, CMD_SHA );
 }
 
 /** \brief The SHA-256 calculation is complete
@@ -2893,8 +2860,10 @@ ATCA_STATUS atcab_sha_update(uint16_t length, const uint8_t *message)
 ATCA_STATUS atcab_sha_end(uint8_t *digest, uint16_t length, const uint8_t *message)
 {
 	ATCA_STATUS status = ATCA_GEN_FAIL;
-	ATCAPacket packet;
-	uint16_t execution_time = 0;
+	ATCAPacket *packet;
+
+	if ( !_gDevice )
+		return ATCA_GEN_FAIL;
 
 	if ( length > 63 || digest == NULL )
 		return ATCA_BAD_PARAM;
@@ -2902,57 +2871,21 @@ ATCA_STATUS atcab_sha_end(uint8_t *digest, uint16_t length, const uint8_t *messa
 	if ( length > 0 && message == NULL )
 		return ATCA_BAD_PARAM;
 
-	do {
+	// build SHA command, the message may already have been written into the packet
+	packet = atGetPacket(_gDevice);
+	packet->param1 = SHA_SHA256_END_MASK;
+	packet->param2 = length;
+	if ( length > 0 && message != packet->crypto_data )
+		memmove(&packet->crypto_data[0], message, length);  // may be a view of the previous response
 
-		// Verify the inputs
-		if ( digest == NULL ) {
-			status = ATCA_BAD_PARAM;
-			break;
-		}
-
-		// build SHA command
-		packet.param1 = SHA_SHA256_END_MASK;
-		packet.param2 = length;
-		if ( length > 0 )
-			memcpy(&packet.crypto_data[0], message, length);
-
-		if ( (status = atSHA( &packet)) != ATCA_SUCCESS )
-			break;
-
-		execution_time = atGetExecTime( _gCommandObj, CMD_SHA);
-
-		if ( (status != atcab_wakeup()) != ATCA_SUCCESS ) break;
+	if ( (status = atSHA( packet )) != ATCA_SUCCESS )
+		return status;
 
-		// send the command
-		if ( (status = atsend( _gIface, (uint8_t*)&packet, packet.txsize )) != ATCA_SUCCESS )
-			break;
+	if ( (status = atcab_execute_packet( packet, CMD_SHA )) != ATCA_SUCCESS )
+		return status;
 
-		// delay the appropriate amount of time for command to execute
-		atca_delay_ms( execution_time );
-
-		// receive the response
-		if ( (status = atreceive( _gIface, packet.crypto_data, &(packet.rxsize))) != ATCA_SUCCESS )
-			break;
-
-		// Check response size
-		if (packet.rxsize < 4) {
-			if (packet.rxsize > 0)
-				status = ATCA_RX_FAIL;
-			else
-				status = ATCA_RX_NO_RESPONSE;
-			break;
-		}
-
-		// check for response
-		if ( (status = isATCAError(packet.crypto_data)) != ATCA_SUCCESS )
-			break;
-
-		memcpy( digest, &packet.crypto_data[ATCA_RSP_DATA_IDX], ATCA_SHA_DIGEST_SIZE );
-
-	} while (0);
-
-	_atcab_exit();
-	return status;
+	memcpy( digest, &packet->crypto_data[ATCA_RSP_DATA_IDX], ATCA_SHA_DIGEST_SIZE );
+	return ATCA_SUCCESS;
 }
 
 /** \brief Computes a SHA-256 digest
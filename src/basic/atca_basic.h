@@ -120,6 +120,11 @@ ATCA_STATUS atcab_wakeup(void);
 ATCA_STATUS atcab_idle(void);
 ATCA_STATUS atcab_sleep(void);
 
+// packet level access to the global device
+ATCAPacket* atcab_get_packet(void);
+ATCA_STATUS atcab_execute_packet(ATCAPacket *packet, ATCA_CmdMap cmd);
+const uint8_t* atcab_packet_response(const ATCAPacket *packet, uint8_t *length);
+
 // discovery
 ATCA_STATUS atcab_cfg_discover( ATCAIfaceCfg cfgArray[], uint16_t max);
 
@@ -166,6 +171,8 @@ ATCA_STATUS atcab_get_pubkey(uint8_t privSlotId, uint8_t *pubkey);
 ATCA_STATUS atcab_calc_pubkey(uint8_t privSlotId, uint8_t *pubkey);
 ATCA_STATUS atcab_sign(uint16_t slot, const uint8_t *msg, uint8_t *signature);
 ATCA_STATUS atcab_verify_extern(const uint8_t *message, const uint8_t *signature, const uint8_t *pubkey, bool *verified);
+ATCA_STATUS atcab_verify_extern_start(const uint8_t *message, const uint8_t *signature, const uint8_t *pubkey);
+ATCA_STATUS atcab_verify_extern_finish(bool *verified);
 ATCA_STATUS atcab_ecdh(uint16_t key_id, const uint8_t* pubkey, uint8_t* ret_ecdh);
 ATCA_STATUS atcab_ecdh_enc(uint16_t slotid, const uint8_t* pubkey, uint8_t* ret_ecdh, const uint8_t* enckey, const uint8_t enckeyid);
 ATCA_STATUS atcab_gendig(uint8_t zone, uint16_t key_id);
@@ -0,0 +1,374 @@
+/**
+ * \file
+ * \brief Pool of CryptoAuth devices that runs independent operations side by side.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#include <string.h>
+#include "atca_pool.h"
+
+/* The clock is atca_delay_elapsed_us(): only the delays move it, so it never runs ahead of real time
+   and a response it says is due has really been computed. */
+
+/** \brief waits without tying up the delay functions with a long atca_delay_us() */
+static void pool_delay(uint32_t us)
+{
+	if (us >= 1000)
+		atca_delay_ms(us / 1000);
+	if (us % 1000 != 0)
+		atca_delay_us(us % 1000);
+}
+
+/** \brief builds the next command of the job on a device
+ * \param[out] cmd  command, for its execution time
+ */
+static ATCA_STATUS pool_build(ATCAPoolDevice *dev, ATCA_CmdMap *cmd)
+{
+	ATCAPoolJob *job = dev->job;
+	ATCAPacket *packet = atGetPacket(dev->device);
+	size_t left;
+
+	switch (job->op) {
+	case ATCA_POOL_RANDOM:
+		packet->param1 = RANDOM_SEED_UPDATE;
+		packet->param2 = 0;
+		*cmd = CMD_RANDOM;
+		return atRandom(packet);
+
+	case ATCA_POOL_SIGN:
+		// Random, Nonce pass-through of the digest, Sign external: the order atcab_sign() uses
+		if (job->step == 0) {
+			packet->param1 = RANDOM_SEED_UPDATE;
+			packet->param2 = 0;
+			*cmd = CMD_RANDOM;
+			return atRandom(packet);
+		}
+		if (job->step == 1) {
+			packet->param1 = NONCE_MODE_PASSTHROUGH;
+			packet->param2 = 0;
+			memcpy(packet->crypto_data, job->message, ATCA_KEY_SIZE);
+			*cmd = CMD_NONCE;
+			return atNonce(packet);
+		}
+		packet->param1 = SIGN_MODE_EXTERNAL;
+		packet->param2 = job->key_id;
+		*cmd = CMD_SIGN;
+		return atSign(packet);
+
+	case ATCA_POOL_VERIFY:
+		if (job->step == 0) {
+			packet->param1 = NONCE_MODE_PASSTHROUGH;
+			packet->param2 = 0;
+			memcpy(packet->crypto_data, job->message, ATCA_KEY_SIZE);
+			*cmd = CMD_NONCE;
+			return atNonce(packet);
+		}
+		packet->param1 = VERIFY_MODE_EXTERNAL;
+		packet->param2 = VERIFY_KEY_P256;
+		memcpy(&packet->crypto_data[0], job->signature, ATCA_SIG_SIZE);
+		memcpy(&packet->crypto_data[ATCA_SIG_SIZE], job->public_key, ATCA_PUB_KEY_SIZE);
+		*cmd = CMD_VERIFY;
+		return atVerify(packet);
+
+	case ATCA_POOL_SHA256:
+		// Start, an update per full block, then End with the rest (less than a block)
+		*cmd = CMD_SHA;
+		if (job->step == 0) {
+			packet->param1 = SHA_SHA256_START_MASK;
+			packet->param2 = 0;
+			return atSHA(packet);
+		}
+		left = job->length - job->offset;
+		packet->param1 = (left >= SHA_BLOCK_SIZE) ? SHA_SHA256_UPDATE_MASK : SHA_SHA256_END_MASK;
+		packet->param2 = (uint16_t)((left >= SHA_BLOCK_SIZE) ? SHA_BLOCK_SIZE : left);
+		if (packet->param2 > 0)
+			memcpy(packet->crypto_data, &job->message[job->offset], packet->param2);
+		return atSHA(packet);
+	}
+
+	return ATCA_BAD_PARAM;
+}
+
+/** \brief takes the response of the command just completed
+ * \return true when the job has no more commands
+ */
+static bool pool_absorb(ATCAPoolDevice *dev)
+{
+	ATCAPoolJob *job = dev->job;
+	ATCAPacket *packet = atGetPacket(dev->device);
+	const uint8_t *data = &packet->crypto_data[ATCA_RSP_DATA_IDX];
+
+	switch (job->op) {
+	case ATCA_POOL_RANDOM:
+		memcpy(job->out, data, ATCA_KEY_SIZE);
+		return true;
+
+	case ATCA_POOL_SIGN:
+		if (++job->step < 3)
+			return false;
+		memcpy(job->out, data, ATCA_SIG_SIZE);
+		return true;
+
+	case ATCA_POOL_VERIFY:
+		if (++job->step < 2)
+			return false;
+		job->verified = true;
+		return true;
+
+	case ATCA_POOL_SHA256:
+		if (job->step == 0) {
+			job->step = 1;  // started, offset counts the blocks from here so step can't wrap
+			return false;
+		}
+		if (packet->param1 == SHA_SHA256_UPDATE_MASK) {
+			job->offset += SHA_BLOCK_SIZE;
+			return false;
+		}
+		memcpy(job->out, data, ATCA_SHA_DIGEST_SIZE);
+		return true;
+	}
+
+	return true;
+}
+
+/** \brief ends the job on a device and lets the device idle */
+static void pool_finish(ATCAPoolDevice *dev, ATCA_STATUS status)
+{
+	dev->job->status = status;
+	dev->job = NULL;
+	if (dev->awake) {
+		atidle(atGetIFace(dev->device));
+		dev->awake = false;
+	}
+}
+
+/** \brief sends the next command of the job on a device, without waiting for it */
+static void pool_issue(ATCAPoolDevice *dev)
+{
+	ATCAIface iface = atGetIFace(dev->device);
+	ATCAPacket *packet = atGetPacket(dev->device);
+	ATCA_CmdMap cmd;
+	ATCA_STATUS status;
+	uint32_t exec_us;
+
+	if ((status = pool_build(dev, &cmd)) != ATCA_SUCCESS) {
+		pool_finish(dev, status);
+		return;
+	}
+	exec_us = (uint32_t)atGetExecTime(atGetCommands(dev->device), cmd) * 1000;
+
+	// Idle ahead of the watchdog, e.g. between the blocks of a long SHA-256 job
+	if (dev->awake && atca_delay_elapsed_us() + exec_us - dev->wake_us > ATCA_POOL_AWAKE_US) {
+		if ((status = atidle(iface)) != ATCA_SUCCESS) {
+			pool_finish(dev, status);
+			return;
+		}
+		dev->awake = false;
+	}
+
+	if (!dev->awake) {
+		dev->wake_us = atca_delay_elapsed_us();
+		if ((status = atwake(iface)) != ATCA_SUCCESS) {
+			pool_finish(dev, status);
+			return;
+		}
+		dev->awake = true;
+	}
+
+	if ((status = atsend(iface, (uint8_t*)packet, packet->txsize)) != ATCA_SUCCESS) {
+		pool_finish(dev, status);
+		return;
+	}
+	dev->ready_us = atca_delay_elapsed_us() + exec_us;
+}
+
+/** \brief reads the response of a device whose command is due and moves its job on */
+static void pool_collect(ATCAPoolDevice *dev)
+{
+	ATCAPacket *packet = atGetPacket(dev->device);
+	ATCA_STATUS status;
+
+	if ((status = atreceive(atGetIFace(dev->device), packet->crypto_data, &packet->rxsize)) != ATCA_SUCCESS) {
+		pool_finish(dev, status);
+		return;
+	}
+	if (packet->rxsize < ATCA_RSP_SIZE_MIN) {
+		pool_finish(dev, (packet->rxsize > 0) ? ATCA_RX_FAIL : ATCA_RX_NO_RESPONSE);
+		return;
+	}
+
+	status = isATCAError(packet->crypto_data);
+	if (status == ATCA_CHECKMAC_VERIFY_FAILED && dev->job->op == ATCA_POOL_VERIFY) {
+		// Verify failed, but command succeeded
+		dev->job->verified = false;
+		pool_finish(dev, ATCA_SUCCESS);
+		return;
+	}
+	if (status != ATCA_SUCCESS) {
+		pool_finish(dev, status);
+		return;
+	}
+
+	if (pool_absorb(dev))
+		pool_finish(dev, ATCA_SUCCESS);
+	else
+		pool_issue(dev);
+}
+
+/** \brief creates a device handle for each configuration
+ * \param[out] pool   pool to set up
+ * \param[in] cfg     a configuration per chip, e.g. from atcab_cfg_discover()
+ * \param[in] count   number of configurations, 1 to ATCA_POOL_MAX_DEVICES
+ * \return ATCA_STATUS
+ */
+ATCA_STATUS atcab_pool_init(ATCAPool *pool, ATCAIfaceCfg *cfg[], uint8_t count)
+{
+	uint8_t i;
+
+	if (pool == NULL || cfg == NULL || count == 0 || count > ATCA_POOL_MAX_DEVICES)
+		return ATCA_BAD_PARAM;
+
+	memset(pool, 0, sizeof(*pool));
+	for (i = 0; i < count; i++) {
+		if ((pool->devices[i].device = newATCADevice(cfg[i])) == NULL) {
+			atcab_pool_release(pool);
+			return ATCA_COMM_FAIL;
+		}
+		pool->count++;
+	}
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief runs a batch of jobs across the devices of a pool and returns when all of them are done
+ *
+ * Jobs are started in order on whichever device is idle, a job runs on one device from start to end.
+ * \param[in] pool    pool from atcab_pool_init()
+ * \param[in,out] jobs  jobs to run, each gets its status and outputs
+ * \param[in] count   number of jobs
+ * \return ATCA_SUCCESS when every job succeeded, otherwise the status of the first job that failed
+ */
+ATCA_STATUS atcab_pool_run(ATCAPool *pool, ATCAPoolJob jobs[], uint16_t count)
+{
+	ATCAPoolDevice *dev;
+	uint32_t now, wait;
+	int32_t left;
+	uint16_t next = 0;
+	uint16_t i;
+	bool busy;
+
+	if (pool == NULL || pool->count == 0 || (jobs == NULL && count > 0))
+		return ATCA_BAD_PARAM;
+
+	for (i = 0; i < count; i++) {
+		jobs[i].status = ATCA_GEN_FAIL;
+		jobs[i].verified = false;
+		jobs[i].step = 0;
+		jobs[i].offset = 0;
+	}
+
+	for (;;) {
+		// Hand every idle device the next job
+		for (i = 0; i < pool->count && next < count; i++) {
+			dev = &pool->devices[i];
+			if (dev->job == NULL) {
+				dev->job = &jobs[next++];
+				dev->job->device = (uint8_t)i;
+				pool_issue(dev);
+			}
+		}
+
+		// Sleep until the first response is due
+		now = atca_delay_elapsed_us();
+		wait = UINT32_MAX;
+		busy = false;
+		for (i = 0; i < pool->count; i++) {
+			dev = &pool->devices[i];
+			if (dev->job == NULL)
+				continue;
+			busy = true;
+			left = (int32_t)(dev->ready_us - now);
+			if (left <= 0)
+				wait = 0;
+			else if ((uint32_t)left < wait)
+				wait = (uint32_t)left;
+		}
+		if (!busy) {
+			if (next >= count)
+				break;
+			continue;   // every job in flight failed at once, start the next ones
+		}
+		if (wait > 0)
+			pool_delay(wait);
+
+		now = atca_delay_elapsed_us();
+		for (i = 0; i < pool->count; i++) {
+			dev = &pool->devices[i];
+			if (dev->job != NULL && (int32_t)(dev->ready_us - now) <= 0)
+				pool_collect(dev);
+		}
+	}
+
+	for (i = 0; i < count; i++) {
+		if (jobs[i].status != ATCA_SUCCESS)
+			return jobs[i].status;
+	}
+	return ATCA_SUCCESS;
+}
+
+/** \brief puts the devices of a pool to sleep and deletes their handles
+ * \param[in] pool  pool from atcab_pool_init()
+ */
+void atcab_pool_release(ATCAPool *pool)
+{
+	ATCAPoolDevice *dev;
+	ATCAIface iface;
+	uint8_t i;
+
+	for (i = 0; i < pool->count; i++) {
+		dev = &pool->devices[i];
+		iface = atGetIFace(dev->device);
+		// A device only takes the sleep flag while awake
+		if (dev->awake || atwake(iface) == ATCA_SUCCESS)
+			atsleep(iface);
+		dev->awake = false;
+		deleteATCADevice(&dev->device);
+	}
+	pool->count = 0;
+}
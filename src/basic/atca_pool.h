@@ -0,0 +1,125 @@
+/**
+ * \file
+ * \brief Pool of CryptoAuth devices that runs independent operations side by side.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#ifndef ATCA_POOL_H_
+#define ATCA_POOL_H_
+
+#include "cryptoauthlib.h"
+
+/** \defgroup atcab_ Basic Crypto API methods (atcab_)
+ *
+   @{ */
+
+/* The atcab_ methods talk to the one device selected by atcab_init(). A pool owns a device handle per
+   chip instead and runs a batch of jobs across them: every idle chip is handed the next job, the
+   commands of all busy chips execute at the same time, and the pool sleeps only until the first of
+   them is due. With n chips on the bus a batch of signatures takes about 1/n of the time.
+
+   The chips must be ECCx08A devices provisioned alike, so that any of them can run any job. */
+
+/** Most devices in a pool. */
+#ifndef ATCA_POOL_MAX_DEVICES
+#define ATCA_POOL_MAX_DEVICES   (4)
+#endif
+
+/** Longest a device stays awake through a job, in microseconds. The watchdog puts an ECCx08A to sleep
+    about 1.3 s after its wake and drops TempKey and the SHA context, so a job that would run past this
+    idles the device and wakes it again, which restarts the watchdog and keeps both. */
+#ifndef ATCA_POOL_AWAKE_US
+#define ATCA_POOL_AWAKE_US      (500000UL)
+#endif
+
+typedef enum {
+	ATCA_POOL_RANDOM,       //!< 32 random bytes into out
+	ATCA_POOL_SIGN,         //!< sign the 32 byte digest message with the private key in key_id, 64 bytes into out
+	ATCA_POOL_VERIFY,       //!< verify signature over the 32 byte digest message with public_key, result in verified
+	ATCA_POOL_SHA256        //!< SHA-256 of length bytes of message, 32 bytes into out
+} ATCAPoolOp;
+
+/** \brief One operation of a batch. Fill in the inputs of the operation; status and the outputs are
+ *         set by atcab_pool_run(). */
+typedef struct {
+	ATCAPoolOp op;
+	uint16_t key_id;            //!< ATCA_POOL_SIGN
+	const uint8_t *message;     //!< digest, or the data for ATCA_POOL_SHA256
+	size_t length;              //!< ATCA_POOL_SHA256, any length, see ATCA_POOL_AWAKE_US
+	const uint8_t *signature;   //!< ATCA_POOL_VERIFY
+	const uint8_t *public_key;  //!< ATCA_POOL_VERIFY
+	uint8_t *out;               //!< ATCA_POOL_RANDOM, ATCA_POOL_SIGN, ATCA_POOL_SHA256
+	bool verified;              //!< ATCA_POOL_VERIFY
+	ATCA_STATUS status;         //!< result of the job
+	uint8_t device;             //!< index of the device that ran it
+
+	// private, progress through the commands of the job
+	uint8_t step;
+	size_t offset;
+} ATCAPoolJob;
+
+/** \brief State of one device of a pool */
+typedef struct {
+	ATCADevice device;
+	ATCAPoolJob *job;           // job in progress, NULL when idle
+	uint32_t ready_us;          // atca_delay_elapsed_us() when the response is due
+	uint32_t wake_us;           // atca_delay_elapsed_us() at the last wake
+	bool awake;
+} ATCAPoolDevice;
+
+typedef struct {
+	ATCAPoolDevice devices[ATCA_POOL_MAX_DEVICES];
+	uint8_t count;
+} ATCAPool;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ATCA_STATUS atcab_pool_init(ATCAPool *pool, ATCAIfaceCfg *cfg[], uint8_t count);
+ATCA_STATUS atcab_pool_run(ATCAPool *pool, ATCAPoolJob jobs[], uint16_t count);
+void atcab_pool_release(ATCAPool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif /* ATCA_POOL_H_ */
@@ -0,0 +1,264 @@
+/**
+ * \file
+ * \brief Latency benchmark of the eGuard (eg*) entry points.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#include <stdio.h>
+#include <string.h>
+#include "eg_bench.h"
+#include "astekcrypto.h"
+
+/** \brief	Message signed, hashed and booted by the cases, one SHA-256 block. */
+#define EG_BENCH_MESSAGE_SIZE	(64)
+
+/** \brief	Inputs and outputs shared by the cases, static to keep them off small stacks. */
+static struct
+{
+	uint8_t message[EG_BENCH_MESSAGE_SIZE];
+	uint8_t sernum[ATCA_SERIAL_NUM_SIZE];
+	uint8_t random[RANDOM_NUM_SIZE];
+	uint8_t digest[ATCA_SHA_DIGEST_SIZE];
+	uint8_t pubkey[ATCA_PUB_KEY_SIZE];
+	uint8_t signature[ATCA_SIG_SIZE];
+#ifndef EG_BENCH_SKIP_CHAIN
+	auth_chain_inparams chain;
+#endif
+} s_bench;
+
+static ATCA_STATUS bench_detect(void)
+{
+	return egDetectDevice();
+}
+
+static ATCA_STATUS bench_sernum(void)
+{
+	return egSerNum(s_bench.sernum);
+}
+
+static ATCA_STATUS bench_random(void)
+{
+	return egGenRandom(s_bench.random);
+}
+
+static ATCA_STATUS bench_sha256(void)
+{
+	return egSHA256(s_bench.message, sizeof(s_bench.message), s_bench.digest);
+}
+
+static ATCA_STATUS bench_pubkey(void)
+{
+	return egDevicePubKey(s_bench.pubkey);
+}
+
+static ATCA_STATUS bench_auth_symmetric(void)
+{
+	return egAuthenticate(SYMMETRIC, NULL);
+}
+
+static ATCA_STATUS bench_auth_sw_pki(void)
+{
+	return egAuthenticate(SW_PKI, s_bench.pubkey);
+}
+
+static ATCA_STATUS bench_auth_sw_pki_chain(void)
+{
+	return egAuthenticate(SW_PKI_CHAIN, NULL);
+}
+
+#ifndef EG_BENCH_SKIP_CHAIN
+static ATCA_STATUS bench_auth_hw_pki_chain(void)
+{
+	return egAuthenticate(HW_PKI_CHAIN, &s_bench.chain);
+}
+
+static ATCA_STATUS bench_auth_response(void)
+{
+	return egAuthResponse(&s_bench.chain.auth_struct, s_bench.chain.digest, sizeof(s_bench.chain.digest));
+}
+#endif
+
+static ATCA_STATUS bench_sign_tag(void)
+{
+	return egSignTag(s_bench.message, sizeof(s_bench.message), s_bench.signature);
+}
+
+static ATCA_STATUS bench_verify_tag(void)
+{
+	return egVerifyTag(s_bench.message, sizeof(s_bench.message), s_bench.signature);
+}
+
+#ifndef EG_BENCH_SKIP_CHAIN
+static ATCA_STATUS bench_secure_boot(void)
+{
+	return egSecureBoot(&s_bench.chain.auth_struct, s_bench.message);
+}
+#endif
+
+/** \brief	One timed entry point. */
+typedef struct
+{
+	const char* name;
+	ATCA_STATUS (*call)(void);
+} eg_bench_case_t;
+
+static const eg_bench_case_t s_bench_cases[] =
+{
+	{ "egDetectDevice",               bench_detect },
+	{ "egSerNum",                     bench_sernum },
+	{ "egGenRandom",                  bench_random },
+	{ "egSHA256",                     bench_sha256 },
+	{ "egDevicePubKey",               bench_pubkey },
+	{ "egAuthenticate(SYMMETRIC)",    bench_auth_symmetric },
+	{ "egAuthenticate(SW_PKI)",       bench_auth_sw_pki },
+	{ "egAuthenticate(SW_PKI_CHAIN)", bench_auth_sw_pki_chain },
+#ifndef EG_BENCH_SKIP_CHAIN
+	{ "egAuthenticate(HW_PKI_CHAIN)", bench_auth_hw_pki_chain },
+	{ "egAuthResponse",               bench_auth_response },
+#endif
+	{ "egSignTag",                    bench_sign_tag },
+	{ "egVerifyTag",                  bench_verify_tag },
+#ifndef EG_BENCH_SKIP_CHAIN
+	{ "egSecureBoot",                 bench_secure_boot },
+#endif
+};
+
+/** \brief	Produces the public key, signature and authentication response the cases consume.
+ * 			Failures are left for the cases that depend on them to report. */
+static void bench_prepare(void)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(s_bench.message); i++)
+	{
+		s_bench.message[i] = (uint8_t)i;
+	}
+
+	egDevicePubKey(s_bench.pubkey);
+	egSignTag(s_bench.message, sizeof(s_bench.message), s_bench.signature);
+#ifndef EG_BENCH_SKIP_CHAIN
+	egGenRandom(s_bench.chain.digest);
+	egAuthResponse(&s_bench.chain.auth_struct, s_bench.chain.digest, sizeof(s_bench.chain.digest));
+#endif
+}
+
+ATCA_STATUS eg_bench_run(uint16_t iterations, eg_bench_clock_t clock, eg_bench_report_t report, void* context)
+{
+	ATCADevice device = atcab_getDevice();
+	const ATCAIfaceStats* stats;
+	eg_bench_result_t result;
+	ATCAIfaceStats before;
+	uint32_t delay_before;
+	uint32_t start, elapsed;
+	ATCA_STATUS status;
+	size_t i;
+	uint16_t n;
+
+	if (iterations == 0 || clock == NULL || report == NULL)
+	{
+		return ATCA_BAD_PARAM;
+	}
+	if (device == NULL)
+	{
+		return ATCA_GEN_FAIL;
+	}
+	stats = atgetifacestats(atGetIFace(device));
+
+	bench_prepare();
+
+	for (i = 0; i < sizeof(s_bench_cases) / sizeof(s_bench_cases[0]); i++)
+	{
+		memset(&result, 0, sizeof(result));
+		result.name = s_bench_cases[i].name;
+		result.iterations = iterations;
+		result.status = ATCA_SUCCESS;
+		result.wall_min_us = UINT32_MAX;
+
+		before = *stats;
+		delay_before = atca_delay_elapsed_us();
+
+		for (n = 0; n < iterations; n++)
+		{
+			start = clock();
+			status = s_bench_cases[i].call();
+			elapsed = clock() - start;
+
+			result.wall_us += elapsed;
+			if (elapsed < result.wall_min_us)
+			{
+				result.wall_min_us = elapsed;
+			}
+			if (elapsed > result.wall_max_us)
+			{
+				result.wall_max_us = elapsed;
+			}
+			if (status != ATCA_SUCCESS && result.status == ATCA_SUCCESS)
+			{
+				result.status = status;
+			}
+		}
+
+		result.tx_bytes = stats->tx_bytes - before.tx_bytes;
+		result.rx_bytes = stats->rx_bytes - before.rx_bytes;
+		result.wakes = (uint16_t)(stats->wakes - before.wakes);
+		result.delay_us = atca_delay_elapsed_us() - delay_before;
+
+		report(&result, context);
+	}
+
+	return ATCA_SUCCESS;
+}
+
+size_t eg_bench_format_header(char* line, size_t size)
+{
+	int length = snprintf(line, size, "version,name,iterations,status,wall_us,wall_min_us,wall_max_us,tx_bytes,rx_bytes,wakes,delay_us");
+
+	return (length < 0) ? 0 : (size_t)length;
+}
+
+size_t eg_bench_format(const eg_bench_result_t* result, char* line, size_t size)
+{
+	int length = snprintf(line, size, "%d,\"%s\",%u,%02X,%lu,%lu,%lu,%lu,%lu,%lu,%lu",
+		EG_BENCH_FORMAT_VERSION, result->name, (unsigned)result->iterations, (unsigned)result->status,
+		(unsigned long)result->wall_us, (unsigned long)result->wall_min_us, (unsigned long)result->wall_max_us,
+		(unsigned long)result->tx_bytes, (unsigned long)result->rx_bytes, (unsigned long)result->wakes,
+		(unsigned long)result->delay_us);
+
+	return (length < 0) ? 0 : (size_t)length;
+}
@@ -0,0 +1,148 @@
+/**
+ * \file
+ * \brief Latency benchmark of the eGuard (eg*) entry points.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#ifndef EG_BENCH_H_
+#define EG_BENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "atca_status.h"
+
+/** Version of the CSV layout written by eg_bench_format(), first field of every record. */
+#define EG_BENCH_FORMAT_VERSION		(1)
+
+/** Size of a buffer that holds any line written by eg_bench_format() or eg_bench_format_header(). */
+#define EG_BENCH_LINE_SIZE			(160)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************//**
+ * \struct	eg_bench_result_t
+ *
+ * \brief	Measurements of one entry point over all iterations. Counters are totals, divide by
+ * 			iterations for the per-call figures.
+ **************************************************************************************************/
+typedef struct eg_bench_result_t
+{
+	/** Case name, e.g. "egAuthenticate(SYMMETRIC)". */
+	const char* name;
+	/** Calls made. */
+	uint16_t iterations;
+	/** First status other than ATCA_SUCCESS, ATCA_SUCCESS if every call passed. */
+	ATCA_STATUS status;
+	/** Total wall time in microseconds, from the caller's clock. */
+	uint32_t wall_us;
+	/** Fastest and slowest single call in microseconds. */
+	uint32_t wall_min_us;
+	uint32_t wall_max_us;
+	/** Bytes sent and received on the bus (ATCAIfaceStats). */
+	uint32_t tx_bytes;
+	uint32_t rx_bytes;
+	/** Wake attempts. */
+	uint32_t wakes;
+	/** Microseconds requested from the atca_delay functions (atca_delay_elapsed_us()). */
+	uint32_t delay_us;
+} eg_bench_result_t;
+
+/** \brief	Microsecond clock used for wall time, e.g. micros() on Arduino. May wrap. */
+typedef uint32_t (*eg_bench_clock_t)(void);
+
+/** \brief	Receives the result of each case as soon as it completes. */
+typedef void (*eg_bench_report_t)(const eg_bench_result_t* result, void* context);
+
+/**********************************************************************************************//**
+ * \fn	ATCA_STATUS eg_bench_run(uint16_t iterations, eg_bench_clock_t clock, eg_bench_report_t report, void* context)
+ *
+ * \brief	Times every eg* entry point against the device selected with egSelectDevice():
+ * 			egDetectDevice, egSerNum, egGenRandom, egSHA256, egDevicePubKey, the four
+ * 			egAuthenticate modes, egAuthResponse, egSignTag, egVerifyTag and egSecureBoot.
+ * 			Inputs the later cases need (public key, signature, authentication response) are
+ * 			produced before timing starts. A failing case is still timed and reported with its
+ * 			status, the run carries on with the next one.
+ *
+ * 			Define EG_BENCH_SKIP_CHAIN to leave out the cases that need a pki_chain_auth_struct
+ * 			(about 1.1 KB of RAM) on small parts.
+ *
+ * \param	iterations	Calls per case, at least 1.
+ * \param	clock	  	Microsecond clock.
+ * \param	report	  	Called once per case.
+ * \param	context	  	Passed through to report.
+ *
+ * \return	ATCA_SUCCESS once every case ran, ATCA_BAD_PARAM or ATCA_GEN_FAIL if no device is
+ * 			selected. Case failures are reported through report only.
+ **************************************************************************************************/
+ATCA_STATUS eg_bench_run(uint16_t iterations, eg_bench_clock_t clock, eg_bench_report_t report, void* context);
+
+/**********************************************************************************************//**
+ * \fn	size_t eg_bench_format_header(char* line, size_t size)
+ *
+ * \brief	Writes the CSV header matching eg_bench_format(), without a line ending.
+ *
+ * \param [out]	line	Output buffer, EG_BENCH_LINE_SIZE bytes is always enough.
+ * \param 	   	size	Size of line.
+ *
+ * \return	Characters written, excluding the terminator.
+ **************************************************************************************************/
+size_t eg_bench_format_header(char* line, size_t size);
+
+/**********************************************************************************************//**
+ * \fn	size_t eg_bench_format(const eg_bench_result_t* result, char* line, size_t size)
+ *
+ * \brief	Writes one result as a CSV record, without a line ending:
+ * 			version,name,iterations,status,wall_us,wall_min_us,wall_max_us,tx_bytes,rx_bytes,wakes,delay_us
+ * 			with totals over all iterations and the status in hex. The name is quoted.
+ *
+ * \param [in] 	result	Result to write.
+ * \param [out]	line  	Output buffer, EG_BENCH_LINE_SIZE bytes is always enough.
+ * \param 	   	size  	Size of line.
+ *
+ * \return	Characters written, excluding the terminator.
+ **************************************************************************************************/
+size_t eg_bench_format(const eg_bench_result_t* result, char* line, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EG_BENCH_H_ */
@@ -42,12 +42,15 @@
  */
 #include "secureboot.h"
 #include "atcacert/atcacert_client.h"
+#include "atcacert/atcacert_chain.h"
 #include "atcacert/atcacert_host_hw.h"
+#include "atcacert/atcacert_host_sw.h"
 #include "atcacert/atcacert_def.h"
 #include "crypto/atca_crypto_sw_sha2.h"
 #include "custom/cert_def_1_signer.h"
 #include "custom/cert_def_2_device.h"
 #include "custom/custom_auth_def.h"
+#include "custom/custom_fixed_base.h"
 #include "authentication/Authenticate.h"
 
 
@@ -63,8 +66,8 @@
 ATCA_STATUS secureboot_verify_fw_img(pki_chain_auth_struct* params, uint8_t* AppImage)
 {
 	ATCA_STATUS ret = ATCA_UNIMPLEMENTED;
-	uint8_t signer_pubkey[ATCA_PUB_KEY_SIZE];
-	uint8_t device_pubkey[ATCA_PUB_KEY_SIZE];
+	atcacert_chain_link_t links[PKI_CHAIN_LINKS];
+	const uint8_t* device_pubkey = NULL;
 	uint8_t digest[ATCA_SHA_DIGEST_SIZE];
 	bool is_verified = false;
 	
@@ -74,20 +77,9 @@ ATCA_STATUS secureboot_verify_fw_img(pki_chain_auth_struct* params, uint8_t* App
 		return ATCA_INVALID_ID;
 	}
 	
-	/*Validate signer certificate against root public key*/
-	ret = atcacert_verify_cert_hw(&g_cert_def_1_signer, &params->signer_cert[0], SIGNER_CERT_SIZE, params->root_pubkey);
-	if (ret != ATCA_SUCCESS) return ret;
-	
-	/*Extract signer public key*/
-	ret = atcacert_get_subj_public_key(&g_cert_def_1_signer, &params->signer_cert[0], SIGNER_CERT_SIZE, signer_pubkey);
-	if (ret != ATCA_SUCCESS) return ret;
-	
-	/*Validate the device cert against signer key*/
-	ret = atcacert_verify_cert_hw(&g_cert_def_2_device, &params->device_cert[0], DEVICE_CERT_SIZE, signer_pubkey);
-	if (ret != ATCA_SUCCESS) return ret;
-	
-	/*Extract device public key.*/
-	ret = atcacert_get_subj_public_key(&g_cert_def_2_device, &params->device_cert[0], DEVICE_CERT_SIZE, device_pubkey);
+	/*Validate signer certificate against root public key and device cert against signer key, extract device public key*/
+	auth_pki_chain_links(params, links);
+	ret = atcacert_chain_verify(links, PKI_CHAIN_LINKS, params->root_pubkey, &atcacert_chain_verifier_hw, NULL, &device_pubkey);
 	if (ret != ATCA_SUCCESS) return ret;
 
 	/*Check device public key matches tag_signer_pubkey*/
@@ -108,3 +100,42 @@ ATCA_STATUS secureboot_verify_fw_img(pki_chain_auth_struct* params, uint8_t* App
 }
 
 
+ATCA_STATUS secureboot_verify_fw_img_sw(pki_chain_auth_struct* params, uint8_t* AppImage)
+{
+	ATCA_STATUS ret = ATCA_UNIMPLEMENTED;
+	atcacert_chain_link_t links[PKI_CHAIN_LINKS];
+	const uint8_t* device_pubkey = NULL;
+	uint8_t digest[ATCA_SHA_DIGEST_SIZE];
+	
+	if (params == NULL || AppImage == NULL)
+	{
+		return ATCA_BAD_PARAM;
+	}
+	
+	//Check root public keys match
+	if ( memcmp( &(params->root_pubkey), &g_signer_1_ca_public_key, ATCA_PUB_KEY_SIZE ) != 0 )
+	{
+		return ATCA_INVALID_ID;
+	}
+	
+	/*Validate signer certificate against the precomputed root key table and device cert against signer key, extract device public key*/
+	auth_pki_chain_links(params, links);
+	links[0].verifier         = &atcacert_chain_verifier_fixed_sw;
+	links[0].verifier_context = &g_signer_1_ca_public_key_table;
+	ret = atcacert_chain_verify(links, PKI_CHAIN_LINKS, params->root_pubkey, &atcacert_chain_verifier_sw, NULL, &device_pubkey);
+	if (ret != ATCA_SUCCESS) return ret;
+
+	/*Check device public key matches tag_signer_pubkey*/
+	if ( memcmp( &device_pubkey[0], &tag_signer_pubkey, ATCA_PUB_KEY_SIZE ) != 0 )
+	{
+		return ATCA_INVALID_ID;
+	}
+	
+	/*Calculate app digest*/
+	ret = atcac_sw_sha2_256(AppImage, params->msg_size, digest);
+	if (ret != ATCA_SUCCESS) return ret;
+	
+	/*Verify digest against signature with the precomputed tag signer table*/
+	return atcac_sw_ecdsa_verify_p256_fixed(&digest[0], &(params->msg_signature[0]), &g_tag_signer_pubkey_table);
+}
+
@@ -69,4 +69,18 @@
  **************************************************************************************************/
 ATCA_STATUS secureboot_verify_fw_img(pki_chain_auth_struct* params, uint8_t* AppImage);
 
+/**********************************************************************************************//**
+ * \fn	ATCA_STATUS secureboot_verify_fw_img_sw(pki_chain_auth_struct* params, uint8_t* AppImage);
+ *
+ * \brief	Software-only variant of secureboot_verify_fw_img(). The root and tag signer keys are
+ * 			fixed at build time, so their checks use the precomputed comb tables in
+ * 			custom_fixed_base.c instead of generic scalar multiplications.
+ *
+ * \param [in,out]	params  	Pointer to Certificate (authentication structure)
+ * \param [in,out]	AppImage	Pointer to beginning of application image
+ *
+ * \return	 ATCA_SUCCESS otherwise error code
+ **************************************************************************************************/
+ATCA_STATUS secureboot_verify_fw_img_sw(pki_chain_auth_struct* params, uint8_t* AppImage);
+
 #endif /* SECUREBOOT_H_ */
\ No newline at end of file
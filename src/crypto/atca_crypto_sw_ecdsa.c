@@ -41,6 +41,7 @@
  * \astek_eguard_library_license_stop
  */
 #include "atca_crypto_sw_ecdsa.h"
+#include "atca_crypto_sw_sha2.h"
 #include <string.h>
 
 #define NUM_ECC_DIGITS (ECC_BYTES/8)
@@ -1109,6 +1110,30 @@ int ecc_make_key(uint8_t p_publicKey[ECC_BYTES+1], uint8_t p_privateKey[ECC_BYTE
     return 1;
 }
 
+int ecc_make_public_key_sw(const uint8_t p_privateKey[ECC_BYTES], uint8_t p_publicKey[ECC_BYTES*2])
+{
+    uint64_t l_private[NUM_ECC_DIGITS];
+    EccPoint l_public;
+
+    ecc_bytes2native(l_private, p_privateKey);
+
+    /* The private key must be in the range [1, n-1]. */
+    if(vli_isZero(l_private) || vli_cmp(curve_n, l_private) != 1)
+    {
+        return 0;
+    }
+
+    EccPoint_mult(&l_public, &curve_G, l_private, NULL);
+    if(EccPoint_isZero(&l_public))
+    {
+        return 0;
+    }
+
+    ecc_native2bytes(p_publicKey, l_public.x);
+    ecc_native2bytes(p_publicKey + ECC_BYTES, l_public.y);
+    return 1;
+}
+
 int ecdh_shared_secret(const uint8_t p_publicKey[ECC_BYTES+1], const uint8_t p_privateKey[ECC_BYTES], uint8_t p_secret[ECC_BYTES])
 {
     EccPoint l_public;
@@ -1203,14 +1228,51 @@ static uint umax(uint a, uint b)
     return (a > b ? a : b);
 }
 
-int ecdsa_sign_sw(const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_BYTES], uint8_t p_signature[ECC_BYTES*2])
+/* Computes the signature for nonce p_k. Returns 0 if p_k must be rejected (r == 0). */
+static int ecdsa_sign_k(uint64_t l_private[NUM_ECC_DIGITS], uint64_t l_hash[NUM_ECC_DIGITS], uint64_t k[NUM_ECC_DIGITS], uint8_t p_signature[ECC_BYTES*2])
 {
-    uint64_t k[NUM_ECC_DIGITS];
-    uint64_t l_tmp[NUM_ECC_DIGITS];
     uint64_t l_s[NUM_ECC_DIGITS];
     EccPoint p;
+
+    /* tmp = k * G */
+    EccPoint_mult(&p, &curve_G, k, NULL);
+
+    /* r = x1 (mod n) */
+    if(vli_cmp(curve_n, p.x) != 1)
+    {
+        vli_sub(p.x, p.x, curve_n);
+    }
+    if(vli_isZero(p.x))
+    {
+        return 0;
+    }
+
+    ecc_native2bytes(p_signature, p.x);
+
+    vli_modMult(l_s, p.x, l_private, curve_n); /* s = r*d */
+    vli_modAdd(l_s, l_hash, l_s, curve_n); /* s = e + r*d */
+    vli_modInv(k, k, curve_n); /* k = 1 / k */
+    vli_modMult(l_s, l_s, k, curve_n); /* s = (e + r*d) / k */
+    ecc_native2bytes(p_signature + ECC_BYTES, l_s);
+
+    return 1;
+}
+
+#if !ECC_DETERMINISTIC_NONCE
+int ecdsa_sign_sw(const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_BYTES], uint8_t p_signature[ECC_BYTES*2])
+{
+    uint64_t k[NUM_ECC_DIGITS];
+    uint64_t l_private[NUM_ECC_DIGITS];
+    uint64_t l_hash[NUM_ECC_DIGITS];
     unsigned l_tries = 0;
-    
+
+    ecc_bytes2native(l_private, p_privateKey);
+    ecc_bytes2native(l_hash, p_hash);
+    if(vli_cmp(curve_n, l_hash) != 1)
+    {
+        vli_sub(l_hash, l_hash, curve_n);
+    }
+
     do
     {
         if(!getRandomNumber(k) || (l_tries++ >= MAX_TRIES))
@@ -1221,34 +1283,109 @@ int ecdsa_sign_sw(const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[EC
         {
             continue;
         }
-    
+
         if(vli_cmp(curve_n, k) != 1)
         {
             vli_sub(k, k, curve_n);
         }
-    
-        /* tmp = k * G */
-        EccPoint_mult(&p, &curve_G, k, NULL);
-    
-        /* r = x1 (mod n) */
-        if(vli_cmp(curve_n, p.x) != 1)
+    } while(!ecdsa_sign_k(l_private, l_hash, k, p_signature));
+
+    return 1;
+}
+#endif
+
+/* k = HMAC_K(V || p_sep || x || h1) followed by V = HMAC_K(V), RFC 6979 section 3.2 d-g. */
+static int rfc6979_update(uint8_t K[ECC_BYTES], uint8_t V[ECC_BYTES], const uint8_t *p_sep, const uint8_t *p_private, const uint8_t *p_hash)
+{
+    atcac_hmac_sha256_ctx l_ctx;
+
+    if(atcac_sw_hmac_sha256_init(&l_ctx, K, ECC_BYTES) != ATCA_SUCCESS)
+    {
+        return 0;
+    }
+    atcac_sw_hmac_sha256_update(&l_ctx, V, ECC_BYTES);
+    if(p_sep)
+    {
+        atcac_sw_hmac_sha256_update(&l_ctx, p_sep, 1);
+        atcac_sw_hmac_sha256_update(&l_ctx, p_private, ECC_BYTES);
+        atcac_sw_hmac_sha256_update(&l_ctx, p_hash, ECC_BYTES);
+    }
+    else
+    {
+        static const uint8_t l_zero = 0x00;
+        atcac_sw_hmac_sha256_update(&l_ctx, &l_zero, 1);
+    }
+    atcac_sw_hmac_sha256_finish(&l_ctx, K);
+
+    return atcac_sw_hmac_sha256(K, ECC_BYTES, V, ECC_BYTES, V) == ATCA_SUCCESS;
+}
+
+int ecdsa_sign_deterministic_sw(const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_BYTES], uint8_t p_signature[ECC_BYTES*2])
+{
+    static const uint8_t l_sep[2] = {0x00, 0x01};
+    uint8_t K[ECC_BYTES];
+    uint8_t V[ECC_BYTES];
+    uint8_t l_h1[ECC_BYTES];
+    uint64_t k[NUM_ECC_DIGITS];
+    uint64_t l_private[NUM_ECC_DIGITS];
+    uint64_t l_hash[NUM_ECC_DIGITS];
+    unsigned l_tries = 0;
+    int l_ret = 0;
+
+    ecc_bytes2native(l_private, p_privateKey);
+    if(vli_isZero(l_private) || vli_cmp(curve_n, l_private) != 1)
+    {
+        return 0;
+    }
+
+    /* bits2octets(h1): the hash reduced mod n. */
+    ecc_bytes2native(l_hash, p_hash);
+    if(vli_cmp(curve_n, l_hash) != 1)
+    {
+        vli_sub(l_hash, l_hash, curve_n);
+    }
+    ecc_native2bytes(l_h1, l_hash);
+
+    memset(V, 0x01, sizeof(V));
+    memset(K, 0x00, sizeof(K));
+    if(!rfc6979_update(K, V, &l_sep[0], p_privateKey, l_h1) ||
+       !rfc6979_update(K, V, &l_sep[1], p_privateKey, l_h1))
+    {
+        goto done;
+    }
+
+    while(l_tries++ < MAX_TRIES)
+    {
+        if(atcac_sw_hmac_sha256(K, ECC_BYTES, V, ECC_BYTES, V) != ATCA_SUCCESS)
+        {
+            goto done;
+        }
+        ecc_bytes2native(k, V);
+        if(!vli_isZero(k) && vli_cmp(curve_n, k) == 1 && ecdsa_sign_k(l_private, l_hash, k, p_signature))
         {
-            vli_sub(p.x, p.x, curve_n);
+            l_ret = 1;
+            goto done;
         }
-    } while(vli_isZero(p.x));
+        if(!rfc6979_update(K, V, NULL, NULL, NULL))
+        {
+            goto done;
+        }
+    }
 
-    ecc_native2bytes(p_signature, p.x);
-    
-    ecc_bytes2native(l_tmp, p_privateKey);
-    vli_modMult(l_s, p.x, l_tmp, curve_n); /* s = r*d */
-    ecc_bytes2native(l_tmp, p_hash);
-    vli_modAdd(l_s, l_tmp, l_s, curve_n); /* s = e + r*d */
-    vli_modInv(k, k, curve_n); /* k = 1 / k */
-    vli_modMult(l_s, l_s, k, curve_n); /* s = (e + r*d) / k */
-    ecc_native2bytes(p_signature + ECC_BYTES, l_s);
-    
-    return 1;
+done:
+    memset(K, 0, sizeof(K));
+    memset(V, 0, sizeof(V));
+    memset(k, 0, sizeof(k));
+    memset(l_private, 0, sizeof(l_private));
+    return l_ret;
+}
+
+#if ECC_DETERMINISTIC_NONCE
+int ecdsa_sign_sw(const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_BYTES], uint8_t p_signature[ECC_BYTES*2])
+{
+    return ecdsa_sign_deterministic_sw(p_privateKey, p_hash, p_signature);
 }
+#endif
 
 int ecdsa_verify_sw(const uint8_t p_publicKey[ECC_BYTES*2], const uint8_t p_hash[ECC_BYTES], const uint8_t p_signature[ECC_BYTES*2])
 {
@@ -1339,7 +1476,348 @@ int ecdsa_verify_sw(const uint8_t p_publicKey[ECC_BYTES*2], const uint8_t p_hash
     return (vli_cmp(rx, l_r) == 0);
 }
 
+/* -------- Fixed-base comb verification -------- */
+
+#if ECC_CURVE == secp256r1
+
+/* Comb table of the curve generator, produced by extras/gen_fixed_base. */
+static const ecc_fixed_base_t curve_G_table ATCA_PROGMEM = { {
+    {
+        0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47, 0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
+        0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0, 0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96,
+        0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B, 0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
+        0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE, 0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5,
+    },
+    {
+        0x0F, 0xA8, 0x22, 0xBC, 0x28, 0x11, 0xAA, 0xA5, 0x84, 0x92, 0x59, 0x2E, 0x32, 0x6E, 0x25, 0xDE,
+        0x29, 0x49, 0x3B, 0xAA, 0xAD, 0x65, 0x1F, 0x7E, 0x90, 0xE7, 0x5C, 0xB4, 0x8E, 0x14, 0xDB, 0x63,
+        0xBF, 0xF4, 0x4A, 0xE8, 0xF5, 0xDB, 0xA8, 0x0D, 0x6F, 0x4A, 0xD4, 0xBC, 0xB3, 0xDF, 0x18, 0x8B,
+        0x34, 0xB1, 0xA6, 0x50, 0x50, 0xFE, 0x82, 0xF5, 0xE4, 0x11, 0x24, 0x54, 0x5F, 0x46, 0x2E, 0xE7,
+    },
+    {
+        0x30, 0x0A, 0x4B, 0xBC, 0x89, 0xD6, 0x72, 0x6F, 0xB2, 0x57, 0xC0, 0xDE, 0x95, 0xE0, 0x27, 0x89,
+        0xE9, 0x6C, 0x98, 0xFD, 0x0D, 0x35, 0xF1, 0xFA, 0x93, 0x39, 0x1C, 0xE2, 0x09, 0x79, 0x92, 0xAF,
+        0x72, 0xAA, 0xC7, 0xE0, 0xD0, 0x9B, 0x46, 0x44, 0x7F, 0x1D, 0xDB, 0x25, 0xFF, 0x1E, 0x3C, 0x6F,
+        0x5B, 0xB1, 0xEE, 0xAD, 0xA9, 0xD8, 0x06, 0xA5, 0xAA, 0x54, 0xA2, 0x91, 0xC0, 0x81, 0x27, 0xA0,
+    },
+    {
+        0x44, 0x7D, 0x73, 0x9B, 0xEE, 0xDB, 0x5E, 0x67, 0xFB, 0x98, 0x2F, 0xD5, 0x88, 0xC6, 0x76, 0x6E,
+        0xFC, 0x35, 0xFF, 0x7D, 0xC2, 0x97, 0xEA, 0xC3, 0x57, 0xC8, 0x4F, 0xC9, 0xD7, 0x89, 0xBD, 0x85,
+        0x2D, 0x48, 0x25, 0xAB, 0x83, 0x41, 0x31, 0xEE, 0xE1, 0x2E, 0x9D, 0x95, 0x3A, 0x4A, 0xAF, 0xF7,
+        0x3D, 0x34, 0x9B, 0x95, 0xA7, 0xFA, 0xE5, 0x00, 0x0C, 0x7E, 0x33, 0xC9, 0x72, 0xE2, 0x5B, 0x32,
+    },
+    {
+        0xEF, 0x95, 0x19, 0x32, 0x8A, 0x9C, 0x72, 0xFF, 0xDD, 0xC6, 0x06, 0x8B, 0xB9, 0x1D, 0xFC, 0x60,
+        0xEF, 0x7F, 0xBD, 0x2B, 0x1A, 0x0A, 0x11, 0xB7, 0x13, 0x94, 0x9C, 0x93, 0x2A, 0x1D, 0x36, 0x7F,
+        0x61, 0x1E, 0x9F, 0xC3, 0x7D, 0xBB, 0x2C, 0x9B, 0xC1, 0xEE, 0x98, 0x07, 0x02, 0x2C, 0x21, 0x9C,
+        0x23, 0x18, 0x3B, 0x08, 0x95, 0xCA, 0x17, 0x40, 0x19, 0x60, 0x35, 0xA7, 0x73, 0x76, 0xD8, 0xA8,
+    },
+    {
+        0x55, 0x06, 0x63, 0x79, 0x7B, 0x51, 0xF5, 0xD8, 0x7D, 0xEA, 0x64, 0x82, 0xE1, 0x12, 0x38, 0xBF,
+        0x29, 0x36, 0xDF, 0x5E, 0xC6, 0xC9, 0xBC, 0x36, 0xCA, 0xE2, 0xB1, 0x92, 0x0B, 0x57, 0xF4, 0xBC,
+        0x15, 0x71, 0x64, 0x84, 0x8A, 0xEC, 0xB8, 0x51, 0x0A, 0xFA, 0x40, 0x01, 0x8D, 0x9D, 0x50, 0xE5,
+        0x9F, 0xB3, 0xD5, 0x76, 0xDB, 0xDE, 0xFB, 0xE1, 0x44, 0xFF, 0xE2, 0x16, 0x34, 0x8A, 0x96, 0x4C,
+    },
+    {
+        0xEB, 0x5D, 0x77, 0x45, 0xB2, 0x11, 0x41, 0xEA, 0xA2, 0xE8, 0xF4, 0x83, 0xF4, 0x3E, 0x43, 0x91,
+        0x7C, 0xCD, 0x84, 0xE7, 0x0D, 0x71, 0x5F, 0x26, 0xE4, 0x8E, 0xCA, 0xFF, 0xFC, 0x5C, 0xDE, 0x01,
+        0xEA, 0xFD, 0x72, 0xEB, 0xDB, 0xEC, 0xC1, 0x7B, 0x09, 0x90, 0xE6, 0xA1, 0x58, 0x00, 0x6C, 0xEE,
+        0x85, 0xF2, 0x2C, 0xFE, 0x28, 0x44, 0xB6, 0x45, 0xCA, 0xC9, 0x17, 0xE2, 0x73, 0x1A, 0x34, 0x79,
+    },
+    {
+        0xA6, 0xD3, 0x96, 0x77, 0xA7, 0x84, 0x92, 0x76, 0x27, 0x36, 0xFF, 0x83, 0x44, 0x31, 0x5F, 0xC5,
+        0x96, 0x43, 0x95, 0x91, 0xA3, 0xC6, 0xB9, 0x4A, 0x6C, 0xF2, 0x0F, 0xFB, 0x31, 0x37, 0x28, 0xBE,
+        0x67, 0x4F, 0x84, 0x74, 0x9B, 0x0B, 0x88, 0x16, 0x66, 0xB8, 0xBA, 0xBD, 0x2D, 0x27, 0xEC, 0xDF,
+        0x82, 0x4A, 0x92, 0x0C, 0x22, 0x84, 0x05, 0x9B, 0xF2, 0xBA, 0xB8, 0x33, 0xC3, 0x57, 0xF5, 0xF4,
+    },
+    {
+        0x4E, 0x76, 0x9E, 0x76, 0x72, 0xC9, 0xDD, 0xAD, 0x31, 0x85, 0x5F, 0x7D, 0xB8, 0xC7, 0xFE, 0xDB,
+        0x74, 0xE0, 0x2F, 0x08, 0x02, 0x03, 0xA5, 0x6B, 0x2D, 0xF4, 0x8C, 0x04, 0x67, 0x7C, 0x8A, 0x3E,
+        0x42, 0xB9, 0x90, 0x82, 0xDE, 0x83, 0x06, 0x63, 0x1E, 0xC0, 0x05, 0x72, 0x06, 0x94, 0x72, 0x81,
+        0xFB, 0x9A, 0xE1, 0x6F, 0x3B, 0x91, 0x22, 0xA5, 0xA4, 0xC3, 0x61, 0x65, 0xB8, 0x24, 0xBB, 0xB0,
+    },
+    {
+        0x78, 0x87, 0x8E, 0xF6, 0x1C, 0x6C, 0xE0, 0x4D, 0x7F, 0xDC, 0x1C, 0xA0, 0x08, 0xA1, 0xC4, 0x78,
+        0xD1, 0xF8, 0x9E, 0x79, 0x9C, 0x0C, 0xE1, 0x31, 0x6E, 0xF9, 0x51, 0x50, 0xDD, 0xA8, 0x68, 0xB9,
+        0xB6, 0xCB, 0x3F, 0x5D, 0x7B, 0x72, 0xC3, 0x21, 0xDE, 0x53, 0x14, 0x2C, 0x12, 0x30, 0x9D, 0xEF,
+        0x6A, 0xCE, 0x57, 0x0E, 0xBD, 0xE0, 0x8D, 0x4F, 0x9C, 0x62, 0xB9, 0x12, 0x1F, 0xE0, 0xD9, 0x76,
+    },
+    {
+        0x0C, 0x88, 0xBC, 0x4D, 0x71, 0x6B, 0x12, 0x87, 0x59, 0x5C, 0x52, 0x20, 0x81, 0x2F, 0xFC, 0xAE,
+        0x5B, 0x82, 0xDD, 0x5B, 0xD5, 0x4F, 0xB4, 0x96, 0x7F, 0x99, 0x1E, 0xD2, 0xC3, 0x1A, 0x35, 0x73,
+        0xDD, 0x5D, 0xDE, 0xA3, 0xF3, 0x90, 0x1D, 0xC6, 0x18, 0xD1, 0xB5, 0xB3, 0x9C, 0x04, 0xE6, 0xAA,
+        0x7C, 0x81, 0x81, 0xF4, 0xDF, 0x25, 0x64, 0xF3, 0x3A, 0x57, 0xBF, 0x63, 0x5F, 0x48, 0xAC, 0xA8,
+    },
+    {
+        0x68, 0xF3, 0x44, 0xAF, 0x6B, 0x31, 0x74, 0x66, 0xEF, 0xE0, 0xA4, 0x23, 0x08, 0x3E, 0x49, 0xF3,
+        0x43, 0xA0, 0xA2, 0x8C, 0x42, 0xBA, 0x79, 0x2F, 0xE9, 0x6A, 0x79, 0xFB, 0x3E, 0x72, 0xAD, 0x0C,
+        0x31, 0xB9, 0xC4, 0x05, 0xF8, 0x54, 0x0A, 0x20, 0x60, 0x4E, 0xD9, 0x3C, 0x24, 0xD6, 0x7F, 0xF3,
+        0x66, 0x8B, 0xFC, 0x22, 0x71, 0xF5, 0xC6, 0x26, 0xCD, 0xFE, 0x17, 0xDB, 0x3F, 0xB2, 0x4D, 0x4A,
+    },
+    {
+        0x40, 0x52, 0xBF, 0x4B, 0x6F, 0x46, 0x1D, 0xB9, 0x66, 0x3C, 0x62, 0xC3, 0xED, 0xBA, 0xD7, 0xA0,
+        0x0D, 0x1A, 0x10, 0x14, 0x4E, 0xC3, 0x9C, 0x28, 0xD3, 0x6B, 0x47, 0x89, 0xA2, 0x58, 0x2E, 0x7F,
+        0xFE, 0xCF, 0x4D, 0x51, 0x90, 0xB0, 0xFC, 0x61, 0x86, 0x2B, 0xE6, 0xBD, 0x71, 0xD7, 0x0C, 0xC8,
+        0xE7, 0x24, 0xF3, 0x39, 0x99, 0xBF, 0xCC, 0x5B, 0x23, 0x5A, 0x27, 0xC3, 0x18, 0x8D, 0x25, 0xEB,
+    },
+    {
+        0x1E, 0xDD, 0xBA, 0xE2, 0xC8, 0x02, 0xE4, 0x1A, 0x12, 0x32, 0x02, 0xA8, 0xF6, 0x2B, 0xFF, 0x7A,
+        0xAF, 0xDF, 0x5C, 0xC0, 0x85, 0x26, 0xA7, 0xA4, 0x74, 0x34, 0x6C, 0x10, 0xA1, 0xD4, 0xCF, 0xAC,
+        0x43, 0x10, 0x4D, 0x86, 0x56, 0x0E, 0xBC, 0xFC, 0x0C, 0x45, 0xF4, 0x52, 0x73, 0xDB, 0x33, 0xA0,
+        0x36, 0xE0, 0x6B, 0x7E, 0x4C, 0x70, 0x19, 0x17, 0x8F, 0xA0, 0xAF, 0x2D, 0xD6, 0x03, 0xF8, 0x44,
+    },
+    {
+        0xB4, 0x8E, 0x26, 0xB4, 0x84, 0xF7, 0xA2, 0x1C, 0x0A, 0x4A, 0x46, 0xFB, 0x6A, 0xAF, 0x36, 0x3A,
+        0x66, 0xB0, 0xDE, 0x32, 0x25, 0xC4, 0x74, 0x4B, 0x96, 0x15, 0xB5, 0x11, 0x0D, 0x1D, 0x78, 0xE5,
+        0xFA, 0xC0, 0x15, 0x40, 0x4D, 0x4D, 0x3D, 0xAB, 0x64, 0x13, 0x1B, 0xCD, 0xFE, 0xD6, 0xF6, 0x68,
+        0xC0, 0x04, 0xE4, 0x04, 0x8B, 0x7B, 0x0F, 0x98, 0x06, 0xEB, 0xB0, 0xF6, 0x21, 0xA0, 0x1B, 0x2D,
+    }
+} };
+
+/* Computes p_result = p_left + p_right for affine points with distinct x. p_result may alias p_left. */
+static void EccPoint_add_affine(EccPoint *p_result, EccPoint *p_left, EccPoint *p_right)
+{
+    uint64_t tx[NUM_ECC_DIGITS];
+    uint64_t ty[NUM_ECC_DIGITS];
+    uint64_t z[NUM_ECC_DIGITS];
+
+    vli_set(tx, p_left->x);
+    vli_set(ty, p_left->y);
+    vli_set(p_result->x, p_right->x);
+    vli_set(p_result->y, p_right->y);
+    vli_modSub(z, p_result->x, tx, curve_p); /* Z = x2 - x1 */
+    XYcZ_add(tx, ty, p_result->x, p_result->y);
+    vli_modInv(z, z, curve_p); /* Z = 1/Z */
+    apply_z(p_result->x, p_result->y, z);
+}
+
+/* Reads comb entry p_index (1..ECC_FIXED_BASE_POINTS) from a table that may live in flash. */
+static void EccPoint_read_fixed(uint64_t *X1, uint64_t *Y1, const ecc_fixed_base_t *p_table, uint p_index)
+{
+    uint8_t l_bytes[ECC_BYTES*2];
+
+    atca_memcpy_P(l_bytes, p_table->point[p_index - 1], sizeof(l_bytes));
+    ecc_bytes2native(X1, l_bytes);
+    ecc_bytes2native(Y1, l_bytes + ECC_BYTES);
+}
+
+/* Adds the affine point (X2, Y2) into the Jacobian accumulator (X1, Y1, Z1).
+   *p_isSet is cleared while the accumulator is the point at infinity. */
+static void EccPoint_add_fixed(uint64_t *X1, uint64_t *Y1, uint64_t *Z1, int *p_isSet, uint64_t *X2, uint64_t *Y2)
+{
+    uint64_t tz[NUM_ECC_DIGITS];
+
+    if(!*p_isSet)
+    {
+        vli_set(X1, X2);
+        vli_set(Y1, Y2);
+        vli_clear(Z1);
+        Z1[0] = 1;
+        *p_isSet = 1;
+        return;
+    }
+
+    apply_z(X2, Y2, Z1);
+    vli_modSub(tz, X1, X2, curve_p); /* Z = x2 - x1 */
+    if(vli_isZero(tz))
+    { /* Same x: either P + P or P + (-P). */
+        if(vli_cmp(Y1, Y2) == 0)
+        {
+            EccPoint_double_jacobian(X1, Y1, Z1);
+        }
+        else
+        {
+            *p_isSet = 0;
+        }
+        return;
+    }
+    XYcZ_add(X2, Y2, X1, Y1);
+    vli_modMult_fast(Z1, Z1, tz);
+}
+
+/* Returns the comb column index for bit position p_column of p_scalar. */
+static uint vli_combIndex(uint64_t *p_scalar, uint p_column)
+{
+    uint l_index = 0;
+    uint j;
+
+    for(j = 0; j < ECC_FIXED_BASE_TEETH; ++j)
+    {
+        if(vli_testBit(p_scalar, p_column + j * ECC_FIXED_BASE_SPACING))
+        {
+            l_index |= (1u << j);
+        }
+    }
+    return l_index;
+}
+
+int ecc_fixed_base_precompute(const uint8_t p_publicKey[ECC_BYTES*2], ecc_fixed_base_t *p_table)
+{
+    EccPoint l_teeth[ECC_FIXED_BASE_TEETH];
+    EccPoint l_entry;
+    uint64_t z[NUM_ECC_DIGITS];
+    uint i, j;
+
+    if(p_publicKey == NULL || p_table == NULL)
+    {
+        return 0;
+    }
+
+    /* l_teeth[j] = 2^(j*spacing) * P */
+    ecc_bytes2native(l_teeth[0].x, p_publicKey);
+    ecc_bytes2native(l_teeth[0].y, p_publicKey + ECC_BYTES);
+    if(EccPoint_isZero(&l_teeth[0]))
+    {
+        return 0;
+    }
+    for(j = 1; j < ECC_FIXED_BASE_TEETH; ++j)
+    {
+        vli_set(l_teeth[j].x, l_teeth[j-1].x);
+        vli_set(l_teeth[j].y, l_teeth[j-1].y);
+        vli_clear(z);
+        z[0] = 1;
+        for(i = 0; i < ECC_FIXED_BASE_SPACING; ++i)
+        {
+            EccPoint_double_jacobian(l_teeth[j].x, l_teeth[j].y, z);
+        }
+        vli_modInv(z, z, curve_p); /* Z = 1/Z */
+        apply_z(l_teeth[j].x, l_teeth[j].y, z);
+    }
+
+    /* Entry i is the sum of the teeth selected by the bits of i. */
+    for(i = 1; i <= ECC_FIXED_BASE_POINTS; ++i)
+    {
+        int l_isSet = 0;
+        for(j = 0; j < ECC_FIXED_BASE_TEETH; ++j)
+        {
+            if(!(i & (1u << j)))
+            {
+                continue;
+            }
+            if(!l_isSet)
+            {
+                vli_set(l_entry.x, l_teeth[j].x);
+                vli_set(l_entry.y, l_teeth[j].y);
+                l_isSet = 1;
+            }
+            else
+            {
+                EccPoint_add_affine(&l_entry, &l_entry, &l_teeth[j]);
+            }
+        }
+        ecc_native2bytes(p_table->point[i - 1], l_entry.x);
+        ecc_native2bytes(p_table->point[i - 1] + ECC_BYTES, l_entry.y);
+    }
+
+    return 1;
+}
+
+int ecdsa_verify_fixed_sw(const ecc_fixed_base_t *p_table, const uint8_t p_hash[ECC_BYTES], const uint8_t p_signature[ECC_BYTES*2])
+{
+    uint64_t u1[NUM_ECC_DIGITS], u2[NUM_ECC_DIGITS];
+    uint64_t z[NUM_ECC_DIGITS];
+    uint64_t rx[NUM_ECC_DIGITS];
+    uint64_t ry[NUM_ECC_DIGITS];
+    uint64_t tx[NUM_ECC_DIGITS];
+    uint64_t ty[NUM_ECC_DIGITS];
+    uint64_t l_r[NUM_ECC_DIGITS], l_s[NUM_ECC_DIGITS];
+    int l_isSet = 0;
+    int i;
+
+    if(p_table == NULL)
+    {
+        return 0;
+    }
+
+    ecc_bytes2native(l_r, p_signature);
+    ecc_bytes2native(l_s, p_signature + ECC_BYTES);
+
+    if(vli_isZero(l_r) || vli_isZero(l_s))
+    { /* r, s must not be 0. */
+        return 0;
+    }
+
+    if(vli_cmp(curve_n, l_r) != 1 || vli_cmp(curve_n, l_s) != 1)
+    { /* r, s must be < n. */
+        return 0;
+    }
+
+    /* Calculate u1 and u2. */
+    vli_modInv(z, l_s, curve_n); /* Z = s^-1 */
+    ecc_bytes2native(u1, p_hash);
+    vli_modMult(u1, u1, z, curve_n); /* u1 = e/s */
+    vli_modMult(u2, l_r, z, curve_n); /* u2 = r/s */
+
+    /* Interleaved combs: u1*G + u2*Q with one shared doubling per column. */
+    for(i = ECC_FIXED_BASE_SPACING - 1; i >= 0; --i)
+    {
+        uint l_index;
+
+        if(l_isSet)
+        {
+            EccPoint_double_jacobian(rx, ry, z);
+        }
+
+        l_index = vli_combIndex(u1, i);
+        if(l_index)
+        {
+            EccPoint_read_fixed(tx, ty, &curve_G_table, l_index);
+            EccPoint_add_fixed(rx, ry, z, &l_isSet, tx, ty);
+        }
+
+        l_index = vli_combIndex(u2, i);
+        if(l_index)
+        {
+            EccPoint_read_fixed(tx, ty, p_table, l_index);
+            EccPoint_add_fixed(rx, ry, z, &l_isSet, tx, ty);
+        }
+    }
+
+    if(!l_isSet)
+    {
+        return 0;
+    }
+
+    vli_modInv(z, z, curve_p); /* Z = 1/Z */
+    apply_z(rx, ry, z);
+
+    /* v = x1 (mod n) */
+    if(vli_cmp(curve_n, rx) != 1)
+    {
+        vli_sub(rx, rx, curve_n);
+    }
+
+    /* Accept only if v == r. */
+    return (vli_cmp(rx, l_r) == 0);
+}
+
+#endif /* ECC_CURVE == secp256r1 */
+
+
+
+/** \brief software ECDSA P256 signature of a message digest
+ * \param[in]  msg          Pointer to message digest or challenge (32 bytes)
+ * \param[in]  private_key  Pointer to signer private key (32 bytes)
+ * \param[out] signature    Receives the R and S integers concatenated (64 bytes)
+ * return ATCA_STATUS
+ */
+
+int atcac_sw_ecdsa_sign_p256( const uint8_t msg[ATCA_ECC_P256_FIELD_SIZE],
+                              const uint8_t private_key[ATCA_ECC_P256_PRIVATE_KEY_SIZE],
+                              uint8_t signature[ATCA_ECC_P256_SIGNATURE_SIZE])
+{
+	if (msg == NULL || private_key == NULL || signature == NULL)
+	{
+		return ATCA_BAD_PARAM;
+	}
 
+	if (ecdsa_sign_sw(private_key, msg, signature) == 1)
+	{
+		return ATCA_SUCCESS;
+	}
+
+	return ATCA_GEN_FAIL;
+}
 
 /** \brief return software generated ECDSA verification result
  * \param[in] msg         Pointer to message or challenge
@@ -1358,4 +1836,31 @@ int atcac_sw_ecdsa_verify_p256( const uint8_t msg[ATCA_ECC_P256_FIELD_SIZE],
 	}
 	
 	return ATCACERT_E_VERIFY_FAILED;
-}
\ No newline at end of file
+}
+#if ECC_CURVE == secp256r1
+
+/** \brief return software generated ECDSA verification result for a key held as a comb table
+ * \param[in] msg               Pointer to message or challenge
+ * \param[in] signature         Pointer to the signature to verify
+ * \param[in] public_key_table  Comb table of the signer public key, see ecc_fixed_base_precompute()
+ * return ATCA_STATUS
+ */
+
+int atcac_sw_ecdsa_verify_p256_fixed( const uint8_t msg[ATCA_ECC_P256_FIELD_SIZE],
+                                      const uint8_t signature[ATCA_ECC_P256_SIGNATURE_SIZE],
+                                      const ecc_fixed_base_t* public_key_table)
+{
+	if (msg == NULL || signature == NULL || public_key_table == NULL)
+	{
+		return ATCA_BAD_PARAM;
+	}
+
+	if (ecdsa_verify_fixed_sw(public_key_table, msg, signature) == 1)
+	{
+		return ATCA_SUCCESS;
+	}
+
+	return ATCACERT_E_VERIFY_FAILED;
+}
+
+#endif
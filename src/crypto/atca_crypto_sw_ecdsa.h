@@ -44,6 +44,7 @@
 #define ATCA_CRYPTO_SW_ECDSA_H
 
 #include "atca_crypto_sw.h"
+#include "atca_compiler.h"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -61,6 +62,13 @@
 
 #define ECC_BYTES ECC_CURVE
 
+/* Nonce selection for ecdsa_sign_sw(). When non-zero, k is derived from the private key and hash
+   as specified by RFC 6979 (HMAC-SHA256 DRBG), so signing needs no entropy source or device I/O
+   and is reproducible. Set to 0 to draw k from getRandomNumber() instead. */
+#ifndef ECC_DETERMINISTIC_NONCE
+#define ECC_DETERMINISTIC_NONCE 1
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -77,6 +85,19 @@ Returns 1 if the key pair was generated successfully, 0 if an error occurred.
 */
 int ecc_make_key(uint8_t p_publicKey[ECC_BYTES+1], uint8_t p_privateKey[ECC_BYTES]);
 
+/* ecc_make_public_key_sw() function.
+Compute the uncompressed public key belonging to an existing private key.
+
+Inputs:
+    p_privateKey - The private key, must be in the range [1, n-1].
+
+Outputs:
+    p_publicKey  - Will be filled in with the public key as X||Y.
+
+Returns 1 if the public key was computed successfully, 0 if the private key is out of range.
+*/
+int ecc_make_public_key_sw(const uint8_t p_privateKey[ECC_BYTES], uint8_t p_publicKey[ECC_BYTES*2]);
+
 /* ecdh_shared_secret() function.
 Compute a shared secret given your secret key and someone else's public key.
 Note: It is recommended that you hash the result of ecdh_shared_secret before using it for symmetric encryption or HMAC.
@@ -109,6 +130,21 @@ Returns 1 if the signature generated successfully, 0 if an error occurred.
 */
 int ecdsa_sign_sw(const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_BYTES], uint8_t p_signature[ECC_BYTES*2]);
 
+/* ecdsa_sign_deterministic_sw() function.
+Generate an ECDSA signature using the RFC 6979 deterministic nonce (HMAC-SHA256). The same key and
+hash always give the same signature. Used by ecdsa_sign_sw() when ECC_DETERMINISTIC_NONCE is set.
+
+Inputs:
+    p_privateKey - Your private key.
+    p_hash       - The message hash (SHA-256) to sign.
+
+Outputs:
+    p_signature  - Will be filled in with the signature value.
+
+Returns 1 if the signature generated successfully, 0 if an error occurred.
+*/
+int ecdsa_sign_deterministic_sw(const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_BYTES], uint8_t p_signature[ECC_BYTES*2]);
+
 /* ecdsa_verify() function.
 Verify an ECDSA signature.
 
@@ -124,6 +160,49 @@ Returns 1 if the signature is valid, 0 if it is invalid.
 */                                          //33 bytes                       32 bytes                              64 bytes
 int ecdsa_verify_sw(const uint8_t p_publicKey[ECC_BYTES*2], const uint8_t p_hash[ECC_BYTES], const uint8_t p_signature[ECC_BYTES*2]);
 
+/* Fixed-base comb tables.
+A public key that never changes (a root or product signer key) can be expanded once, at build
+time, into a comb table so that verification against it needs only ECC_FIXED_BASE_SPACING point
+doublings shared between u1*G and u2*Q. Entry i-1 holds sum(2^(j*ECC_FIXED_BASE_SPACING) * P) for
+every bit j set in i, stored as big-endian X||Y like a raw public key. Tables are normally declared
+with ATCA_PROGMEM so that they stay in flash on AVR.
+*/
+#define ECC_FIXED_BASE_TEETH   4
+#define ECC_FIXED_BASE_SPACING (ECC_BYTES * 8 / ECC_FIXED_BASE_TEETH)
+#define ECC_FIXED_BASE_POINTS  ((1 << ECC_FIXED_BASE_TEETH) - 1)
+
+typedef struct
+{
+    uint8_t point[ECC_FIXED_BASE_POINTS][ECC_BYTES*2];
+} ecc_fixed_base_t;
+
+/* ecc_fixed_base_precompute() function.
+Expand a public key into a comb table. Intended for the host-side generator
+(extras/gen_fixed_base) but usable at run time for keys that are only known after boot.
+
+Inputs:
+    p_publicKey - The public key to expand (X||Y, 64 bytes).
+
+Outputs:
+    p_table     - Will be filled in with the comb table.
+
+Returns 1 if the table was generated successfully, 0 if an error occurred.
+*/
+int ecc_fixed_base_precompute(const uint8_t p_publicKey[ECC_BYTES*2], ecc_fixed_base_t *p_table);
+
+/* ecdsa_verify_fixed_sw() function.
+Verify an ECDSA signature against a public key supplied as a comb table. Same result as
+ecdsa_verify_sw() for the key the table was generated from.
+
+Inputs:
+    p_table     - Comb table of the signer's public key (may live in ATCA_PROGMEM).
+    p_hash      - The hash of the signed data.
+    p_signature - The signature value.
+
+Returns 1 if the signature is valid, 0 if it is invalid.
+*/
+int ecdsa_verify_fixed_sw(const ecc_fixed_base_t *p_table, const uint8_t p_hash[ECC_BYTES], const uint8_t p_signature[ECC_BYTES*2]);
+
 #ifdef __cplusplus
 } /* end of extern "C" */
 #endif
@@ -146,10 +225,18 @@ int ecdsa_verify_sw(const uint8_t p_publicKey[ECC_BYTES*2], const uint8_t p_hash
 extern "C" {
 #endif
 				
+int atcac_sw_ecdsa_sign_p256( const uint8_t msg[ATCA_ECC_P256_FIELD_SIZE],
+                              const uint8_t private_key[ATCA_ECC_P256_PRIVATE_KEY_SIZE],
+                              uint8_t signature[ATCA_ECC_P256_SIGNATURE_SIZE]);
+
 int atcac_sw_ecdsa_verify_p256( const uint8_t msg[ATCA_ECC_P256_FIELD_SIZE],				//32 btes
                                 const uint8_t signature[ATCA_ECC_P256_SIGNATURE_SIZE],		//64 bytes
                                 const uint8_t public_key[ATCA_ECC_P256_PUBLIC_KEY_SIZE]);	//64 bytes
 
+int atcac_sw_ecdsa_verify_p256_fixed( const uint8_t msg[ATCA_ECC_P256_FIELD_SIZE],
+                                      const uint8_t signature[ATCA_ECC_P256_SIGNATURE_SIZE],
+                                      const ecc_fixed_base_t* public_key_table);
+
 #ifdef __cplusplus
 }
 #endif
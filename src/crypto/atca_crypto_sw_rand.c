@@ -47,51 +47,196 @@
 #include "atca_crypto_sw_sha2.h"
 #include "hal/atca_hal.h"
 #include <stdlib.h>
+#include <string.h>
 
+/** \brief HMAC_DRBG (SP 800-90A 10.1.2) working state plus the output pool. */
+typedef struct {
+	uint8_t  key[ATCA_SHA2_256_DIGEST_SIZE];      //!< K
+	uint8_t  v[ATCA_SHA2_256_DIGEST_SIZE];        //!< V
+	uint32_t reseed_counter;                      //!< Generate calls since the last (re)seed
+	uint32_t reseed_interval;                     //!< Generate calls allowed between reseeds
+	uint8_t  pool[ATCAC_DRBG_POOL_SIZE];          //!< Generated bytes not yet handed out
+	size_t   pool_used;                           //!< Bytes of pool already consumed
+	bool     instantiated;                        //!< Seeded from the device at least once
+} atcac_drbg_state;
 
-uint8_t seed[32];
+static atcac_drbg_state g_drbg = {
+	.reseed_interval = ATCAC_DRBG_RESEED_INTERVAL,
+	.pool_used       = ATCAC_DRBG_POOL_SIZE,
+};
 
-static void onetimepad(uint8_t* msg, uint8_t* key, int length)
-{
-	int i;
-	for (i=0; i<length; i++)
-	*(msg + i) ^= *(key + i);
+/* K = HMAC(K, V || sep || data), V = HMAC(K, V) */
+static int drbg_update_step(uint8_t sep, const uint8_t* data, size_t data_size)
+{
+	int ret;
+	atcac_hmac_sha256_ctx ctx;
+
+	ret = atcac_sw_hmac_sha256_init(&ctx, g_drbg.key, sizeof(g_drbg.key));
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	atcac_sw_hmac_sha256_update(&ctx, g_drbg.v, sizeof(g_drbg.v));
+	atcac_sw_hmac_sha256_update(&ctx, &sep, 1);
+	if (data_size > 0)
+		atcac_sw_hmac_sha256_update(&ctx, data, data_size);
+	ret = atcac_sw_hmac_sha256_finish(&ctx, g_drbg.key);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	return atcac_sw_hmac_sha256(g_drbg.key, sizeof(g_drbg.key), g_drbg.v, sizeof(g_drbg.v), g_drbg.v);
+}
+
+/* HMAC_DRBG_Update (SP 800-90A 10.1.2.2) */
+static int drbg_update(const uint8_t* data, size_t data_size)
+{
+	int ret;
+
+	ret = drbg_update_step(0x00, data, data_size);
+	if (ret != ATCA_SUCCESS || data_size == 0)
+		return ret;
+
+	return drbg_update_step(0x01, data, data_size);
+}
+
+/* Refills the pool with one generate request (SP 800-90A 10.1.2.5) */
+static int drbg_generate_pool(void)
+{
+	int ret;
+	size_t offset;
+
+	if (!g_drbg.instantiated || g_drbg.reseed_counter > g_drbg.reseed_interval)
+	{
+		ret = atcac_sw_random_reseed(NULL, 0);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+
+	for (offset = 0; offset < sizeof(g_drbg.pool); offset += ATCA_SHA2_256_DIGEST_SIZE)
+	{
+		ret = atcac_sw_hmac_sha256(g_drbg.key, sizeof(g_drbg.key), g_drbg.v, sizeof(g_drbg.v), g_drbg.v);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+		memcpy(&g_drbg.pool[offset], g_drbg.v, ATCA_SHA2_256_DIGEST_SIZE);
+	}
+
+	ret = drbg_update(NULL, 0);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	g_drbg.reseed_counter++;
+	g_drbg.pool_used = 0;
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief sets how many pool refills may be served between reseeds from the device RNG
+ * \param[in] reseed_interval  number of generate requests, 0 selects ATCAC_DRBG_RESEED_INTERVAL
+ * return ATCA_STATUS
+ */
+int atcac_sw_random_set_reseed_interval(uint32_t reseed_interval)
+{
+	if (reseed_interval > ATCAC_DRBG_RESEED_INTERVAL_MAX)
+		return ATCA_BAD_PARAM;
+
+	g_drbg.reseed_interval = (reseed_interval == 0) ? ATCAC_DRBG_RESEED_INTERVAL : reseed_interval;
+
+	return ATCA_SUCCESS;
 }
 
+/** \brief reseeds the software DRBG from the crypto IC and HAL entropy sources, discarding any
+ *         pooled output. Instantiates the DRBG on first use.
+ * \param[in] additional       optional additional input mixed into the state, may be NULL
+ * \param[in] additional_size  size of additional input
+ * return ATCA_STATUS
+ */
+int atcac_sw_random_reseed(const uint8_t* additional, size_t additional_size)
+{
+	ATCA_STATUS ret;
+	uint8_t seed_material[RANDOM_NUM_SIZE * 2 + ATCA_SHA2_256_DIGEST_SIZE];
+	size_t seed_size = RANDOM_NUM_SIZE * 2;
+
+	if (additional == NULL && additional_size > 0)
+		return ATCA_BAD_PARAM;
+
+	//Entropy input: crypto IC random number followed by the HAL source
+	ret = atcab_random(&seed_material[0]);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = hal_random_number(&seed_material[RANDOM_NUM_SIZE]);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	if (additional_size > 0)
+	{
+		//Long additional input is compressed so the seed material stays on the stack
+		ret = atcac_sw_sha2_256(additional, additional_size, &seed_material[seed_size]);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+		seed_size += ATCA_SHA2_256_DIGEST_SIZE;
+	}
+	else if (!g_drbg.instantiated)
+	{
+		//Personalization string on instantiate
+		memcpy(&seed_material[seed_size], g_signer_1_ca_public_key, ATCA_SHA2_256_DIGEST_SIZE);
+		seed_size += ATCA_SHA2_256_DIGEST_SIZE;
+	}
+
+	if (!g_drbg.instantiated)
+	{
+		memset(g_drbg.key, 0x00, sizeof(g_drbg.key));
+		memset(g_drbg.v, 0x01, sizeof(g_drbg.v));
+	}
+
+	ret = drbg_update(seed_material, seed_size);
+	memset(seed_material, 0, sizeof(seed_material));
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	g_drbg.reseed_counter = 1;
+	g_drbg.instantiated = true;
+	memset(g_drbg.pool, 0, sizeof(g_drbg.pool));
+	g_drbg.pool_used = sizeof(g_drbg.pool);
+
+	return ATCA_SUCCESS;
+}
 
 /** \brief return software generated random number
+ *
+ * Bytes are served from a pool filled by an HMAC-SHA256 DRBG (SP 800-90A). The DRBG is seeded
+ * from the crypto IC on first use and again every reseed interval, so most calls complete
+ * without any device I/O.
+ *
  * \param[out] data       ptr to space to receive the random number
  * \param[in]  data_size  size of data buffer
  * return ATCA_STATUS
  */
 int atcac_sw_random(uint8_t* data, size_t data_size)
 {
-	ATCA_STATUS ret;
-	uint8_t nonce[32], randnum[32];
-	
-	//Request random number from IC
-	atcab_random(nonce);
-	
-	hal_random_number(&randnum[0]);
-	onetimepad(nonce,randnum, 32);
-	
-	if ((seed[0] == 0) && (seed[10] == 0))
+	int ret;
+	size_t count;
+
+	if (data == NULL && data_size > 0)
+		return ATCA_BAD_PARAM;
+
+	while (data_size > 0)
 	{
-		memcpy(seed, g_signer_1_ca_public_key, 32);				//if seed hasn't been initialized use root public key
+		if (g_drbg.pool_used >= sizeof(g_drbg.pool))
+		{
+			ret = drbg_generate_pool();
+			if (ret != ATCA_SUCCESS)
+				return ret;
+		}
+
+		count = sizeof(g_drbg.pool) - g_drbg.pool_used;
+		if (count > data_size)
+			count = data_size;
+
+		memcpy(data, &g_drbg.pool[g_drbg.pool_used], count);
+		memset(&g_drbg.pool[g_drbg.pool_used], 0, count);		//served bytes are never kept
+		g_drbg.pool_used += count;
+		data += count;
+		data_size -= count;
 	}
-	
-	onetimepad(nonce,seed,32);									//one time pad to create cipher seed with nonce
-	
-	ret = atcac_sw_sha2_256(nonce, sizeof(nonce), seed);		//create digest of seed and store in nonce variable
-	if (ret != ATCA_SUCCESS)
-	return ret;
-	
-	ret = atcac_sw_sha2_256(seed, sizeof(seed), nonce);			//create digest of seed and store in nonce variable
-	if (ret != ATCA_SUCCESS)
-	return ret;
-	
-	memcpy(data, nonce, data_size);
-	
+
 	return ATCA_SUCCESS;
 }
-
@@ -54,11 +54,25 @@
  * algorithms
  *
    @{ */
+
+/** Number of pool refills (generate requests) served between reseeds from the crypto IC. */
+#ifndef ATCAC_DRBG_RESEED_INTERVAL
+#define ATCAC_DRBG_RESEED_INTERVAL      (1024)
+#endif
+/** Upper bound on the reseed interval, SP 800-90A allows up to 2^48 for HMAC_DRBG. */
+#define ATCAC_DRBG_RESEED_INTERVAL_MAX  (0xFFFFFFFEUL)
+/** Bytes generated per refill, a multiple of the SHA-256 digest size. */
+#ifndef ATCAC_DRBG_POOL_SIZE
+#define ATCAC_DRBG_POOL_SIZE            (64)
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 	
 int atcac_sw_random(uint8_t* data, size_t data_size);
+int atcac_sw_random_reseed(const uint8_t* additional, size_t additional_size);
+int atcac_sw_random_set_reseed_interval(uint32_t reseed_interval);
 
 
 #ifdef __cplusplus
@@ -130,4 +130,16 @@ int atcac_sw_sha1(const uint8_t* data, size_t data_size, uint8_t digest[ATCA_SHA
 		return ret;
 
 	return ATCA_SUCCESS;
-}
\ No newline at end of file
+}
+
+int atcac_sw_sha1_multi(const uint8_t* const data[], size_t data_size, size_t count, uint8_t (*digests)[ATCA_SHA1_DIGEST_SIZE])
+{
+	if (count == 0)
+		return ATCA_SUCCESS;
+	if (data == NULL || digests == NULL)
+		return ATCA_BAD_PARAM;
+
+	CL_hashMulti(data, (int)data_size, (int)count, &digests[0][0]);
+
+	return ATCA_SUCCESS;
+}
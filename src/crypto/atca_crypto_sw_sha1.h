@@ -115,6 +115,17 @@ int atcac_sw_sha1_update(atcac_sha1_ctx* ctx, const uint8_t* data, size_t data_s
 int atcac_sw_sha1_finish(atcac_sha1_ctx * ctx, uint8_t digest[ATCA_SHA1_DIGEST_SIZE]);
 int atcac_sw_sha1(const uint8_t * data, size_t data_size, uint8_t digest[ATCA_SHA1_DIGEST_SIZE]);
 
+/** \brief Hash several messages of the same size, side by side where the platform allows it.
+ *
+ * \param[in]  data       Pointer to each message.
+ * \param[in]  data_size  Size of every message in bytes.
+ * \param[in]  count      Number of messages.
+ * \param[out] digests    Receives the digest of each message.
+ *
+ * \return ATCA_SUCCESS on success
+ */
+int atcac_sw_sha1_multi(const uint8_t * const data[], size_t data_size, size_t count, uint8_t (*digests)[ATCA_SHA1_DIGEST_SIZE]);
+
 #ifdef __cplusplus
 }
 #endif
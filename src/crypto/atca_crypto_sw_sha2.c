@@ -87,6 +87,7 @@
 
 #include "atca_crypto_sw_sha2.h"
 #include "hashes/sha2_routines.h"
+#include <string.h>
 
 /** \brief initializes the SHA256 software
  * \param[in] ctx  ptr to context data structure
@@ -130,6 +131,53 @@ int atcac_sw_sha2_256_finish(atcac_sha2_256_ctx* ctx, uint8_t digest[ATCA_SHA2_2
 	return ATCA_SUCCESS;
 }
 
+/** \brief exports the hash state of a context that sits on a block boundary, so hashing can
+ *         later resume from it with atcac_sw_sha2_256_resume()
+ * \param[in]  ctx        ptr to context data structure
+ * \param[out] state      receives the eight SHA256 state words
+ * \param[out] processed  receives the number of bytes hashed so far
+ * \return ATCA_STATUS, ATCA_BAD_PARAM when part of a block is still buffered
+ */
+
+int atcac_sw_sha2_256_get_midstate(const atcac_sha2_256_ctx* ctx, uint32_t state[8], size_t* processed)
+{
+	const sw_sha256_ctx* sw_ctx = (const sw_sha256_ctx*)ctx;
+
+	if (ctx == NULL || state == NULL || processed == NULL || sw_ctx->block_size != 0)
+		return ATCA_BAD_PARAM;
+
+	memcpy(state, sw_ctx->hash, sizeof(sw_ctx->hash));
+	*processed = sw_ctx->total_msg_size;
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief starts a context from a previously exported hash state instead of the SHA256 initial
+ *         values
+ * \param[out] ctx        ptr to context data structure
+ * \param[in]  state      eight SHA256 state words from atcac_sw_sha2_256_get_midstate()
+ * \param[in]  processed  number of bytes the state covers, a multiple of the block size
+ * \return ATCA_STATUS
+ */
+
+int atcac_sw_sha2_256_resume(atcac_sha2_256_ctx* ctx, const uint32_t state[8], size_t processed)
+{
+	sw_sha256_ctx* sw_ctx = (sw_sha256_ctx*)ctx;
+	int ret;
+
+	if (ctx == NULL || state == NULL || (processed % ATCA_SHA2_256_BLOCK_SIZE) != 0)
+		return ATCA_BAD_PARAM;
+
+	ret = atcac_sw_sha2_256_init(ctx);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	memcpy(sw_ctx->hash, state, sizeof(sw_ctx->hash));
+	sw_ctx->total_msg_size = (uint32_t)processed;
+
+	return ATCA_SUCCESS;
+}
+
 
 /** \brief single call convenience function to comput SHA256 of given data
  * \param[in]  data       pointer to stream of data to hash
@@ -156,4 +204,112 @@ int atcac_sw_sha2_256(const uint8_t* data, size_t data_size, uint8_t digest[ATCA
 		return ret;
 
 	return ATCA_SUCCESS;
-}
\ No newline at end of file
+}
+
+/** \brief initializes an HMAC-SHA256 (RFC 2104) computation with the given key
+ * \param[in] ctx       ptr to HMAC context data structure
+ * \param[in] key       HMAC key, keys longer than the block size are hashed first
+ * \param[in] key_size  size of the key in bytes
+ * \return ATCA_STATUS
+ */
+
+int atcac_sw_hmac_sha256_init(atcac_hmac_sha256_ctx* ctx, const uint8_t* key, size_t key_size)
+{
+	int ret;
+	uint8_t ipad_key[ATCA_SHA2_256_BLOCK_SIZE];
+	size_t i;
+
+	if (ctx == NULL || (key == NULL && key_size > 0))
+		return ATCA_BAD_PARAM;
+
+	memset(ctx->opad_key, 0, sizeof(ctx->opad_key));
+	if (key_size > ATCA_SHA2_256_BLOCK_SIZE)
+	{
+		ret = atcac_sw_sha2_256(key, key_size, ctx->opad_key);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+	else if (key_size > 0)
+	{
+		memcpy(ctx->opad_key, key, key_size);
+	}
+
+	for (i = 0; i < ATCA_SHA2_256_BLOCK_SIZE; i++)
+	{
+		ipad_key[i] = ctx->opad_key[i] ^ 0x36;
+		ctx->opad_key[i] ^= 0x5C;
+	}
+
+	ret = atcac_sw_sha2_256_init(&ctx->sha_ctx);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	return atcac_sw_sha2_256_update(&ctx->sha_ctx, ipad_key, sizeof(ipad_key));
+}
+
+/** \brief adds the next block of message data to a running HMAC-SHA256 computation
+ * \param[in] ctx        ptr to HMAC context data structure
+ * \param[in] data       ptr to next block of data
+ * \param[in] data_size  size of data in bytes
+ * \return ATCA_STATUS
+ */
+
+int atcac_sw_hmac_sha256_update(atcac_hmac_sha256_ctx* ctx, const uint8_t* data, size_t data_size)
+{
+	return atcac_sw_sha2_256_update(&ctx->sha_ctx, data, data_size);
+}
+
+/** \brief completes the HMAC-SHA256 computation and returns the MAC
+ * \param[in]  ctx     ptr to HMAC context data structure
+ * \param[out] digest  receives the 32 byte MAC
+ * \return ATCA_STATUS
+ */
+
+int atcac_sw_hmac_sha256_finish(atcac_hmac_sha256_ctx* ctx, uint8_t digest[ATCA_SHA2_256_DIGEST_SIZE])
+{
+	int ret;
+	uint8_t inner[ATCA_SHA2_256_DIGEST_SIZE];
+
+	ret = atcac_sw_sha2_256_finish(&ctx->sha_ctx, inner);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcac_sw_sha2_256_init(&ctx->sha_ctx);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcac_sw_sha2_256_update(&ctx->sha_ctx, ctx->opad_key, sizeof(ctx->opad_key));
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcac_sw_sha2_256_update(&ctx->sha_ctx, inner, sizeof(inner));
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	return atcac_sw_sha2_256_finish(&ctx->sha_ctx, digest);
+}
+
+/** \brief single call convenience function to compute HMAC-SHA256 of given data
+ * \param[in]  key        HMAC key
+ * \param[in]  key_size   size of the key in bytes
+ * \param[in]  data       pointer to stream of data to authenticate
+ * \param[in]  data_size  size of data stream
+ * \param[out] digest     result
+ * \return ATCA_STATUS
+ */
+
+int atcac_sw_hmac_sha256(const uint8_t* key, size_t key_size, const uint8_t* data, size_t data_size, uint8_t digest[ATCA_SHA2_256_DIGEST_SIZE])
+{
+	int ret;
+	atcac_hmac_sha256_ctx ctx;
+
+	ret = atcac_sw_hmac_sha256_init(&ctx, key, key_size);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	ret = atcac_sw_hmac_sha256_update(&ctx, data, data_size);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	return atcac_sw_hmac_sha256_finish(&ctx, digest);
+}
@@ -101,11 +101,17 @@
    @{ */
 
 #define ATCA_SHA2_256_DIGEST_SIZE (32)
+#define ATCA_SHA2_256_BLOCK_SIZE  (64)
 
 typedef struct {
 	uint32_t pad[48]; //!< Filler value to make sure the actual implementation has enough room to store its context. uint32_t is used to remove some alignment warnings.
 } atcac_sha2_256_ctx;
 
+typedef struct {
+	atcac_sha2_256_ctx sha_ctx;                    //!< Inner hash, then outer hash once finished
+	uint8_t opad_key[ATCA_SHA2_256_BLOCK_SIZE];    //!< Key XOR opad, kept for the outer hash
+} atcac_hmac_sha256_ctx;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -113,8 +119,15 @@ extern "C" {
 int atcac_sw_sha2_256_init(atcac_sha2_256_ctx* ctx);
 int atcac_sw_sha2_256_update(atcac_sha2_256_ctx* ctx, const uint8_t* data, size_t data_size);
 int atcac_sw_sha2_256_finish(atcac_sha2_256_ctx * ctx, uint8_t digest[ATCA_SHA2_256_DIGEST_SIZE]);
+int atcac_sw_sha2_256_get_midstate(const atcac_sha2_256_ctx* ctx, uint32_t state[8], size_t* processed);
+int atcac_sw_sha2_256_resume(atcac_sha2_256_ctx* ctx, const uint32_t state[8], size_t processed);
 int atcac_sw_sha2_256(const uint8_t * data, size_t data_size, uint8_t digest[ATCA_SHA2_256_DIGEST_SIZE]);
 
+int atcac_sw_hmac_sha256_init(atcac_hmac_sha256_ctx* ctx, const uint8_t* key, size_t key_size);
+int atcac_sw_hmac_sha256_update(atcac_hmac_sha256_ctx* ctx, const uint8_t* data, size_t data_size);
+int atcac_sw_hmac_sha256_finish(atcac_hmac_sha256_ctx* ctx, uint8_t digest[ATCA_SHA2_256_DIGEST_SIZE]);
+int atcac_sw_hmac_sha256(const uint8_t* key, size_t key_size, const uint8_t* data, size_t data_size, uint8_t digest[ATCA_SHA2_256_DIGEST_SIZE]);
+
 #ifdef __cplusplus
 }
 #endif
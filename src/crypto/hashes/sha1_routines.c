@@ -88,6 +88,262 @@
 #include "sha1_routines.h"
 #include <string.h>
 
+/*
+   SHA-1 engine.  From FIPS 180.
+
+   sha1_blocks_c() is the portable core.  Message words are loaded
+   big-endian straight from the input and the schedule lives in a
+   rolling 16-word window.  Unless SHA1_UNROLL is 0 (the default on AVR,
+   where the unrolled rounds cost too much flash) the 80 rounds are
+   unrolled, so the round function and constant of each round are fixed
+   and the five working variables rotate by renaming instead of moves.
+
+   x86 hosts built with GCC or Clang also get sha1_blocks_shani(), which
+   runs on the SHA extensions when the CPU has them.
+ */
+
+#if defined(__AVR__) && !defined(SHA1_UNROLL)
+#define SHA1_UNROLL 0
+#endif
+#ifndef SHA1_UNROLL
+#define SHA1_UNROLL 1
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(SHA1_NO_SHANI)
+#define SHA1_SHANI 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#define SHA1_LOAD(p)        (((U32)(p)[0] << 24) | ((U32)(p)[1] << 16) | ((U32)(p)[2] << 8) | (U32)(p)[3])
+#define SHA1_ROL(x, n)      (((x) << (n)) | ((x) >> (32 - (n))))
+
+#define SHA1_F0(b, c, d)    ((d) ^ ((b) & ((c) ^ (d))))
+#define SHA1_F1(b, c, d)    ((b) ^ (c) ^ (d))
+#define SHA1_F2(b, c, d)    (((b) & (c)) | ((d) & ((b) | (c))))
+#define SHA1_F3(b, c, d)    ((b) ^ (c) ^ (d))
+
+#define SHA1_K0             0x5a827999UL
+#define SHA1_K1             0x6ed9eba1UL
+#define SHA1_K2             0x8f1bbcdcUL
+#define SHA1_K3             0xca62c1d6UL
+
+/* Schedule word t >= 16, replacing word t - 16 in the window */
+#define SHA1_SCHED(w, t) \
+	((w)[(t) & 15] = SHA1_ROL((w)[((t) + 13) & 15] ^ (w)[((t) + 8) & 15] ^ (w)[((t) + 2) & 15] ^ (w)[(t) & 15], 1))
+
+static void sha1_blocks_c(U32 *h, const U8 *data, size_t blocks)
+{
+	U32 a, b, c, d, e;
+	U32 w[16];
+	U8 t;
+
+	for (; blocks > 0; blocks--, data += 64) {
+		for (t = 0; t < 16; t++)
+			w[t] = SHA1_LOAD(&data[t * 4]);
+
+		a = h[0];
+		b = h[1];
+		c = h[2];
+		d = h[3];
+		e = h[4];
+
+#if SHA1_UNROLL
+#define SHA1_W(t)           ((t) < 16 ? w[(t) & 15] : SHA1_SCHED(w, t))
+#define SHA1_R(a, b, c, d, e, f, k, t) \
+	e += SHA1_ROL(a, 5) + f(b, c, d) + (k) + SHA1_W(t); \
+	b = SHA1_ROL(b, 30);
+#define SHA1_R5(f, k, t) \
+	SHA1_R(a, b, c, d, e, f, k, (t)); \
+	SHA1_R(e, a, b, c, d, f, k, (t) + 1); \
+	SHA1_R(d, e, a, b, c, f, k, (t) + 2); \
+	SHA1_R(c, d, e, a, b, f, k, (t) + 3); \
+	SHA1_R(b, c, d, e, a, f, k, (t) + 4);
+
+		SHA1_R5(SHA1_F0, SHA1_K0, 0);  SHA1_R5(SHA1_F0, SHA1_K0, 5);
+		SHA1_R5(SHA1_F0, SHA1_K0, 10); SHA1_R5(SHA1_F0, SHA1_K0, 15);
+		SHA1_R5(SHA1_F1, SHA1_K1, 20); SHA1_R5(SHA1_F1, SHA1_K1, 25);
+		SHA1_R5(SHA1_F1, SHA1_K1, 30); SHA1_R5(SHA1_F1, SHA1_K1, 35);
+		SHA1_R5(SHA1_F2, SHA1_K2, 40); SHA1_R5(SHA1_F2, SHA1_K2, 45);
+		SHA1_R5(SHA1_F2, SHA1_K2, 50); SHA1_R5(SHA1_F2, SHA1_K2, 55);
+		SHA1_R5(SHA1_F3, SHA1_K3, 60); SHA1_R5(SHA1_F3, SHA1_K3, 65);
+		SHA1_R5(SHA1_F3, SHA1_K3, 70); SHA1_R5(SHA1_F3, SHA1_K3, 75);
+
+#undef SHA1_R5
+#undef SHA1_R
+#undef SHA1_W
+#else
+		for (t = 0; t < 80; t++) {
+			U32 temp = SHA1_ROL(a, 5) + e + (t < 16 ? w[t] : SHA1_SCHED(w, t));
+
+			if (t < 20)
+				temp += SHA1_F0(b, c, d) + SHA1_K0;
+			else if (t < 40)
+				temp += SHA1_F1(b, c, d) + SHA1_K1;
+			else if (t < 60)
+				temp += SHA1_F2(b, c, d) + SHA1_K2;
+			else
+				temp += SHA1_F3(b, c, d) + SHA1_K3;
+
+			e = d;
+			d = c;
+			c = SHA1_ROL(b, 30);
+			b = a;
+			a = temp;
+		}
+#endif
+
+		h[0] += a;
+		h[1] += b;
+		h[2] += c;
+		h[3] += d;
+		h[4] += e;
+	}
+}
+
+#ifdef SHA1_SHANI
+
+/* Four rounds from round 16 on, also advancing the message schedule */
+#define SHA1NI_4(Ea, Eb, m0, m1, m2, m3, f) \
+	Ea = _mm_sha1nexte_epu32(Ea, m0); \
+	Eb = abcd; \
+	m1 = _mm_sha1msg2_epu32(m1, m0); \
+	abcd = _mm_sha1rnds4_epu32(abcd, Ea, f); \
+	m3 = _mm_sha1msg1_epu32(m3, m0); \
+	m2 = _mm_xor_si128(m2, m0);
+
+__attribute__((target("sha,sse4.1")))
+static void sha1_blocks_shani(U32 *h, const U8 *data, size_t blocks)
+{
+	const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+	__m128i abcd, abcd_save, e0, e0_save, e1;
+	__m128i msg0, msg1, msg2, msg3;
+
+	abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0x1B);
+	e0 = _mm_set_epi32((int)h[4], 0, 0, 0);
+
+	for (; blocks > 0; blocks--, data += 64) {
+		abcd_save = abcd;
+		e0_save = e0;
+
+		/* Rounds 0-15 load the message */
+		msg0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), mask);
+		e0 = _mm_add_epi32(e0, msg0);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+		msg1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), mask);
+		e1 = _mm_sha1nexte_epu32(e1, msg1);
+		e0 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+		msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+		msg2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), mask);
+		e0 = _mm_sha1nexte_epu32(e0, msg2);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+		msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+		msg0 = _mm_xor_si128(msg0, msg2);
+
+		msg3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), mask);
+		e1 = _mm_sha1nexte_epu32(e1, msg3);
+		e0 = abcd;
+		msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+		abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+		msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+		msg1 = _mm_xor_si128(msg1, msg3);
+
+		/* Rounds 16-67 */
+		SHA1NI_4(e0, e1, msg0, msg1, msg2, msg3, 0);
+		SHA1NI_4(e1, e0, msg1, msg2, msg3, msg0, 1);
+		SHA1NI_4(e0, e1, msg2, msg3, msg0, msg1, 1);
+		SHA1NI_4(e1, e0, msg3, msg0, msg1, msg2, 1);
+		SHA1NI_4(e0, e1, msg0, msg1, msg2, msg3, 1);
+		SHA1NI_4(e1, e0, msg1, msg2, msg3, msg0, 1);
+		SHA1NI_4(e0, e1, msg2, msg3, msg0, msg1, 2);
+		SHA1NI_4(e1, e0, msg3, msg0, msg1, msg2, 2);
+		SHA1NI_4(e0, e1, msg0, msg1, msg2, msg3, 2);
+		SHA1NI_4(e1, e0, msg1, msg2, msg3, msg0, 2);
+		SHA1NI_4(e0, e1, msg2, msg3, msg0, msg1, 2);
+		SHA1NI_4(e1, e0, msg3, msg0, msg1, msg2, 3);
+		SHA1NI_4(e0, e1, msg0, msg1, msg2, msg3, 3);
+
+		/* Rounds 68-79 only use what is left of the schedule */
+		e1 = _mm_sha1nexte_epu32(e1, msg1);
+		e0 = abcd;
+		msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+		abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+		msg3 = _mm_xor_si128(msg3, msg1);
+
+		e0 = _mm_sha1nexte_epu32(e0, msg2);
+		e1 = abcd;
+		msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+
+		e1 = _mm_sha1nexte_epu32(e1, msg3);
+		e0 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+		e0 = _mm_sha1nexte_epu32(e0, e0_save);
+		abcd = _mm_add_epi32(abcd, abcd_save);
+	}
+
+	_mm_storeu_si128((__m128i*)h, _mm_shuffle_epi32(abcd, 0x1B));
+	h[4] = (U32)_mm_extract_epi32(e0, 3);
+}
+
+#undef SHA1NI_4
+
+/* 1 when the CPU has the SHA extensions (and SSE4.1), 0 when not, -1 before checking */
+static volatile signed char sha1_has_shani = -1;
+
+static int sha1_check_shani(void)
+{
+	unsigned int eax, ebx, ecx, edx;
+	int has = 0;
+
+	if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSE4_1)
+	    && __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & (1u << 29)))
+		has = 1;
+	sha1_has_shani = (signed char)has;
+
+	return has;
+}
+
+#endif
+
+/* Hash whole 64-byte blocks into the chaining variables h[0,...,4] */
+static void sha1_blocks(U32 *h, const U8 *data, size_t blocks)
+{
+#ifdef SHA1_SHANI
+	int has = sha1_has_shani;
+
+	if (has < 0)
+		has = sha1_check_shani();
+	if (has) {
+		sha1_blocks_shani(h, data, blocks);
+		return;
+	}
+#endif
+	sha1_blocks_c(h, data, blocks);
+}
+
+void shaEngine(U32 *buf, U32 *h)
+{
+
+	/*
+	   On entry, buf[64] contains the 64 bytes to digest.
+
+	   h[5] contains the 5 chaining variables.  They must have the
+	   proper value on entry and are updated on exit.
+
+	   The order of bytes in buf[] and h[] matches that used by the
+	   hardware SHA engine.
+	 */
+
+	sha1_blocks(h, (const U8*)buf, 1);
+}
+
 void CL_hashInit(CL_HashContext *ctx)
 {
 	static const U32 hashContext_h_init[] = {
@@ -113,17 +369,6 @@ void CL_hashUpdate(CL_HashContext *ctx, const U8 *src, int nbytes)
 	U8 i, freeBytes;
 	U32 temp32;
 
-	typedef struct {
-		U8 buf[64];
-	} Buf64;
-
-	// We are counting on the fact that Buf64 is 64 bytes long.  In
-	// principle the compiler may make Buf64 bigger 64 bytes, but this
-	// seems unlikely.  Add an assertion check to be sure.  Beware that
-	// assert may not be active in release versions.
-	//
-	//assert(sizeof(Buf64) == 64);
-
 	// Get number of free bytes in the buf
 	freeBytes = (U8)(ctx->byteCount);
 	freeBytes &= 63;
@@ -135,22 +380,20 @@ void CL_hashUpdate(CL_HashContext *ctx, const U8 *src, int nbytes)
 		i = freeBytes;
 		if (nbytes < i) i = (U8)nbytes;
 
-		// Copy src bytes to buf
-		if (i == 64)
-			// This seems to be much faster on IAR than memcpy().
-			*(Buf64*)(ctx->buf) = *(Buf64*)src;
-		else
-			// Have to use memcpy, size is other than 64 bytes.
+		if (i == 64) {
+			// Whole block, hash it straight from src
+			sha1_blocks(ctx->h, src, 1);
+		}else {
 			memcpy(((U8*)ctx->buf) + 64 - freeBytes, src, i);
 
+			// Do SHA crunch if buf is full
+			if (freeBytes == i)
+				shaEngine(ctx->buf, ctx->h);
+		}
+
 		// Adjust for transferred bytes
 		src += i;
 		nbytes -= i;
-		freeBytes -= i;
-
-		// Do SHA crunch if buf is full
-		if (freeBytes == 0)
-			shaEngine(ctx->buf, ctx->h);
 
 		// Update 64-bit byte count
 		temp32 = (ctx->byteCount += i);
@@ -230,96 +473,144 @@ void CL_hash(U8 *msg, int msgBytes, U8 *dest)
 	CL_hashFinal(&ctx, dest);
 }
 
-void shaEngine(U32 *buf, U32 *h)
-{
-
-	/*
-	   SHA-1 Engine.  From FIPS 180.
 
-	   On entry, buf[64] contains the 64 bytes to digest.  These bytes
-	   are destroyed.
-
-	   _H[20] contains the 5 chaining variables.  They must have the
-	   proper value on entry and are updated on exit.
+/*
+   Multi-buffer SHA-1.  CL_hashMulti() hashes SHA1_LANES messages of
+   the same length side by side, one lane per message, so that the
+   compiler can run the lanes in SIMD registers.  CPUs with the SHA
+   extensions hash the messages one after the other instead, which is
+   faster still.
+ */
 
-	   The order of bytes in buf[] and _h[] matches that used by the
-	   hardware SHA engine.
-	 */
+#ifndef SHA1_LANES
+#if defined(__AVR__)
+#define SHA1_LANES 1
+#else
+#define SHA1_LANES 8
+#endif
+#endif
+
+#if SHA1_LANES > 1
+
+#define SHA1_LANE_ROUNDS(t0, t1, f, k) \
+	for (t = (t0); t < (t1); t++) { \
+		if (t >= 16) \
+			for (l = 0; l < SHA1_LANES; l++) \
+				w[t & 15][l] = SHA1_ROL(w[(t + 13) & 15][l] ^ w[(t + 8) & 15][l] ^ w[(t + 2) & 15][l] ^ w[t & 15][l], 1); \
+		for (l = 0; l < SHA1_LANES; l++) { \
+			U32 temp = SHA1_ROL(a[l], 5) + f(b[l], c[l], d[l]) + e[l] + (k) + w[t & 15][l]; \
+			e[l] = d[l]; \
+			d[l] = c[l]; \
+			c[l] = SHA1_ROL(b[l], 30); \
+			b[l] = a[l]; \
+			a[l] = temp; \
+		} \
+	}
 
+/* Hash one 64-byte block of each lane, h[i][lane] holds the chaining variables */
+static void sha1_blocks_lanes(U32 h[5][SHA1_LANES], const U8 *const data[SHA1_LANES])
+{
+	U32 w[16][SHA1_LANES];
+	U32 a[SHA1_LANES], b[SHA1_LANES], c[SHA1_LANES], d[SHA1_LANES], e[SHA1_LANES];
 	U8 t;
-	U32 a, b, c, d, e;
-	U32 temp = 0;
-	U8 *p;
-	U32 *w = (U32*)buf;
-
-	/*
-	   Pack first 64 bytes of buf into w[0,...,15].  Within a word,
-	   bytes are big-endian.  Do this in place -- buf[0,...,63]
-	   overlays w[0,...,15].
-	 */
-	p = (U8*)w;
-	for (t = 0; t < 16; t++) {
-		temp = (temp << 8) | *p++;
-		temp = (temp << 8) | *p++;
-		temp = (temp << 8) | *p++;
-		temp = (temp << 8) | *p++;
-		w[t] = temp;
+	int l;
+
+	for (t = 0; t < 16; t++)
+		for (l = 0; l < SHA1_LANES; l++)
+			w[t][l] = SHA1_LOAD(&data[l][t * 4]);
+
+	memcpy(a, h[0], sizeof(a));
+	memcpy(b, h[1], sizeof(b));
+	memcpy(c, h[2], sizeof(c));
+	memcpy(d, h[3], sizeof(d));
+	memcpy(e, h[4], sizeof(e));
+
+	SHA1_LANE_ROUNDS(0, 20, SHA1_F0, SHA1_K0);
+	SHA1_LANE_ROUNDS(20, 40, SHA1_F1, SHA1_K1);
+	SHA1_LANE_ROUNDS(40, 60, SHA1_F2, SHA1_K2);
+	SHA1_LANE_ROUNDS(60, 80, SHA1_F3, SHA1_K3);
+
+	for (l = 0; l < SHA1_LANES; l++) {
+		h[0][l] += a[l];
+		h[1][l] += b[l];
+		h[2][l] += c[l];
+		h[3][l] += d[l];
+		h[4][l] += e[l];
 	}
+}
 
-	/*
-	   Pack the 20 bytes of _h[] into h[0,...,4].  Do in place using
-	   same convention as for buidling w[].
-	 */
+#undef SHA1_LANE_ROUNDS
 
-	/* Copy the chaining variables to a, b, c, d, e */
-	a = h[0];
-	b = h[1];
-	c = h[2];
-	d = h[3];
-	e = h[4];
-
-	/* Now do the 80 rounds */
-	for (t = 0; t < 80; t++) {
-
-		temp = a;
-		leftRotate(temp, 5);
-		temp += e;
-		temp += w[t & 0xf];
-
-		if (t < 20) {
-			temp += (b & c) | (~b & d);
-			temp += 0x5a827999L;
-		}else if (t < 40) {
-			temp += b ^ c ^ d;
-			temp += 0x6ed9eba1L;
-		}else if (t < 60) {
-			temp += (b & c) | (b & d) | (c & d);
-			temp += 0x8f1bbcdcL;
-		}else {
-			temp += b ^ c ^ d;
-			temp += 0xca62c1d6L;
-		}
+#endif
 
-		e = d;
-		d = c;
-		c = b; leftRotate(c, 30);
-		b = a;
-		a = temp;
+void CL_hashMulti(const U8 *const msgs[], int msgBytes, int count, U8 *dest)
+{
+	int first = 0;
+#if SHA1_LANES > 1
+	static const U32 hashContext_h_init[] = {
+		0x67452301,
+		0xefcdab89,
+		0x98badcfe,
+		0x10325476,
+		0xc3d2e1f0
+	};
+	U32 h[5][SHA1_LANES];
+	U8 tail[SHA1_LANES][128];
+	const U8 *blocks[SHA1_LANES];
+	int full = msgBytes / 64;
+	int rem = msgBytes % 64;
+	int tail_blocks = (rem > 64 - 9) ? 2 : 1;
+	U32 bits_hi = (U32)msgBytes >> 29;
+	U32 bits_lo = (U32)msgBytes << 3;
+	int use_lanes = 1;
+	int blk, i, l;
+	U8 *end;
+
+#ifdef SHA1_SHANI
+	if (sha1_has_shani > 0 || (sha1_has_shani < 0 && sha1_check_shani()))
+		use_lanes = 0;      // One message at a time below
+#endif
+
+	for (; use_lanes && first + SHA1_LANES <= count; first += SHA1_LANES) {
+		for (i = 0; i < 5; i++)
+			for (l = 0; l < SHA1_LANES; l++)
+				h[i][l] = hashContext_h_init[i];
+
+		for (blk = 0; blk < full; blk++) {
+			for (l = 0; l < SHA1_LANES; l++)
+				blocks[l] = &msgs[first + l][blk * 64];
+			sha1_blocks_lanes(h, blocks);
+		}
 
-		temp = w[t & 0xf] ^ w[(t - 3) & 0xf] ^ w[(t - 8) & 0xf] ^ w[(t - 14) & 0xf];
-		leftRotate(temp, 1);
-		w[t & 0xf] = temp;
+		// Pad each lane's last bytes with the 0x80 marker and the big-endian bit count
+		for (l = 0; l < SHA1_LANES; l++) {
+			memcpy(tail[l], &msgs[first + l][full * 64], rem);
+			tail[l][rem] = 0x80;
+			memset(&tail[l][rem + 1], 0, tail_blocks * 64 - rem - 1);
+			end = &tail[l][tail_blocks * 64 - 8];
+			for (i = 0; i < 4; i++) {
+				end[i] = (U8)(bits_hi >> (24 - 8 * i));
+				end[i + 4] = (U8)(bits_lo >> (24 - 8 * i));
+			}
+		}
+		for (blk = 0; blk < tail_blocks; blk++) {
+			for (l = 0; l < SHA1_LANES; l++)
+				blocks[l] = &tail[l][blk * 64];
+			sha1_blocks_lanes(h, blocks);
+		}
 
+		for (l = 0; l < SHA1_LANES; l++) {
+			for (i = 0; i < 5; i++) {
+				dest[(first + l) * 20 + i * 4 + 0] = (U8)(h[i][l] >> 24);
+				dest[(first + l) * 20 + i * 4 + 1] = (U8)(h[i][l] >> 16);
+				dest[(first + l) * 20 + i * 4 + 2] = (U8)(h[i][l] >> 8);
+				dest[(first + l) * 20 + i * 4 + 3] = (U8)(h[i][l] >> 0);
+			}
+		}
 	}
+#endif
 
-	/* Update the chaining variables */
-	h[0] += a;
-	h[1] += b;
-	h[2] += c;
-	h[3] += d;
-	h[4] += e;
-
-	/* Unpack the chaining variables into _h[] buffer. */
-
-
+	// Messages left over from the lanes
+	for (; first < count; first++)
+		CL_hash((U8*)msgs[first], msgBytes, &dest[first * 20]);
 }
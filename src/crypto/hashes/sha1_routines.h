@@ -140,6 +140,7 @@ void CL_hashInit(CL_HashContext *ctx);
 void CL_hashUpdate(CL_HashContext *ctx, const U8 *src, int nbytes);
 void CL_hashFinal(CL_HashContext *ctx, U8 *dest);
 void CL_hash(U8 *msg, int msgBytes, U8 *dest);
+void CL_hashMulti(const U8 *const msgs[], int msgBytes, int count, U8 *dest);
 
 #endif // __SHA1_ROUTINES_DOT_H__
 
@@ -0,0 +1,232 @@
+/**
+ * \file
+ * \brief Fixed-base comb tables for the compile-time public keys.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ *
+ * Generated by extras/gen_fixed_base from tag_signer_pubkey and g_signer_1_ca_public_key.
+ * Do not edit, rerun the generator whenever those keys change.
+ */
+#include "custom_fixed_base.h"
+
+const ecc_fixed_base_t g_tag_signer_pubkey_table ATCA_PROGMEM = { {
+    {
+        0xFC, 0xC3, 0x82, 0xE7, 0x0B, 0x23, 0x0E, 0xC2, 0xAE, 0xF3, 0xD0, 0x44, 0x56, 0xC6, 0xAB, 0xF6,
+        0x81, 0xB1, 0xFD, 0x84, 0xB3, 0xC4, 0x21, 0xB6, 0x0E, 0x93, 0x9E, 0x06, 0x27, 0xB9, 0x17, 0x74,
+        0x0D, 0x5C, 0x93, 0xF4, 0x4F, 0x80, 0x26, 0x46, 0x1E, 0x90, 0xB2, 0xB1, 0x0C, 0xA0, 0x09, 0x97,
+        0xBB, 0x92, 0x6A, 0xE8, 0x1B, 0x7B, 0x0D, 0x47, 0x7A, 0xEC, 0x3E, 0x3E, 0xD5, 0xEF, 0x7C, 0x7F,
+    },
+    {
+        0xE2, 0xA5, 0x37, 0x37, 0x11, 0xC8, 0x2B, 0xCE, 0x89, 0xEA, 0x15, 0x36, 0x4A, 0x5F, 0x9E, 0x91,
+        0x72, 0x08, 0x65, 0xA0, 0x8E, 0x3F, 0x13, 0x4A, 0xFD, 0x0F, 0xC0, 0xB3, 0x91, 0x9C, 0x2C, 0xC8,
+        0xF7, 0xB7, 0x1A, 0x1F, 0xD4, 0xB6, 0xD1, 0x12, 0xCA, 0x39, 0x37, 0xF7, 0x94, 0x33, 0xD7, 0x3D,
+        0x1D, 0x34, 0x12, 0x9B, 0xAA, 0xD1, 0xFB, 0xBF, 0xD4, 0xBA, 0x89, 0x36, 0xAC, 0x1A, 0xFA, 0xFA,
+    },
+    {
+        0x5E, 0x42, 0x9E, 0xA4, 0xF6, 0xBE, 0xC1, 0xED, 0x19, 0x8C, 0xAF, 0x5E, 0x15, 0x0D, 0x93, 0x8A,
+        0xAD, 0xF5, 0xCB, 0xB7, 0x74, 0x5A, 0xA5, 0x59, 0x4C, 0x25, 0x31, 0x7D, 0xBE, 0x3A, 0xA4, 0x50,
+        0x41, 0xF5, 0xDB, 0xFB, 0xEC, 0xAD, 0x67, 0x2B, 0xD6, 0xEA, 0xA9, 0x51, 0xF1, 0x4A, 0xAF, 0xA8,
+        0x8F, 0x39, 0x66, 0xA3, 0x5E, 0xB5, 0x36, 0x71, 0xF2, 0xC0, 0x53, 0xAE, 0xE3, 0x91, 0x4D, 0xCB,
+    },
+    {
+        0x3A, 0xBC, 0x42, 0x57, 0x95, 0x42, 0x16, 0x2D, 0x2A, 0x6F, 0xC5, 0x53, 0x02, 0x3E, 0x3D, 0x50,
+        0x30, 0x26, 0x84, 0x94, 0xB5, 0x60, 0x29, 0xB2, 0x49, 0x04, 0x93, 0x03, 0xF2, 0xC0, 0x22, 0x22,
+        0x90, 0xCD, 0xD2, 0xB5, 0x82, 0x30, 0x7D, 0xEA, 0x02, 0x31, 0x93, 0x04, 0xD5, 0x04, 0xE8, 0x53,
+        0x14, 0xC4, 0xAF, 0x67, 0xC2, 0x90, 0x2F, 0x44, 0xC3, 0x34, 0xE0, 0x9D, 0x46, 0x12, 0xD4, 0x76,
+    },
+    {
+        0xED, 0x8B, 0x75, 0x42, 0xB6, 0x18, 0x56, 0xF7, 0xE6, 0x0A, 0x64, 0xB6, 0x85, 0x6F, 0x08, 0xD9,
+        0x22, 0x9C, 0xC5, 0x9E, 0xFC, 0xC2, 0x95, 0xF5, 0x14, 0xC9, 0xEC, 0x4A, 0xDF, 0x72, 0x32, 0x14,
+        0x5E, 0x09, 0xC1, 0x5C, 0x4B, 0x4C, 0x29, 0x90, 0x0E, 0x32, 0x5A, 0x23, 0x2A, 0x3F, 0x34, 0xD1,
+        0xCA, 0x84, 0x30, 0x66, 0x65, 0x96, 0xF9, 0x7B, 0xE3, 0xCF, 0xDA, 0x4B, 0xC0, 0x51, 0x31, 0x1F,
+    },
+    {
+        0xA6, 0x8D, 0x5A, 0x99, 0x5B, 0xEA, 0xB9, 0x9D, 0xE0, 0x29, 0x49, 0xD7, 0xE1, 0x1F, 0x2E, 0xA5,
+        0x6B, 0xBF, 0x5A, 0xB0, 0x91, 0xCB, 0x91, 0x10, 0x35, 0xCF, 0x69, 0x6B, 0xB2, 0x5F, 0x6E, 0xFD,
+        0x36, 0x1D, 0x51, 0x96, 0xE1, 0x5B, 0xE4, 0xBC, 0xC4, 0x73, 0xA0, 0x9C, 0xDC, 0xA6, 0xF2, 0xAE,
+        0xEB, 0xA6, 0xBA, 0x5F, 0x8A, 0xF1, 0x39, 0x52, 0xC4, 0x0D, 0x37, 0xB6, 0x4C, 0xBE, 0x44, 0xF7,
+    },
+    {
+        0x91, 0xB3, 0x0E, 0x37, 0x2D, 0xAC, 0x0A, 0xBC, 0x79, 0x30, 0x0C, 0x7E, 0x96, 0x1F, 0x99, 0x62,
+        0x3A, 0xAA, 0x11, 0x1E, 0x7E, 0xA8, 0x3F, 0xB8, 0x4C, 0x4C, 0x07, 0xB6, 0x9C, 0x46, 0xDB, 0xDA,
+        0x9B, 0x07, 0x8A, 0x05, 0xAF, 0xA2, 0xCD, 0xF5, 0x82, 0x32, 0xC2, 0xC1, 0xC0, 0x74, 0x7F, 0x7D,
+        0xF3, 0x68, 0xC6, 0x6C, 0xE2, 0xA6, 0xAB, 0xE0, 0x82, 0x87, 0x62, 0x9A, 0xFA, 0x10, 0xDE, 0x72,
+    },
+    {
+        0xAF, 0x4B, 0xC8, 0xB0, 0x23, 0x33, 0x16, 0xE4, 0x90, 0x31, 0xD8, 0x2C, 0xEB, 0x95, 0x6B, 0x4F,
+        0x93, 0x7F, 0x9E, 0x3C, 0x00, 0xDF, 0x42, 0x3B, 0x58, 0xE4, 0x3C, 0x37, 0x9D, 0xAA, 0x8D, 0x1B,
+        0x1C, 0xDD, 0x81, 0x8B, 0xD5, 0xFD, 0x81, 0xCE, 0x44, 0x22, 0x11, 0x8A, 0xEC, 0xED, 0x1F, 0x45,
+        0x31, 0xA1, 0x0C, 0xA2, 0x6B, 0x28, 0x75, 0x34, 0x67, 0xE1, 0xD9, 0x7F, 0x73, 0xDF, 0x0D, 0x1C,
+    },
+    {
+        0xF4, 0x70, 0x9D, 0x74, 0x02, 0x4F, 0x5C, 0xBF, 0x91, 0x89, 0x02, 0x0C, 0x29, 0xF2, 0xF2, 0xC2,
+        0x80, 0xBD, 0xDD, 0x29, 0x69, 0x6C, 0xB3, 0x1D, 0x01, 0xAF, 0x32, 0x8A, 0x22, 0x0C, 0xA3, 0xA3,
+        0xA4, 0x3F, 0xB7, 0x78, 0x39, 0x13, 0xDC, 0x9D, 0xAB, 0x06, 0xCB, 0xE3, 0x31, 0xB1, 0x6E, 0xF0,
+        0x92, 0xFC, 0xDE, 0x42, 0xE5, 0x04, 0x59, 0x61, 0x3C, 0x2A, 0xBB, 0x4E, 0x87, 0xD0, 0xDB, 0x45,
+    },
+    {
+        0x64, 0x1C, 0xD6, 0x99, 0x1A, 0xFE, 0x57, 0xB7, 0xD7, 0xBC, 0x65, 0x73, 0xEF, 0xD3, 0x8B, 0x18,
+        0xFB, 0x42, 0xCE, 0x37, 0x5C, 0xFE, 0xF7, 0x49, 0xEF, 0x81, 0xF3, 0x9C, 0x8A, 0xB8, 0x4F, 0x2E,
+        0x3B, 0xC8, 0x65, 0x88, 0xFC, 0xB0, 0x0D, 0x10, 0x3D, 0x98, 0xF8, 0x4A, 0xBD, 0xBC, 0xA2, 0x2D,
+        0x11, 0xCC, 0xF6, 0x79, 0x36, 0x4C, 0x13, 0x3C, 0x25, 0x76, 0xFE, 0x4A, 0x82, 0x29, 0xAF, 0x48,
+    },
+    {
+        0x92, 0xC7, 0x25, 0x8B, 0x34, 0xFE, 0xBF, 0x0F, 0x60, 0xBB, 0x7F, 0x43, 0x9C, 0x33, 0x42, 0x7B,
+        0xEE, 0xF5, 0x69, 0xA0, 0x0E, 0x25, 0x43, 0xEE, 0xDE, 0x35, 0x75, 0xD8, 0xDC, 0xF9, 0x05, 0x21,
+        0xA5, 0xC3, 0x86, 0xAE, 0x87, 0x48, 0x24, 0x5A, 0x1D, 0x2D, 0x51, 0x56, 0x91, 0x64, 0x88, 0x23,
+        0x72, 0xB2, 0x53, 0x16, 0xE0, 0x1B, 0x77, 0xB7, 0x41, 0xD2, 0x96, 0x09, 0x14, 0x5F, 0x4A, 0x29,
+    },
+    {
+        0xC4, 0x94, 0xDF, 0x33, 0xFB, 0x2E, 0x53, 0x52, 0xD7, 0xF1, 0x9A, 0xB9, 0x2F, 0xE6, 0xC7, 0xB8,
+        0x7A, 0x04, 0xFC, 0x7A, 0x1F, 0x56, 0x1D, 0xF2, 0xA3, 0xCE, 0x58, 0xF8, 0x1C, 0x4B, 0xBD, 0xF9,
+        0x39, 0x82, 0x23, 0x79, 0xBB, 0x58, 0x43, 0x7C, 0xB3, 0x09, 0x9D, 0xC0, 0x04, 0xDD, 0x15, 0x52,
+        0xD1, 0x14, 0x21, 0x89, 0x03, 0x19, 0x75, 0x9D, 0xB5, 0xAA, 0x3C, 0xC6, 0xB9, 0x21, 0x18, 0x9E,
+    },
+    {
+        0x79, 0xF3, 0xC0, 0x96, 0x19, 0x23, 0xD8, 0xB0, 0xCD, 0xEC, 0x0A, 0x4B, 0x86, 0x80, 0xB5, 0xE7,
+        0xBC, 0x3E, 0xA1, 0x74, 0xBE, 0x71, 0xA5, 0x1E, 0x07, 0x61, 0x98, 0x6A, 0x91, 0x90, 0xE9, 0xC2,
+        0x40, 0xB2, 0xB8, 0x84, 0x30, 0x2D, 0x2A, 0x87, 0x56, 0x1C, 0xC4, 0xE9, 0xFA, 0x4C, 0x72, 0xDF,
+        0x3C, 0xD1, 0x2F, 0xCF, 0xC3, 0x95, 0x0D, 0x25, 0x3B, 0x74, 0x8A, 0xE4, 0xD2, 0xAB, 0xD6, 0xF1,
+    },
+    {
+        0x3E, 0x1C, 0x06, 0x6E, 0xF7, 0x84, 0x21, 0xEF, 0x9B, 0x63, 0xBF, 0x10, 0xF9, 0xED, 0x59, 0xE4,
+        0xB4, 0x6C, 0x20, 0xF0, 0xC9, 0xDB, 0x1F, 0xD1, 0xF4, 0x76, 0xA4, 0x51, 0x23, 0x2D, 0x91, 0xED,
+        0x53, 0xCC, 0x57, 0xA0, 0xA2, 0x46, 0x7A, 0x1B, 0xF3, 0xED, 0x0A, 0x6E, 0x0A, 0x1C, 0x26, 0x01,
+        0x39, 0x38, 0x94, 0x36, 0x78, 0xB0, 0xED, 0x2E, 0x49, 0xC4, 0xB5, 0x51, 0xFE, 0xC2, 0x49, 0x48,
+    },
+    {
+        0x0A, 0xEE, 0x0E, 0x9D, 0xF3, 0xB2, 0x49, 0x41, 0x71, 0x3A, 0x1E, 0x05, 0xB6, 0xF3, 0x0D, 0xF2,
+        0x29, 0x00, 0x2D, 0x88, 0x80, 0x8F, 0xF2, 0x25, 0x17, 0x12, 0xB4, 0x85, 0x1B, 0x52, 0x54, 0xCB,
+        0xA4, 0x1F, 0x9E, 0x4B, 0xEC, 0xEE, 0xA0, 0xF9, 0x5B, 0xE4, 0xA9, 0xF9, 0x97, 0x96, 0x6A, 0x2A,
+        0x66, 0x8A, 0x97, 0x26, 0x2D, 0x1C, 0xF8, 0x96, 0x6A, 0x9F, 0x73, 0x19, 0x3B, 0xE8, 0x74, 0xBA,
+    },
+} };
+
+const ecc_fixed_base_t g_signer_1_ca_public_key_table ATCA_PROGMEM = { {
+    {
+        0x3D, 0x1A, 0x85, 0x25, 0xB7, 0xB5, 0xC3, 0x2C, 0xF3, 0x6E, 0x3B, 0x13, 0x20, 0x4A, 0xC4, 0xEF,
+        0x1F, 0x9E, 0xBE, 0xFB, 0xC5, 0x9B, 0x98, 0x59, 0x38, 0x23, 0xC6, 0x4A, 0xE1, 0x04, 0x8A, 0x66,
+        0x1C, 0x6D, 0xEA, 0x06, 0x3F, 0xBD, 0xD8, 0xEF, 0x5D, 0xD2, 0xC6, 0x25, 0xB6, 0xB1, 0x5A, 0xAB,
+        0x91, 0x2F, 0x33, 0x23, 0xCD, 0x65, 0x06, 0x16, 0x87, 0x06, 0xB7, 0xEA, 0xC1, 0xFF, 0xA0, 0x6B,
+    },
+    {
+        0x7A, 0x2A, 0x88, 0x5D, 0xC2, 0xC6, 0xEC, 0xC6, 0x81, 0x37, 0xE0, 0xC3, 0xA7, 0xE5, 0x5E, 0x4C,
+        0xAA, 0x56, 0xCF, 0xC6, 0x96, 0x0B, 0xFF, 0xF9, 0xD6, 0xCC, 0xE7, 0x12, 0x64, 0xB8, 0x9C, 0xB8,
+        0xE3, 0xA7, 0xBC, 0x01, 0xFA, 0x8F, 0xE3, 0xE8, 0xE5, 0x95, 0xC9, 0x3B, 0x0B, 0x9D, 0x01, 0xFB,
+        0x26, 0x98, 0x54, 0x30, 0x71, 0x5A, 0x4F, 0xE4, 0xC8, 0xBA, 0xA0, 0xA6, 0x5B, 0x77, 0x1F, 0x50,
+    },
+    {
+        0xDE, 0x26, 0x8D, 0x7D, 0x67, 0xED, 0x34, 0xBE, 0xBD, 0xFE, 0x47, 0x0F, 0xE6, 0x14, 0x7D, 0xAE,
+        0x2C, 0x08, 0x23, 0x66, 0x1A, 0x16, 0x87, 0xC8, 0xCF, 0x7A, 0x5E, 0x32, 0x4D, 0xD4, 0x96, 0x09,
+        0x52, 0x60, 0x28, 0x79, 0x08, 0x3C, 0x58, 0x9D, 0xBE, 0xEE, 0x43, 0x11, 0xED, 0xA9, 0x1C, 0x9A,
+        0x39, 0x85, 0x46, 0x44, 0xDD, 0x30, 0xDA, 0x43, 0xFB, 0xAB, 0x80, 0x0B, 0x38, 0x64, 0xDF, 0x0C,
+    },
+    {
+        0xF1, 0x8A, 0x58, 0x09, 0x30, 0xF1, 0x30, 0xFA, 0xD4, 0xFE, 0x7C, 0xA1, 0xC0, 0xA6, 0x66, 0xD8,
+        0x33, 0x0A, 0xD0, 0x3D, 0x0C, 0xE4, 0x92, 0x52, 0x17, 0xE9, 0xA2, 0xB6, 0x42, 0xD0, 0xCA, 0xE0,
+        0x6D, 0xBA, 0x9C, 0x32, 0x6F, 0xCA, 0x4E, 0x20, 0x4B, 0xC7, 0x6A, 0x70, 0xA2, 0x2E, 0xA1, 0x0E,
+        0x74, 0x27, 0xBC, 0xA6, 0x2E, 0x85, 0x77, 0x53, 0xF9, 0x6B, 0x2B, 0x73, 0x76, 0x70, 0x07, 0xF0,
+    },
+    {
+        0x7D, 0xD2, 0x53, 0x1D, 0x38, 0xCC, 0x48, 0x9C, 0x40, 0xF9, 0x82, 0xC4, 0x99, 0x4E, 0xC2, 0xDD,
+        0x21, 0xB6, 0x7B, 0xE7, 0x56, 0xA0, 0x84, 0x90, 0x73, 0x67, 0x3B, 0xCF, 0xC3, 0x65, 0xFA, 0x31,
+        0x01, 0x60, 0xDF, 0x92, 0xA3, 0x4E, 0x5F, 0xE1, 0x61, 0x73, 0xFC, 0x95, 0xC6, 0xCE, 0x2D, 0x48,
+        0xD9, 0x87, 0x7F, 0xF3, 0xDC, 0xEA, 0x1F, 0x54, 0x42, 0xEB, 0x37, 0x1A, 0x12, 0xF9, 0x52, 0x44,
+    },
+    {
+        0x56, 0x29, 0x92, 0x98, 0x68, 0x35, 0x31, 0x10, 0x2B, 0x20, 0xBE, 0x17, 0xB7, 0xCB, 0xA3, 0x68,
+        0xED, 0xC6, 0xF0, 0x81, 0x51, 0x5D, 0x3C, 0xB1, 0xA2, 0x8E, 0xA6, 0x51, 0xEF, 0x75, 0x94, 0x65,
+        0xF6, 0x60, 0xBB, 0xF4, 0xEB, 0x71, 0x30, 0x97, 0xA9, 0x25, 0x67, 0x84, 0x15, 0xC5, 0xDF, 0x05,
+        0xF7, 0xD9, 0x11, 0x0D, 0xA4, 0x2E, 0x5A, 0x51, 0x8E, 0xC9, 0xF0, 0x2F, 0x60, 0xE5, 0xB0, 0xB4,
+    },
+    {
+        0xB0, 0x6C, 0x21, 0xF8, 0x09, 0xBB, 0x8A, 0x00, 0xA4, 0xB3, 0x0F, 0xDC, 0xF5, 0x71, 0xF8, 0x9D,
+        0xA4, 0x9C, 0xB3, 0xD1, 0xD3, 0xD3, 0x60, 0x08, 0x39, 0x70, 0xFE, 0xE4, 0x5C, 0x75, 0xD6, 0x58,
+        0x6A, 0xE6, 0xC3, 0x27, 0xF0, 0xB4, 0x58, 0x1E, 0xD8, 0xB3, 0x95, 0xBA, 0xAE, 0xE8, 0x5E, 0x14,
+        0x28, 0x4E, 0x2F, 0x9C, 0xA6, 0xCA, 0xFF, 0x36, 0x45, 0x32, 0xDA, 0xD4, 0x34, 0xA7, 0xF4, 0xC0,
+    },
+    {
+        0x9E, 0xE0, 0x36, 0x9F, 0xBD, 0x6E, 0xB9, 0x50, 0xDE, 0x32, 0x5A, 0x41, 0xFA, 0x89, 0x71, 0x33,
+        0xB6, 0xEF, 0xB3, 0x60, 0x66, 0xD9, 0x30, 0x72, 0xAC, 0x98, 0x8E, 0xD2, 0x44, 0x85, 0x7A, 0x47,
+        0x38, 0x64, 0xD4, 0x08, 0xA8, 0x91, 0x3C, 0x02, 0x76, 0x39, 0x92, 0x9F, 0x93, 0xFF, 0x6E, 0x2F,
+        0x8E, 0x0E, 0x16, 0x18, 0x13, 0x55, 0xCE, 0x51, 0x0D, 0x8A, 0x16, 0x0D, 0x7E, 0x53, 0x26, 0xFC,
+    },
+    {
+        0x61, 0xA3, 0x86, 0xFA, 0xEC, 0xA3, 0x0F, 0xFA, 0xF3, 0xD4, 0x0E, 0x34, 0x5A, 0xD8, 0xE3, 0xA1,
+        0x56, 0x63, 0xB3, 0xF6, 0x73, 0x28, 0x91, 0xE4, 0x7E, 0x30, 0xEB, 0xA3, 0xF6, 0x77, 0x9D, 0x58,
+        0x0E, 0xA8, 0x94, 0x76, 0x46, 0xD6, 0xA0, 0xBA, 0x81, 0x9D, 0x3D, 0x0B, 0xD0, 0xE3, 0x9A, 0x53,
+        0x7E, 0xFE, 0xF3, 0x57, 0xA5, 0x3F, 0x29, 0x46, 0x06, 0x38, 0x5C, 0x8F, 0x7B, 0x8C, 0x1C, 0xAC,
+    },
+    {
+        0xDC, 0x55, 0x88, 0x13, 0x9F, 0x5C, 0x76, 0xA2, 0x46, 0xE3, 0xC2, 0x32, 0x1F, 0xA9, 0x8E, 0x08,
+        0x1E, 0xB4, 0xD2, 0x9C, 0xCF, 0xE5, 0xA3, 0xBB, 0xD9, 0x46, 0x8D, 0x53, 0x67, 0x55, 0x19, 0x23,
+        0x52, 0x04, 0xE9, 0x6F, 0xE5, 0x2B, 0x15, 0xE3, 0xC7, 0x31, 0x6B, 0xEA, 0x65, 0xF0, 0x69, 0xCB,
+        0x9C, 0xB9, 0x4C, 0xCE, 0xE2, 0x3F, 0xA8, 0xF3, 0x0B, 0x35, 0x32, 0x07, 0x44, 0xD5, 0x3E, 0x36,
+    },
+    {
+        0x3E, 0xDD, 0x32, 0xED, 0xCF, 0x4F, 0x03, 0x19, 0xEA, 0x53, 0x7D, 0x72, 0x87, 0xF0, 0x29, 0xDE,
+        0x27, 0x96, 0x75, 0x2A, 0x9E, 0x98, 0x49, 0xD9, 0x86, 0x10, 0x61, 0xC1, 0xE8, 0x15, 0xCF, 0x32,
+        0xB6, 0x8A, 0x74, 0x91, 0x94, 0x5A, 0x11, 0x0E, 0x6F, 0x5F, 0xA7, 0x49, 0xA3, 0xEF, 0x1D, 0x4D,
+        0xA9, 0xC7, 0xAC, 0x84, 0xD4, 0xDB, 0x9A, 0xB3, 0xE6, 0x0B, 0xB9, 0xB2, 0x0F, 0x5A, 0xC4, 0x49,
+    },
+    {
+        0xDD, 0xBF, 0xE6, 0xB2, 0xFF, 0x05, 0x1C, 0x6F, 0x4D, 0x09, 0xAF, 0xA5, 0x1A, 0xEC, 0x78, 0xAC,
+        0x53, 0xF9, 0x39, 0x8E, 0xFA, 0x2C, 0xC6, 0x4D, 0x0D, 0x04, 0xD7, 0xB0, 0x71, 0x26, 0x50, 0x00,
+        0xA7, 0xE1, 0x99, 0x9D, 0x0A, 0xB4, 0x85, 0xC7, 0x40, 0x35, 0xA4, 0x5B, 0x6B, 0x24, 0x11, 0xC6,
+        0xD5, 0xF3, 0x9C, 0xCD, 0x15, 0x9E, 0x61, 0x0E, 0x61, 0x0C, 0xE7, 0x29, 0xD9, 0xF7, 0xF1, 0xA1,
+    },
+    {
+        0xC2, 0xED, 0x14, 0x6E, 0x8E, 0xA6, 0xA0, 0xFF, 0x87, 0x30, 0xC2, 0x1D, 0x4B, 0x57, 0x18, 0x65,
+        0x89, 0xA1, 0xB1, 0x35, 0xF9, 0x55, 0xA9, 0x20, 0x72, 0xE7, 0x2E, 0x9B, 0x3A, 0x0B, 0xFC, 0xCB,
+        0x1C, 0x33, 0x00, 0x7E, 0xBC, 0xCB, 0xA8, 0x49, 0x41, 0x9B, 0x35, 0x2A, 0xB1, 0x0C, 0xF8, 0xF5,
+        0xE4, 0xD4, 0xAC, 0x54, 0x6C, 0xE9, 0x1B, 0x0D, 0x40, 0xE2, 0xFB, 0xE1, 0x88, 0x58, 0xB0, 0xBC,
+    },
+    {
+        0x68, 0xBF, 0x62, 0x17, 0x31, 0x3F, 0xAD, 0xD4, 0x1A, 0x59, 0xEF, 0x95, 0x69, 0x83, 0xA3, 0xDD,
+        0x3A, 0x5A, 0x81, 0xAD, 0x58, 0x8B, 0xEE, 0x58, 0xCA, 0x43, 0x94, 0xEC, 0x57, 0x25, 0x4E, 0x5C,
+        0x32, 0xD0, 0x1A, 0x49, 0x00, 0xFE, 0x2A, 0xA3, 0x77, 0x60, 0x91, 0xDE, 0xCF, 0x9F, 0xF8, 0x8E,
+        0xB3, 0xBC, 0x83, 0xD5, 0xBE, 0x56, 0x62, 0x44, 0xCF, 0xA0, 0x71, 0x72, 0x91, 0xF7, 0xA1, 0xEC,
+    },
+    {
+        0xCE, 0xD6, 0xCD, 0x4E, 0x13, 0x32, 0x21, 0xA9, 0xDE, 0x57, 0x66, 0xE5, 0xDC, 0x0B, 0xED, 0xE7,
+        0xC8, 0x3B, 0xFC, 0xF9, 0xD2, 0xB6, 0x20, 0x1F, 0xBC, 0x74, 0xED, 0x8A, 0xD1, 0xF9, 0xE2, 0xAD,
+        0xFF, 0x5F, 0xF8, 0x4B, 0x3E, 0x19, 0xA3, 0xA3, 0x28, 0xCD, 0x7E, 0x21, 0xE1, 0x3B, 0x1B, 0xED,
+        0x9B, 0xFE, 0xD3, 0x9C, 0x69, 0xFC, 0xA9, 0xA6, 0x82, 0xA3, 0xC1, 0x88, 0xDF, 0xA3, 0x88, 0x59,
+    },
+} };
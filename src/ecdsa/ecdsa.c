@@ -42,6 +42,7 @@
  */
 #include "ecdsa.h"
 #include "custom/custom_auth_def.h"
+#include "custom/custom_fixed_base.h"
 #include "crypto/atca_crypto_sw_sha2.h"
 #include "crypto/atca_crypto_sw_ecdsa.h"
 #include "atcacert/atcacert_host_hw.h"
@@ -105,5 +106,5 @@ ATCA_STATUS ecdsa_custom_verify_sw(uint8_t* msg, size_t length, uint8_t* signatu
 	ret = atcac_sw_sha2_256(msg, length, tbs_digest);	//generate digest of buffer
 	if (ret != ATCA_SUCCESS) return ret;
 	
-	return atcac_sw_ecdsa_verify_p256(tbs_digest, signature, tag_signer_pubkey);
+	return atcac_sw_ecdsa_verify_p256_fixed(tbs_digest, signature, &g_tag_signer_pubkey_table);
 }
\ No newline at end of file
@@ -83,6 +83,8 @@ ATCA_STATUS ecdsa_custom_verify(uint8_t* msg, size_t length, uint8_t* signature)
  * \fn	ATCA_STATUS ecdsa_custom_verify_sw(uint8_t* buffer, size_t length, uint8_t* signature);
  *
  * \brief	Verify signature in SW generated by ecdsa_custom_sign using tag signer private key.
+ * 			Uses the precomputed tag signer table (custom_fixed_base.c) so both scalar
+ * 			multiplications are fixed-base.
  *
  * \param [in]	buffer   	Pointer to to be signed message
  * \param 	  	length   	Length of input message
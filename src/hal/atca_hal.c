@@ -177,6 +177,36 @@ ATCA_STATUS hal_iface_init( ATCAIfaceCfg *cfg, ATCAHAL_t *hal )
 		hal->halrelease = &hal_kit_hid_release;
 		hal->hal_data = NULL;
 
+		status = ATCA_SUCCESS;
+		#endif
+		break;
+	case ATCA_SIM_IFACE:
+		#ifdef ATCA_HAL_SIM
+		hal->halinit = &hal_sim_init;
+		hal->halpostinit = &hal_sim_post_init;
+		hal->halreceive = &hal_sim_receive;
+		hal->halsend = &hal_sim_send;
+		hal->halsleep = &hal_sim_sleep;
+		hal->halwake = &hal_sim_wake;
+		hal->halidle = &hal_sim_idle;
+		hal->halrelease = &hal_sim_release;
+		hal->hal_data = NULL;
+
+		status = ATCA_SUCCESS;
+		#endif
+		break;
+	case ATCA_REPLAY_IFACE:
+		#ifdef ATCA_HAL_REPLAY
+		hal->halinit = &hal_replay_init;
+		hal->halpostinit = &hal_replay_post_init;
+		hal->halreceive = &hal_replay_receive;
+		hal->halsend = &hal_replay_send;
+		hal->halsleep = &hal_replay_sleep;
+		hal->halwake = &hal_replay_wake;
+		hal->halidle = &hal_replay_idle;
+		hal->halrelease = &hal_replay_release;
+		hal->hal_data = NULL;
+
 		status = ATCA_SUCCESS;
 		#endif
 		break;
@@ -184,6 +214,12 @@ ATCA_STATUS hal_iface_init( ATCAIfaceCfg *cfg, ATCAHAL_t *hal )
 		status = ATCA_BAD_PARAM;
 		break;
 	}
+
+	#ifdef ATCA_HAL_TRACE
+	if (status == ATCA_SUCCESS)
+		hal_trace_attach(cfg, hal);
+	#endif
+
 	return status;
 }
 
@@ -225,6 +261,16 @@ ATCA_STATUS hal_iface_release( ATCAIfaceType ifacetype, void *hal_data )
 		status = hal_kit_hid_release(hal_data);
 			#endif
 		break;
+	case ATCA_SIM_IFACE:
+			#ifdef ATCA_HAL_SIM
+		status = hal_sim_release(hal_data);
+			#endif
+		break;
+	case ATCA_REPLAY_IFACE:
+			#ifdef ATCA_HAL_REPLAY
+		status = hal_replay_release(hal_data);
+			#endif
+		break;
 	default:
 		status = ATCA_BAD_PARAM;
 	break;
@@ -233,6 +279,7 @@ ATCA_STATUS hal_iface_release( ATCAIfaceType ifacetype, void *hal_data )
 	return status;
 }
 
+#ifdef ATCA_HAL_I2C
 
 /** \brief wake up CryptoAuth device using I2C bus
  * \param[in] iface  interface to logical device to wakeup
@@ -245,24 +292,28 @@ ATCA_STATUS hal_i2c_wake(ATCAIface iface)
 	uint8_t data[ATCA_RSP_SIZE_MIN], expected[ATCA_RSP_SIZE_MIN] = { 0x04, 0x11, 0x33, 0x43 };
 	uint16_t rlength = ATCA_RSP_SIZE_MIN;
 	
-	if ( bdrt != I2C_BAUD_RATE_100KHZ )  // if not already at 100KHz, change it
-	change_i2c_speed( iface, I2C_BAUD_RATE_100KHZ );
-	
-	//change address temporarily to 0x11 in order to wake up IC correctly and also test writing HAL layer function
-	cfg->atcai2c.slave_address = I2C_WAKE_SLAVE_ADDR;
+	// Drive SDA low directly if the HAL can, which keeps the bus at its speed. Otherwise an
+	// address byte at 100KHz holds SDA low long enough.
+	if (i2c_wake_pulse(iface) != ATCA_SUCCESS) {
+		if ( bdrt != I2C_BAUD_RATE_100KHZ )  // if not already at 100KHz, change it
+		change_i2c_speed( iface, I2C_BAUD_RATE_100KHZ );
+		
+		//change address temporarily to 0x11 in order to wake up IC correctly and also test writing HAL layer function
+		cfg->atcai2c.slave_address = I2C_WAKE_SLAVE_ADDR;
 
-	i2c_master_write (iface,&data[0],0);    // part will NACK, so don't check for status
-	
-	//change address back to original value
-	cfg->atcai2c.slave_address = addr;
+		i2c_master_write (iface,&data[0],0);    // part will NACK, so don't check for status
+		
+		//change address back to original value
+		cfg->atcai2c.slave_address = addr;
+
+		// if necessary, revert baud rate to what came in.
+		if ( bdrt != I2C_BAUD_RATE_100KHZ )
+		change_i2c_speed( iface, bdrt );
+	}
 
 	atca_delay_us(cfg->wake_delay);     // wait tWHI + tWLO which is configured based on device type and configuration structure
 	
 	hal_i2c_receive (iface,&data[0],&rlength);
-	
-	// if necessary, revert baud rate to what came in.
-	if ( bdrt != I2C_BAUD_RATE_100KHZ )
-	change_i2c_speed( iface, bdrt );
 
 	if ( memcmp( data, expected, ATCA_RSP_SIZE_MIN ) == 0 )
 	return ATCA_SUCCESS;
@@ -316,3 +367,5 @@ ATCA_STATUS hal_i2c_receive( ATCAIface iface, uint8_t *rxdata, uint16_t *rxlengt
 {
 	return i2c_master_read(iface, rxdata, rxlength);
 }
+
+#endif /* ATCA_HAL_I2C */
@@ -141,6 +141,11 @@ extern ATCA_STATUS hal_iface_release(ATCAIfaceType ifacetype, void *hal_data);
 //ATCA_HAL_UART
 //ATCA_HAL_KIT_HID
 //ATCA_HAL_KIT_CDC
+//ATCA_HAL_SIM
+//ATCA_HAL_REPLAY
+
+// Not an interface of its own: records the traffic of the interfaces above, see hal/hal_trace.h
+//ATCA_HAL_TRACE
 
 //If nothing defined than use I2C
 #ifndef ATCA_HAL_I2C
@@ -148,7 +153,11 @@ extern ATCA_STATUS hal_iface_release(ATCAIfaceType ifacetype, void *hal_data);
 		#ifndef ATCA_HAL_UART
 			#ifndef ATCA_HAL_KIT_CDC
 				#ifndef ATCA_HAL_KIT_HID
-					#define ATCA_HAL_I2C
+					#ifndef ATCA_HAL_SIM
+						#ifndef ATCA_HAL_REPLAY
+							#define ATCA_HAL_I2C
+						#endif
+					#endif
 				#endif
 			#endif
 		#endif
@@ -172,6 +181,7 @@ ATCA_STATUS hal_i2c_discover_devices(uint16_t busNum, ATCAIfaceCfg cfg[], uint16
 void change_i2c_speed( ATCAIface iface, uint32_t speed );
 ATCA_STATUS i2c_master_write(ATCAIface iface, uint8_t *txdata, uint16_t txlength);
 ATCA_STATUS i2c_master_read( ATCAIface iface, uint8_t *rxdata, uint16_t *rxlength);
+ATCA_STATUS i2c_wake_pulse(ATCAIface iface);
 #endif
 
 #ifdef ATCA_HAL_SWI
@@ -226,12 +236,40 @@ ATCA_STATUS hal_kit_hid_discover_buses(uint16_t i2c_buses[], uint16_t max_buses)
 ATCA_STATUS hal_kit_hid_discover_devices(uint16_t busNum, ATCAIfaceCfg *cfg, uint16_t *found);
 #endif
 
+#ifdef ATCA_HAL_SIM
+ATCA_STATUS hal_sim_init(void *hal, ATCAIfaceCfg *cfg);
+ATCA_STATUS hal_sim_post_init(ATCAIface iface);
+ATCA_STATUS hal_sim_send(ATCAIface iface, uint8_t *txdata, uint16_t txlength);
+ATCA_STATUS hal_sim_receive(ATCAIface iface, uint8_t *rxdata, uint16_t *rxlength);
+ATCA_STATUS hal_sim_wake(ATCAIface iface);
+ATCA_STATUS hal_sim_idle(ATCAIface iface);
+ATCA_STATUS hal_sim_sleep(ATCAIface iface);
+ATCA_STATUS hal_sim_release(void *hal_data);
+#endif
+
+#ifdef ATCA_HAL_REPLAY
+ATCA_STATUS hal_replay_init(void *hal, ATCAIfaceCfg *cfg);
+ATCA_STATUS hal_replay_post_init(ATCAIface iface);
+ATCA_STATUS hal_replay_send(ATCAIface iface, uint8_t *txdata, uint16_t txlength);
+ATCA_STATUS hal_replay_receive(ATCAIface iface, uint8_t *rxdata, uint16_t *rxlength);
+ATCA_STATUS hal_replay_wake(ATCAIface iface);
+ATCA_STATUS hal_replay_idle(ATCAIface iface);
+ATCA_STATUS hal_replay_sleep(ATCAIface iface);
+ATCA_STATUS hal_replay_release(void *hal_data);
+#endif
+
+#ifdef ATCA_HAL_TRACE
+void hal_trace_attach(ATCAIfaceCfg *cfg, ATCAHAL_t *hal);
+#endif
+
 
 
 /** \brief Timer API implemented at the HAL level */
 void atca_delay_us(uint32_t delay);
 void atca_delay_10us(uint32_t delay);
 void atca_delay_ms(uint32_t delay);
+/** \brief Microseconds requested from the delay functions since start-up, wraps at 2^32 */
+uint32_t atca_delay_elapsed_us(void);
 
 
 /************************************************************************/
@@ -244,7 +282,8 @@ void atca_delay_ms(uint32_t delay);
 /**********************************************************************************************//**
  * \fn	ATCA_STATUS hal_random_number(uint8_t* random_number)
  *
- * \brief	HAL random number. Implementation of SW pseudo random number generator (PRG)
+ * \brief	HAL random number. 32 bytes from the platform noise source (ADC/timer on AVR, the
+ * 			OS on a host), health tested and SHA-256 conditioned. See hal/hal_entropy.h.
  *
  * \param [in,out]	random_number	32 byte random number
  *
@@ -3,12 +3,44 @@
 #include "custom_hal.h"
 #include "atca_device.h"
 #include <avr/io.h>
+#include <avr/eeprom.h>
+#include <stddef.h>
+#include <string.h>
 #include "twi.h"
 #include <util/delay.h>
 
 //! \internal Pointer to the applicative TWI receive buffer.
 static volatile uint8_t *twim_rx_data = NULL;
 
+//! \internal SCL frequency the TWI is programmed for, 0 until hal_i2c_init().
+static uint32_t i2c_current_speed = 0;
+
+/* SDA as a GPIO, used to send the wake pulse without reprogramming the bit rate. Define these in the
+   compiler settings for other parts; without them hal_i2c_wake() falls back to a 100 kHz transfer. */
+#ifndef I2C_SDA_BIT
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__) || defined(__AVR_ATmega88__)
+#define I2C_SDA_DDR		DDRC
+#define I2C_SDA_PORT	PORTC
+#define I2C_SDA_BIT		PC4
+#elif defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__) || defined(__AVR_ATmega32U4__)
+#define I2C_SDA_DDR		DDRD
+#define I2C_SDA_PORT	PORTD
+#define I2C_SDA_BIT		PD1
+#endif
+#endif
+
+//! \internal SDA low time of the wake pulse, tWLO is 60 us minimum.
+#define I2C_WAKE_LOW_US	60
+
+/* The execution waits of atca_command.c already cover most commands, so a receive is seldom retried.
+   When it is, poll gently: slow commands back off exponentially, the rest linearly. */
+static const ATCARetryPolicy device_e0_rx_policy[] = {
+	{ CMD_GENKEY,      ATCA_RETRY_EXPONENTIAL, 1000, 8000, 0, 60000 },
+	{ CMD_SIGN,        ATCA_RETRY_EXPONENTIAL, 1000, 8000, 0, 60000 },
+	{ CMD_VERIFY,      ATCA_RETRY_EXPONENTIAL, 1000, 8000, 0, 60000 },
+	{ CMD_LASTCOMMAND, ATCA_RETRY_LINEAR,       200, 2000, 0, 20000 }
+};
+
 ATCAIfaceCfg device_e0 = {
 	.iface_type       = ATCA_I2C_IFACE,
 	.devtype        = ATECC508A,
@@ -17,16 +49,27 @@ ATCAIfaceCfg device_e0 = {
 	.atcai2c.baud     = 400000,
 	//.atcai2c.baud = 100000,
 	.wake_delay       = 800,
-	.rx_retries       = 20
+	.rx_retries       = 20,
+	.rx_policy        = device_e0_rx_policy
 };
 
 ATCAIfaceCfg *cfg_eGuard = &device_e0;
 
 /*Timer functions*/
 /*Examples use atmel ASF supplied routines*/
+
+//! \internal Microseconds requested from the delay functions, see atca_delay_elapsed_us().
+static uint32_t delay_elapsed_us = 0;
+
+uint32_t atca_delay_elapsed_us(void)
+{
+	return delay_elapsed_us;
+}
+
 void atca_delay_ms(uint32_t delay)
 {
 	int i;
+	delay_elapsed_us += delay * 1000;
 	for (i = 0; i <= (delay); i++)
 	{
 		_delay_ms(1);
@@ -36,6 +79,7 @@ void atca_delay_ms(uint32_t delay)
 void atca_delay_us(uint32_t delay)
 {
 	int i;
+	delay_elapsed_us += delay;
 	for (i = 0; i <= (delay); i++)
 	{
 		_delay_us(1);
@@ -46,6 +90,7 @@ void atca_delay_10us(uint32_t delay)
 {
 
 	int i;
+	delay_elapsed_us += delay * 10;
 	for (i = 0; i <= (10*delay); i++)
 	{
 		_delay_us(1);
@@ -60,24 +105,10 @@ void atca_delay_10us(uint32_t delay)
  */
 ATCA_STATUS hal_i2c_init(void *hal, ATCAIfaceCfg *cfg)
 {
-    if(cfg->atcai2c.baud == 400000)
-	{
-		//set SCL to 400kHz
-		TWSR = 0x00;
-		TWBR = 0x0C;
-	}
-	else
-	{
-		//set SCL to 100kHz
-		TWSR = 0x00;
-		TWBR = 0x48;		
-	}
-	
-    //enable TWI
-    TWCR = (1<<TWEN);
+	i2c_current_speed = 0;
+	change_i2c_speed(NULL, (cfg->atcai2c.baud != 0) ? cfg->atcai2c.baud : SCLFREQ100KHZ);
 
-	
-return ATCA_SUCCESS;
+	return ATCA_SUCCESS;
 }
 
 /** \brief HAL implementation of I2C post init
@@ -327,8 +358,7 @@ ATCA_STATUS i2c_master_read( ATCAIface iface, uint8_t *rxdata, uint16_t *rxlengt
 	ATCAIfaceCfg *cfg = atgetifacecfg(iface);
 	ATCA_STATUS ret = ATCA_UNIMPLEMENTED;
 	twi_package_t package;
-	
-	int retries = cfg->rx_retries;
+	ATCARetryState retry;
 
 	/*! TWI chip address to communicate with*/
 	package.chip = cfg->atcai2c.slave_address;
@@ -344,44 +374,78 @@ ATCA_STATUS i2c_master_read( ATCAIface iface, uint8_t *rxdata, uint16_t *rxlengt
 	  to check for ack only*/
 	package.chk_ack_only_flag = false;
 	
-	while ((retries-- > 0 ) && (ret != ATCA_SUCCESS))
+	/* the device NACKs its address until the command has executed,
+	   cfg->rx_policy paces the attempts */
+	atretrystart(iface, &retry);
+	do
 	{
 		ret = twi_master_read(&package);
-	}	
-	
+	} while ((ret != ATCA_SUCCESS) && atretrynext(iface, &retry));
+	atretrydone(iface, &retry, ret);
+
 	return ret;
 	
 }
 
 
 
-/** \brief method to change the bus speed of I2C
- * \param[in] iface  interface on which to change bus speed
- * \param[in] speed  baud rate (typically 100000 or 400000)
+/** \brief method to change the bus speed of I2C, does nothing if the bus already runs at that speed
+ * \param[in] iface  interface on which to change bus speed, unused
+ * \param[in] speed  baud rate (typically 100000 or 400000, 1000000 if the pull-ups are strong enough)
  */
 void change_i2c_speed( ATCAIface iface, uint32_t speed )
 {
+	uint32_t twbr;
+
+	if (speed == i2c_current_speed)
+		return;
+
 	/*Disable TWI transceiver*/
-	TWCR &= ~(1 << TWEN);   
-
- switch(speed)
- {
-	case SCLFREQ100KHZ:
-		TWBR	=  0x12;		// Define the baud rate using formula
-		TWSR	|= (1<<TWPS0);
-	break;
-	
-	default:
-		TWBR	=  0x03;		// Define the baud rate using formula
-		TWSR	|= (1<<TWPS0);
-	break;
+	TWCR &= ~(1 << TWEN);
 
+	/*SCL = F_CPU / (16 + 2 * TWBR * prescaler), prescaler 4 once TWBR no longer fits a byte*/
+	twbr = (F_CPU / speed > 16) ? (F_CPU / speed - 16) / 2 : 0;
+	if (twbr > 0xFF)
+	{
+		TWSR = (1 << TWPS0);
+		twbr /= 4;
 	}
-
+	else
+	{
+		TWSR = 0x00;
+	}
+	TWBR = (uint8_t)((twbr > 0xFF) ? 0xFF : twbr);
 
 	/*Enable TWI transceiver*/
-	TWCR	= (1 << TWEN);   
+	TWCR = (1 << TWEN);
 
+	i2c_current_speed = speed;
+}
+
+/** \brief sends the wake pulse by holding SDA low as a GPIO, the bit rate is left alone
+ * \param[in] iface  interface to wake
+ * \return ATCA_SUCCESS, or ATCA_UNIMPLEMENTED when SDA is not known for this part
+ */
+ATCA_STATUS i2c_wake_pulse(ATCAIface iface)
+{
+#ifdef I2C_SDA_BIT
+	uint8_t port = I2C_SDA_PORT & (1 << I2C_SDA_BIT);
+
+	/*Take SDA from the TWI and drive it low for tWLO*/
+	TWCR &= ~(1 << TWEN);
+	I2C_SDA_PORT &= ~(1 << I2C_SDA_BIT);
+	I2C_SDA_DDR |= (1 << I2C_SDA_BIT);
+	_delay_us(I2C_WAKE_LOW_US);
+
+	/*Release it and hand it back*/
+	I2C_SDA_DDR &= ~(1 << I2C_SDA_BIT);
+	I2C_SDA_PORT |= port;
+	TWCR = (1 << TWEN);
+
+	return ATCA_SUCCESS;
+#else
+	return ATCA_UNIMPLEMENTED;
+#endif
 }
 
 
@@ -393,51 +457,201 @@ void change_i2c_speed( ATCAIface iface, uint32_t speed )
  */
 ATCA_STATUS hal_i2c_release( void *hal_data )
 {
-	/* implement your code here */
+	/* nothing is allocated per interface, the TWI stays enabled for other devices */
+	return ATCA_SUCCESS;
 }
 
-ATCA_STATUS hal_i2c_discover_buses(uint16_t i2c_buses[], uint16_t max_buses)
+/* Discovery wakes every CryptoAuth device on the bus with one wake pulse, sends Info to each address
+   and classifies the devices that answer by their revision. The result is cached in EEPROM so later
+   boots skip the scan; hal_i2c_discover_forget() drops the cache after the board is changed. */
+
+//! \internal Most devices discovered on the bus and kept in the cache.
+#ifndef HAL_I2C_DISCOVER_MAX
+#define HAL_I2C_DISCOVER_MAX		8
+#endif
+
+//! \internal Wait for the Info response, long enough for every supported device.
+#define HAL_I2C_DISCOVER_INFO_MS	3
+
+#define HAL_I2C_DISCOVER_MAGIC		0xD15C
+
+//! \internal Discovery result as stored in EEPROM.
+typedef struct {
+	uint16_t magic;
+	uint8_t bus;
+	uint8_t count;
+	struct {
+		uint8_t address;
+		uint8_t devtype;
+	} device[HAL_I2C_DISCOVER_MAX];
+	uint8_t crc[ATCA_CRC_SIZE];
+} i2c_discover_cache_t;
+
+//! \internal EEPROM address of the cache, the top of the EEPROM unless set in the compiler settings.
+#ifndef HAL_I2C_DISCOVER_EEPROM
+#define HAL_I2C_DISCOVER_EEPROM		(E2END + 1 - sizeof(i2c_discover_cache_t))
+#endif
+
+/** \brief fills a configuration for a discovered device, like device_e0 but at its own address */
+static void i2c_discover_fill(ATCAIfaceCfg *cfg, uint8_t bus, uint8_t address, ATCADeviceType devtype)
 {
-	return ATCA_UNIMPLEMENTED;
+	memset(cfg, 0, sizeof(*cfg));
+	cfg->iface_type = ATCA_I2C_IFACE;
+	cfg->devtype = devtype;
+	cfg->atcai2c.slave_address = address;
+	cfg->atcai2c.bus = bus;
+	cfg->atcai2c.baud = device_e0.atcai2c.baud;
+	cfg->wake_delay = (devtype == ATSHA204A) ? 2560 : 800;
+	cfg->rx_retries = 20;
+	cfg->rx_policy = (devtype == ATSHA204A) ? NULL : device_e0_rx_policy;
 }
 
-ATCA_STATUS hal_i2c_discover_devices(uint16_t busNum, ATCAIfaceCfg cfg[], uint16_t *found )
+/** \brief tells the device type from the 4 byte revision Info returns */
+static ATCADeviceType i2c_discover_classify(const uint8_t *revision)
 {
+	switch (revision[2])
+	{
+	case 0x00:
+	case 0x02:
+		return ATSHA204A;
+	case 0x10:
+		return ATECC108A;
+	case 0x50:
+		return ATECC508A;
+	default:
+		return ATCA_DEV_UNKNOWN;
+	}
+}
 
-	return ATCA_UNIMPLEMENTED;
+/** \brief probes every address of the bus with Info */
+static uint16_t i2c_discover_scan(uint8_t bus, ATCAIfaceCfg cfg[], uint16_t max)
+{
+	ATCAIfaceCfg probe_cfg = device_e0;
+	ATCAIface probe;
+	ATCAPacket packet;
+	ATCADeviceType devtype;
+	uint16_t address;
+	uint16_t found = 0;
+	uint16_t i;
+
+	probe_cfg.atcai2c.bus = bus;
+	probe_cfg.rx_policy = NULL;
+	if ((probe = newATCAIface(&probe_cfg)) == NULL)
+		return 0;
+
+	// One pulse wakes every device on the bus, whether the first address answers does not matter
+	atwake(probe);
+
+	for (address = 0x10; address <= 0xEE && found < max; address += 2)
+	{
+		probe_cfg.atcai2c.slave_address = (uint8_t)address;
+		packet.param1 = INFO_MODE_REVISION;
+		packet.param2 = 0;
+		atInfo(&packet);
+
+		// An empty address NACKs, which fails the send without waiting
+		if (atsend(probe, (uint8_t*)&packet, packet.txsize) != ATCA_SUCCESS)
+			continue;
+		atca_delay_ms(HAL_I2C_DISCOVER_INFO_MS);
+		if (atreceive(probe, packet.crypto_data, &packet.rxsize) != ATCA_SUCCESS)
+			continue;
+		if (packet.crypto_data[ATCA_COUNT_IDX] != INFO_RSP_SIZE || atCheckCrc(packet.crypto_data) != ATCA_SUCCESS)
+			continue;
+
+		devtype = i2c_discover_classify(&packet.crypto_data[ATCA_RSP_DATA_IDX]);
+		if (devtype != ATCA_DEV_UNKNOWN)
+			i2c_discover_fill(&cfg[found++], bus, (uint8_t)address, devtype);
+	}
+
+	for (i = 0; i < found; i++)
+	{
+		probe_cfg.atcai2c.slave_address = cfg[i].atcai2c.slave_address;
+		atsleep(probe);
+	}
+	deleteATCAIface(&probe);
+
+	return found;
 }
 
- /* brief return software generated 32 byte random number
-  * param[out] random_number - ptr to space to receive the random number
+/** \brief fills the configurations from the EEPROM cache
+ * \return true if the cache holds the result of a scan of this bus
  */
-ATCA_STATUS hal_random_number(uint8_t* random_number)
+static bool i2c_discover_load(uint8_t bus, ATCAIfaceCfg cfg[], uint16_t max, uint16_t *found)
 {
-  /* below is a psuedo-random number generator. Note: this generator does not meet the NIST requirements
-     for a random number generator. However, it is sufficient for the purposes of this general purpose 
-	 security evaluation platform. For additional entroy in the random number generator, an alternate
-	 algorithm is recommended. */
-  uint8_t random_array[32];
-  uint8_t rval;
-                 // UNDONE
-                uint8_t challenge[32]= {
-                                0x3D, 0x1A, 0x85, 0x25, 0x37, 0xB5, 0xC3, 0x2C,  0xF3, 0x6E, 0x3B, 0x13, 0x20, 0x4A, 0xC4, 0xEF,
-                0x1F, 0x9E, 0xBE, 0xFB, 0xf5, 0x9B, 0x98, 0x59,  0x38, 0x23, 0xC6, 0x4A, 0xE1, 0x04, 0x8A, 0x66};
-                
-                memcpy(random_number, challenge, ATCA_KEY_SIZE);
-                
-                return ATCA_SUCCESS;
+	i2c_discover_cache_t cache;
+	uint8_t crc[ATCA_CRC_SIZE];
+	uint16_t i;
 
-   
-  // if analog input pin 0 is unconnected, random analog
-  // noise will cause the call to randomSeed() to generate
-  // different seed numbers each time the sketch runs.
-  // randomSeed() will then shuffle the random function.
-//  randomSeed(analogRead(0));
-
-//  for (int i; i < 32; i++) {
-//	  rval = random(0x00, 0x100);  // min value is inclusive, max value is exclusive.
-//	  random_array[i] = rval;
-//  }
-     
-//  memcpy(random_number, random_array, 32); // copy 32 byts from random_array to the random_number variable.
+	eeprom_read_block(&cache, (const void*)HAL_I2C_DISCOVER_EEPROM, sizeof(cache));
+	if (cache.magic != HAL_I2C_DISCOVER_MAGIC || cache.bus != bus || cache.count > HAL_I2C_DISCOVER_MAX)
+		return false;
+	atCRC(offsetof(i2c_discover_cache_t, crc), (uint8_t*)&cache, crc);
+	if (memcmp(crc, cache.crc, sizeof(crc)) != 0)
+		return false;
+
+	for (i = 0; i < cache.count && i < max; i++)
+		i2c_discover_fill(&cfg[i], bus, cache.device[i].address, (ATCADeviceType)cache.device[i].devtype);
+	*found = i;
+
+	return true;
+}
+
+/** \brief stores the result of a scan in the EEPROM cache */
+static void i2c_discover_save(uint8_t bus, const ATCAIfaceCfg cfg[], uint16_t found)
+{
+	i2c_discover_cache_t cache;
+	uint16_t i;
+
+	memset(&cache, 0, sizeof(cache));
+	cache.magic = HAL_I2C_DISCOVER_MAGIC;
+	cache.bus = bus;
+	cache.count = (uint8_t)((found > HAL_I2C_DISCOVER_MAX) ? HAL_I2C_DISCOVER_MAX : found);
+	for (i = 0; i < cache.count; i++)
+	{
+		cache.device[i].address = cfg[i].atcai2c.slave_address;
+		cache.device[i].devtype = (uint8_t)cfg[i].devtype;
+	}
+	atCRC(offsetof(i2c_discover_cache_t, crc), (uint8_t*)&cache, cache.crc);
+
+	eeprom_update_block(&cache, (void*)HAL_I2C_DISCOVER_EEPROM, sizeof(cache));
+}
+
+/** \brief discover i2c buses available for this hardware
+ * \param[out] i2c_buses  logical bus numbers found, the TWI is the DEV1_BUS bus
+ * \param[in] max_buses   size of i2c_buses
+ * \return ATCA_SUCCESS
+ */
+ATCA_STATUS hal_i2c_discover_buses(uint16_t i2c_buses[], uint16_t max_buses)
+{
+	if (max_buses > 0)
+		i2c_buses[0] = DEV1_BUS;
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief discover the CryptoAuth devices on a bus, from the EEPROM cache when it holds a previous scan
+ * \param[in] busNum       logical bus number from hal_i2c_discover_buses()
+ * \param[out] cfg         receives a configuration per device found
+ * \param[in,out] found    room in cfg, 0 for HAL_I2C_DISCOVER_MAX; number of devices found
+ * \return ATCA_SUCCESS, or ATCA_NO_DEVICES
+ */
+ATCA_STATUS hal_i2c_discover_devices(uint16_t busNum, ATCAIfaceCfg cfg[], uint16_t *found )
+{
+	uint16_t max = (*found != 0) ? *found : HAL_I2C_DISCOVER_MAX;
+
+	if (!i2c_discover_load((uint8_t)busNum, cfg, max, found))
+	{
+		*found = i2c_discover_scan((uint8_t)busNum, cfg, max);
+		// An empty bus is not cached, the devices may just not have been powered yet
+		if (*found > 0)
+			i2c_discover_save((uint8_t)busNum, cfg, *found);
+	}
+
+	return (*found > 0) ? ATCA_SUCCESS : ATCA_NO_DEVICES;
+}
+
+/** \brief drops the discovery cache so the next hal_i2c_discover_devices() scans the bus again */
+void hal_i2c_discover_forget(void)
+{
+	eeprom_update_word((uint16_t*)HAL_I2C_DISCOVER_EEPROM, 0xFFFF);
 }
@@ -7,6 +7,9 @@
 
 extern ATCAIfaceCfg *cfg_eGuard;
 
+/** \brief Forget the devices hal_i2c_discover_devices() cached in EEPROM, e.g. after changing the board */
+void hal_i2c_discover_forget(void);
+
 /** \brief Custom configurations for crypto ICs */
 #define DEV1_NAME	cfg_device_e0
 #define DEV1_ADDR	0xE0
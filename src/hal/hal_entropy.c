@@ -0,0 +1,272 @@
+/**
+ * \file
+ * \brief HAL entropy source for hal_random_number() with SP 800-90B health tests.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#include <string.h>
+#include "atca_hal.h"
+#include "hal_entropy.h"
+#include "crypto/hashes/sha2_routines.h"
+
+#if defined(__AVR__)
+#include <avr/io.h>
+#elif defined(__linux__)
+#include <sys/random.h>
+#else
+#include <stdio.h>
+#endif
+
+/** \brief Health test state of the noise source */
+static struct {
+	uint8_t  rct_value;     //!< Last sample seen by the repetition count test
+	uint16_t rct_count;     //!< Times rct_value has repeated
+	uint8_t  apt_value;     //!< First sample of the current adaptive proportion window
+	uint16_t apt_count;     //!< Occurrences of apt_value in the window
+	uint16_t apt_index;     //!< Samples seen in the window
+	bool     started;       //!< Start-up tests passed
+	bool     failed;        //!< A health test failed, output is blocked
+} g_entropy;
+
+#if defined(__AVR__)
+
+static ATCA_STATUS hal_entropy_open(void)
+{
+	return ATCA_SUCCESS;
+}
+
+static void hal_entropy_close(void)
+{
+}
+
+/* Raw samples: the low bits of a fast ADC conversion on a floating input carry thermal noise.
+   Timer0, which the ADC clock drifts against, is read with each conversion but only goes into the
+   conditioning: the health tests have to see the ADC alone, or a stuck input would pass them.
+   ADC registers are restored afterwards. Batches are at most SHA256_DIGEST_SIZE samples. */
+static ATCA_STATUS hal_entropy_sample(uint8_t* samples, uint16_t count, sw_sha256_ctx* mix)
+{
+	uint8_t timer[SHA256_DIGEST_SIZE];
+	uint8_t admux = ADMUX;
+	uint8_t adcsra = ADCSRA;
+	uint16_t i;
+
+	ADMUX = (1 << REFS0) | (HAL_ENTROPY_ADC_CHANNEL & 0x0F);   // AVcc reference
+	ADCSRA = (1 << ADEN) | (1 << ADPS1);            // enable, clk/4 for maximum noise
+	for (i = 0; i < count; i++)
+	{
+		ADCSRA |= (1 << ADSC);
+		while (ADCSRA & (1 << ADSC))
+			;
+		samples[i] = ADCL;
+		(void)ADCH;                                 // ADCL locks the result until ADCH is read
+		timer[i] = TCNT0;
+	}
+
+	ADMUX = admux;
+	ADCSRA = adcsra;
+
+	if (mix != NULL)
+		sw_sha256_update(mix, timer, count);
+	memset(timer, 0, sizeof(timer));
+
+	return ATCA_SUCCESS;
+}
+
+#elif defined(__linux__)
+
+static ATCA_STATUS hal_entropy_open(void)
+{
+	return ATCA_SUCCESS;
+}
+
+static void hal_entropy_close(void)
+{
+}
+
+static ATCA_STATUS hal_entropy_sample(uint8_t* samples, uint16_t count, sw_sha256_ctx* mix)
+{
+	(void)mix;
+
+	return (getrandom(samples, count, 0) == (ssize_t)count) ? ATCA_SUCCESS : ATCA_GEN_FAIL;
+}
+
+#else
+
+/* /dev/urandom stays open for the length of one request */
+static FILE* g_urandom;
+
+static ATCA_STATUS hal_entropy_open(void)
+{
+	g_urandom = fopen("/dev/urandom", "rb");
+
+	return (g_urandom != NULL) ? ATCA_SUCCESS : ATCA_UNIMPLEMENTED;
+}
+
+static void hal_entropy_close(void)
+{
+	fclose(g_urandom);
+	g_urandom = NULL;
+}
+
+static ATCA_STATUS hal_entropy_sample(uint8_t* samples, uint16_t count, sw_sha256_ctx* mix)
+{
+	(void)mix;
+
+	return (fread(samples, 1, count, g_urandom) == count) ? ATCA_SUCCESS : ATCA_GEN_FAIL;
+}
+
+#endif
+
+/* Reads count raw samples and runs each through the repetition count and adaptive proportion tests.
+   Anything the source adds for the conditioning only goes into mix, which may be NULL. */
+static ATCA_STATUS hal_entropy_next(uint8_t* samples, uint16_t count, sw_sha256_ctx* mix)
+{
+	ATCA_STATUS ret;
+	uint16_t i;
+
+	ret = hal_entropy_sample(samples, count, mix);
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	for (i = 0; i < count; i++)
+	{
+		//Repetition Count Test (SP 800-90B 4.4.1)
+		if (g_entropy.rct_count > 0 && samples[i] == g_entropy.rct_value)
+		{
+			if (++g_entropy.rct_count >= HAL_ENTROPY_RCT_CUTOFF)
+				g_entropy.failed = true;
+		}
+		else
+		{
+			g_entropy.rct_value = samples[i];
+			g_entropy.rct_count = 1;
+		}
+
+		//Adaptive Proportion Test (SP 800-90B 4.4.2)
+		if (g_entropy.apt_index == 0)
+		{
+			g_entropy.apt_value = samples[i];
+			g_entropy.apt_count = 1;
+		}
+		else if (samples[i] == g_entropy.apt_value)
+		{
+			if (++g_entropy.apt_count >= HAL_ENTROPY_APT_CUTOFF)
+				g_entropy.failed = true;
+		}
+		if (++g_entropy.apt_index >= HAL_ENTROPY_APT_WINDOW)
+			g_entropy.apt_index = 0;
+	}
+
+	return g_entropy.failed ? ATCA_FUNC_FAIL : ATCA_SUCCESS;
+}
+
+/* Start-up tests, with the noise source already open. */
+static ATCA_STATUS hal_entropy_startup(void)
+{
+	ATCA_STATUS ret;
+	uint8_t samples[SHA256_DIGEST_SIZE];
+	uint16_t i;
+
+	memset(&g_entropy, 0, sizeof(g_entropy));
+
+	for (i = 0; i < HAL_ENTROPY_STARTUP_SAMPLES; i += sizeof(samples))
+	{
+		ret = hal_entropy_next(samples, sizeof(samples), NULL);
+		if (ret != ATCA_SUCCESS)
+			return ret;
+	}
+	g_entropy.started = true;
+
+	return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_entropy_restart(void)
+{
+	ATCA_STATUS ret;
+
+	ret = hal_entropy_open();
+	if (ret != ATCA_SUCCESS)
+		return ret;
+	ret = hal_entropy_startup();
+	hal_entropy_close();
+
+	return ret;
+}
+
+/** \brief Returns 32 bytes of conditioned entropy. Raw samples pass the SP 800-90B health tests
+ *         and are compressed with SHA-256; a test failure is latched until hal_entropy_restart().
+ * \param[out] random_number  receives 32 bytes
+ * \return ATCA_SUCCESS, or ATCA_FUNC_FAIL if the noise source failed its health tests
+ */
+ATCA_STATUS hal_random_number(uint8_t* random_number)
+{
+	ATCA_STATUS ret;
+	sw_sha256_ctx ctx;
+	uint8_t samples[SHA256_DIGEST_SIZE];
+	uint16_t i;
+
+	if (random_number == NULL)
+		return ATCA_BAD_PARAM;
+
+	if (g_entropy.failed)
+		return ATCA_FUNC_FAIL;
+
+	ret = hal_entropy_open();
+	if (ret != ATCA_SUCCESS)
+		return ret;
+
+	if (!g_entropy.started)
+		ret = hal_entropy_startup();
+
+	sw_sha256_init(&ctx);
+	for (i = 0; ret == ATCA_SUCCESS && i < HAL_ENTROPY_SAMPLES_PER_OUTPUT; i += sizeof(samples))
+	{
+		ret = hal_entropy_next(samples, sizeof(samples), &ctx);
+		if (ret == ATCA_SUCCESS)
+			sw_sha256_update(&ctx, samples, sizeof(samples));
+	}
+	hal_entropy_close();
+
+	if (ret == ATCA_SUCCESS)
+		sw_sha256_final(&ctx, random_number);
+	memset(&ctx, 0, sizeof(ctx));
+	memset(samples, 0, sizeof(samples));
+
+	return ret;
+}
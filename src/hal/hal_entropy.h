@@ -0,0 +1,110 @@
+/**
+ * \file
+ * \brief HAL entropy source for hal_random_number() with SP 800-90B health tests.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#ifndef HAL_ENTROPY_H_
+#define HAL_ENTROPY_H_
+
+#include <stdint.h>
+#include "atca_status.h"
+
+/** \defgroup hal_ Hardware abstraction layer (hal_)
+ *
+   @{ */
+
+/** Assessed min-entropy of one raw sample, in bits. The AVR ADC/timer source is credited
+    conservatively; raise it only after an SP 800-90B assessment of the board. */
+#ifndef HAL_ENTROPY_BITS_PER_SAMPLE
+#define HAL_ENTROPY_BITS_PER_SAMPLE     (1)
+#endif
+
+/** Raw samples conditioned into each 32 byte output, twice the credited entropy needed. */
+#define HAL_ENTROPY_SAMPLES_PER_OUTPUT  ((2 * 256) / HAL_ENTROPY_BITS_PER_SAMPLE)
+
+/** Repetition Count Test cutoff, 1 + ceil(20 / H) for alpha = 2^-20 (SP 800-90B 4.4.1). */
+#define HAL_ENTROPY_RCT_CUTOFF          (1 + (20 + HAL_ENTROPY_BITS_PER_SAMPLE - 1) / HAL_ENTROPY_BITS_PER_SAMPLE)
+
+/** Adaptive Proportion Test window for non-binary samples (SP 800-90B 4.4.2). */
+#define HAL_ENTROPY_APT_WINDOW          (512)
+
+/** Adaptive Proportion Test cutoff, 1 + CRITBINOM(512, 2^-H, 1 - 2^-20) for the window above and
+    alpha = 2^-20 (SP 800-90B 4.4.2), worked out for each whole H of 1 to 8 bits. */
+#if HAL_ENTROPY_BITS_PER_SAMPLE < 1 || HAL_ENTROPY_BITS_PER_SAMPLE > 8
+#error "HAL_ENTROPY_BITS_PER_SAMPLE must be 1 to 8"
+#endif
+#define HAL_ENTROPY_APT_CUTOFF          (HAL_ENTROPY_BITS_PER_SAMPLE == 1 ? 311 : \
+                                         HAL_ENTROPY_BITS_PER_SAMPLE == 2 ? 177 : \
+                                         HAL_ENTROPY_BITS_PER_SAMPLE == 3 ? 103 : \
+                                         HAL_ENTROPY_BITS_PER_SAMPLE == 4 ? 62 :  \
+                                         HAL_ENTROPY_BITS_PER_SAMPLE == 5 ? 39 :  \
+                                         HAL_ENTROPY_BITS_PER_SAMPLE == 6 ? 25 :  \
+                                         HAL_ENTROPY_BITS_PER_SAMPLE == 7 ? 18 : 13)
+
+/** AVR ADC channel sampled as the noise source. Pick an analog pin the board leaves unconnected;
+    its ADC settings are restored after each batch of samples. */
+#ifndef HAL_ENTROPY_ADC_CHANNEL
+#define HAL_ENTROPY_ADC_CHANNEL         (0)
+#endif
+
+/** Samples run through the health tests and discarded before first use (SP 800-90B 4.3). */
+#define HAL_ENTROPY_STARTUP_SAMPLES     (1024)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************//**
+ * \fn	ATCA_STATUS hal_entropy_restart(void)
+ *
+ * \brief	Clears a latched health test failure and repeats the start-up tests. Call after the
+ * 			noise source has been checked, hal_random_number() refuses to run until then.
+ *
+ * \return	ATCA_SUCCESS if the start-up tests pass, ATCA_FUNC_FAIL otherwise
+ **************************************************************************************************/
+ATCA_STATUS hal_entropy_restart(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif /* HAL_ENTROPY_H_ */
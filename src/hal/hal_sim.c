@@ -0,0 +1,1158 @@
+/**
+ * \file
+ * \brief Software ATECC508A / ATSHA204A device simulator HAL for host builds.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#if !defined(__AVR__) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L         // nanosleep()
+#endif
+
+#include <string.h>
+#include "atca_hal.h"
+
+#ifdef ATCA_HAL_SIM
+
+#include "hal_sim.h"
+#include "atca_command.h"
+#include "host/atca_host.h"
+#include "crypto/atca_crypto_sw_sha2.h"
+#include "crypto/atca_crypto_sw_ecdsa.h"
+
+#if !defined(__AVR__)
+#include <time.h>
+#endif
+
+/* The simulator answers every command the way the silicon does, but from RAM: a command is
+   executed as soon as it is sent, and its response only becomes readable once the simulated
+   clock has moved past the typical execution time in the command table of atca_command.c. The
+   clock is advanced by the atca_delay functions, so the stack's own delays are what lets the
+   responses through. Keys are real, signatures and MACs verify against the host helpers.
+
+   Simulated: Nonce, Random, Read, Write (plain and encrypted), Lock, GenDig, MAC, Info, Pause and,
+   on the ATECCx08A, GenKey, Sign (external message), Verify (external and stored keys) and the
+   SHA-256 modes of SHA. Anything else answers with a parse error. */
+
+// Configuration zone fields shared by the ATECC508A and ATSHA204A
+#define SIM_CFG_REVNUM          (4)
+#define SIM_CFG_SN_4            (8)
+#define SIM_CFG_I2C_ENABLE      (14)
+#define SIM_CFG_I2C_ADDRESS     (16)
+#define SIM_CFG_OTP_MODE        (18)
+#define SIM_CFG_SLOT_CONFIG     (20)
+#define SIM_CFG_SELECTOR        (85)
+#define SIM_CFG_LOCK_VALUE      (86)
+#define SIM_CFG_LOCK_CONFIG     (87)
+#define SIM_CFG_SLOT_LOCKED     (88)
+#define SIM_CFG_KEY_CONFIG      (96)
+#define SIM_CFG_WRITABLE        (16)        // bytes 0-15 are factory programmed
+#define SIM_CFG_UPDATE_ONLY     (84)        // bytes 84-87 change through UpdateExtra and Lock only
+#define SIM_UNLOCKED            (0x55)
+
+// SlotConfig and KeyConfig fields
+#define SIM_SLOT_READ_KEY(c)        ((c) & 0x0F)
+#define SIM_SLOT_ENCRYPT_READ       (0x0040)
+#define SIM_SLOT_IS_SECRET          (0x0080)
+#define SIM_SLOT_WRITE_KEY(c)       (((c) >> 8) & 0x0F)
+#define SIM_SLOT_WRITE_CONFIG(c)    (((c) >> 12) & 0x0F)
+#define SIM_WRITE_GENKEY            (0x02)  // WriteConfig bit allowing GenKey on a locked slot
+#define SIM_KEY_PRIVATE             (0x0001)
+#define SIM_KEY_TYPE(c)             (((c) >> 2) & 0x07)
+#define SIM_KEY_TYPE_P256           (4)
+#define SIM_KEY_LOCKABLE            (0x0020)
+
+#define SIM_PRIV_PAD                (4)     // zero bytes stored ahead of a P256 private key
+#define SIM_PUB_PAD                 (4)     // zero bytes stored ahead of each public key coordinate
+
+/** \brief Power state of a simulated device */
+typedef enum {
+	SIM_SLEEP,
+	SIM_IDLE,
+	SIM_AWAKE
+} hal_sim_power_t;
+
+/** \brief State of one simulated device */
+typedef struct {
+	bool               powered;                         //!< Zones hold a factory image
+	ATCADeviceType     devtype;                         //!< Device being simulated
+	ATCACommand        commands;                        //!< Execution times for devtype
+	uint32_t           seed;                            //!< Seed of the key and random number generator
+	bool               provisioned;                     //!< Factory image has locked zones and keys
+	uint32_t           baud;                            //!< Bus speed used to charge transfer time, 0 for none
+	hal_sim_power_t    power;
+	uint64_t           wake_time;                       //!< Time of the last wake, for the watchdog
+	uint64_t           ready_time;                      //!< Time the current command completes
+	uint8_t            config[ATCA_CONFIG_SIZE];
+	uint8_t            otp[ATCA_OTP_SIZE];
+	uint8_t            data[HAL_SIM_DATA_SIZE];
+	atca_temp_key_t    temp_key;
+	atcac_sha2_256_ctx sha_ctx;
+	bool               sha_started;
+	uint8_t            rng_key[ATCA_SHA2_256_DIGEST_SIZE];
+	uint32_t           rng_counter;
+	uint8_t            response[ATCA_RSP_SIZE_MAX];     //!< Output buffer, count byte 0 when empty
+} hal_sim_device_t;
+
+static hal_sim_device_t g_sim_devices[HAL_SIM_MAX_DEVICES];
+static uint64_t g_sim_clock_us;
+static bool g_sim_realtime;
+
+/** \brief Slot layout of the factory image, matching the slots eGuard uses: 0, 2 and 3 hold
+ *         P256 private keys, 1 the symmetric key, 10-12 certificates and 13 the root public key */
+static const uint16_t sim_slot_config_x08a[16] = {
+	0x208F, 0x808F, 0x208F, 0x208F, 0x0000, 0x0000, 0x0000, 0x0000,
+	0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+};
+static const uint16_t sim_key_config_x08a[16] = {
+	0x0033, 0x003C, 0x0033, 0x0033, 0x003C, 0x003C, 0x003C, 0x003C,
+	0x003C, 0x003C, 0x003C, 0x003C, 0x003C, 0x0030, 0x003C, 0x003C
+};
+static const uint16_t sim_slot_config_204a[16] = {
+	0x808F, 0x808F, 0x808F, 0x808F, 0x808F, 0x808F, 0x808F, 0x808F,
+	0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+};
+static const uint8_t sim_revision_x08a[4] = { 0x00, 0x00, 0x50, 0x00 };
+static const uint8_t sim_revision_204a[4] = { 0x00, 0x02, 0x00, 0x09 };
+
+static bool hal_sim_is_ecc(const hal_sim_device_t* dev)
+{
+	return dev->devtype != ATSHA204A;
+}
+
+static uint16_t hal_sim_config_size(const hal_sim_device_t* dev)
+{
+	return hal_sim_is_ecc(dev) ? ATCA_CONFIG_SIZE : ATCA_SHA_CONFIG_SIZE;
+}
+
+static uint16_t hal_sim_data_size(const hal_sim_device_t* dev)
+{
+	return hal_sim_is_ecc(dev) ? HAL_SIM_DATA_SIZE : ATCA_KEY_COUNT * ATCA_KEY_SIZE;
+}
+
+static uint16_t hal_sim_slot_size(const hal_sim_device_t* dev, uint8_t slot)
+{
+	if (!hal_sim_is_ecc(dev))
+		return ATCA_KEY_SIZE;
+	if (slot < 8)
+		return ATCA_KEY_SLOT_SIZE;
+	if (slot == 8)
+		return ATCA_MAX_SLOT_SIZE;
+	return ATCA_PUB_KEY_SIZE + 2 * SIM_PUB_PAD;
+}
+
+static uint8_t* hal_sim_slot(hal_sim_device_t* dev, uint8_t slot)
+{
+	if (!hal_sim_is_ecc(dev))
+		return &dev->data[slot * ATCA_KEY_SIZE];
+	if (slot <= 8)
+		return &dev->data[slot * ATCA_KEY_SLOT_SIZE];
+	return &dev->data[8 * ATCA_KEY_SLOT_SIZE + ATCA_MAX_SLOT_SIZE + (slot - 9) * (ATCA_PUB_KEY_SIZE + 2 * SIM_PUB_PAD)];
+}
+
+static uint16_t hal_sim_slot_config(const hal_sim_device_t* dev, uint8_t slot)
+{
+	return dev->config[SIM_CFG_SLOT_CONFIG + 2 * slot] | (dev->config[SIM_CFG_SLOT_CONFIG + 2 * slot + 1] << 8);
+}
+
+static uint16_t hal_sim_key_config(const hal_sim_device_t* dev, uint8_t slot)
+{
+	if (!hal_sim_is_ecc(dev))
+		return 0;
+	return dev->config[SIM_CFG_KEY_CONFIG + 2 * slot] | (dev->config[SIM_CFG_KEY_CONFIG + 2 * slot + 1] << 8);
+}
+
+static bool hal_sim_is_private(const hal_sim_device_t* dev, uint8_t slot)
+{
+	uint16_t key_config = hal_sim_key_config(dev, slot);
+
+	return (key_config & SIM_KEY_PRIVATE) && SIM_KEY_TYPE(key_config) == SIM_KEY_TYPE_P256;
+}
+
+static bool hal_sim_config_locked(const hal_sim_device_t* dev)
+{
+	return dev->config[SIM_CFG_LOCK_CONFIG] != SIM_UNLOCKED;
+}
+
+static bool hal_sim_data_locked(const hal_sim_device_t* dev)
+{
+	return dev->config[SIM_CFG_LOCK_VALUE] != SIM_UNLOCKED;
+}
+
+static bool hal_sim_slot_locked(const hal_sim_device_t* dev, uint8_t slot)
+{
+	uint16_t slot_locked;
+
+	if (!hal_sim_is_ecc(dev))
+		return false;
+	slot_locked = dev->config[SIM_CFG_SLOT_LOCKED] | (dev->config[SIM_CFG_SLOT_LOCKED + 1] << 8);
+	return (slot_locked & (1 << slot)) == 0;
+}
+
+static void hal_sim_serial_number(const hal_sim_device_t* dev, uint8_t* sn)
+{
+	memcpy(&sn[0], &dev->config[0], 4);
+	memcpy(&sn[4], &dev->config[SIM_CFG_SN_4], 5);
+}
+
+/* CRC-16 of the command layer (polynomial 0x8005, bits in LSB first), continued from crc. Unlike
+   atCRC() it takes lengths over 255 bytes, for the Lock summaries. */
+static uint16_t hal_sim_crc(const uint8_t* data, size_t length, uint16_t crc)
+{
+	size_t i;
+	uint8_t mask;
+
+	for (i = 0; i < length; i++) {
+		for (mask = CRC_SHIFT1; mask > CRC_SHIFT0; mask <<= MAXSHIFT) {
+			if (((data[i] & mask) ? 1 : 0) != (crc >> ENDSHIFT))
+				crc = (crc << MAXSHIFT) ^ CRC_POLYNOM;
+			else
+				crc <<= MAXSHIFT;
+		}
+	}
+	return crc;
+}
+
+/* Device random number: counter mode SHA-256 over the per-device seed so that runs repeat.
+   Before the configuration zone is locked the silicon returns a fixed FF FF 00 00 pattern. */
+static void hal_sim_random(hal_sim_device_t* dev, uint8_t* random)
+{
+	atcac_sha2_256_ctx ctx;
+	uint8_t counter[4];
+	uint8_t i;
+
+	if (!hal_sim_config_locked(dev)) {
+		for (i = 0; i < RANDOM_NUM_SIZE; i++)
+			random[i] = (i & 0x02) ? 0x00 : 0xFF;
+		return;
+	}
+
+	counter[0] = (uint8_t)(dev->rng_counter);
+	counter[1] = (uint8_t)(dev->rng_counter >> 8);
+	counter[2] = (uint8_t)(dev->rng_counter >> 16);
+	counter[3] = (uint8_t)(dev->rng_counter >> 24);
+	dev->rng_counter++;
+
+	atcac_sw_sha2_256_init(&ctx);
+	atcac_sw_sha2_256_update(&ctx, dev->rng_key, sizeof(dev->rng_key));
+	atcac_sw_sha2_256_update(&ctx, counter, sizeof(counter));
+	atcac_sw_sha2_256_finish(&ctx, random);
+}
+
+/* Generates a P256 private key into slot and returns its public key. */
+static bool hal_sim_generate_key(hal_sim_device_t* dev, uint8_t slot, uint8_t* public_key)
+{
+	uint8_t* key = hal_sim_slot(dev, slot);
+
+	memset(key, 0, SIM_PRIV_PAD);
+	do {
+		hal_sim_random(dev, &key[SIM_PRIV_PAD]);
+	} while (!ecc_make_public_key_sw(&key[SIM_PRIV_PAD], public_key));
+
+	return true;
+}
+
+/* Drops everything held in SRAM, as sleep and the watchdog do. */
+static void hal_sim_clear_volatile(hal_sim_device_t* dev)
+{
+	memset(&dev->temp_key, 0, sizeof(dev->temp_key));
+	dev->sha_started = false;
+	dev->response[ATCA_COUNT_IDX] = 0;
+}
+
+/* Loads the factory image. A provisioned image has both zones locked and fresh keys in the
+   private and secret slots, otherwise the zones are unlocked and the data zone erased. */
+static void hal_sim_power_up(hal_sim_device_t* dev)
+{
+	const uint16_t* slot_config = hal_sim_is_ecc(dev) ? sim_slot_config_x08a : sim_slot_config_204a;
+	uint8_t public_key[ATCA_PUB_KEY_SIZE];
+	uint8_t seed[4];
+	uint8_t slot;
+
+	seed[0] = (uint8_t)(dev->seed);
+	seed[1] = (uint8_t)(dev->seed >> 8);
+	seed[2] = (uint8_t)(dev->seed >> 16);
+	seed[3] = (uint8_t)(dev->seed >> 24);
+	atcac_sw_sha2_256(seed, sizeof(seed), dev->rng_key);
+	dev->rng_counter = 0;
+
+	memset(dev->config, 0, sizeof(dev->config));
+	dev->config[0] = ATCA_SN_0;
+	dev->config[1] = ATCA_SN_1;
+	dev->config[2] = dev->rng_key[0];
+	dev->config[3] = dev->rng_key[1];
+	memcpy(&dev->config[SIM_CFG_REVNUM], hal_sim_is_ecc(dev) ? sim_revision_x08a : sim_revision_204a, 4);
+	memcpy(&dev->config[SIM_CFG_SN_4], &dev->rng_key[2], 4);
+	dev->config[SIM_CFG_SN_4 + 4] = ATCA_SN_8;
+	dev->config[SIM_CFG_I2C_ENABLE] = 0x01;
+	dev->config[SIM_CFG_I2C_ADDRESS] = 0xC0;
+	dev->config[SIM_CFG_OTP_MODE] = 0xAA;
+	for (slot = 0; slot < ATCA_KEY_COUNT; slot++) {
+		dev->config[SIM_CFG_SLOT_CONFIG + 2 * slot] = (uint8_t)slot_config[slot];
+		dev->config[SIM_CFG_SLOT_CONFIG + 2 * slot + 1] = (uint8_t)(slot_config[slot] >> 8);
+		if (hal_sim_is_ecc(dev)) {
+			dev->config[SIM_CFG_KEY_CONFIG + 2 * slot] = (uint8_t)sim_key_config_x08a[slot];
+			dev->config[SIM_CFG_KEY_CONFIG + 2 * slot + 1] = (uint8_t)(sim_key_config_x08a[slot] >> 8);
+		}
+	}
+	if (hal_sim_is_ecc(dev)) {
+		memset(&dev->config[52], 0xFF, 32);                 // Counter[0..1] and LastKeyUse
+		dev->config[SIM_CFG_SLOT_LOCKED] = 0xFF;
+		dev->config[SIM_CFG_SLOT_LOCKED + 1] = 0xFF;
+	}
+	dev->config[SIM_CFG_LOCK_VALUE] = SIM_UNLOCKED;
+	dev->config[SIM_CFG_LOCK_CONFIG] = SIM_UNLOCKED;
+
+	memset(dev->otp, 0, sizeof(dev->otp));
+	memset(dev->data, 0xFF, sizeof(dev->data));
+
+	if (dev->provisioned) {
+		dev->config[SIM_CFG_LOCK_CONFIG] = 0x00;            // hal_sim_random() needs the lock
+		memset(dev->data, 0, sizeof(dev->data));
+		for (slot = 0; slot < ATCA_KEY_COUNT; slot++) {
+			if (hal_sim_is_private(dev, slot))
+				hal_sim_generate_key(dev, slot, public_key);
+			else if (hal_sim_slot_config(dev, slot) & SIM_SLOT_IS_SECRET)
+				hal_sim_random(dev, hal_sim_slot(dev, slot));
+		}
+		dev->config[SIM_CFG_LOCK_VALUE] = 0x00;
+	}
+
+	hal_sim_clear_volatile(dev);
+	dev->power = SIM_SLEEP;
+	dev->ready_time = 0;
+	dev->powered = true;
+}
+
+/* Puts the device to sleep once tWATCHDOG has passed since it woke up. */
+static void hal_sim_watchdog(hal_sim_device_t* dev)
+{
+	if (dev->power == SIM_AWAKE && g_sim_clock_us - dev->wake_time >= HAL_SIM_WATCHDOG_US) {
+		dev->power = SIM_SLEEP;
+		hal_sim_clear_volatile(dev);
+	}
+}
+
+/* Charges bus transfer time, 9 clocks per byte including the acknowledge. */
+static void hal_sim_bus(const hal_sim_device_t* dev, uint16_t bytes)
+{
+	if (dev->baud != 0)
+		g_sim_clock_us += ((uint64_t)bytes * 9 * 1000000UL) / dev->baud;
+}
+
+/* Resolves a Read/Write address to zone storage, NULL if it lies outside the zone or slot. A 32 byte
+   access may start in the last, partial block of a slot (the public key layout of the 72 byte slots
+   relies on it), length is cut to the bytes that exist. */
+static uint8_t* hal_sim_address(hal_sim_device_t* dev, uint8_t zone, uint16_t address, uint8_t* length, uint8_t* slot)
+{
+	uint16_t offset = (address & 0x07) * ATCA_WORD_SIZE;
+	uint16_t size;
+	uint8_t* base;
+
+	switch (zone & ATCA_ZONE_MASK) {
+	case ATCA_ZONE_CONFIG:
+		offset += ((address >> 3) & 0x03) * ATCA_BLOCK_SIZE;
+		base = dev->config;
+		size = hal_sim_config_size(dev);
+		break;
+	case ATCA_ZONE_OTP:
+		offset += ((address >> 3) & 0x01) * ATCA_BLOCK_SIZE;
+		base = dev->otp;
+		size = ATCA_OTP_SIZE;
+		break;
+	case ATCA_ZONE_DATA:
+		*slot = (address >> 3) & 0x0F;
+		offset += (address >> 8) * ATCA_BLOCK_SIZE;
+		base = hal_sim_slot(dev, *slot);
+		size = hal_sim_slot_size(dev, *slot);
+		break;
+	default:
+		return NULL;
+	}
+
+	if (offset >= size)
+		return NULL;
+	if (offset + *length > size)
+		*length = (uint8_t)(size - offset);
+	return base + offset;
+}
+
+static uint8_t hal_sim_nonce(hal_sim_device_t* dev, uint8_t param1, const uint8_t* data, uint8_t length, uint8_t* out, uint8_t* out_length)
+{
+	atca_nonce_in_out_t nonce;
+	uint8_t mode = param1 & NONCE_MODE_MASK;
+
+	nonce.mode = mode;
+	nonce.num_in = data;
+	nonce.rand_out = out;
+	nonce.temp_key = &dev->temp_key;
+
+	if (mode == NONCE_MODE_PASSTHROUGH) {
+		if (length != NONCE_NUMIN_SIZE_PASSTHROUGH)
+			return CMD_STATUS_BYTE_PARSE;
+	}else if (mode == NONCE_MODE_SEED_UPDATE || mode == NONCE_MODE_NO_SEED_UPDATE) {
+		if (length != NONCE_NUMIN_SIZE)
+			return CMD_STATUS_BYTE_PARSE;
+		hal_sim_random(dev, out);
+		*out_length = RANDOM_NUM_SIZE;
+	}else
+		return CMD_STATUS_BYTE_PARSE;
+
+	return (atcah_nonce(&nonce) == ATCA_SUCCESS) ? CMD_STATUS_SUCCESS : CMD_STATUS_BYTE_PARSE;
+}
+
+static uint8_t hal_sim_mac(hal_sim_device_t* dev, uint8_t param1, uint16_t param2, const uint8_t* data, uint8_t length, uint8_t* out, uint8_t* out_length)
+{
+	struct atca_mac_in_out mac;
+	uint8_t sn[ATCA_SERIAL_NUM_SIZE];
+	ATCA_STATUS status;
+
+	if ((param1 & ~MAC_MODE_MASK) || param2 > ATCA_KEY_ID_MAX)
+		return CMD_STATUS_BYTE_PARSE;
+	if (length != ((param1 & MAC_MODE_BLOCK2_TEMPKEY) ? 0 : MAC_CHALLENGE_SIZE))
+		return CMD_STATUS_BYTE_PARSE;
+	if (hal_sim_is_private(dev, (uint8_t)param2))
+		return CMD_STATUS_BYTE_EXEC;
+
+	hal_sim_serial_number(dev, sn);
+	mac.mode = param1;
+	mac.key_id = param2;
+	mac.challenge = data;
+	mac.key = hal_sim_slot(dev, (uint8_t)param2);
+	mac.otp = dev->otp;
+	mac.sn = sn;
+	mac.response = out;
+	mac.temp_key = &dev->temp_key;
+
+	status = atcah_mac(&mac);
+	if (status == ATCA_EXECUTION_ERROR)
+		return CMD_STATUS_BYTE_EXEC;
+	if (status != ATCA_SUCCESS)
+		return CMD_STATUS_BYTE_PARSE;
+
+	*out_length = MAC_SIZE;
+	return CMD_STATUS_SUCCESS;
+}
+
+static uint8_t hal_sim_gendig(hal_sim_device_t* dev, uint8_t param1, uint16_t param2, uint8_t length)
+{
+	atca_gen_dig_in_out_t gen_dig;
+
+	// Four bytes of other data are accepted and ignored, shared nonce mode is not simulated
+	if (length != 0 && length != ATCA_WORD_SIZE)
+		return CMD_STATUS_BYTE_PARSE;
+
+	gen_dig.zone = param1;
+	gen_dig.key_id = param2;
+	gen_dig.temp_key = &dev->temp_key;
+
+	switch (param1) {
+	case GENDIG_ZONE_CONFIG:
+		if (param2 * ATCA_BLOCK_SIZE + ATCA_BLOCK_SIZE > hal_sim_config_size(dev))
+			return CMD_STATUS_BYTE_PARSE;
+		gen_dig.stored_value = &dev->config[param2 * ATCA_BLOCK_SIZE];
+		break;
+	case GENDIG_ZONE_OTP:
+		if (param2 * ATCA_BLOCK_SIZE + ATCA_BLOCK_SIZE > ATCA_OTP_SIZE)
+			return CMD_STATUS_BYTE_PARSE;
+		gen_dig.stored_value = &dev->otp[param2 * ATCA_BLOCK_SIZE];
+		break;
+	case GENDIG_ZONE_DATA:
+		if (param2 > ATCA_KEY_ID_MAX)
+			return CMD_STATUS_BYTE_PARSE;
+		if (hal_sim_is_private(dev, (uint8_t)param2))
+			return CMD_STATUS_BYTE_EXEC;
+		gen_dig.stored_value = hal_sim_slot(dev, (uint8_t)param2);
+		break;
+	default:
+		return CMD_STATUS_BYTE_PARSE;
+	}
+
+	if (atcah_gen_dig(&gen_dig) != ATCA_SUCCESS)
+		return CMD_STATUS_BYTE_EXEC;
+
+	dev->temp_key.gen_data = (param1 == GENDIG_ZONE_DATA);
+	dev->temp_key.key_id = param2 & 0x0F;
+	return CMD_STATUS_SUCCESS;
+}
+
+static uint8_t hal_sim_sign(hal_sim_device_t* dev, uint8_t param1, uint16_t param2, uint8_t* out, uint8_t* out_length)
+{
+	// Internal messages (GenDig of slots plus the config fields) are not simulated
+	if ((param1 & SIGN_MODE_EXTERNAL) == 0 || param2 > ATCA_KEY_ID_MAX)
+		return CMD_STATUS_BYTE_PARSE;
+	if (!hal_sim_is_private(dev, (uint8_t)param2) || !dev->temp_key.valid)
+		return CMD_STATUS_BYTE_EXEC;
+
+	if (!ecdsa_sign_deterministic_sw(hal_sim_slot(dev, (uint8_t)param2) + SIM_PRIV_PAD, dev->temp_key.value, out))
+		return CMD_STATUS_BYTE_EXEC;
+
+	*out_length = ATCA_SIG_SIZE;
+	return CMD_STATUS_SUCCESS;
+}
+
+static uint8_t hal_sim_verify(hal_sim_device_t* dev, uint8_t param1, uint16_t param2, const uint8_t* data, uint8_t length)
+{
+	uint8_t public_key[ATCA_PUB_KEY_SIZE];
+	uint8_t* slot;
+
+	switch (param1) {
+	case VERIFY_MODE_EXTERNAL:
+		if (param2 != VERIFY_KEY_P256 || length != VERIFY_256_SIGNATURE_SIZE + VERIFY_256_KEY_SIZE)
+			return CMD_STATUS_BYTE_PARSE;
+		memcpy(public_key, &data[VERIFY_256_SIGNATURE_SIZE], ATCA_PUB_KEY_SIZE);
+		break;
+	case VERIFY_MODE_STORED:
+		if (param2 > ATCA_KEY_ID_MAX || length != VERIFY_256_SIGNATURE_SIZE)
+			return CMD_STATUS_BYTE_PARSE;
+		if (hal_sim_is_private(dev, (uint8_t)param2) || SIM_KEY_TYPE(hal_sim_key_config(dev, (uint8_t)param2)) != SIM_KEY_TYPE_P256
+		    || hal_sim_slot_size(dev, (uint8_t)param2) < ATCA_PUB_KEY_SIZE + 2 * SIM_PUB_PAD)
+			return CMD_STATUS_BYTE_EXEC;
+		slot = hal_sim_slot(dev, (uint8_t)param2);
+		memcpy(&public_key[0], &slot[SIM_PUB_PAD], ATCA_PUB_KEY_SIZE / 2);
+		memcpy(&public_key[ATCA_PUB_KEY_SIZE / 2], &slot[2 * SIM_PUB_PAD + ATCA_PUB_KEY_SIZE / 2], ATCA_PUB_KEY_SIZE / 2);
+		break;
+	default:
+		return CMD_STATUS_BYTE_PARSE;
+	}
+
+	if (!dev->temp_key.valid)
+		return CMD_STATUS_BYTE_EXEC;
+
+	return ecdsa_verify_sw(public_key, dev->temp_key.value, data) ? CMD_STATUS_SUCCESS : CHECKMAC_CMD_MISMATCH;
+}
+
+static uint8_t hal_sim_sha(hal_sim_device_t* dev, uint8_t param1, uint16_t param2, const uint8_t* data, uint8_t length, uint8_t* out, uint8_t* out_length)
+{
+	switch (param1) {
+	case SHA_SHA256_START_MASK:
+		atcac_sw_sha2_256_init(&dev->sha_ctx);
+		dev->sha_started = true;
+		break;
+	case SHA_SHA256_UPDATE_MASK:
+		if (length != SHA_BLOCK_SIZE)
+			return CMD_STATUS_BYTE_PARSE;
+		if (!dev->sha_started)
+			return CMD_STATUS_BYTE_EXEC;
+		atcac_sw_sha2_256_update(&dev->sha_ctx, data, length);
+		break;
+	case SHA_SHA256_END_MASK:
+		if (length != param2 || length >= SHA_BLOCK_SIZE)
+			return CMD_STATUS_BYTE_PARSE;
+		if (!dev->sha_started)
+			return CMD_STATUS_BYTE_EXEC;
+		atcac_sw_sha2_256_update(&dev->sha_ctx, data, length);
+		atcac_sw_sha2_256_finish(&dev->sha_ctx, out);
+		dev->sha_started = false;
+		*out_length = ATCA_SHA_DIGEST_SIZE;
+		break;
+	default:
+		return CMD_STATUS_BYTE_PARSE;
+	}
+
+	return CMD_STATUS_SUCCESS;
+}
+
+static uint8_t hal_sim_read(hal_sim_device_t* dev, uint8_t param1, uint16_t param2, uint8_t* out, uint8_t* out_length)
+{
+	uint8_t zone = param1 & ATCA_ZONE_MASK;
+	uint8_t length = (param1 & ATCA_ZONE_READWRITE_32) ? ATCA_BLOCK_SIZE : ATCA_WORD_SIZE;
+	uint8_t available = length;
+	uint8_t slot = 0;
+	uint16_t slot_config;
+	uint8_t* source;
+	uint8_t i;
+
+	if ((param1 & ~(ATCA_ZONE_READWRITE_32 | ATCA_ZONE_MASK)) || zone == ATCA_ZONE_MASK)
+		return CMD_STATUS_BYTE_PARSE;
+	if ((source = hal_sim_address(dev, zone, param2, &available, &slot)) == NULL)
+		return CMD_STATUS_BYTE_PARSE;
+
+	if (zone != ATCA_ZONE_CONFIG && !hal_sim_data_locked(dev))
+		return CMD_STATUS_BYTE_EXEC;
+
+	memset(out, 0, length);
+	memcpy(out, source, available);
+	*out_length = length;
+
+	if (zone == ATCA_ZONE_DATA) {
+		slot_config = hal_sim_slot_config(dev, slot);
+		if (hal_sim_is_private(dev, slot))
+			return CMD_STATUS_BYTE_EXEC;
+		if (slot_config & SIM_SLOT_IS_SECRET) {
+			// Secret slots are only readable encrypted, with TempKey from a GenDig of ReadKey
+			if (!(slot_config & SIM_SLOT_ENCRYPT_READ) || length != ATCA_BLOCK_SIZE || !dev->temp_key.valid
+			    || !dev->temp_key.gen_data || dev->temp_key.key_id != SIM_SLOT_READ_KEY(slot_config)) {
+				*out_length = 0;
+				return CMD_STATUS_BYTE_EXEC;
+			}
+			for (i = 0; i < ATCA_BLOCK_SIZE; i++)
+				out[i] ^= dev->temp_key.value[i];
+		}
+	}
+
+	return CMD_STATUS_SUCCESS;
+}
+
+static uint8_t hal_sim_write(hal_sim_device_t* dev, uint8_t param1, uint16_t param2, const uint8_t* data, uint8_t length)
+{
+	uint8_t zone = param1 & ATCA_ZONE_MASK;
+	uint8_t size = (param1 & ATCA_ZONE_READWRITE_32) ? ATCA_BLOCK_SIZE : ATCA_WORD_SIZE;
+	uint8_t available = size;
+	bool encrypted = (length == size + WRITE_MAC_SIZE);    // the ATECCx08A goes by the input size, not zone bit 6
+	atca_gen_dig_in_out_t gen_mac;
+	atca_temp_key_t mac_key;
+	uint8_t plain[ATCA_BLOCK_SIZE];
+	uint8_t keep[ATCA_WORD_SIZE];
+	uint16_t slot_config;
+	uint8_t write_config;
+	uint8_t slot = 0;
+	uint8_t* target;
+	uint16_t offset;
+	uint8_t i;
+
+	if ((param1 & ~WRITE_ZONE_MASK) || zone == ATCA_ZONE_MASK)
+		return CMD_STATUS_BYTE_PARSE;
+	if (length != size && !encrypted)
+		return CMD_STATUS_BYTE_PARSE;
+	if ((target = hal_sim_address(dev, zone, param2, &available, &slot)) == NULL)
+		return CMD_STATUS_BYTE_PARSE;
+	memcpy(plain, data, size);
+
+	if (zone == ATCA_ZONE_CONFIG) {
+		offset = (uint16_t)(target - dev->config);
+		if (hal_sim_config_locked(dev) || encrypted || offset < SIM_CFG_WRITABLE)
+			return CMD_STATUS_BYTE_EXEC;
+		// UserExtra, Selector and the lock bytes are left alone
+		memcpy(keep, &dev->config[SIM_CFG_UPDATE_ONLY], sizeof(keep));
+		memcpy(target, plain, available);
+		memcpy(&dev->config[SIM_CFG_UPDATE_ONLY], keep, sizeof(keep));
+		return CMD_STATUS_SUCCESS;
+	}
+
+	if (!hal_sim_config_locked(dev))
+		return CMD_STATUS_BYTE_EXEC;
+
+	if (hal_sim_data_locked(dev)) {
+		// OTP is read-only once locked, data slots follow WriteConfig
+		if (zone == ATCA_ZONE_OTP || hal_sim_slot_locked(dev, slot) || hal_sim_is_private(dev, slot))
+			return CMD_STATUS_BYTE_EXEC;
+		slot_config = hal_sim_slot_config(dev, slot);
+		write_config = SIM_SLOT_WRITE_CONFIG(slot_config);
+		if (encrypted) {
+			if ((write_config & 0x0C) != 0x04 || size != ATCA_BLOCK_SIZE || !dev->temp_key.valid
+			    || !dev->temp_key.gen_data || dev->temp_key.key_id != SIM_SLOT_WRITE_KEY(slot_config))
+				return CMD_STATUS_BYTE_EXEC;
+			for (i = 0; i < ATCA_BLOCK_SIZE; i++)
+				plain[i] ^= dev->temp_key.value[i];
+
+			mac_key = dev->temp_key;
+			gen_mac.zone = param1;
+			gen_mac.key_id = param2;
+			gen_mac.stored_value = plain;
+			gen_mac.temp_key = &mac_key;
+			dev->temp_key.valid = 0;
+			if (atcah_gen_mac(&gen_mac) != ATCA_SUCCESS || memcmp(mac_key.value, &data[size], WRITE_MAC_SIZE) != 0)
+				return CMD_STATUS_BYTE_EXEC;
+		}else if (write_config > 0x01)
+			return CMD_STATUS_BYTE_EXEC;
+	}else if (encrypted)
+		return CMD_STATUS_BYTE_EXEC;
+
+	memcpy(target, plain, available);
+	return CMD_STATUS_SUCCESS;
+}
+
+static uint8_t hal_sim_lock(hal_sim_device_t* dev, uint8_t param1, uint16_t param2)
+{
+	uint8_t mode = param1 & ~LOCK_ZONE_NO_CRC;
+	bool check_crc = (param1 & LOCK_ZONE_NO_CRC) == 0;
+	uint8_t slot = (mode >> 2) & 0x0F;
+	uint16_t crc;
+
+	switch (mode & 0x03) {
+	case LOCK_ZONE_CONFIG:
+		if (mode != LOCK_ZONE_CONFIG)
+			return CMD_STATUS_BYTE_PARSE;
+		if (hal_sim_config_locked(dev))
+			return CMD_STATUS_BYTE_EXEC;
+		crc = hal_sim_crc(dev->config, hal_sim_config_size(dev), 0);
+		if (check_crc && crc != param2)
+			return CMD_STATUS_BYTE_EXEC;
+		dev->config[SIM_CFG_LOCK_CONFIG] = 0x00;
+		break;
+	case LOCK_ZONE_DATA:
+		if (mode != LOCK_ZONE_DATA)
+			return CMD_STATUS_BYTE_PARSE;
+		if (!hal_sim_config_locked(dev) || hal_sim_data_locked(dev))
+			return CMD_STATUS_BYTE_EXEC;
+		crc = hal_sim_crc(dev->data, hal_sim_data_size(dev), 0);
+		crc = hal_sim_crc(dev->otp, ATCA_OTP_SIZE, crc);
+		if (check_crc && crc != param2)
+			return CMD_STATUS_BYTE_EXEC;
+		dev->config[SIM_CFG_LOCK_VALUE] = 0x00;
+		break;
+	case LOCK_ZONE_DATA_SLOT:
+		if (!hal_sim_is_ecc(dev))
+			return CMD_STATUS_BYTE_PARSE;
+		if (!hal_sim_data_locked(dev) || hal_sim_slot_locked(dev, slot) || !(hal_sim_key_config(dev, slot) & SIM_KEY_LOCKABLE))
+			return CMD_STATUS_BYTE_EXEC;
+		crc = hal_sim_crc(hal_sim_slot(dev, slot), hal_sim_slot_size(dev, slot), 0);
+		if (check_crc && crc != param2)
+			return CMD_STATUS_BYTE_EXEC;
+		dev->config[SIM_CFG_SLOT_LOCKED + slot / 8] &= ~(1 << (slot % 8));
+		break;
+	default:
+		return CMD_STATUS_BYTE_PARSE;
+	}
+
+	return CMD_STATUS_SUCCESS;
+}
+
+static uint8_t hal_sim_info(hal_sim_device_t* dev, uint8_t param1, uint16_t param2, uint8_t* out, uint8_t* out_length)
+{
+	switch (param1) {
+	case INFO_MODE_REVISION:
+		memcpy(out, &dev->config[SIM_CFG_REVNUM], INFO_SIZE);
+		break;
+	case INFO_MODE_KEY_VALID:
+		if (!hal_sim_is_ecc(dev) || param2 > ATCA_KEY_ID_MAX)
+			return CMD_STATUS_BYTE_PARSE;
+		memset(out, 0, INFO_SIZE);
+		out[0] = hal_sim_is_private(dev, (uint8_t)param2) ? 1 : 0;
+		break;
+	default:
+		return CMD_STATUS_BYTE_PARSE;
+	}
+
+	*out_length = INFO_SIZE;
+	return CMD_STATUS_SUCCESS;
+}
+
+static uint8_t hal_sim_genkey(hal_sim_device_t* dev, uint8_t param1, uint16_t param2, uint8_t* out, uint8_t* out_length)
+{
+	uint8_t slot = (uint8_t)param2;
+
+	// Public key digests are not simulated
+	if ((param1 & ~GENKEY_MODE_MASK) || (param1 & (GENKEY_MODE_DIGEST | GENKEY_MODE_ADD_DIGEST)) || param2 > ATCA_KEY_ID_MAX)
+		return CMD_STATUS_BYTE_PARSE;
+	if (!hal_sim_is_private(dev, slot))
+		return CMD_STATUS_BYTE_EXEC;
+
+	if (param1 & GENKEY_MODE_PRIVATE) {
+		if (!hal_sim_config_locked(dev) || hal_sim_slot_locked(dev, slot)
+		    || (hal_sim_data_locked(dev) && !(SIM_SLOT_WRITE_CONFIG(hal_sim_slot_config(dev, slot)) & SIM_WRITE_GENKEY)))
+			return CMD_STATUS_BYTE_EXEC;
+		hal_sim_generate_key(dev, slot, out);
+	}else if (!ecc_make_public_key_sw(hal_sim_slot(dev, slot) + SIM_PRIV_PAD, out))
+		return CMD_STATUS_BYTE_EXEC;
+
+	*out_length = ATCA_PUB_KEY_SIZE;
+	return CMD_STATUS_SUCCESS;
+}
+
+/* Maps an opcode to its execution time entry, CMD_LASTCOMMAND when the device does not simulate it. */
+static ATCA_CmdMap hal_sim_command(const hal_sim_device_t* dev, uint8_t opcode)
+{
+	ATCA_CmdMap command = atGetCmdMap(opcode);
+
+	switch (command) {
+	case CMD_GENDIG:
+	case CMD_INFO:
+	case CMD_LOCK:
+	case CMD_MAC:
+	case CMD_NONCE:
+	case CMD_PAUSE:
+	case CMD_RANDOM:
+	case CMD_READMEM:
+	case CMD_WRITEMEM:
+		return command;
+	case CMD_GENKEY:
+	case CMD_SHA:
+	case CMD_SIGN:
+	case CMD_VERIFY:
+		return hal_sim_is_ecc(dev) ? command : CMD_LASTCOMMAND;
+	default:
+		return CMD_LASTCOMMAND;
+	}
+}
+
+/* Runs one command packet ([count][opcode][param1][param2][data][crc]) and fills the output
+   buffer. Returns the execution time in milliseconds. */
+static uint16_t hal_sim_execute(hal_sim_device_t* dev, const uint8_t* packet)
+{
+	uint8_t count = packet[ATCA_COUNT_IDX];
+	uint8_t opcode = packet[ATCA_OPCODE_IDX];
+	uint8_t param1 = packet[ATCA_PARAM1_IDX];
+	uint16_t param2 = packet[ATCA_PARAM2_IDX] | (packet[ATCA_PARAM2_IDX + 1] << 8);
+	const uint8_t* data = &packet[ATCA_DATA_IDX];
+	uint8_t length = count - ATCA_CMD_SIZE_MIN;
+	uint8_t* out = &dev->response[ATCA_RSP_DATA_IDX];
+	uint8_t out_length = 0;
+	uint8_t status = CMD_STATUS_BYTE_PARSE;
+	uint16_t exec_time = 0;
+	ATCA_CmdMap command;
+	uint8_t crc[ATCA_CRC_SIZE];
+
+	atCRC(count - ATCA_CRC_SIZE, (uint8_t*)packet, crc);
+	if (crc[0] != packet[count - ATCA_CRC_SIZE] || crc[1] != packet[count - 1])
+		status = CMD_STATUS_BYTE_COMM;
+	else if ((command = hal_sim_command(dev, opcode)) != CMD_LASTCOMMAND) {
+		exec_time = atGetExecTime(dev->commands, command);
+		switch (opcode) {
+		case ATCA_GENDIG:   status = hal_sim_gendig(dev, param1, param2, length); break;
+		case ATCA_GENKEY:   status = hal_sim_genkey(dev, param1, param2, out, &out_length); break;
+		case ATCA_INFO:     status = hal_sim_info(dev, param1, param2, out, &out_length); break;
+		case ATCA_LOCK:     status = hal_sim_lock(dev, param1, param2); break;
+		case ATCA_MAC:      status = hal_sim_mac(dev, param1, param2, data, length, out, &out_length); break;
+		case ATCA_NONCE:    status = hal_sim_nonce(dev, param1, data, length, out, &out_length); break;
+		case ATCA_READ:     status = hal_sim_read(dev, param1, param2, out, &out_length); break;
+		case ATCA_SHA:      status = hal_sim_sha(dev, param1, param2, data, length, out, &out_length); break;
+		case ATCA_SIGN:     status = hal_sim_sign(dev, param1, param2, out, &out_length); break;
+		case ATCA_VERIFY:   status = hal_sim_verify(dev, param1, param2, data, length); break;
+		case ATCA_WRITE:    status = hal_sim_write(dev, param1, param2, data, length); break;
+		case ATCA_RANDOM:
+			hal_sim_random(dev, out);
+			out_length = RANDOM_NUM_SIZE;
+			status = CMD_STATUS_SUCCESS;
+			break;
+		case ATCA_PAUSE:
+			// Every device but the selected one goes idle
+			if (param1 != dev->config[SIM_CFG_SELECTOR])
+				dev->power = SIM_IDLE;
+			status = CMD_STATUS_SUCCESS;
+			break;
+		}
+	}
+
+	if (status != CMD_STATUS_SUCCESS)
+		out_length = 0;
+	if (out_length == 0) {
+		out[0] = status;
+		out_length = 1;
+	}
+	dev->response[ATCA_COUNT_IDX] = out_length + ATCA_PACKET_OVERHEAD;
+	atCRC(out_length + ATCA_COUNT_SIZE, dev->response, &dev->response[out_length + ATCA_COUNT_SIZE]);
+
+	return exec_time;
+}
+
+/** \brief initialize a simulated device interface, powering the device up on first use
+ * \param[in] hal - opaque ptr to HAL data
+ * \param[in] cfg - interface configuration
+ */
+ATCA_STATUS hal_sim_init(void *hal, ATCAIfaceCfg *cfg)
+{
+	ATCAHAL_t *phal = (ATCAHAL_t*)hal;
+	hal_sim_device_t *dev;
+
+	if (cfg->atcasim.instance >= HAL_SIM_MAX_DEVICES)
+		return ATCA_BAD_PARAM;
+	if (cfg->devtype != ATECC508A && cfg->devtype != ATECC108A && cfg->devtype != ATSHA204A)
+		return ATCA_BAD_PARAM;
+
+	dev = &g_sim_devices[cfg->atcasim.instance];
+	if (!dev->powered || dev->devtype != cfg->devtype) {
+		if (dev->commands != NULL)
+			deleteATCACommand(&dev->commands);
+		if ((dev->commands = newATCACommand(cfg->devtype)) == NULL)
+			return ATCA_GEN_FAIL;
+		dev->devtype = cfg->devtype;
+		dev->seed = cfg->atcasim.seed ^ cfg->atcasim.instance;
+		dev->provisioned = cfg->atcasim.provisioned != 0;
+		hal_sim_power_up(dev);
+	}
+	dev->baud = cfg->atcasim.baud;
+
+	phal->hal_data = dev;
+
+	return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_sim_post_init(ATCAIface iface)
+{
+	(void)iface;
+	return ATCA_SUCCESS;
+}
+
+/** \brief send a command packet to the simulated device and execute it
+ * \param[in] iface     instance
+ * \param[in] txdata    ATCAPacket bytes, txdata[0] is the reserved word address byte
+ * \param[in] txlength  number of command bytes after the word address
+ */
+ATCA_STATUS hal_sim_send(ATCAIface iface, uint8_t *txdata, uint16_t txlength)
+{
+	hal_sim_device_t *dev = (hal_sim_device_t*)atgetifacehaldat(iface);
+	uint16_t exec_time;
+
+	txdata[0] = 0x03;   // word address value, command, as on the I2C bus
+	hal_sim_bus(dev, txlength + 1);
+	hal_sim_watchdog(dev);
+
+	// A sleeping, idle or busy device does not acknowledge its address
+	if (dev->power != SIM_AWAKE || g_sim_clock_us < dev->ready_time)
+		return ATCA_COMM_FAIL;
+
+	if (txlength < ATCA_CMD_SIZE_MIN || txlength > ATCA_CMD_SIZE_MAX || txdata[1] != txlength) {
+		dev->response[ATCA_COUNT_IDX] = ATCA_RSP_SIZE_MIN;
+		dev->response[ATCA_RSP_DATA_IDX] = CMD_STATUS_BYTE_COMM;
+		atCRC(ATCA_RSP_SIZE_MIN - ATCA_CRC_SIZE, dev->response, &dev->response[ATCA_RSP_SIZE_MIN - ATCA_CRC_SIZE]);
+		return ATCA_SUCCESS;
+	}
+
+	exec_time = hal_sim_execute(dev, &txdata[1]);
+	dev->ready_time = g_sim_clock_us + (uint64_t)exec_time * 1000;
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief read the response of the simulated device
+ * \param[in] iface     instance
+ * \param[out] rxdata   buffer for the response
+ * \param[in,out] rxlength  size of rxdata, number of bytes read
+ */
+ATCA_STATUS hal_sim_receive(ATCAIface iface, uint8_t *rxdata, uint16_t *rxlength)
+{
+	hal_sim_device_t *dev = (hal_sim_device_t*)atgetifacehaldat(iface);
+	uint16_t length = dev->response[ATCA_COUNT_IDX];
+	ATCARetryState retry;
+
+	// A busy or sleeping device NACKs its address; poll under the retry policy as i2c_master_read does
+	atretrystart(iface, &retry);
+	hal_sim_watchdog(dev);
+	while (dev->power != SIM_AWAKE || g_sim_clock_us < dev->ready_time || length == 0) {
+		hal_sim_bus(dev, 1);
+		if (!atretrynext(iface, &retry)) {
+			atretrydone(iface, &retry, ATCA_RX_NO_RESPONSE);
+			*rxlength = 0;
+			return ATCA_RX_NO_RESPONSE;
+		}
+		hal_sim_watchdog(dev);
+	}
+	atretrydone(iface, &retry, ATCA_SUCCESS);
+
+	if (length > *rxlength)
+		length = *rxlength;
+	memcpy(rxdata, dev->response, length);
+	*rxlength = length;
+	hal_sim_bus(dev, length + 1);
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief wake up the simulated device
+ * \param[in] iface  interface to logical device to wakeup
+ */
+ATCA_STATUS hal_sim_wake(ATCAIface iface)
+{
+	ATCAIfaceCfg *cfg = atgetifacecfg(iface);
+	hal_sim_device_t *dev = (hal_sim_device_t*)atgetifacehaldat(iface);
+	const uint8_t expected[ATCA_RSP_SIZE_MIN] = { 0x04, 0x11, 0x33, 0x43 };
+
+	hal_sim_watchdog(dev);
+
+	// An awake device ignores the wake pulse and keeps its output buffer
+	if (dev->power != SIM_AWAKE) {
+		dev->power = SIM_AWAKE;
+		dev->wake_time = g_sim_clock_us;
+		dev->ready_time = g_sim_clock_us;
+		memcpy(dev->response, expected, sizeof(expected));
+	}
+
+	atca_delay_us(cfg->wake_delay);     // tWHI + tWLO, as hal_i2c_wake waits
+	hal_sim_bus(dev, ATCA_RSP_SIZE_MIN + 1);
+
+	if (memcmp(dev->response, expected, ATCA_RSP_SIZE_MIN) == 0)
+		return ATCA_SUCCESS;
+
+	return ATCA_COMM_FAIL;
+}
+
+/** \brief idle the simulated device, TempKey and the SHA context are kept
+ * \param[in] iface  interface to logical device to idle
+ */
+ATCA_STATUS hal_sim_idle(ATCAIface iface)
+{
+	hal_sim_device_t *dev = (hal_sim_device_t*)atgetifacehaldat(iface);
+
+	hal_sim_bus(dev, 2);
+	hal_sim_watchdog(dev);
+	if (dev->power != SIM_AWAKE || g_sim_clock_us < dev->ready_time)
+		return ATCA_COMM_FAIL;
+
+	dev->power = SIM_IDLE;
+	dev->response[ATCA_COUNT_IDX] = 0;
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief put the simulated device to sleep, clearing its volatile state
+ * \param[in] iface  interface to logical device to sleep
+ */
+ATCA_STATUS hal_sim_sleep(ATCAIface iface)
+{
+	hal_sim_device_t *dev = (hal_sim_device_t*)atgetifacehaldat(iface);
+
+	hal_sim_bus(dev, 2);
+	hal_sim_watchdog(dev);
+	if (dev->power != SIM_AWAKE || g_sim_clock_us < dev->ready_time)
+		return ATCA_COMM_FAIL;
+
+	dev->power = SIM_SLEEP;
+	hal_sim_clear_volatile(dev);
+
+	return ATCA_SUCCESS;
+}
+
+/** \brief release a simulated device interface, the device keeps its zones like a chip left on the bus
+ * \param[in] hal_data - opaque pointer to hal data structure - known only to the HAL implementation
+ */
+ATCA_STATUS hal_sim_release(void *hal_data)
+{
+	(void)hal_data;
+	return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_sim_reset(uint8_t instance)
+{
+	if (instance >= HAL_SIM_MAX_DEVICES)
+		return ATCA_BAD_PARAM;
+
+	if (g_sim_devices[instance].powered)
+		hal_sim_power_up(&g_sim_devices[instance]);
+
+	return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_sim_load_zone(uint8_t instance, uint8_t zone, uint16_t offset, const uint8_t *data, size_t length)
+{
+	hal_sim_device_t *dev;
+	uint8_t *target;
+	size_t size;
+
+	if (instance >= HAL_SIM_MAX_DEVICES || !g_sim_devices[instance].powered || data == NULL)
+		return ATCA_BAD_PARAM;
+	dev = &g_sim_devices[instance];
+
+	switch (zone) {
+	case ATCA_ZONE_CONFIG:
+		target = dev->config;
+		size = hal_sim_config_size(dev);
+		break;
+	case ATCA_ZONE_OTP:
+		target = dev->otp;
+		size = ATCA_OTP_SIZE;
+		break;
+	case ATCA_ZONE_DATA:
+		target = dev->data;
+		size = hal_sim_data_size(dev);
+		break;
+	default:
+		return ATCA_BAD_PARAM;
+	}
+	if (offset > size || length > size - offset)
+		return ATCA_BAD_PARAM;
+
+	memcpy(&target[offset], data, length);
+
+	return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_sim_load_slot(uint8_t instance, uint8_t slot, const uint8_t *data, size_t length)
+{
+	hal_sim_device_t *dev;
+
+	if (instance >= HAL_SIM_MAX_DEVICES || !g_sim_devices[instance].powered || slot > ATCA_KEY_ID_MAX || data == NULL)
+		return ATCA_BAD_PARAM;
+	dev = &g_sim_devices[instance];
+
+	if (length > hal_sim_slot_size(dev, slot))
+		return ATCA_BAD_PARAM;
+
+	memcpy(hal_sim_slot(dev, slot), data, length);
+
+	return ATCA_SUCCESS;
+}
+
+uint64_t hal_sim_time_us(void)
+{
+	return g_sim_clock_us;
+}
+
+void hal_sim_set_realtime(bool realtime)
+{
+	g_sim_realtime = realtime;
+}
+
+#if !defined(__AVR__)
+
+/* Timer functions for host builds, the simulated clock stands in for the bus and the device. */
+static uint32_t g_sim_delay_us;
+
+uint32_t atca_delay_elapsed_us(void)
+{
+	return g_sim_delay_us;
+}
+
+void atca_delay_us(uint32_t delay)
+{
+	struct timespec duration;
+
+	g_sim_clock_us += delay;
+	g_sim_delay_us += delay;
+
+	if (g_sim_realtime) {
+		duration.tv_sec = delay / 1000000UL;
+		duration.tv_nsec = (long)(delay % 1000000UL) * 1000L;
+		nanosleep(&duration, NULL);
+	}
+}
+
+void atca_delay_10us(uint32_t delay)
+{
+	atca_delay_us(delay * 10);
+}
+
+void atca_delay_ms(uint32_t delay)
+{
+	atca_delay_us(delay * 1000);
+}
+
+#endif /* !__AVR__ */
+
+#endif /* ATCA_HAL_SIM */
@@ -0,0 +1,140 @@
+/**
+ * \file
+ * \brief Software ATECC508A / ATSHA204A device simulator HAL for host builds.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#ifndef HAL_SIM_H_
+#define HAL_SIM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "atca_status.h"
+
+/** \defgroup hal_ Hardware abstraction layer (hal_)
+ *
+   @{ */
+
+/** Number of simulated devices, selected by ATCAIfaceCfg.atcasim.instance. */
+#ifndef HAL_SIM_MAX_DEVICES
+#define HAL_SIM_MAX_DEVICES     (4)
+#endif
+
+/** Time from wake until the watchdog forces the device to sleep (tWATCHDOG, typical). */
+#define HAL_SIM_WATCHDOG_US     (1300000UL)
+
+/** Size of the ATECC508A data zone: slots 0-7 of 36 bytes, slot 8 of 416, slots 9-15 of 72. */
+#define HAL_SIM_DATA_SIZE       (8 * 36 + 416 + 7 * 72)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************//**
+ * \fn	ATCA_STATUS hal_sim_reset(uint8_t instance)
+ *
+ * \brief	Restores a simulated device to its factory image and puts it to sleep. TempKey,
+ * 			the SHA context and everything loaded or written since are lost.
+ *
+ * \param	instance	Simulated device index, 0 to HAL_SIM_MAX_DEVICES - 1.
+ *
+ * \return	ATCA_SUCCESS, or ATCA_BAD_PARAM for an unknown instance
+ **************************************************************************************************/
+ATCA_STATUS hal_sim_reset(uint8_t instance);
+
+/**********************************************************************************************//**
+ * \fn	ATCA_STATUS hal_sim_load_zone(uint8_t instance, uint8_t zone, uint16_t offset, const uint8_t *data, size_t length)
+ *
+ * \brief	Writes a zone of a simulated device directly, bypassing locks and slot permissions.
+ * 			Used to provision keys and certificates before a test. Data zone offsets are
+ * 			linear byte offsets across the slots.
+ *
+ * \param	instance	Simulated device index, the device must have been initialized.
+ * \param	zone		ATCA_ZONE_CONFIG, ATCA_ZONE_OTP or ATCA_ZONE_DATA.
+ * \param	offset		Byte offset into the zone.
+ * \param	data		Bytes to store.
+ * \param	length		Number of bytes to store.
+ *
+ * \return	ATCA_SUCCESS, or ATCA_BAD_PARAM if the write falls outside the zone
+ **************************************************************************************************/
+ATCA_STATUS hal_sim_load_zone(uint8_t instance, uint8_t zone, uint16_t offset, const uint8_t *data, size_t length);
+
+/**********************************************************************************************//**
+ * \fn	ATCA_STATUS hal_sim_load_slot(uint8_t instance, uint8_t slot, const uint8_t *data, size_t length)
+ *
+ * \brief	Writes the start of a data slot of a simulated device directly. Private keys are
+ * 			stored as four zero bytes followed by the 32 byte key, as PrivWrite stores them.
+ *
+ * \param	instance	Simulated device index, the device must have been initialized.
+ * \param	slot		Slot number, 0 to 15.
+ * \param	data		Bytes to store.
+ * \param	length		Number of bytes to store, at most the slot size.
+ *
+ * \return	ATCA_SUCCESS, or ATCA_BAD_PARAM if the data does not fit the slot
+ **************************************************************************************************/
+ATCA_STATUS hal_sim_load_slot(uint8_t instance, uint8_t slot, const uint8_t *data, size_t length);
+
+/**********************************************************************************************//**
+ * \fn	uint64_t hal_sim_time_us(void)
+ *
+ * \brief	Returns the simulated time in microseconds. atca_delay_ms(), atca_delay_us() and
+ * 			atca_delay_10us() advance it, and so does bus traffic when a baud rate is configured.
+ *
+ * \return	Microseconds of simulated time since start-up
+ **************************************************************************************************/
+uint64_t hal_sim_time_us(void);
+
+/**********************************************************************************************//**
+ * \fn	void hal_sim_set_realtime(bool realtime)
+ *
+ * \brief	Selects whether the atca_delay functions also sleep the calling thread. Off by
+ * 			default, so command latencies only advance the simulated clock and the stack runs
+ * 			as fast as the host can execute it.
+ *
+ * \param	realtime	true to sleep for every delay, false to only advance the simulated clock.
+ **************************************************************************************************/
+void hal_sim_set_realtime(bool realtime);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif /* HAL_SIM_H_ */
@@ -0,0 +1,499 @@
+/**
+ * \file
+ * \brief Bus transaction trace recorder and replay HAL.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#include <stdio.h>
+#include <string.h>
+#include "atca_hal.h"
+
+#if defined(ATCA_HAL_TRACE) || defined(ATCA_HAL_REPLAY)
+
+#include "hal_trace.h"
+
+/** \brief reads a little-endian 16 bit value */
+static uint16_t hal_trace_get16(const uint8_t *buf)
+{
+	return (uint16_t)(buf[0] | ((uint16_t)buf[1] << 8));
+}
+
+/** \brief number of data bytes stored after a record header */
+static uint16_t hal_trace_stored(const uint8_t *header)
+{
+	return (header[0] & HAL_TRACE_TRUNCATED) ? 0 : hal_trace_get16(&header[2]);
+}
+
+#endif
+
+#ifdef ATCA_HAL_TRACE
+
+/* The ring holds whole records back to back and wraps byte by byte, so a record can straddle the
+   end of the buffer. Room for a new record is made by dropping the oldest ones. */
+
+#define HAL_TRACE_IFACE_TYPES   (ATCA_REPLAY_IFACE + 1)
+
+static ATCAHAL_t g_trace_inner[HAL_TRACE_IFACE_TYPES];  // the HAL each interface type was wrapped around
+static uint8_t g_trace_ring[HAL_TRACE_BUFFER_SIZE];
+static size_t g_trace_head;             // where the next record is written
+static size_t g_trace_tail;             // oldest record
+static size_t g_trace_used;             // bytes in the ring
+static uint16_t g_trace_records;        // records in the ring
+static uint32_t g_trace_dropped;
+static bool g_trace_enabled = true;
+static hal_trace_clock_t g_trace_clock = atca_delay_elapsed_us;
+
+/** \brief copies bytes out of the ring starting at an offset, wrapping at the end */
+static void hal_trace_copy_out(size_t offset, uint8_t *buf, size_t length)
+{
+	size_t chunk = HAL_TRACE_BUFFER_SIZE - offset;
+
+	if (chunk > length)
+		chunk = length;
+	memcpy(buf, &g_trace_ring[offset], chunk);
+	memcpy(&buf[chunk], g_trace_ring, length - chunk);
+}
+
+/** \brief appends bytes at the head of the ring, the caller has made room */
+static void hal_trace_copy_in(const uint8_t *buf, size_t length)
+{
+	size_t chunk = HAL_TRACE_BUFFER_SIZE - g_trace_head;
+
+	if (chunk > length)
+		chunk = length;
+	memcpy(&g_trace_ring[g_trace_head], buf, chunk);
+	memcpy(g_trace_ring, &buf[chunk], length - chunk);
+	g_trace_head = (g_trace_head + length) % HAL_TRACE_BUFFER_SIZE;
+	g_trace_used += length;
+}
+
+/** \brief drops the oldest record */
+static void hal_trace_drop(void)
+{
+	uint8_t header[HAL_TRACE_HEADER_SIZE];
+	size_t size;
+
+	hal_trace_copy_out(g_trace_tail, header, sizeof(header));
+	size = HAL_TRACE_HEADER_SIZE + hal_trace_stored(header);
+	g_trace_tail = (g_trace_tail + size) % HAL_TRACE_BUFFER_SIZE;
+	g_trace_used -= size;
+	g_trace_records--;
+	g_trace_dropped++;
+}
+
+/** \brief appends a record, dropping the oldest ones as needed */
+static void hal_trace_record(uint8_t op, ATCA_STATUS status, const uint8_t *data, uint16_t length)
+{
+	uint8_t header[HAL_TRACE_HEADER_SIZE];
+	uint32_t now;
+	uint16_t stored = length;
+
+	if (!g_trace_enabled)
+		return;
+
+	now = g_trace_clock();
+	if (HAL_TRACE_HEADER_SIZE + (size_t)length > HAL_TRACE_BUFFER_SIZE) {
+		op |= HAL_TRACE_TRUNCATED;
+		stored = 0;
+	}
+	while (HAL_TRACE_BUFFER_SIZE - g_trace_used < HAL_TRACE_HEADER_SIZE + (size_t)stored)
+		hal_trace_drop();
+
+	header[0] = op;
+	header[1] = (uint8_t)status;
+	header[2] = (uint8_t)length;
+	header[3] = (uint8_t)(length >> 8);
+	header[4] = (uint8_t)now;
+	header[5] = (uint8_t)(now >> 8);
+	header[6] = (uint8_t)(now >> 16);
+	header[7] = (uint8_t)(now >> 24);
+	hal_trace_copy_in(header, sizeof(header));
+	hal_trace_copy_in(data, stored);
+	g_trace_records++;
+}
+
+/** \brief the HAL an interface was wrapped around */
+static ATCAHAL_t* hal_trace_inner(ATCAIface iface)
+{
+	return &g_trace_inner[atgetifacecfg(iface)->iface_type];
+}
+
+static ATCA_STATUS hal_trace_init(void *hal, ATCAIfaceCfg *cfg)
+{
+	return g_trace_inner[cfg->iface_type].halinit(hal, cfg);
+}
+
+static ATCA_STATUS hal_trace_post_init(ATCAIface iface)
+{
+	return hal_trace_inner(iface)->halpostinit(iface);
+}
+
+static ATCA_STATUS hal_trace_send(ATCAIface iface, uint8_t *txdata, uint16_t txlength)
+{
+	ATCA_STATUS status = hal_trace_inner(iface)->halsend(iface, txdata, txlength);
+
+	// txdata[0] is the reserved byte of the ATCAPacket, the packet itself follows
+	hal_trace_record(HAL_TRACE_SEND, status, &txdata[1], txlength);
+	return status;
+}
+
+static ATCA_STATUS hal_trace_receive(ATCAIface iface, uint8_t *rxdata, uint16_t *rxlength)
+{
+	ATCA_STATUS status = hal_trace_inner(iface)->halreceive(iface, rxdata, rxlength);
+
+	hal_trace_record(HAL_TRACE_RECEIVE, status, rxdata, (status == ATCA_SUCCESS) ? *rxlength : 0);
+	return status;
+}
+
+static ATCA_STATUS hal_trace_wake(ATCAIface iface)
+{
+	ATCA_STATUS status = hal_trace_inner(iface)->halwake(iface);
+
+	hal_trace_record(HAL_TRACE_WAKE, status, NULL, 0);
+	return status;
+}
+
+static ATCA_STATUS hal_trace_idle(ATCAIface iface)
+{
+	ATCA_STATUS status = hal_trace_inner(iface)->halidle(iface);
+
+	hal_trace_record(HAL_TRACE_IDLE, status, NULL, 0);
+	return status;
+}
+
+static ATCA_STATUS hal_trace_sleep(ATCAIface iface)
+{
+	ATCA_STATUS status = hal_trace_inner(iface)->halsleep(iface);
+
+	hal_trace_record(HAL_TRACE_SLEEP, status, NULL, 0);
+	return status;
+}
+
+/** \brief wraps the recorder around the HAL hal_iface_init() picked for an interface type
+ * \param[in] cfg  interface configuration
+ * \param[in,out] hal  HAL methods, replaced by the recorder's
+ */
+void hal_trace_attach(ATCAIfaceCfg *cfg, ATCAHAL_t *hal)
+{
+	if ((unsigned)cfg->iface_type >= HAL_TRACE_IFACE_TYPES)
+		return;
+
+	g_trace_inner[cfg->iface_type] = *hal;
+	hal->halinit = &hal_trace_init;
+	hal->halpostinit = &hal_trace_post_init;
+	hal->halsend = &hal_trace_send;
+	hal->halreceive = &hal_trace_receive;
+	hal->halwake = &hal_trace_wake;
+	hal->halidle = &hal_trace_idle;
+	hal->halsleep = &hal_trace_sleep;
+}
+
+void hal_trace_enable(bool enable)
+{
+	g_trace_enabled = enable;
+}
+
+void hal_trace_set_clock(hal_trace_clock_t clock)
+{
+	g_trace_clock = (clock != NULL) ? clock : atca_delay_elapsed_us;
+}
+
+void hal_trace_clear(void)
+{
+	g_trace_head = 0;
+	g_trace_tail = 0;
+	g_trace_used = 0;
+	g_trace_records = 0;
+	g_trace_dropped = 0;
+}
+
+size_t hal_trace_read(uint8_t *trace, size_t size)
+{
+	uint8_t header[HAL_TRACE_HEADER_SIZE];
+	size_t offset = g_trace_tail;
+	size_t copied = 0;
+	size_t record;
+	uint16_t i;
+
+	for (i = 0; i < g_trace_records; i++) {
+		hal_trace_copy_out(offset, header, sizeof(header));
+		record = HAL_TRACE_HEADER_SIZE + hal_trace_stored(header);
+		if (copied + record > size)
+			break;
+		hal_trace_copy_out(offset, &trace[copied], record);
+		copied += record;
+		offset = (offset + record) % HAL_TRACE_BUFFER_SIZE;
+	}
+
+	return copied;
+}
+
+uint32_t hal_trace_dropped(void)
+{
+	return g_trace_dropped;
+}
+
+void hal_trace_dump(hal_trace_line_t print, void *context)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	char line[2 * 32 + 1];
+	uint8_t buf[32];
+	size_t offset = g_trace_tail;
+	size_t record, done, chunk, j;
+	uint16_t i;
+
+	snprintf(line, sizeof(line), "# hal_trace records=%u dropped=%lu", g_trace_records, (unsigned long)g_trace_dropped);
+	print(line, context);
+
+	// A record is printed in pieces of at most 32 bytes; each line is a whole number of bytes,
+	// so the pieces can be decoded and concatenated without looking at the record boundaries
+	for (i = 0; i < g_trace_records; i++) {
+		hal_trace_copy_out(offset, buf, HAL_TRACE_HEADER_SIZE);
+		record = HAL_TRACE_HEADER_SIZE + hal_trace_stored(buf);
+		for (done = 0; done < record; done += chunk) {
+			chunk = (record - done > sizeof(buf)) ? sizeof(buf) : record - done;
+			hal_trace_copy_out((offset + done) % HAL_TRACE_BUFFER_SIZE, buf, chunk);
+			for (j = 0; j < chunk; j++) {
+				line[2 * j] = hex[buf[j] >> 4];
+				line[2 * j + 1] = hex[buf[j] & 0x0F];
+			}
+			line[2 * chunk] = '\0';
+			print(line, context);
+		}
+		offset = (offset + record) % HAL_TRACE_BUFFER_SIZE;
+	}
+}
+
+#endif /* ATCA_HAL_TRACE */
+
+#ifdef ATCA_HAL_REPLAY
+
+/** \brief reads a little-endian 32 bit value */
+static uint32_t hal_trace_get32(const uint8_t *buf)
+{
+	return buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+static const uint8_t *g_replay_trace;
+static size_t g_replay_length;
+static size_t g_replay_next;            // offset of the first record not replayed yet
+static bool g_replay_started;
+static uint32_t g_replay_last;          // timestamp of the last replayed record
+static hal_replay_stats_t g_replay_stats;
+
+/** \brief finds the next record of an operation and moves past it
+ * \return the record header, NULL when the trace has no more records of that operation
+ */
+static const uint8_t* hal_replay_next(uint8_t op)
+{
+	const uint8_t *record;
+	size_t offset = g_replay_next;
+	uint32_t skipped = 0;
+	uint32_t now;
+
+	while (offset + HAL_TRACE_HEADER_SIZE <= g_replay_length) {
+		record = &g_replay_trace[offset];
+		offset += HAL_TRACE_HEADER_SIZE + hal_trace_stored(record);
+		if ((record[0] & HAL_TRACE_OP_MASK) != op) {
+			skipped++;
+			continue;
+		}
+
+		now = hal_trace_get32(&record[4]);
+		if (g_replay_started)
+			g_replay_stats.device_us += now - g_replay_last;
+		g_replay_started = true;
+		g_replay_last = now;
+		g_replay_next = offset;
+		g_replay_stats.skipped += skipped;
+		g_replay_stats.replayed++;
+		return record;
+	}
+
+	return NULL;
+}
+
+ATCA_STATUS hal_replay_load(const uint8_t *trace, size_t length)
+{
+	size_t offset = 0;
+
+	while (offset < length) {
+		if (offset + HAL_TRACE_HEADER_SIZE > length)
+			return ATCA_BAD_PARAM;
+		offset += HAL_TRACE_HEADER_SIZE + hal_trace_stored(&trace[offset]);
+		if (offset > length)
+			return ATCA_BAD_PARAM;
+	}
+
+	g_replay_trace = trace;
+	g_replay_length = length;
+	g_replay_next = 0;
+	g_replay_started = false;
+	memset(&g_replay_stats, 0, sizeof(g_replay_stats));
+
+	return ATCA_SUCCESS;
+}
+
+void hal_replay_get_stats(hal_replay_stats_t *stats)
+{
+	*stats = g_replay_stats;
+}
+
+/** \brief initialize the replay HAL, the trace is loaded separately with hal_replay_load() */
+ATCA_STATUS hal_replay_init(void *hal, ATCAIfaceCfg *cfg)
+{
+	(void)cfg;
+	((ATCAHAL_t*)hal)->hal_data = NULL;
+	return ATCA_SUCCESS;
+}
+
+/** \brief nothing to do after initializing the replay HAL */
+ATCA_STATUS hal_replay_post_init(ATCAIface iface)
+{
+	(void)iface;
+	return ATCA_SUCCESS;
+}
+
+/** \brief compare a packet with the next recorded send and return its status */
+ATCA_STATUS hal_replay_send(ATCAIface iface, uint8_t *txdata, uint16_t txlength)
+{
+	const uint8_t *record = hal_replay_next(HAL_TRACE_SEND);
+
+	(void)iface;
+
+	if (record == NULL)
+		return ATCA_COMM_FAIL;
+
+	txdata[0] = 0x03;   // word address value, as hal_i2c_send inserts it
+	if (!(record[0] & HAL_TRACE_TRUNCATED)
+	    && (hal_trace_get16(&record[2]) != txlength || memcmp(&record[HAL_TRACE_HEADER_SIZE], &txdata[1], txlength) != 0))
+		g_replay_stats.mismatches++;
+
+	return (ATCA_STATUS)record[1];
+}
+
+/** \brief return the bytes and status of the next recorded receive */
+ATCA_STATUS hal_replay_receive(ATCAIface iface, uint8_t *rxdata, uint16_t *rxlength)
+{
+	const uint8_t *record = hal_replay_next(HAL_TRACE_RECEIVE);
+	uint16_t length;
+
+	(void)iface;
+
+	if (record == NULL) {
+		*rxlength = 0;
+		return ATCA_RX_NO_RESPONSE;
+	}
+
+	length = hal_trace_stored(record);
+	if (length > *rxlength)
+		length = *rxlength;
+	memcpy(rxdata, &record[HAL_TRACE_HEADER_SIZE], length);
+	*rxlength = length;
+
+	return (ATCA_STATUS)record[1];
+}
+
+/** \brief return the status of the next recorded wake */
+ATCA_STATUS hal_replay_wake(ATCAIface iface)
+{
+	const uint8_t *record = hal_replay_next(HAL_TRACE_WAKE);
+
+	(void)iface;
+
+	return (record != NULL) ? (ATCA_STATUS)record[1] : ATCA_WAKE_FAILED;
+}
+
+/** \brief return the status of the next recorded idle */
+ATCA_STATUS hal_replay_idle(ATCAIface iface)
+{
+	const uint8_t *record = hal_replay_next(HAL_TRACE_IDLE);
+
+	(void)iface;
+
+	return (record != NULL) ? (ATCA_STATUS)record[1] : ATCA_COMM_FAIL;
+}
+
+/** \brief return the status of the next recorded sleep */
+ATCA_STATUS hal_replay_sleep(ATCAIface iface)
+{
+	const uint8_t *record = hal_replay_next(HAL_TRACE_SLEEP);
+
+	(void)iface;
+
+	return (record != NULL) ? (ATCA_STATUS)record[1] : ATCA_COMM_FAIL;
+}
+
+/** \brief release the replay HAL, the loaded trace stays loaded */
+ATCA_STATUS hal_replay_release(void *hal_data)
+{
+	(void)hal_data;
+	return ATCA_SUCCESS;
+}
+
+#if !defined(__AVR__) && !defined(ATCA_HAL_SIM)
+
+/* Host builds without the simulator have no other timer implementation. The device times are in
+   the trace, so the delays return at once and are only counted. */
+
+static uint32_t g_replay_delay_us;
+
+uint32_t atca_delay_elapsed_us(void)
+{
+	return g_replay_delay_us;
+}
+
+void atca_delay_us(uint32_t delay)
+{
+	g_replay_delay_us += delay;
+}
+
+void atca_delay_10us(uint32_t delay)
+{
+	atca_delay_us(delay * 10);
+}
+
+void atca_delay_ms(uint32_t delay)
+{
+	atca_delay_us(delay * 1000);
+}
+
+#endif /* !__AVR__ && !ATCA_HAL_SIM */
+
+#endif /* ATCA_HAL_REPLAY */
@@ -0,0 +1,207 @@
+/**
+ * \file
+ * \brief Bus transaction trace recorder and replay HAL.
+ *
+ * Copyright (c) 2016 Astek Corporation. All rights reserved.
+ *
+ * \astek_eguard_library_license_start
+ *
+ * \page eGuard_License
+ * 
+ * The source code contained within is subject to Astek's eGuard licensing
+ * agreement located at: https://www.astekcorp.com/
+ *
+ * The eGuard product may be used in source and binary forms, with or without
+ * modifications, with the following conditions:
+ *
+ * 1. The source code must retain the above copyright notice, this list of
+ *    conditions, and the disclaimer.
+ *
+ * 2. Distribution of source code is not authorized.
+ *
+ * 3. This software may only be used in connection with an Astek eGuard
+ *    Product.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT OF
+ * THIRD PARTY RIGHTS. THE COPYRIGHT HOLDER OR HOLDERS INCLUDED IN THIS NOTICE
+ * DO NOT WARRANT THAT THE FUNCTIONS CONTAINED IN THE SOFTWARE WILL MEET YOUR
+ * REQUIREMENTS OR THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR
+ * ERROR FREE. ANY USE OF THE SOFTWARE SHALL BE MADE ENTIRELY AT THE USER'S OWN
+ * RISK. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR ANY CONTRIUBUTER OF
+ * INTELLECTUAL PROPERTY RIGHTS TO THE SOFTWARE PROPERTY BE LIABLE FOR ANY
+ * CLAIM, OR ANY DIRECT, SPECIAL, INDIRECT, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES, OR ANY DAMAGES WHATSOEVER RESULTING FROM ANY ALLEGED INFRINGEMENT
+ * OR ANY LOSS OF USE, DATA, OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE, OR UNDER ANY OTHER LEGAL THEORY, ARISING OUT OF OR IN
+ * CONNECTION WITH THE IMPLEMENTATION, USE, COMMERCIALIZATION, OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ * 
+ * \astek_eguard_library_license_stop
+ */
+#ifndef HAL_TRACE_H_
+#define HAL_TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "atca_status.h"
+
+/** \defgroup hal_ Hardware abstraction layer (hal_)
+ *
+   @{ */
+
+/* A trace is a sequence of records, each an 8 byte header followed by its data:
+
+     byte 0     operation, HAL_TRACE_SEND to HAL_TRACE_SLEEP, HAL_TRACE_TRUNCATED when the data was dropped
+     byte 1     ATCA_STATUS returned by the HAL
+     byte 2-3   data length, little-endian
+     byte 4-7   timestamp in microseconds from the trace clock, little-endian
+     byte 8-    the bytes sent, or received, when the operation carries data and was not truncated
+
+   With ATCA_HAL_TRACE defined in the compiler settings, hal_iface_init() slides a recorder between the
+   library and the HAL of every interface it sets up and keeps the most recent records in a RAM ring.
+   With ATCA_HAL_REPLAY defined, ATCA_REPLAY_IFACE is a HAL that answers from a loaded trace instead of a
+   device, so a trace taken on a board can be run through the library again on a host. */
+
+#define HAL_TRACE_SEND          (1)     //!< halsend, data is the packet sent
+#define HAL_TRACE_RECEIVE       (2)     //!< halreceive, data is the bytes received
+#define HAL_TRACE_WAKE          (3)     //!< halwake
+#define HAL_TRACE_IDLE          (4)     //!< halidle
+#define HAL_TRACE_SLEEP         (5)     //!< halsleep
+#define HAL_TRACE_OP_MASK       (0x0F)
+#define HAL_TRACE_TRUNCATED     (0x80)  //!< the data did not fit the ring and was not kept
+
+#define HAL_TRACE_HEADER_SIZE   (8)
+
+/** Size of the recorder ring in bytes; a wake, command and response typically take 50 to 150. */
+#ifndef HAL_TRACE_BUFFER_SIZE
+#ifdef __AVR__
+#define HAL_TRACE_BUFFER_SIZE   (256)
+#else
+#define HAL_TRACE_BUFFER_SIZE   (16384)
+#endif
+#endif
+
+/** \brief Microsecond clock used to timestamp records, e.g. micros() on Arduino */
+typedef uint32_t (*hal_trace_clock_t)(void);
+
+/** \brief Receives one line of hal_trace_dump() output, without a line ending */
+typedef void (*hal_trace_line_t)(const char *line, void *context);
+
+/** \brief Progress of a replay */
+typedef struct {
+	uint32_t replayed;      //!< records answered
+	uint32_t skipped;       //!< records passed over because the library made a different call
+	uint32_t mismatches;    //!< packets sent that differ from the recorded ones
+	uint32_t device_us;     //!< recorded time between the replayed records
+} hal_replay_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef ATCA_HAL_TRACE
+
+/**********************************************************************************************//**
+ * \fn	void hal_trace_enable(bool enable)
+ *
+ * \brief	Starts or pauses recording. Recording is on from start-up.
+ *
+ * \param	enable	true to record, false to pass calls through untouched.
+ **************************************************************************************************/
+void hal_trace_enable(bool enable);
+
+/**********************************************************************************************//**
+ * \fn	void hal_trace_set_clock(hal_trace_clock_t clock)
+ *
+ * \brief	Selects the clock for the timestamps. The default, atca_delay_elapsed_us(), only counts
+ * 			the library's own delays; pass micros() on a board to get wall time.
+ *
+ * \param	clock	Microsecond clock, NULL for the default.
+ **************************************************************************************************/
+void hal_trace_set_clock(hal_trace_clock_t clock);
+
+/**********************************************************************************************//**
+ * \fn	void hal_trace_clear(void)
+ *
+ * \brief	Drops every record in the ring and zeroes the dropped count.
+ **************************************************************************************************/
+void hal_trace_clear(void);
+
+/**********************************************************************************************//**
+ * \fn	size_t hal_trace_read(uint8_t *trace, size_t size)
+ *
+ * \brief	Copies the records in the ring, oldest first, in the format hal_replay_load() takes.
+ * 			Only whole records are copied.
+ *
+ * \param	trace	Receives the records.
+ * \param	size	Size of trace in bytes.
+ *
+ * \return	Number of bytes copied
+ **************************************************************************************************/
+size_t hal_trace_read(uint8_t *trace, size_t size);
+
+/**********************************************************************************************//**
+ * \fn	uint32_t hal_trace_dropped(void)
+ *
+ * \brief	Returns how many of the oldest records were overwritten to make room.
+ *
+ * \return	Records lost since start-up or the last hal_trace_clear()
+ **************************************************************************************************/
+uint32_t hal_trace_dropped(void);
+
+/**********************************************************************************************//**
+ * \fn	void hal_trace_dump(hal_trace_line_t print, void *context)
+ *
+ * \brief	Writes the ring as text, e.g. to Serial.println: a "#" comment line with the record
+ * 			and dropped counts, then one line of hex digits per record. Decoding the hex of the
+ * 			non-comment lines gives the input of hal_replay_load().
+ *
+ * \param	print	Receives each line.
+ * \param	context	Passed through to print.
+ **************************************************************************************************/
+void hal_trace_dump(hal_trace_line_t print, void *context);
+
+#endif /* ATCA_HAL_TRACE */
+
+#ifdef ATCA_HAL_REPLAY
+
+/**********************************************************************************************//**
+ * \fn	ATCA_STATUS hal_replay_load(const uint8_t *trace, size_t length)
+ *
+ * \brief	Loads the trace the replay HAL answers from and rewinds it. The trace is not copied and
+ * 			must stay valid while it is replayed.
+ *
+ * 			Each call the library makes is answered by the next record of the same operation: a
+ * 			receive gets the recorded bytes and both get the recorded status. Records the library
+ * 			does not ask for are skipped. Commands built from host random numbers (nonces, the
+ * 			symmetric challenge) are sent with other bytes than recorded and are counted as
+ * 			mismatches; the recorded responses are returned regardless.
+ *
+ * \param	trace	Records as produced by hal_trace_read().
+ * \param	length	Length of trace in bytes.
+ *
+ * \return	ATCA_SUCCESS, or ATCA_BAD_PARAM if a record runs past the end of the trace
+ **************************************************************************************************/
+ATCA_STATUS hal_replay_load(const uint8_t *trace, size_t length);
+
+/**********************************************************************************************//**
+ * \fn	void hal_replay_get_stats(hal_replay_stats_t *stats)
+ *
+ * \brief	Reports the progress of the replay since it was loaded.
+ *
+ * \param	stats	Receives the counters.
+ **************************************************************************************************/
+void hal_replay_get_stats(hal_replay_stats_t *stats);
+
+#endif /* ATCA_HAL_REPLAY */
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif /* HAL_TRACE_H_ */